@@ -0,0 +1,121 @@
+"""
+标定数据日志工具
+
+EliteCalibration 在标定过程中逐点追加写入二进制日志 (workspace/calibration_data.calib,
+workspace/calibration_3d_data.calib)，每个点写入后立即落盘。本工具负责读取与导出:
+
+    python calibration_log_tool.py info   workspace/calibration_3d_data.calib
+    python calibration_log_tool.py export workspace/calibration_3d_data.calib [-o out.txt] [--images]
+
+export 生成与旧版相同的 "PointID, X, Y, Z, Rx, Ry, Rz" CSV (m, rad)。
+在Python中可直接零拷贝读取:
+
+    header, records = load_calibration_log(path)
+    poses = records['tcp_pose']          # (N, 6) m/rad，np.memmap 视图
+"""
+import argparse
+import os
+import sys
+
+import numpy as np
+
+# 与 cpp_extensions/CalibrationLog.hpp 的布局一致 (elite_ext.CALIB_LOG_DTYPE)
+CALIB_LOG_MAGIC = b"ELTCALB1"
+CALIB_LOG_HEADER_DTYPE = np.dtype([
+    ('magic', 'S8'),
+    ('version', '<u4'),
+    ('record_size', '<u4'),
+    ('capacity', '<u8'),
+    ('count', '<u8'),
+    ('start_ns', '<i8'),
+    ('kind', '<i4'),
+    ('reserved', '<u4'),
+    ('description', 'S80'),
+])
+CALIB_LOG_DTYPE = np.dtype([
+    ('point_id', '<i4'),
+    ('flags', '<u4'),
+    ('captured_ns', '<i8'),
+    ('settle_time', '<f8'),
+    ('tcp_pose', '<f8', (6,)),
+    ('target_pose', '<f8', (6,)),
+    ('image', 'S136'),
+])
+assert CALIB_LOG_HEADER_DTYPE.itemsize == 128 and CALIB_LOG_DTYPE.itemsize == 256
+
+RUN_KINDS = {0: "unknown", 1: "9-point grid", 2: "3D pyramid"}
+POINT_FLAGS = {1: "captured", 2: "capture_failed", 4: "not_arrived", 8: "image_truncated"}
+
+
+def load_calibration_log(path):
+    """读取标定日志，返回 (header字典, 有效记录的只读 np.memmap 视图)"""
+    header = np.fromfile(path, dtype=CALIB_LOG_HEADER_DTYPE, count=1)
+    if header.size != 1 or header['magic'][0] != CALIB_LOG_MAGIC:
+        raise ValueError(f"不是标定日志文件: {path}")
+    h = header[0]
+    if h['record_size'] != CALIB_LOG_DTYPE.itemsize:
+        raise ValueError(f"不支持的记录大小 {h['record_size']} (版本 {h['version']})")
+
+    info = {
+        'version': int(h['version']),
+        'count': int(h['count']),
+        'capacity': int(h['capacity']),
+        'start_ns': int(h['start_ns']),
+        'kind': RUN_KINDS.get(int(h['kind']), str(int(h['kind']))),
+        'description': h['description'].decode('utf-8', 'replace'),
+    }
+    if info['count'] == 0:
+        return info, np.zeros(0, dtype=CALIB_LOG_DTYPE)
+    records = np.memmap(path, dtype=CALIB_LOG_DTYPE, mode='r',
+                        offset=CALIB_LOG_HEADER_DTYPE.itemsize, shape=(info['count'],))
+    return info, records
+
+
+def flag_names(flags):
+    return "|".join(name for bit, name in POINT_FLAGS.items() if flags & bit) or "-"
+
+
+def export_csv(path, out_path, with_images=False):
+    """导出为旧版 CSV 格式，返回导出的点数"""
+    _, records = load_calibration_log(path)
+    with open(out_path, 'w', encoding='utf-8') as f:
+        f.write("PointID, X, Y, Z, Rx, Ry, Rz" + (", Image" if with_images else "") + "\n")
+        for r in records:
+            line = f"{r['point_id']}, " + ", ".join(f"{v:.6f}" for v in r['tcp_pose'])
+            if with_images:
+                line += ", " + r['image'].decode('utf-8', 'replace')
+            f.write(line + "\n")
+    return len(records)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="标定数据日志工具")
+    sub = parser.add_subparsers(dest='command', required=True)
+    p_info = sub.add_parser('info', help="显示日志头与各点信息")
+    p_info.add_argument('log')
+    p_export = sub.add_parser('export', help="导出为 CSV")
+    p_export.add_argument('log')
+    p_export.add_argument('-o', '--output', help="输出文件 (默认与日志同名 .txt)")
+    p_export.add_argument('--images', action='store_true', help="附加图像路径列")
+    args = parser.parse_args()
+
+    try:
+        if args.command == 'info':
+            info, records = load_calibration_log(args.log)
+            print(f"类型: {info['kind']}  点数: {info['count']}  参数: {info['description']}")
+            for r in records:
+                pose = " ".join(f"{v:.6f}" for v in r['tcp_pose'])
+                print(f"  {r['point_id']:4d}  [{pose}]  settle={r['settle_time'] * 1000:.0f}ms  "
+                      f"{flag_names(int(r['flags']))}  {r['image'].decode('utf-8', 'replace')}")
+        else:
+            out = args.output or os.path.splitext(args.log)[0] + ".txt"
+            n = export_csv(args.log, out, args.images)
+            print(f"已导出 {n} 个点到 {out}")
+    except (OSError, ValueError) as e:
+        print(f"错误: {e}")
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
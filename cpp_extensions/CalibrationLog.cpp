@@ -0,0 +1,180 @@
+#include "CalibrationLog.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace ELITE_EXTENSION
+{
+
+    bool copyFixedString(char *dst, size_t size, const std::string &src)
+    {
+        const size_t n = src.size() < size ? src.size() : size - 1;
+        std::memset(dst, 0, size);
+        std::memcpy(dst, src.data(), n);
+        return n == src.size();
+    }
+
+    CalibrationLog::~CalibrationLog()
+    {
+        close();
+    }
+
+    bool CalibrationLog::map(size_t capacity, bool create)
+    {
+        const size_t size = sizeof(CalibrationLogHeader) + capacity * sizeof(CalibrationRecord);
+        void *base = nullptr;
+
+#ifdef _WIN32
+        HANDLE file = static_cast<HANDLE>(file_handle);
+        if (create)
+        {
+            file = CreateFileA(file_path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                               CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                return false;
+            file_handle = file;
+        }
+        // A mapping larger than the file extends it with zeroes
+        const uint64_t size64 = static_cast<uint64_t>(size);
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE,
+                                            static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64 & 0xFFFFFFFFu), nullptr);
+        if (!mapping)
+            return false;
+        base = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        if (!base)
+        {
+            CloseHandle(mapping);
+            return false;
+        }
+        mapping_handle = mapping;
+#else
+        if (create)
+        {
+            // Readers (np.memmap, calibration_log_tool) may still map the previous run's log;
+            // truncating that inode would SIGBUS them. Unlink it and create a new inode instead.
+            ::unlink(file_path.c_str());
+            fd = ::open(file_path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+            if (fd < 0)
+                return false;
+        }
+        if (ftruncate(fd, static_cast<off_t>(size)) != 0)
+            return false;
+        base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (base == MAP_FAILED)
+            return false;
+#endif
+
+        mapped_size = size;
+        header = static_cast<CalibrationLogHeader *>(base);
+        return true;
+    }
+
+    void CalibrationLog::unmap()
+    {
+        if (!header)
+            return;
+#ifdef _WIN32
+        UnmapViewOfFile(header);
+        CloseHandle(static_cast<HANDLE>(mapping_handle));
+        mapping_handle = nullptr;
+#else
+        munmap(header, mapped_size);
+#endif
+        header = nullptr;
+        mapped_size = 0;
+    }
+
+    bool CalibrationLog::open(const std::string &path, size_t capacity, int kind, const std::string &description)
+    {
+        close();
+        file_path = path;
+        if (!map(capacity > 0 ? capacity : 1, true))
+        {
+            close();
+            return false;
+        }
+
+        // The file is newly created, so the mapping starts zeroed
+        header = new (header) CalibrationLogHeader;
+        std::memcpy(header->magic, CALIB_LOG_MAGIC, sizeof(header->magic));
+        header->version = 1;
+        header->record_size = sizeof(CalibrationRecord);
+        header->capacity = capacity > 0 ? capacity : 1;
+        header->start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::system_clock::now().time_since_epoch())
+                               .count();
+        header->kind = kind;
+        copyFixedString(header->description, sizeof(header->description), description);
+        header->count.store(0, std::memory_order_release);
+        flush();
+        return true;
+    }
+
+    bool CalibrationLog::append(const CalibrationRecord &record)
+    {
+        if (!header)
+            return false;
+        const uint64_t n = header->count.load(std::memory_order_relaxed);
+        if (n >= header->capacity)
+        {
+            // Grow by doubling; the header and records written so far are in the file already
+            const size_t grown = static_cast<size_t>(header->capacity) * 2;
+            flush();
+            unmap();
+            if (!map(grown, false))
+            {
+                // Keep what is on disk, stop recording
+                close();
+                return false;
+            }
+            header->capacity = grown;
+        }
+
+        CalibrationRecord *records = reinterpret_cast<CalibrationRecord *>(reinterpret_cast<char *>(header) + sizeof(CalibrationLogHeader));
+        std::memcpy(&records[n], &record, sizeof(CalibrationRecord));
+        header->count.store(n + 1, std::memory_order_release);
+        flush();
+        return true;
+    }
+
+    void CalibrationLog::flush()
+    {
+        if (!header)
+            return;
+        // Synchronous: one point per second at most, and a dropped point costs a robot move
+#ifdef _WIN32
+        FlushViewOfFile(header, mapped_size);
+        FlushFileBuffers(static_cast<HANDLE>(file_handle));
+#else
+        msync(header, mapped_size, MS_SYNC);
+#endif
+    }
+
+    void CalibrationLog::close()
+    {
+        flush();
+        unmap();
+#ifdef _WIN32
+        if (file_handle)
+            CloseHandle(static_cast<HANDLE>(file_handle));
+        file_handle = nullptr;
+#else
+        if (fd >= 0)
+            ::close(fd);
+        fd = -1;
+#endif
+    }
+
+} // namespace ELITE_EXTENSION
@@ -0,0 +1,108 @@
+#ifndef ELITE_CALIBRATION_LOG_HPP
+#define ELITE_CALIBRATION_LOG_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ELITE_EXTENSION
+{
+
+    enum CalibrationRunKind
+    {
+        CALIB_RUN_UNKNOWN = 0,
+        CALIB_RUN_GRID = 1,    // run_calibration, 9-point plane grid
+        CALIB_RUN_PYRAMID = 2  // run_3d_calibration
+    };
+
+    // CalibrationRecord::flags
+    enum CalibrationPointFlags
+    {
+        CALIB_POINT_CAPTURED = 1,        // capture callback returned normally
+        CALIB_POINT_CAPTURE_FAILED = 2,  // capture callback raised
+        CALIB_POINT_NOT_ARRIVED = 4,     // arrival wait timed out, pose may be off target
+        CALIB_POINT_IMAGE_TRUNCATED = 8  // image reference longer than the field
+    };
+
+    // One captured calibration point. Fixed 256-byte layout without implicit padding so the file
+    // can be read back with a NumPy structured dtype (see CALIB_LOG_MAGIC).
+    struct CalibrationRecord
+    {
+        int32_t point_id;
+        uint32_t flags;         // CalibrationPointFlags
+        int64_t captured_ns;    // system_clock (Unix) time of the capture (ns)
+        double settle_time;     // s, measured before the capture
+        double tcp_pose[6];     // measured at the capture (m, rad)
+        double target_pose[6];  // commanded capture pose (m, rad)
+        char image[136];        // image reference (path), UTF-8, NUL-padded
+    };
+    static_assert(sizeof(CalibrationRecord) == 256, "CalibrationRecord layout is part of the file format");
+
+    // File layout: CalibrationLogHeader (128 bytes), then `capacity` CalibrationRecords of which
+    // the first `count` are valid. count is bumped and the file flushed after every record, so a
+    // crash loses at most the point being captured.
+    const char CALIB_LOG_MAGIC[8] = {'E', 'L', 'T', 'C', 'A', 'L', 'B', '1'};
+
+    struct CalibrationLogHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t record_size;
+        uint64_t capacity;
+        std::atomic<uint64_t> count;
+        int64_t start_ns;       // system_clock (Unix) time the log was created (ns)
+        int32_t kind;           // CalibrationRunKind
+        uint32_t reserved;
+        char description[80];   // run parameters, NUL-terminated
+    };
+    static_assert(sizeof(CalibrationLogHeader) == 128, "CalibrationLogHeader layout is part of the file format");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "count must be lock-free to live in a shared mapping");
+
+    // Memory-mapped, append-only calibration dataset. Single writer; the file grows (and is
+    // remapped) when capacity runs out, so readers map the file themselves rather than holding
+    // pointers into this one.
+    class CalibrationLog
+    {
+    public:
+        CalibrationLog() = default;
+        ~CalibrationLog();
+        CalibrationLog(const CalibrationLog &) = delete;
+        CalibrationLog &operator=(const CalibrationLog &) = delete;
+
+        // Creates path with room for `capacity` records. Returns false on I/O error. An existing
+        // file is unlinked first on POSIX, so readers still mapping it keep the old run; on Windows
+        // a file that is still mapped cannot be replaced and open fails.
+        bool open(const std::string &path, size_t capacity, int kind, const std::string &description);
+        void close();
+        bool isOpen() const { return header != nullptr; }
+
+        // Appends one record and flushes it to disk. Returns false if the file can't grow.
+        bool append(const CalibrationRecord &record);
+
+        const std::string &path() const { return file_path; }
+        size_t capacity() const { return header ? static_cast<size_t>(header->capacity) : 0; }
+        uint64_t count() const { return header ? header->count.load(std::memory_order_acquire) : 0; }
+
+    private:
+        bool map(size_t capacity, bool create);
+        void unmap();
+        void flush();
+
+        std::string file_path;
+        CalibrationLogHeader *header = nullptr;
+        size_t mapped_size = 0;
+#ifdef _WIN32
+        void *file_handle = nullptr;
+        void *mapping_handle = nullptr;
+#else
+        int fd = -1;
+#endif
+    };
+
+    // Copies a NUL-terminated string into a fixed char field, returns false if it was truncated
+    bool copyFixedString(char *dst, size_t size, const std::string &src);
+
+} // namespace ELITE_EXTENSION
+
+#endif // ELITE_CALIBRATION_LOG_HPP
@@ -0,0 +1,137 @@
+#ifndef CPU_DISPATCH_HPP
+#define CPU_DISPATCH_HPP
+
+// Runtime CPU feature dispatch for the hand-written SIMD kernels.
+//
+// The extensions are built for a portable baseline (see CMakeLists.txt) so one wheel runs on
+// every line PC. Kernels with SIMD variants mark them CPU_TARGET_SSE42 / _AVX2 / _AVX512 and
+// pick one per call from CPU_DISPATCH::level(), detected once from CPUID (and the OS's saved
+// register state, so AVX is only used where the OS supports it). arm64 always has NEON, which
+// is used unconditionally at compile time.
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define CPU_DISPATCH_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// MSVC accepts any intrinsic without flags; GCC/Clang need the ISA enabled on the function
+#if defined(CPU_DISPATCH_X86) && (defined(__GNUC__) || defined(__clang__))
+#define CPU_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define CPU_TARGET_AVX2 __attribute__((target("avx2")))
+#define CPU_TARGET_AVX512 __attribute__((target("avx2,avx512f,avx512bw")))
+#else
+#define CPU_TARGET_SSE42
+#define CPU_TARGET_AVX2
+#define CPU_TARGET_AVX512
+#endif
+
+namespace CPU_DISPATCH
+{
+
+    enum CpuLevel
+    {
+        CPU_SCALAR = 0,
+        CPU_SSE42 = 1,
+        CPU_AVX2 = 2,
+        CPU_AVX512 = 3, // AVX-512F + BW
+        CPU_NEON = 4
+    };
+
+    inline const char *levelName(int level)
+    {
+        static const char *NAMES[] = {"scalar", "sse4.2", "avx2", "avx512", "neon"};
+        return level >= CPU_SCALAR && level <= CPU_NEON ? NAMES[level] : "unknown";
+    }
+
+    // Highest level this CPU and OS support
+    inline int detect()
+    {
+#if defined(__aarch64__) || defined(_M_ARM64) || defined(__ARM_NEON)
+        return CPU_NEON;
+#elif defined(CPU_DISPATCH_X86) && defined(_MSC_VER) && !defined(__clang__)
+        int r[4];
+        __cpuid(r, 0);
+        const int max_leaf = r[0];
+        __cpuid(r, 1);
+        const bool sse42 = (r[2] & (1 << 20)) != 0;
+        const bool osxsave = (r[2] & (1 << 27)) != 0;
+        const bool avx = (r[2] & (1 << 28)) != 0;
+        if (!sse42)
+            return CPU_SCALAR;
+        if (!osxsave || !avx || max_leaf < 7)
+            return CPU_SSE42;
+        const unsigned long long xcr0 = _xgetbv(0);
+        if ((xcr0 & 0x6) != 0x6) // XMM and YMM state
+            return CPU_SSE42;
+        __cpuidex(r, 7, 0);
+        const bool avx2 = (r[1] & (1 << 5)) != 0;
+        const bool avx512 = (r[1] & (1 << 16)) && (r[1] & (1 << 30)) && (xcr0 & 0xE6) == 0xE6; // F, BW, opmask/ZMM state
+        if (avx512 && avx2)
+            return CPU_AVX512;
+        return avx2 ? CPU_AVX2 : CPU_SSE42;
+#elif defined(CPU_DISPATCH_X86)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx2"))
+            return CPU_AVX512;
+        if (__builtin_cpu_supports("avx2"))
+            return CPU_AVX2;
+        if (__builtin_cpu_supports("sse4.2"))
+            return CPU_SSE42;
+        return CPU_SCALAR;
+#else
+        return CPU_SCALAR;
+#endif
+    }
+
+    // requested, or the nearest level the CPU supports below it. A level of the other
+    // architecture (NEON on x86, an x86 level on arm64) falls back to scalar.
+    inline int clampLevel(int requested, int supported)
+    {
+        if (requested <= CPU_SCALAR)
+            return CPU_SCALAR;
+        if (supported == CPU_NEON || requested == CPU_NEON)
+            return requested == supported ? requested : CPU_SCALAR;
+        return requested < supported ? requested : supported;
+    }
+
+    // VISION_CPU_DISPATCH=scalar|sse4.2|avx2|avx512|neon caps the detected level
+    inline int initialLevel()
+    {
+        const int supported = detect();
+        if (const char *env = std::getenv("VISION_CPU_DISPATCH"))
+            for (int l = CPU_SCALAR; l <= CPU_NEON; ++l)
+                if (std::strcmp(env, levelName(l)) == 0)
+                    return clampLevel(l, supported);
+        return supported;
+    }
+
+    inline std::atomic<int> &activeLevel()
+    {
+        static std::atomic<int> level{initialLevel()};
+        return level;
+    }
+
+    inline int level()
+    {
+        return activeLevel().load(std::memory_order_relaxed);
+    }
+
+    // Caps dispatch at `requested` (clamped to what the CPU supports); returns the level in use.
+    // Meant for tests and A/B timing, not for switching while kernels run.
+    inline int setLevel(int requested)
+    {
+        const int l = clampLevel(requested, detect());
+        activeLevel().store(l, std::memory_order_relaxed);
+        return l;
+    }
+
+} // namespace CPU_DISPATCH
+
+#endif // CPU_DISPATCH_HPP
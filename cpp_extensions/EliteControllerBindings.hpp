@@ -0,0 +1,454 @@
+#ifndef ELITE_CONTROLLER_BINDINGS_HPP
+#define ELITE_CONTROLLER_BINDINGS_HPP
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <pybind11/stl.h>
+
+#include "EliteRobotController.hpp"
+#include "PoseMath.hpp"
+#include "TelemetryRecorder.hpp"
+#include "CalibrationLog.hpp"
+
+PYBIND11_NUMPY_DTYPE(ELITE_EXTENSION::TelemetryRecord, sequence, timestamp, received_ns, tcp_pose, tcp_speed,
+                     joint_positions, joint_speeds, robot_mode, runtime_state, output_bit_registers, reserved);
+PYBIND11_NUMPY_DTYPE(ELITE_EXTENSION::CalibrationRecord, point_id, flags, captured_ns, settle_time, tcp_pose,
+                     target_pose, image);
+
+namespace ELITE_EXTENSION
+{
+
+    // Binds EliteRobotController and RobotStateSnapshot into m. Function names exposed to Python
+    // are snake_case, mapping to the C++ camelCase methods. Every call that touches a socket
+    // releases the GIL so camera and UI threads keep running during robot I/O.
+    inline void bindEliteRobotController(pybind11::module_ &m)
+    {
+        namespace py = pybind11;
+        using ELITE::vector6d_t;
+
+        // Pose/joint fields are exposed as read-only NumPy views into the snapshot copy
+        auto array_view = [](std::array<double, 6> RobotStateSnapshot::*field)
+        {
+            return [field](py::object self)
+            {
+                auto &snap = self.cast<RobotStateSnapshot &>();
+                py::array_t<double> view(6, (snap.*field).data(), self);
+                view.attr("setflags")(py::arg("write") = false);
+                return view;
+            };
+        };
+
+        py::class_<RobotStateSnapshot>(m, "RobotStateSnapshot")
+            .def_readonly("sequence", &RobotStateSnapshot::sequence)
+            .def_readonly("timestamp", &RobotStateSnapshot::timestamp)
+            .def_readonly("robot_mode", &RobotStateSnapshot::robot_mode)
+            .def_readonly("runtime_state", &RobotStateSnapshot::runtime_state)
+            .def_property_readonly("valid", &RobotStateSnapshot::valid)
+            .def_property_readonly("age", &RobotStateSnapshot::age, "Seconds since the sample was received")
+            .def_property_readonly("tcp_pose", array_view(&RobotStateSnapshot::tcp_pose), "[x,y,z,rx,ry,rz] (m, rad)")
+            .def_property_readonly("tcp_speed", array_view(&RobotStateSnapshot::tcp_speed), "TCP speed (m/s, rad/s)")
+            .def_property_readonly("joint_positions", array_view(&RobotStateSnapshot::joint_positions), "Joint positions (rad)")
+            .def_property_readonly("joint_speeds", array_view(&RobotStateSnapshot::joint_speeds), "Joint speeds (rad/s)");
+
+        // The records view shares the mapping; the capsule keeps the recorder alive after stop_recording()
+        py::class_<TelemetryRecorder, std::shared_ptr<TelemetryRecorder>>(m, "TelemetryRecorder")
+            .def_property_readonly("path", &TelemetryRecorder::path)
+            .def_property_readonly("capacity", &TelemetryRecorder::capacity)
+            .def_property_readonly("count", &TelemetryRecorder::count, "Total records written, may exceed capacity")
+            .def_property_readonly(
+                "oldest_index",
+                [](const TelemetryRecorder &self)
+                {
+                    uint64_t n = self.count();
+                    return n < self.capacity() ? 0 : static_cast<size_t>(n % self.capacity());
+                },
+                "Ring slot of the oldest record")
+            .def_property_readonly(
+                "records",
+                [](std::shared_ptr<TelemetryRecorder> self)
+                {
+                    if (!self->isOpen())
+                        throw std::runtime_error("recorder is closed");
+                    auto *owner = new std::shared_ptr<TelemetryRecorder>(self);
+                    py::capsule base(owner, [](void *p)
+                                     { delete static_cast<std::shared_ptr<TelemetryRecorder> *>(p); });
+                    py::array_t<TelemetryRecord> view(self->capacity(), self->records(), base);
+                    view.attr("setflags")(py::arg("write") = false);
+                    return view;
+                },
+                "Read-only structured view of the whole ring, in slot order (see oldest_index)")
+            .def("flush", &TelemetryRecorder::flush, py::call_guard<py::gil_scoped_release>());
+
+        // Writer side of the calibration point log, for calibrations driven from Python.
+        // Reading goes through np.memmap (calibration_log_tool.load_calibration_log).
+        py::class_<CalibrationLog>(m, "CalibrationLog")
+            .def(py::init<>())
+            .def("open", &CalibrationLog::open, "Create (truncate) a log with room for capacity points; it grows as needed",
+                 py::arg("path"), py::arg("capacity") = 16, py::arg("kind") = static_cast<int>(CALIB_RUN_UNKNOWN),
+                 py::arg("description") = "", py::call_guard<py::gil_scoped_release>())
+            .def(
+                "append",
+                [](CalibrationLog &self, int point_id, const std::vector<double> &tcp_pose, const std::vector<double> &target_pose,
+                   double settle_time, const std::string &image, uint32_t flags)
+                {
+                    if (tcp_pose.size() < 6 || (!target_pose.empty() && target_pose.size() < 6))
+                        throw std::invalid_argument("poses must be [x,y,z,rx,ry,rz]");
+                    // mm, deg -> m, rad; a missing target repeats the measured pose
+                    const std::vector<double> &target = target_pose.empty() ? tcp_pose : target_pose;
+                    CalibrationRecord rec{};
+                    rec.point_id = point_id;
+                    rec.captured_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                          std::chrono::system_clock::now().time_since_epoch())
+                                          .count();
+                    rec.settle_time = settle_time;
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        rec.tcp_pose[i] = tcp_pose[i] / 1000.0;
+                        rec.tcp_pose[i + 3] = tcp_pose[i + 3] / 57.29578;
+                        rec.target_pose[i] = target[i] / 1000.0;
+                        rec.target_pose[i + 3] = target[i + 3] / 57.29578;
+                    }
+                    if (!copyFixedString(rec.image, sizeof(rec.image), image))
+                        flags |= CALIB_POINT_IMAGE_TRUNCATED;
+                    rec.flags = flags;
+                    py::gil_scoped_release release;
+                    return self.append(rec);
+                },
+                "Append one point (mm, deg) and flush it to disk",
+                py::arg("point_id"), py::arg("tcp_pose"), py::arg("target_pose") = std::vector<double>(),
+                py::arg("settle_time") = 0.0, py::arg("image") = "",
+                py::arg("flags") = static_cast<uint32_t>(CALIB_POINT_CAPTURED))
+            .def("close", &CalibrationLog::close, py::call_guard<py::gil_scoped_release>())
+            .def_property_readonly("is_open", &CalibrationLog::isOpen)
+            .def_property_readonly("path", &CalibrationLog::path)
+            .def_property_readonly("capacity", &CalibrationLog::capacity)
+            .def_property_readonly("count", &CalibrationLog::count);
+
+        // Bind the Unified Controller Class
+        py::class_<EliteRobotController>(m, "EliteRobotController")
+            .def(py::init<>())
+            .def("connect", &EliteRobotController::connect, "Connect to robot", py::arg("ip"), py::arg("recipe_dir") = "config",
+                 py::call_guard<py::gil_scoped_release>())
+            .def("connect_async", &EliteRobotController::connectAsync,
+                 "Start connecting in the background, poll connect_status() or wait_connected()",
+                 py::arg("ip"), py::arg("recipe_dir") = "config", py::arg("timeout") = CONNECT_TIMEOUT,
+                 py::call_guard<py::gil_scoped_release>())
+            .def("connect_status", &EliteRobotController::getConnectStatus, "CONNECT_IDLE/PENDING/READY/FAILED")
+            .def("wait_connected", &EliteRobotController::waitConnected, "Wait for connect_async to finish, returns the status",
+                 py::arg("timeout") = CONNECT_TIMEOUT, py::call_guard<py::gil_scoped_release>())
+            .def("disconnect", &EliteRobotController::disconnect, "Disconnect from robot", py::call_guard<py::gil_scoped_release>())
+            .def("is_connected", &EliteRobotController::isConnected, "Check connection status")
+            .def("get_position", &EliteRobotController::getPosition, "Get current position [x,y,z,rx,ry,rz] (mm, deg)")
+            .def("get_state_snapshot", &EliteRobotController::getStateSnapshot, "Get the latest cached RTSI state (non-blocking)")
+            .def(
+                "inject_state",
+                [](EliteRobotController &self, const std::vector<double> &tcp_pose, const std::vector<double> &tcp_speed, bool playing)
+                {
+                    if (tcp_pose.size() < 6 || tcp_speed.size() < 6)
+                        throw std::invalid_argument("tcp_pose and tcp_speed must have 6 values");
+                    RobotStateSnapshot snap;
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        snap.tcp_pose[i] = tcp_pose[i] / 1000.0;
+                        snap.tcp_pose[i + 3] = tcp_pose[i + 3] / 57.29578;
+                        snap.tcp_speed[i] = tcp_speed[i] / 1000.0;
+                        snap.tcp_speed[i + 3] = tcp_speed[i + 3] / 57.29578;
+                    }
+                    snap.robot_mode = static_cast<int32_t>(ELITE::RobotMode::RUNNING);
+                    snap.runtime_state = static_cast<int32_t>(playing ? ELITE::TaskStatus::PLAYING : ELITE::TaskStatus::STOPPED);
+                    self.injectStateSample(snap);
+                },
+                "Publish a simulated RUNNING sample (mm, deg, mm/s, deg/s) in place of RTSI, for tests without a robot",
+                py::arg("tcp_pose"), py::arg("tcp_speed") = std::vector<double>(6, 0.0), py::arg("playing") = false)
+            .def("get_robot_state", &EliteRobotController::getRobotState, "Get robot state string")
+            .def(
+                "get_rtsi_health",
+                [](const EliteRobotController &self)
+                {
+                    RtsiHealth h = self.getRtsiHealth();
+                    py::dict d;
+                    d["connected"] = h.connected;
+                    d["samples"] = h.samples;
+                    d["disconnects"] = h.disconnects;
+                    d["stale_resets"] = h.stale_resets;
+                    d["reconnect_attempts"] = h.reconnect_attempts;
+                    d["reconnects"] = h.reconnects;
+                    d["backoff"] = h.backoff_s;
+                    d["last_sample_age"] = h.last_sample_age;
+                    return d;
+                },
+                "RTSI reconnect supervisor counters (non-blocking)")
+            .def(
+                "wait_for_motion_done",
+                [](const EliteRobotController &self, const std::vector<double> &target, double pos_tol, double rot_tol, double timeout)
+                {
+                    if (target.size() < 6)
+                        throw std::invalid_argument("target must be [x,y,z,rx,ry,rz]");
+                    // mm/deg -> m/rad, matching move_to
+                    vector6d_t t;
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        t[i] = target[i] / 1000.0;
+                        t[i + 3] = target[i + 3] / 57.29578;
+                    }
+                    py::gil_scoped_release release;
+                    return self.waitForMotionDone(t, pos_tol / 1000.0, rot_tol < 0 ? -1.0 : rot_tol / 57.29578, timeout);
+                },
+                "Wait until the move just sent starts, reaches target [x,y,z,rx,ry,rz] (mm, deg) and stops",
+                py::arg("target"), py::arg("pos_tol") = 2.0, py::arg("rot_tol") = 3.0, py::arg("timeout") = 10.0)
+            .def("set_speed", &EliteRobotController::setSpeed, "Set global speed percent (0-100)", py::call_guard<py::gil_scoped_release>())
+            .def("jog", &EliteRobotController::jog, "Jog axis 0-5 (X/Y/Z in mm, RX/RY/RZ in deg) in the base frame", py::arg("axis"), py::arg("direction"), py::arg("distance_mm"),
+                 py::call_guard<py::gil_scoped_release>())
+            .def("move_to", &EliteRobotController::moveTo, "Move to target pose (mm, deg)", py::call_guard<py::gil_scoped_release>())
+            .def("stop", &EliteRobotController::stop, "Emergency stop", py::call_guard<py::gil_scoped_release>())
+            .def("send_script", &EliteRobotController::sendScript, "Send a raw script over the primary port", py::arg("script"),
+                 py::call_guard<py::gil_scoped_release>())
+            .def("start_servo", &EliteRobotController::startServo,
+                 "Start streaming servo mode (SERVO_SPEED or SERVO_POSE); SERVO_SPEED stops after deadman s without a new setpoint",
+                 py::arg("mode") = static_cast<int>(SERVO_SPEED),
+                 py::arg("deadman") = SERVO_DEADMAN_CYCLES / EliteRobotController::RTSI_FREQUENCY,
+                 py::call_guard<py::gil_scoped_release>())
+            .def("stop_servo", &EliteRobotController::stopServo, "Stop streaming servo mode", py::call_guard<py::gil_scoped_release>())
+            .def("is_servoing", &EliteRobotController::isServoing, "Check whether servo mode is running")
+            .def(
+                "servo_speed",
+                [](EliteRobotController &self, const std::vector<double> &speed)
+                {
+                    if (speed.size() < 6)
+                        throw std::invalid_argument("speed must be [vx,vy,vz,wx,wy,wz]");
+                    // mm/s, deg/s -> m/s, rad/s
+                    vector6d_t v;
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        v[i] = speed[i] / 1000.0;
+                        v[i + 3] = speed[i + 3] / 57.29578;
+                    }
+                    return self.setServoSetpoint(v);
+                },
+                "Set the TCP speed setpoint [vx,vy,vz,wx,wy,wz] (mm/s, deg/s) in SERVO_SPEED mode", py::arg("speed"))
+            .def(
+                "servo_pose",
+                [](EliteRobotController &self, const std::vector<double> &pose)
+                {
+                    if (pose.size() < 6)
+                        throw std::invalid_argument("pose must be [x,y,z,rx,ry,rz]");
+                    // mm, deg -> m, rad
+                    vector6d_t p;
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        p[i] = pose[i] / 1000.0;
+                        p[i + 3] = pose[i + 3] / 57.29578;
+                    }
+                    return self.setServoSetpoint(p);
+                },
+                "Set the TCP pose setpoint [x,y,z,rx,ry,rz] (mm, deg) in SERVO_POSE mode", py::arg("pose"))
+            .def("start_recording", &EliteRobotController::startRecording,
+                 "Record every RTSI sample into a ring file, returns the TelemetryRecorder or None",
+                 py::arg("path"), py::arg("capacity") = static_cast<size_t>(RTSI_RECORD_CAPACITY),
+                 py::call_guard<py::gil_scoped_release>())
+            .def("stop_recording", &EliteRobotController::stopRecording, "Stop recording and flush the ring file",
+                 py::call_guard<py::gil_scoped_release>())
+            .def("is_recording", &EliteRobotController::isRecording, "Check whether telemetry is being recorded");
+
+        m.attr("CONNECT_IDLE") = static_cast<int>(CONNECT_IDLE);
+        m.attr("CONNECT_PENDING") = static_cast<int>(CONNECT_PENDING);
+        m.attr("CONNECT_READY") = static_cast<int>(CONNECT_READY);
+        m.attr("CONNECT_FAILED") = static_cast<int>(CONNECT_FAILED);
+        m.attr("SERVO_SPEED") = static_cast<int>(SERVO_SPEED);
+        m.attr("SERVO_POSE") = static_cast<int>(SERVO_POSE);
+        // Offline reading: np.memmap(path, dtype=TELEMETRY_DTYPE, mode="r", offset=TELEMETRY_HEADER_SIZE)
+        m.attr("TELEMETRY_DTYPE") = py::dtype::of<TelemetryRecord>();
+        m.attr("TELEMETRY_HEADER_SIZE") = sizeof(TelemetryFileHeader);
+        // np.memmap(path, dtype=CALIB_LOG_DTYPE, mode="r", offset=CALIB_LOG_HEADER_SIZE, shape=(count,))
+        m.attr("CALIB_LOG_DTYPE") = py::dtype::of<CalibrationRecord>();
+        m.attr("CALIB_LOG_HEADER_SIZE") = sizeof(CalibrationLogHeader);
+        m.attr("CALIB_RUN_GRID") = static_cast<int>(CALIB_RUN_GRID);
+        m.attr("CALIB_RUN_PYRAMID") = static_cast<int>(CALIB_RUN_PYRAMID);
+        m.attr("CALIB_POINT_CAPTURED") = static_cast<int>(CALIB_POINT_CAPTURED);
+        m.attr("CALIB_POINT_CAPTURE_FAILED") = static_cast<int>(CALIB_POINT_CAPTURE_FAILED);
+        m.attr("CALIB_POINT_NOT_ARRIVED") = static_cast<int>(CALIB_POINT_NOT_ARRIVED);
+        m.attr("CALIB_POINT_IMAGE_TRUNCATED") = static_cast<int>(CALIB_POINT_IMAGE_TRUNCATED);
+    }
+
+    // Rows of a NumPy argument for the batch pose functions: a single row (1-D input) broadcasts
+    // against any batch size through stride 0
+    struct PoseRows
+    {
+        pybind11::array_t<double, pybind11::array::c_style | pybind11::array::forcecast> array;
+        const double *data = nullptr;
+        size_t count = 0;
+        size_t stride = 0;
+        bool batched = false;
+    };
+
+    inline PoseRows poseRows(pybind11::array_t<double, pybind11::array::c_style | pybind11::array::forcecast> a,
+                             std::initializer_list<pybind11::ssize_t> row_shape, const char *name)
+    {
+        PoseRows rows;
+        const pybind11::ssize_t row_dims = static_cast<pybind11::ssize_t>(row_shape.size());
+        rows.batched = a.ndim() == row_dims + 1;
+        if (!rows.batched && a.ndim() != row_dims)
+            throw std::invalid_argument(std::string(name) + " has the wrong number of dimensions");
+        size_t row_size = 1;
+        pybind11::ssize_t d = rows.batched ? 1 : 0;
+        for (pybind11::ssize_t n : row_shape)
+        {
+            if (a.shape(d++) != n)
+                throw std::invalid_argument(std::string(name) + " has the wrong shape");
+            row_size *= static_cast<size_t>(n);
+        }
+        rows.count = rows.batched ? static_cast<size_t>(a.shape(0)) : 1;
+        rows.stride = rows.batched ? row_size : 0;
+        rows.data = a.data();
+        rows.array = std::move(a);
+        return rows;
+    }
+
+    // Common batch size of the arguments; unbatched arguments broadcast
+    inline size_t batchCount(std::initializer_list<const PoseRows *> args)
+    {
+        size_t count = 1;
+        bool batched = false;
+        for (const PoseRows *r : args)
+        {
+            if (!r->batched)
+                continue;
+            if (batched && r->count != count)
+                throw std::invalid_argument("batch sizes do not match");
+            count = r->count;
+            batched = true;
+        }
+        return count;
+    }
+
+    inline pybind11::array_t<double> batchResult(bool batched, size_t count, std::initializer_list<pybind11::ssize_t> row_shape)
+    {
+        std::vector<pybind11::ssize_t> shape;
+        if (batched)
+            shape.push_back(static_cast<pybind11::ssize_t>(count));
+        shape.insert(shape.end(), row_shape.begin(), row_shape.end());
+        return pybind11::array_t<double>(shape);
+    }
+
+    // Batch pose math on (N,6) arrays of [x, y, z, rx, ry, rz]; 1-D inputs give 1-D results.
+    // Rotations are in radians unless degrees=True, positions in any consistent unit.
+    inline void bindPoseMath(pybind11::module_ &m)
+    {
+        namespace py = pybind11;
+        using Array = py::array_t<double, py::array::c_style | py::array::forcecast>;
+        const double DEG = 3.141592653589793 / 180.0;
+
+        m.def(
+            "rotvec_to_matrix",
+            [DEG](Array rotvecs, bool degrees)
+            {
+                // (N,6) poses are accepted too, their rotation columns are used
+                bool pose = rotvecs.ndim() >= 1 && rotvecs.shape(rotvecs.ndim() - 1) == 6;
+                PoseRows r = poseRows(rotvecs, {pose ? 6 : 3}, "rotvecs");
+                auto out = batchResult(r.batched, r.count, {3, 3});
+                double *dst = out.mutable_data();
+                py::gil_scoped_release release;
+                rotVecsToMatrices(r.data, r.stride, pose ? 3 : 0, r.count, degrees ? DEG : 1.0, dst);
+                return out;
+            },
+            "Rotation vectors (N,3) or poses (N,6) to rotation matrices (N,3,3)",
+            py::arg("rotvecs"), py::arg("degrees") = false);
+
+        m.def(
+            "matrix_to_rotvec",
+            [DEG](Array matrices, bool degrees)
+            {
+                PoseRows r = poseRows(matrices, {3, 3}, "matrices");
+                auto out = batchResult(r.batched, r.count, {3});
+                double *dst = out.mutable_data();
+                py::gil_scoped_release release;
+                matricesToRotVecs(r.data, r.count, degrees ? DEG : 1.0, dst, 3, 0);
+                return out;
+            },
+            "Rotation matrices (N,3,3) to rotation vectors (N,3)",
+            py::arg("matrices"), py::arg("degrees") = false);
+
+        m.def(
+            "pose_to_matrix",
+            [DEG](Array poses, bool degrees)
+            {
+                PoseRows r = poseRows(poses, {6}, "poses");
+                auto out = batchResult(r.batched, r.count, {4, 4});
+                double *dst = out.mutable_data();
+                py::gil_scoped_release release;
+                posesToTransforms(r.data, 6, r.count, degrees ? DEG : 1.0, dst);
+                return out;
+            },
+            "Poses (N,6) to homogeneous transforms (N,4,4)",
+            py::arg("poses"), py::arg("degrees") = false);
+
+        m.def(
+            "matrix_to_pose",
+            [DEG](Array transforms, bool degrees)
+            {
+                PoseRows r = poseRows(transforms, {4, 4}, "transforms");
+                auto out = batchResult(r.batched, r.count, {6});
+                double *dst = out.mutable_data();
+                py::gil_scoped_release release;
+                transformsToPoses(r.data, r.count, degrees ? DEG : 1.0, dst);
+                return out;
+            },
+            "Homogeneous transforms (N,4,4) to poses (N,6)",
+            py::arg("transforms"), py::arg("degrees") = false);
+
+        auto compose = [DEG](int kind)
+        {
+            return [DEG, kind](Array a, Array b, bool degrees)
+            {
+                PoseRows ra = poseRows(a, {6}, "a");
+                PoseRows rb = poseRows(b, {6}, "b");
+                size_t count = batchCount({&ra, &rb});
+                auto out = batchResult(ra.batched || rb.batched, count, {6});
+                double *dst = out.mutable_data();
+                py::gil_scoped_release release;
+                composePoses(ra.data, ra.stride, rb.data, rb.stride, count, kind, degrees ? DEG : 1.0, dst);
+                return out;
+            };
+        };
+        m.def("pose_trans", compose(POSE_TRANS),
+              "a * b: b expressed in frame a (script pose_trans), broadcasting single poses",
+              py::arg("a"), py::arg("b"), py::arg("degrees") = false);
+        m.def("pose_add", compose(POSE_ADD),
+              "Positions added, rotations composed a.R * b.R (script pose_add), broadcasting single poses",
+              py::arg("a"), py::arg("b"), py::arg("degrees") = false);
+
+        m.def(
+            "pose_inv",
+            [DEG](Array poses, bool degrees)
+            {
+                PoseRows r = poseRows(poses, {6}, "poses");
+                auto out = batchResult(r.batched, r.count, {6});
+                double *dst = out.mutable_data();
+                py::gil_scoped_release release;
+                invertPoses(r.data, 6, r.count, degrees ? DEG : 1.0, dst);
+                return out;
+            },
+            "Inverse poses (N,6)",
+            py::arg("poses"), py::arg("degrees") = false);
+
+        m.def(
+            "interpolate_pose",
+            [DEG](Array a, Array b, Array t, bool degrees)
+            {
+                PoseRows ra = poseRows(a, {6}, "a");
+                PoseRows rb = poseRows(b, {6}, "b");
+                PoseRows rt = poseRows(t, {}, "t");
+                size_t count = batchCount({&ra, &rb, &rt});
+                auto out = batchResult(ra.batched || rb.batched || rt.batched, count, {6});
+                double *dst = out.mutable_data();
+                py::gil_scoped_release release;
+                interpolatePoses(ra.data, ra.stride, rb.data, rb.stride, rt.data, rt.stride, count, degrees ? DEG : 1.0, dst);
+                return out;
+            },
+            "Interpolate from a (t=0) to b (t=1): linear in position, geodesic in rotation. t may be an array of fractions.",
+            py::arg("a"), py::arg("b"), py::arg("t"), py::arg("degrees") = false);
+    }
+
+} // namespace ELITE_EXTENSION
+
+#endif // ELITE_CONTROLLER_BINDINGS_HPP
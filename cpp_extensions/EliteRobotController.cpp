@@ -1,6 +1,9 @@
 #include "EliteRobotController.hpp"
+#include "PoseMath.hpp"
+#include "PerfStats.hpp"
 
 #include <cmath>
+#include <future>
 #include <thread>
 #include <sstream>
 #include <algorithm>
@@ -9,7 +12,7 @@
 namespace ELITE_EXTENSION
 {
 
-    EliteRobotController::EliteRobotController() : is_connected(false), global_speed(0.5) {}
+    EliteRobotController::EliteRobotController() {}
 
     EliteRobotController::~EliteRobotController()
     {
@@ -17,49 +20,152 @@ namespace ELITE_EXTENSION
     }
 
     bool EliteRobotController::connect(const std::string &ip, const std::string &recipe_dir)
+    {
+        if (!connectAsync(ip, recipe_dir))
+            return false;
+        return waitConnected(CONNECT_TIMEOUT + 1.0) == CONNECT_READY;
+    }
+
+    bool EliteRobotController::connectAsync(const std::string &ip, const std::string &recipe_dir, double timeout_s)
+    {
+        // Claim the bring-up atomically so two concurrent callers can't both start one
+        int status = connect_status.load(std::memory_order_acquire);
+        do
+        {
+            if (status == CONNECT_PENDING)
+                return false;
+        } while (!connect_status.compare_exchange_strong(status, CONNECT_PENDING, std::memory_order_acq_rel));
+
+        if (connect_thread.joinable())
+            connect_thread.join();
+        closeInterfaces();
+
+        // Held until connect_thread is assigned: the bring-up can't publish its result (and let
+        // the next caller join connect_thread) before then
+        std::lock_guard<std::mutex> lock(connect_mutex);
+        connect_thread = std::thread([this, ip, recipe_dir, timeout_s]
+                                     {
+                                         bool ok = bringUp(ip, recipe_dir, timeout_s);
+                                         {
+                                             std::lock_guard<std::mutex> lock(connect_mutex);
+                                             connect_status.store(ok ? CONNECT_READY : CONNECT_FAILED, std::memory_order_release);
+                                         }
+                                         connect_cv.notify_all(); });
+        return true;
+    }
+
+    int EliteRobotController::getConnectStatus() const
+    {
+        return connect_status.load(std::memory_order_acquire);
+    }
+
+    int EliteRobotController::waitConnected(double timeout_s)
+    {
+        std::unique_lock<std::mutex> lock(connect_mutex);
+        connect_cv.wait_for(lock, std::chrono::duration<double>(timeout_s), [this]
+                            { return connect_status.load(std::memory_order_acquire) != CONNECT_PENDING; });
+        return connect_status.load(std::memory_order_acquire);
+    }
+
+    int EliteRobotController::currentRobotMode()
+    {
+        RobotStateSnapshot snap = state_cache.load();
+        if (snap.valid())
+            return snap.robot_mode;
+        return static_cast<int>(dashboard->robotMode());
+    }
+
+    bool EliteRobotController::waitForRobotMode(ELITE::RobotMode min_mode, std::chrono::steady_clock::time_point deadline)
+    {
+        while (currentRobotMode() < static_cast<int>(min_mode))
+        {
+            if (std::chrono::steady_clock::now() >= deadline)
+                return false;
+            std::this_thread::sleep_for(std::chrono::milliseconds(MODE_POLL_MS));
+        }
+        return true;
+    }
+
+    bool EliteRobotController::bringUp(const std::string &ip, const std::string &recipe_dir, double timeout_s)
     {
         robot_ip = ip;
         // Construct paths for recipe files
-        // If running from source, these might need to be absolute, but here we assume relative or handled by caller
         std::string out_recipe = recipe_dir + "/output_recipe.txt";
         std::string in_recipe = recipe_dir + "/input_recipe.txt";
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(timeout_s));
 
         try
         {
             dashboard = std::make_unique<ELITE::DashboardClient>();
             primary = std::make_unique<ELITE::PrimaryPortInterface>();
-            // Update rtsi to use the correct recipe paths (frequency 250Hz)
-            rtsi = std::make_unique<ELITE::RtsiIOInterface>(out_recipe, in_recipe, 250);
+            // Update rtsi to use the correct recipe paths if needed, here assuming files exist
+            rtsi = std::make_unique<ELITE::RtsiIOInterface>(out_recipe, in_recipe, RTSI_FREQUENCY);
 
-            bool db_ok = dashboard->connect(ip);
-            bool pri_ok = primary->connect(ip);
-            bool rtsi_ok = rtsi->connect(ip);
+            // The three interfaces are independent sockets, open them concurrently
+            auto db_ok = std::async(std::launch::async, [&]
+                                    { return dashboard->connect(ip); });
+            auto pri_ok = std::async(std::launch::async, [&]
+                                     { return primary->connect(ip); });
+            auto rtsi_ok = std::async(std::launch::async, [&]
+                                      {
+                                          std::lock_guard<std::mutex> lock(rtsi_mutex);
+                                          return rtsi->connect(ip); });
+            bool db = db_ok.get();
+            bool pri = pri_ok.get();
+            rtsi_ok.get(); // RTSI might be optional or retryable
 
-            // We consider connection successful if at least Dashboard and Primary interfaces are connected.
-            // RTSI is strictly speaking optional for basic control but needed for getPosition.
-            if (db_ok && pri_ok)
+            if (db && pri)
             {
                 is_connected = true;
-                // Init Robot: Power On and Release Brake
-                dashboard->powerOn();
-                std::this_thread::sleep_for(std::chrono::seconds(2));
-                dashboard->brakeRelease();
+                // The receive thread also waits out an RTSI link that isn't up yet
+                startRtsiThread();
+                // Init Robot: release brakes once the arm reports powered (instead of a fixed 2 s)
+                if (currentRobotMode() < static_cast<int>(ELITE::RobotMode::IDLE))
+                {
+                    dashboard->powerOn();
+                    waitForRobotMode(ELITE::RobotMode::IDLE, deadline);
+                }
+                if (currentRobotMode() < static_cast<int>(ELITE::RobotMode::RUNNING))
+                    dashboard->brakeRelease();
                 return true;
             }
         }
         catch (...)
         {
-            return false;
+        }
+
+        // Don't leave half-open sockets or the receive thread behind a failed bring-up
+        try
+        {
+            closeInterfaces();
+        }
+        catch (...)
+        {
         }
         return false;
     }
 
     void EliteRobotController::disconnect()
     {
+        // A bring-up still in flight owns the interfaces until it finishes
+        if (connect_thread.joinable() && connect_thread.get_id() != std::this_thread::get_id())
+            connect_thread.join();
+        closeInterfaces();
+        connect_status.store(CONNECT_IDLE, std::memory_order_release);
+    }
+
+    void EliteRobotController::closeInterfaces()
+    {
+        stopServo();
+        stopRtsiThread();
+        stopRecording();
         if (primary)
             primary->disconnect();
         if (rtsi)
+        {
+            std::lock_guard<std::mutex> lock(rtsi_mutex);
             rtsi->disconnect();
+        }
         if (dashboard)
             dashboard->disconnect();
         is_connected = false;
@@ -70,16 +176,170 @@ namespace ELITE_EXTENSION
         return is_connected;
     }
 
-    std::vector<double> EliteRobotController::getPosition()
+    RobotStateSnapshot EliteRobotController::getStateSnapshot() const
     {
-        if (!rtsi || !rtsi->isConnected())
-            return {};
+        RobotStateSnapshot snap = state_cache.load();
+        if (snap.valid())
+            PERF_VALUE("rtsi.sample_age_ns", PERF_STATS::nowNs() - static_cast<uint64_t>(snap.received_ns));
+        return snap;
+    }
+
+    bool EliteRobotController::waitForSample(uint64_t last_sequence, double timeout_s, RobotStateSnapshot &out) const
+    {
+        state_waiters.fetch_add(1, std::memory_order_acq_rel);
+        std::unique_lock<std::mutex> lock(state_mutex);
+        bool fresh = state_cv.wait_for(lock, std::chrono::duration<double>(timeout_s), [&]
+                                       {
+                                           out = state_cache.load();
+                                           return out.sequence != last_sequence; });
+        lock.unlock();
+        state_waiters.fetch_sub(1, std::memory_order_acq_rel);
+        return fresh;
+    }
+
+    bool EliteRobotController::waitForMotionDone(const ELITE::vector6d_t &target, double pos_tol, double rot_tol, double timeout_s) const
+    {
+        using clock = std::chrono::steady_clock;
+        const auto deadline = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(timeout_s));
+        const int32_t running = static_cast<int32_t>(ELITE::RobotMode::RUNNING);
+        const int32_t playing = static_cast<int32_t>(ELITE::TaskStatus::PLAYING);
+
+        RobotStateSnapshot snap = state_cache.load();
+        // The move only counts once it has been seen to start: the program PLAYING in a sample
+        // since the call, or the TCP leaving the tolerance around the pose it had at the call.
+        // A target next to the start pose would otherwise pass before the movel even runs.
+        bool have_start = false, started = false;
+        std::array<double, 6> start_pose{};
+        while (true)
+        {
+            if (snap.valid())
+            {
+                if (snap.robot_mode != running)
+                    return false;
+
+                const auto &p = snap.tcp_pose;
+                if (!have_start)
+                {
+                    start_pose = p;
+                    have_start = true;
+                }
+                if (!started)
+                {
+                    const auto &s = start_pose;
+                    double sx = p[0] - s[0], sy = p[1] - s[1], sz = p[2] - s[2];
+                    started = snap.runtime_state == playing ||
+                              std::sqrt(sx * sx + sy * sy + sz * sz) >= pos_tol ||
+                              (rot_tol >= 0 && rotationDistance(p[3], p[4], p[5], s[3], s[4], s[5]) >= rot_tol);
+                }
 
-        // RTSI returns position in Meters and Rad (Rotation Vector)
-        auto pose = rtsi->getActualTCPPose();
-        if (pose.size() < 6)
+                double dx = p[0] - target[0], dy = p[1] - target[1], dz = p[2] - target[2];
+                bool in_pos = std::sqrt(dx * dx + dy * dy + dz * dz) < pos_tol;
+                bool in_rot = rot_tol < 0 || rotationDistance(p[3], p[4], p[5], target[3], target[4], target[5]) < rot_tol;
+
+                if (started && in_pos && in_rot)
+                {
+                    const auto &v = snap.tcp_speed;
+                    double lin = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+                    double ang = std::sqrt(v[3] * v[3] + v[4] * v[4] + v[5] * v[5]);
+                    bool stopped = lin < STOPPED_LINEAR_SPEED && ang < STOPPED_ANGULAR_SPEED;
+                    if (stopped || snap.runtime_state != playing)
+                        return true;
+                }
+            }
+
+            double remaining = std::chrono::duration<double>(deadline - clock::now()).count();
+            if (remaining <= 0)
+                return false;
+            waitForSample(snap.sequence, remaining, snap);
+        }
+    }
+
+    bool EliteRobotController::waitForSettle(const SettleConfig &cfg, double max_wait_s, double &settle_time_s) const
+    {
+        using clock = std::chrono::steady_clock;
+        const auto start = clock::now();
+        const auto deadline = start + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(max_wait_s));
+
+        RobotStateSnapshot snap = state_cache.load();
+        RobotStateSnapshot anchor;
+        int run = 0;
+        while (true)
+        {
+            if (snap.valid())
+            {
+                const auto &v = snap.tcp_speed;
+                double lin = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+                double ang = std::sqrt(v[3] * v[3] + v[4] * v[4] + v[5] * v[5]);
+                bool still = lin < cfg.linear_speed && ang < cfg.angular_speed;
+
+                if (still && run > 0)
+                {
+                    const auto &p = snap.tcp_pose, &a = anchor.tcp_pose;
+                    double dx = p[0] - a[0], dy = p[1] - a[1], dz = p[2] - a[2];
+                    still = std::sqrt(dx * dx + dy * dy + dz * dz) < cfg.jitter &&
+                            rotationDistance(p[3], p[4], p[5], a[3], a[4], a[5]) < cfg.rot_jitter;
+                }
+
+                if (!still)
+                    run = 0;
+                else if (run++ == 0)
+                    anchor = snap;
+
+                if (run >= cfg.samples)
+                {
+                    settle_time_s = std::chrono::duration<double>(clock::now() - start).count();
+                    return true;
+                }
+            }
+
+            double remaining = std::chrono::duration<double>(deadline - clock::now()).count();
+            if (remaining <= 0 || !waitForSample(snap.sequence, remaining, snap))
+            {
+                settle_time_s = max_wait_s;
+                return false;
+            }
+        }
+    }
+
+    bool EliteRobotController::waitForOutputBit(int index, bool value, double timeout_s) const
+    {
+        using clock = std::chrono::steady_clock;
+        const auto deadline = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(timeout_s));
+        RobotStateSnapshot snap = state_cache.load();
+        while (true)
+        {
+            if (snap.valid() && (((snap.output_bit_registers >> index) & 1u) != 0) == value)
+                return true;
+            double remaining = std::chrono::duration<double>(deadline - clock::now()).count();
+            if (remaining <= 0)
+                return false;
+            waitForSample(snap.sequence, remaining, snap);
+        }
+    }
+
+    bool EliteRobotController::setInputBitRegister(int index, bool value)
+    {
+        if (index < 0 || index > 31 || !rtsi)
+            return false;
+        std::lock_guard<std::mutex> lock(input_bits_mutex);
+        std::lock_guard<std::mutex> rtsi_lock(rtsi_mutex);
+        if (!rtsi->isConnected())
+            return false;
+        uint32_t bits = value ? (input_bits | (1u << index)) : (input_bits & ~(1u << index));
+        if (!rtsi->setInputRecipeValue("input_bit_registers0_to_31", bits))
+            return false;
+        input_bits = bits;
+        return true;
+    }
+
+    std::vector<double> EliteRobotController::getPosition()
+    {
+        RobotStateSnapshot snap = state_cache.load();
+        if (!snap.valid())
             return {};
+        PERF_VALUE("rtsi.sample_age_ns", PERF_STATS::nowNs() - static_cast<uint64_t>(snap.received_ns));
 
+        const auto &pose = snap.tcp_pose; // m, rad
         std::vector<double> ret(6);
         ret[0] = pose[0] * 1000.0; // m -> mm
         ret[1] = pose[1] * 1000.0;
@@ -94,13 +354,29 @@ namespace ELITE_EXTENSION
     {
         if (!dashboard)
             return "Unknown";
+        // This is a simplification; authentic state would query robot status
         return is_connected ? "Connected" : "Disconnected";
     }
 
+    RtsiHealth EliteRobotController::getRtsiHealth() const
+    {
+        RtsiHealth h;
+        RobotStateSnapshot snap = state_cache.load();
+        h.connected = rtsi_link_up.load(std::memory_order_acquire);
+        h.samples = snap.sequence;
+        h.disconnects = rtsi_disconnects.load(std::memory_order_relaxed);
+        h.stale_resets = rtsi_stale_resets.load(std::memory_order_relaxed);
+        h.reconnect_attempts = rtsi_reconnect_attempts.load(std::memory_order_relaxed);
+        h.reconnects = rtsi_reconnects.load(std::memory_order_relaxed);
+        h.backoff_s = rtsi_backoff.load(std::memory_order_relaxed);
+        h.last_sample_age = snap.age();
+        return h;
+    }
+
     void EliteRobotController::setSpeed(double percent)
     {
         global_speed = std::max(0.01, std::min(1.0, percent / 100.0));
-        // Send speed scaling command to Dashboard
+        // Also send speed command to dashboard if supported
         if (dashboard)
         {
             dashboard->setSpeedScaling((int)percent);
@@ -112,28 +388,25 @@ namespace ELITE_EXTENSION
         if (!is_connected || !primary)
             return false;
 
-        // We assume jogging is relative to Base Frame (pose_add on actual TCP pose)
-        // axis: 0=X, 1=Y, 2=Z, 3=Rx, 4=Ry, 5=Rz
-
-        double dist_m = distance_mm / 1000.0;
+        // We assume jogging is relative to Base Frame (pose_add on actual TCP pose). The script
+        // reads the pose on the controller, so no RTSI sample is needed here.
+        // axis: 0=X, 1=Y, 2=Z (distance in mm), 3=Rx, 4=Ry, 5=Rz (distance in deg)
         double speed_val = global_speed;
 
         double offsets[6] = {0, 0, 0, 0, 0, 0};
-        if (axis >= 0 && axis < 6)
-        {
-            offsets[axis] = direction * dist_m;
-        }
+        if (axis >= 0 && axis < 3)
+            offsets[axis] = direction * distance_mm / 1000.0;
+        else if (axis >= 3 && axis < 6)
+            offsets[axis] = direction * distance_mm / 57.29578;
 
         std::stringstream ss;
-        // Note: p[...] creates a pose/point in Elite script, but [...] list syntax avoids potential scope issues with 'p' in some contexts
-        // For pose_add, the second argument should be a pose. p[x,y,z,rx,ry,rz] is standard.
-        // However, recent fix showed using list [...] works better in some environments to avoid "builtin_function_or_method" errors if 'p' is misinterpreted.
+        // Use list [...] instead of p[...] to avoid builtin_function subscript error
         ss << "movel(pose_add(get_actual_tcp_pose(), [";
         for (int i = 0; i < 6; ++i)
             ss << offsets[i] << (i < 5 ? "," : "");
         ss << "]), a=0.5, v=" << speed_val << ")";
 
-        return primary->sendScript(ss.str());
+        return sendPrimaryScript(ss.str());
     }
 
     bool EliteRobotController::moveTo(double x, double y, double z, double rx, double ry, double rz)
@@ -141,21 +414,406 @@ namespace ELITE_EXTENSION
         if (!is_connected || !primary)
             return false;
 
-        // x,y,z in m; rx,ry,rz in rad
         std::stringstream ss;
+        // Use list [...] instead of p[...] to avoid builtin_function subscript error
         ss << "movel(["
            << x / 1000.0 << "," << y / 1000.0 << "," << z / 1000.0 << ","
            << rx / 57.29578 << "," << ry / 57.29578 << "," << rz / 57.29578
            << "], a=0.5, v=" << global_speed << ")";
 
-        return primary->sendScript(ss.str());
+        return sendPrimaryScript(ss.str());
     }
 
     bool EliteRobotController::stop()
     {
         if (!primary)
             return false;
-        return primary->sendScript("stopj(2.0)");
+        return sendPrimaryScript("stopj(2.0)");
+    }
+
+    bool EliteRobotController::sendScript(const std::string &script)
+    {
+        if (!is_connected || !primary)
+            return false;
+        return sendPrimaryScript(script);
+    }
+
+    bool EliteRobotController::sendPrimaryScript(const std::string &script)
+    {
+        PERF_SCOPE("script.send");
+        return primary->sendScript(script);
+    }
+
+    bool EliteRobotController::startServo(int mode, double deadman_s)
+    {
+        if (!is_connected || !primary || !rtsi)
+            return false;
+        {
+            std::lock_guard<std::mutex> lock(rtsi_mutex);
+            if (!rtsi->isConnected())
+                return false;
+        }
+        if (mode != SERVO_SPEED && mode != SERVO_POSE)
+            return false;
+        stopServo();
+
+        RobotStateSnapshot snap = state_cache.load();
+        if (mode == SERVO_POSE && !snap.valid())
+            return false;
+        {
+            std::lock_guard<std::mutex> lock(servo_mutex);
+            if (mode == SERVO_POSE)
+                servo_setpoint = snap.tcp_pose;
+            else
+                servo_setpoint.fill(0.0);
+            servo_setpoint_at = std::chrono::steady_clock::now();
+        }
+        servo_deadman = deadman_s;
+
+        // Registers must hold a live mode and setpoint before the script's first read
+        servo_mode.store(mode, std::memory_order_release);
+        writeServoRegisters(mode, 0, servo_setpoint);
+        if (!sendPrimaryScript(servoScript()))
+        {
+            servo_mode.store(SERVO_OFF, std::memory_order_release);
+            writeServoRegisters(SERVO_OFF, 0, servo_setpoint);
+            return false;
+        }
+        servo_thread = std::thread(&EliteRobotController::servoLoop, this);
+        return true;
+    }
+
+    void EliteRobotController::stopServo()
+    {
+        servo_mode.store(SERVO_OFF, std::memory_order_release);
+        if (servo_thread.joinable())
+            servo_thread.join();
+    }
+
+    bool EliteRobotController::isServoing() const
+    {
+        return servo_mode.load(std::memory_order_acquire) != SERVO_OFF;
+    }
+
+    bool EliteRobotController::setServoSetpoint(const ELITE::vector6d_t &setpoint)
+    {
+        if (!isServoing())
+            return false;
+        std::lock_guard<std::mutex> lock(servo_mutex);
+        servo_setpoint = setpoint;
+        servo_setpoint_at = std::chrono::steady_clock::now();
+        return true;
+    }
+
+    bool EliteRobotController::writeServoRegisters(int mode, int32_t heartbeat, const ELITE::vector6d_t &setpoint)
+    {
+        std::lock_guard<std::mutex> lock(rtsi_mutex);
+        if (!rtsi->isConnected())
+            return false;
+        for (int i = 0; i < 6; ++i)
+            rtsi->setInputRecipeValue("input_double_register_" + std::to_string(SERVO_SETPOINT_REGISTER + i), setpoint[i]);
+        rtsi->setInputRecipeValue("input_int_register_" + std::to_string(SERVO_HEARTBEAT_REGISTER), heartbeat);
+        rtsi->setInputRecipeValue("input_int_register_" + std::to_string(SERVO_MODE_REGISTER), static_cast<int32_t>(mode));
+        return true;
+    }
+
+    void EliteRobotController::servoLoop()
+    {
+        using clock = std::chrono::steady_clock;
+        const auto period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / RTSI_FREQUENCY));
+        const auto deadman = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(servo_deadman));
+        int32_t heartbeat = 0;
+        bool deadman_tripped = false;
+        auto next = clock::now();
+
+        while (true)
+        {
+            int mode = servo_mode.load(std::memory_order_acquire);
+            ELITE::vector6d_t setpoint;
+            clock::time_point setpoint_at;
+            {
+                std::lock_guard<std::mutex> lock(servo_mutex);
+                setpoint = servo_setpoint;
+                setpoint_at = servo_setpoint_at;
+            }
+            // Deadman: a speed setpoint nobody refreshes (caller hung or gone) must not keep the arm moving
+            bool stale = mode == SERVO_SPEED && servo_deadman > 0.0 && clock::now() - setpoint_at > deadman;
+            if (stale)
+            {
+                if (!deadman_tripped)
+                    PERF_COUNT("servo.deadman", 1);
+                setpoint.fill(0.0);
+            }
+            deadman_tripped = stale;
+            // Skipped while the receive thread reconnects, it holds rtsi_mutex for the whole attempt
+            if (rtsi_link_up.load(std::memory_order_acquire))
+                writeServoRegisters(mode, ++heartbeat, setpoint);
+            if (mode == SERVO_OFF)
+                break; // The stop request itself has been sent
+
+            next += period;
+            auto now = clock::now();
+            if (next < now)
+                next = now;
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+    std::string EliteRobotController::servoScript() const
+    {
+        auto reg = [](const char *fn, int index)
+        { return std::string(fn) + "(" + std::to_string(index) + ")"; };
+        std::string setpoint = "[";
+        for (int i = 0; i < 6; ++i)
+            setpoint += reg("read_input_float_register", SERVO_SETPOINT_REGISTER + i) + (i < 5 ? "," : "]");
+
+        std::stringstream ss;
+        ss << "def rtsi_servo():\n"
+           << "  last = " << reg("read_input_integer_register", SERVO_HEARTBEAT_REGISTER) << "\n"
+           << "  stale = 0\n"
+           << "  while True:\n"
+           << "    mode = " << reg("read_input_integer_register", SERVO_MODE_REGISTER) << "\n"
+           << "    beat = " << reg("read_input_integer_register", SERVO_HEARTBEAT_REGISTER) << "\n"
+           << "    if beat == last:\n"
+           << "      stale = stale + 1\n"
+           << "    else:\n"
+           << "      stale = 0\n"
+           << "      last = beat\n"
+           << "    end\n"
+           << "    if mode == " << SERVO_OFF << " or stale > " << SERVO_WATCHDOG_CYCLES << ":\n"
+           << "      break\n"
+           << "    end\n"
+           << "    sp = " << setpoint << "\n"
+           << "    if mode == " << SERVO_SPEED << ":\n"
+           << "      speedl(sp, " << SERVO_SPEED_ACCEL << ", " << 1.0 / RTSI_FREQUENCY << ")\n"
+           << "    else:\n"
+           << "      servoj(get_inverse_kin(sp), 0, 0, " << 1.0 / RTSI_FREQUENCY << ", " << SERVO_LOOKAHEAD << ", " << SERVO_GAIN << ")\n"
+           << "    end\n"
+           << "  end\n"
+           << "  stopl(" << SERVO_SPEED_ACCEL << ")\n"
+           << "end\n";
+        return ss.str();
+    }
+
+    void EliteRobotController::rtsiLoop()
+    {
+        using clock = std::chrono::steady_clock;
+        const auto period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / RTSI_FREQUENCY));
+        const auto stale_after = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(RTSI_STALE_TIMEOUT));
+        RobotStateSnapshot snap;
+        double last_timestamp = -1.0;
+        auto next = clock::now();
+        // Supervisor state: bringUp() already made the first connect attempt
+        bool link_up = false;
+        bool ever_up = false;
+        double backoff = RTSI_BACKOFF_INITIAL;
+        auto retry_at = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(backoff));
+        auto last_sample_at = clock::now();
+
+        while (rtsi_running.load(std::memory_order_acquire))
+        {
+            next += period;
+            auto now = clock::now();
+            bool connected = false;
+            {
+                std::lock_guard<std::mutex> lock(rtsi_mutex);
+                try
+                {
+                    connected = rtsi->isConnected();
+                    if (connected && link_up && now - last_sample_at > stale_after)
+                    {
+                        // Socket still open but the controller stopped streaming: drop it and reconnect
+                        rtsi_stale_resets.fetch_add(1, std::memory_order_relaxed);
+                        rtsi->disconnect();
+                        connected = false;
+                    }
+                }
+                catch (...)
+                {
+                    connected = false;
+                }
+            }
+
+            if (connected != link_up)
+            {
+                link_up = connected;
+                rtsi_link_up.store(connected, std::memory_order_release);
+                if (connected)
+                {
+                    if (ever_up)
+                        rtsi_reconnects.fetch_add(1, std::memory_order_relaxed);
+                    ever_up = true;
+                    backoff = RTSI_BACKOFF_INITIAL;
+                    rtsi_backoff.store(0.0, std::memory_order_relaxed);
+                    last_sample_at = now;
+                }
+                else
+                {
+                    rtsi_disconnects.fetch_add(1, std::memory_order_relaxed);
+                    retry_at = now + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(backoff));
+                    rtsi_backoff.store(backoff, std::memory_order_relaxed);
+                }
+            }
+
+            if (!connected)
+            {
+                if (now >= retry_at)
+                {
+                    rtsi_reconnect_attempts.fetch_add(1, std::memory_order_relaxed);
+                    bool ok = false;
+                    {
+                        std::lock_guard<std::mutex> lock(rtsi_mutex);
+                        try
+                        {
+                            ok = rtsi->connect(robot_ip);
+                        }
+                        catch (...)
+                        {
+                        }
+                    }
+                    if (!ok)
+                    {
+                        backoff = std::min(backoff * 2.0, RTSI_BACKOFF_MAX);
+                        rtsi_backoff.store(backoff, std::memory_order_relaxed);
+                        retry_at = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(backoff));
+                    }
+                }
+                // Off the sample clock until the link is back; short ticks keep stop responsive
+                next = std::min(retry_at, clock::now() + std::chrono::milliseconds(RTSI_IDLE_POLL_MS));
+                std::this_thread::sleep_until(next);
+                continue;
+            }
+
+            try
+            {
+                PERF_SCOPE("rtsi.read");
+                std::unique_lock<std::mutex> lock(rtsi_mutex);
+                double ts = rtsi->getTimestamp();
+                // Only publish new controller samples so sequence counts real RTSI packets
+                if (ts != last_timestamp)
+                {
+                    last_timestamp = ts;
+                    last_sample_at = now;
+                    auto tcp_pose = rtsi->getActualTCPPose();
+                    auto tcp_speed = rtsi->getActualTCPVelocity();
+                    auto joints = rtsi->getActualJointPositions();
+                    auto joint_speeds = rtsi->getActualJointVelocity();
+                    for (int i = 0; i < 6; ++i)
+                    {
+                        snap.tcp_pose[i] = tcp_pose[i];
+                        snap.tcp_speed[i] = tcp_speed[i];
+                        snap.joint_positions[i] = joints[i];
+                        snap.joint_speeds[i] = joint_speeds[i];
+                    }
+                    snap.robot_mode = static_cast<int32_t>(rtsi->getRobotMode());
+                    snap.runtime_state = static_cast<int32_t>(rtsi->getRuntimeState());
+                    uint32_t out_bits = 0;
+                    if (rtsi->getRecipeValue("output_bit_registers0_to_31", out_bits))
+                        snap.output_bit_registers = out_bits;
+                    lock.unlock();
+                    snap.timestamp = ts;
+                    snap.received_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                           clock::now().time_since_epoch())
+                                           .count();
+                    ++snap.sequence;
+                    PERF_COUNT("rtsi.samples", 1);
+                    publishState(snap);
+                }
+            }
+            catch (...)
+            {
+                // Keep the last good snapshot, retry on the next tick
+            }
+
+            now = clock::now();
+            if (next < now)
+                next = now; // Fell behind (e.g. reconnect), don't try to catch up
+            std::this_thread::sleep_until(next);
+        }
+    }
+
+    void EliteRobotController::publishState(const RobotStateSnapshot &snap)
+    {
+        state_cache.store(snap);
+        if (recording.load(std::memory_order_acquire))
+        {
+            std::lock_guard<std::mutex> lock(recorder_mutex);
+            if (recorder)
+                recorder->append(snap);
+        }
+        if (state_waiters.load(std::memory_order_acquire) > 0)
+        {
+            // Taking the lock orders the store before any waiter's predicate check
+            {
+                std::lock_guard<std::mutex> lock(state_mutex);
+            }
+            state_cv.notify_all();
+        }
+    }
+
+    void EliteRobotController::injectStateSample(RobotStateSnapshot snap)
+    {
+        if (rtsi_running.load(std::memory_order_acquire))
+            return;
+        snap.sequence = state_cache.load().sequence + 1;
+        snap.received_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now().time_since_epoch())
+                               .count();
+        publishState(snap);
+    }
+
+    std::shared_ptr<TelemetryRecorder> EliteRobotController::startRecording(const std::string &path, size_t capacity)
+    {
+        auto rec = std::make_shared<TelemetryRecorder>();
+        if (!rec->open(path, capacity, RTSI_FREQUENCY))
+            return nullptr;
+        std::shared_ptr<TelemetryRecorder> previous;
+        {
+            std::lock_guard<std::mutex> lock(recorder_mutex);
+            previous = std::move(recorder);
+            recorder = rec;
+            recording.store(true, std::memory_order_release);
+        }
+        if (previous)
+            previous->flush();
+        return rec;
+    }
+
+    void EliteRobotController::stopRecording()
+    {
+        std::shared_ptr<TelemetryRecorder> previous;
+        {
+            std::lock_guard<std::mutex> lock(recorder_mutex);
+            recording.store(false, std::memory_order_release);
+            previous = std::move(recorder);
+        }
+        if (previous)
+            previous->flush();
+    }
+
+    bool EliteRobotController::isRecording() const
+    {
+        return recording.load(std::memory_order_acquire);
+    }
+
+    void EliteRobotController::startRtsiThread()
+    {
+        stopRtsiThread();
+        rtsi_disconnects.store(0, std::memory_order_relaxed);
+        rtsi_stale_resets.store(0, std::memory_order_relaxed);
+        rtsi_reconnect_attempts.store(0, std::memory_order_relaxed);
+        rtsi_reconnects.store(0, std::memory_order_relaxed);
+        rtsi_backoff.store(RTSI_BACKOFF_INITIAL, std::memory_order_relaxed);
+        rtsi_running.store(true, std::memory_order_release);
+        rtsi_thread = std::thread(&EliteRobotController::rtsiLoop, this);
+    }
+
+    void EliteRobotController::stopRtsiThread()
+    {
+        rtsi_running.store(false, std::memory_order_release);
+        if (rtsi_thread.joinable())
+            rtsi_thread.join();
+        rtsi_link_up.store(false, std::memory_order_release);
     }
 
 } // namespace ELITE_EXTENSION
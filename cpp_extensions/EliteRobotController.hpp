@@ -5,6 +5,16 @@
 #include <Elite/PrimaryPortInterface.hpp>
 #include <Elite/RtsiIOInterface.hpp>
 #include <Elite/DataType.hpp>
+#include "TelemetryRecorder.hpp"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <type_traits>
 #include <vector>
 #include <string>
 #include <memory>
@@ -13,6 +23,137 @@
 namespace ELITE_EXTENSION
 {
 
+    // Motion-done detection: the TCP counts as stopped below these speeds
+    const double STOPPED_LINEAR_SPEED = 0.001; // m/s
+    const double STOPPED_ANGULAR_SPEED = 0.01; // rad/s
+
+    // Connection bring-up state, see EliteRobotController::connectAsync
+    enum ConnectStatus
+    {
+        CONNECT_IDLE = 0,
+        CONNECT_PENDING = 1,
+        CONNECT_READY = 2,
+        CONNECT_FAILED = 3
+    };
+    const double CONNECT_TIMEOUT = 15.0; // s, bring-up including power on
+    const int MODE_POLL_MS = 50;
+
+    // RTSI supervision: the receive thread reconnects a dropped link with exponential backoff,
+    // and treats a link that stays up without new samples as dropped
+    const double RTSI_BACKOFF_INITIAL = 0.5; // s
+    const double RTSI_BACKOFF_MAX = 10.0;    // s
+    const double RTSI_STALE_TIMEOUT = 1.0;   // s without a new sample
+    const int RTSI_IDLE_POLL_MS = 50;        // receive thread tick while waiting to retry
+
+    // Streaming servo: a resident script reads setpoints from RTSI input registers every cycle
+    // int 0 = mode (0 stop), int 1 = host heartbeat counter, double 0-5 = setpoint
+    enum ServoMode
+    {
+        SERVO_OFF = 0,
+        SERVO_SPEED = 1, // TCP speed [vx,vy,vz,wx,wy,wz] (m/s, rad/s) via speedl
+        SERVO_POSE = 2   // TCP pose [x,y,z,rx,ry,rz] (m, rad) via servoj
+    };
+    const int SERVO_MODE_REGISTER = 0;
+    const int SERVO_HEARTBEAT_REGISTER = 1;
+    const int SERVO_SETPOINT_REGISTER = 0;
+    const int SERVO_WATCHDOG_CYCLES = 50; // script stops after 200 ms without a new heartbeat
+    const int SERVO_DEADMAN_CYCLES = 5;   // default: SERVO_SPEED sends zero after 20 ms without a new setpoint
+    const double SERVO_SPEED_ACCEL = 1.0; // m/s^2 for speedl
+    const double SERVO_LOOKAHEAD = 0.1;   // s, servoj lookahead_time
+    const double SERVO_GAIN = 300.0;
+
+    // Default telemetry ring size: 10 minutes at 250 Hz (~35 MB)
+    const size_t RTSI_RECORD_CAPACITY = 150000;
+
+    // Settle detection: the robot counts as settled once this many consecutive RTSI samples stay
+    // below the speed limits and within `jitter` of the first sample of the run
+    struct SettleConfig
+    {
+        bool enabled = true;
+        double linear_speed = 0.0005; // m/s
+        double angular_speed = 0.005; // rad/s
+        double jitter = 0.00005;      // m
+        double rot_jitter = 0.0005;   // rad
+        int samples = 25;             // 100 ms at 250 Hz
+    };
+
+    // One RTSI sample as published by the receive thread. Units are the SDK's (m, rad, m/s, rad/s).
+    struct RobotStateSnapshot
+    {
+        uint64_t sequence = 0;   // Number of samples published so far, 0 = nothing received yet
+        double timestamp = 0.0;  // Controller timestamp of the sample (s)
+        int64_t received_ns = 0; // Host steady_clock time the sample was read (ns)
+        std::array<double, 6> tcp_pose{};
+        std::array<double, 6> tcp_speed{};
+        std::array<double, 6> joint_positions{};
+        std::array<double, 6> joint_speeds{};
+        int32_t robot_mode = -1;           // ELITE::RobotMode, -1 until the first sample
+        int32_t runtime_state = -1;        // ELITE::TaskStatus of the controller program
+        uint32_t output_bit_registers = 0; // output_bit_registers0_to_31, written by robot scripts
+
+        bool valid() const { return sequence != 0; }
+
+        // Age of the sample relative to now (s)
+        double age() const
+        {
+            if (!valid())
+                return -1.0;
+            int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::steady_clock::now().time_since_epoch())
+                              .count();
+            return (now - received_ns) * 1e-9;
+        }
+    };
+
+    // RTSI link health as seen by the receive thread
+    struct RtsiHealth
+    {
+        bool connected = false;
+        uint64_t samples = 0;            // Samples published since connect
+        uint64_t disconnects = 0;        // Link drops noticed (isConnected() went false)
+        uint64_t stale_resets = 0;       // Links reset because no sample arrived for RTSI_STALE_TIMEOUT
+        uint64_t reconnect_attempts = 0;
+        uint64_t reconnects = 0;         // Successful reconnects
+        double backoff_s = 0.0;          // Current retry delay, 0 while connected
+        double last_sample_age = -1.0;   // s, -1 before the first sample
+    };
+
+    // Single-writer seqlock. The writer never waits; readers retry while a write is in flight,
+    // so a read is a plain copy of T in the common case.
+    template <typename T>
+    class SeqLock
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type");
+
+    public:
+        void store(const T &value)
+        {
+            uint64_t seq = seq_.load(std::memory_order_relaxed);
+            seq_.store(seq + 1, std::memory_order_relaxed); // odd: write in progress
+            std::atomic_thread_fence(std::memory_order_release);
+            std::memcpy(&data_, &value, sizeof(T));
+            seq_.store(seq + 2, std::memory_order_release);
+        }
+
+        T load() const
+        {
+            T out;
+            uint64_t before, after;
+            do
+            {
+                before = seq_.load(std::memory_order_acquire);
+                std::memcpy(&out, &data_, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                after = seq_.load(std::memory_order_relaxed);
+            } while ((before & 1) || before != after);
+            return out;
+        }
+
+    private:
+        std::atomic<uint64_t> seq_{0};
+        T data_{};
+    };
+
     class EliteRobotController
     {
     public:
@@ -20,33 +161,152 @@ namespace ELITE_EXTENSION
         ~EliteRobotController();
 
         // 1. Connection Management
+        // Blocking connect; same bring-up as connectAsync()
         bool connect(const std::string &ip, const std::string &recipe_dir = "config");
+        // Starts bring-up on a background thread and returns immediately. Poll getConnectStatus()
+        // or block in waitConnected(). Returns false if a bring-up is already in progress.
+        bool connectAsync(const std::string &ip, const std::string &recipe_dir = "config", double timeout_s = CONNECT_TIMEOUT);
+        int getConnectStatus() const;
+        // Waits for a pending bring-up to finish, returns the resulting ConnectStatus
+        int waitConnected(double timeout_s);
         void disconnect();
         bool isConnected() const;
 
         // 2. State & Position
+        // Latest RTSI sample, never blocks on the network. Check valid() before use.
+        RobotStateSnapshot getStateSnapshot() const;
+        // Blocks until a sample newer than last_sequence is published or the timeout expires
+        bool waitForSample(uint64_t last_sequence, double timeout_s, RobotStateSnapshot &out) const;
+        // Waits on the RTSI stream until the TCP is within pos_tol (m) / rot_tol (rad) of target
+        // (m, rad) and either stopped or the motion program has ended. A negative rot_tol skips
+        // the orientation check. Call it after sending the move: it only reports done once the move
+        // was seen to start (PLAYING, or the TCP leaving the call-time pose), so a robot already
+        // standing at target times out. Returns false on timeout or if the robot leaves RUNNING mode.
+        bool waitForMotionDone(const ELITE::vector6d_t &target, double pos_tol, double rot_tol, double timeout_s) const;
+        // Waits until the TCP is still per cfg, at most max_wait_s. settle_time_s receives the measured
+        // time until the settled run ended (max_wait_s on timeout). Returns true if it settled.
+        bool waitForSettle(const SettleConfig &cfg, double max_wait_s, double &settle_time_s) const;
+        // Waits until script-written output boolean register `index` (0-31) equals value
+        bool waitForOutputBit(int index, bool value, double timeout_s) const;
+        // Sets input boolean register `index` (0-31), read by robot scripts
+        bool setInputBitRegister(int index, bool value);
+        // Publishes snap as the latest sample as if it came from RTSI (sequence and receive time are
+        // filled in). Stands in for the robot in simulation and tests; ignored while RTSI runs.
+        void injectStateSample(RobotStateSnapshot snap);
+
         // Returns [x, y, z, rx, ry, rz] in mm and degrees (rx, ry, rz are rotation vector in degrees)
         std::vector<double> getPosition();
         std::string getRobotState();
+        // Counters of the RTSI reconnect supervisor, never blocks
+        RtsiHealth getRtsiHealth() const;
 
         // 3. Motion Control
         void setSpeed(double percent);
 
-        // Jog: axis (0=X, 1=Y, 2=Z, 3=RX, 4=RY, 5=RZ), direction (+1/-1), distance (mm)
+        // Jog: axis (0=X, 1=Y, 2=Z, 3=RX, 4=RY, 5=RZ), direction (+1/-1), distance (mm, or deg for RX-RZ).
+        // Relative to the base frame from the controller's actual TCP pose; works without RTSI.
         bool jog(int axis, int direction, double distance_mm);
 
         // MoveTo: x,y,z (mm), rx,ry,rz (deg, rotation vector)
         bool moveTo(double x, double y, double z, double rx, double ry, double rz);
 
         bool stop();
+        bool sendScript(const std::string &script);
+
+        // 4. Streaming Servo
+        // Uploads the resident servo script and streams the current setpoint every RTSI cycle.
+        // SERVO_SPEED starts at rest, SERVO_POSE starts at the current TCP pose. In SERVO_SPEED a
+        // setpoint older than deadman_s is replaced by zero speed until the next one arrives (<= 0
+        // disables it); a stale SERVO_POSE setpoint already holds the arm in place.
+        bool startServo(int mode, double deadman_s = SERVO_DEADMAN_CYCLES / RTSI_FREQUENCY);
+        void stopServo();
+        bool isServoing() const;
+        // Setpoint for the running servo mode (m/s, rad/s or m, rad), picked up on the next cycle and
+        // timestamped for the deadman
+        bool setServoSetpoint(const ELITE::vector6d_t &setpoint);
+
+        // 5. Telemetry Recording
+        // Maps a ring file of `capacity` records at path and appends every RTSI sample to it from
+        // the receive thread. Replaces a running recording. Returns nullptr if the file can't be mapped.
+        std::shared_ptr<TelemetryRecorder> startRecording(const std::string &path, size_t capacity);
+        // Detaches the recorder and flushes it; the mapping stays valid while a reference is held
+        void stopRecording();
+        bool isRecording() const;
+
+        static constexpr double RTSI_FREQUENCY = 250.0;
 
     private:
+        // primary->sendScript, timed as "script.send"
+        bool sendPrimaryScript(const std::string &script);
+        // Tears down whatever it opened when a step fails
+        bool bringUp(const std::string &ip, const std::string &recipe_dir, double timeout_s);
+        // Stops servo, receive thread and recording, then closes all three interfaces
+        void closeInterfaces();
+        // Robot mode from the RTSI cache, falling back to the dashboard before the first sample
+        int currentRobotMode();
+        // Polls robot mode until it reaches at least min_mode
+        bool waitForRobotMode(ELITE::RobotMode min_mode, std::chrono::steady_clock::time_point deadline);
+
+        void rtsiLoop();
+        // Stores snap in state_cache, feeds the recorder and wakes waitForSample() callers
+        void publishState(const RobotStateSnapshot &snap);
+        void startRtsiThread();
+        void stopRtsiThread();
+
+        void servoLoop();
+        // Skips the write and returns false while the RTSI link is down
+        bool writeServoRegisters(int mode, int32_t heartbeat, const ELITE::vector6d_t &setpoint);
+        std::string servoScript() const;
+
         std::string robot_ip;
         std::unique_ptr<ELITE::DashboardClient> dashboard;
         std::unique_ptr<ELITE::PrimaryPortInterface> primary;
         std::unique_ptr<ELITE::RtsiIOInterface> rtsi;
-        bool is_connected;
-        double global_speed; // 0.0 - 1.0 (percent / 100)
+        // Serializes every call on rtsi: receive thread, servo thread and callers share the interface
+        std::mutex rtsi_mutex;
+        std::atomic<bool> is_connected{false};
+        double global_speed = 0.5; // 0.0 - 1.0 (percent / 100)
+
+        // Background bring-up started by connectAsync()
+        std::thread connect_thread;
+        std::atomic<int> connect_status{CONNECT_IDLE};
+        std::mutex connect_mutex;
+        std::condition_variable connect_cv;
+
+        // RTSI receive thread, publishes into state_cache at the recipe frequency
+        SeqLock<RobotStateSnapshot> state_cache;
+        std::thread rtsi_thread;
+        std::atomic<bool> rtsi_running{false};
+
+        // Supervisor counters, written by rtsi_thread
+        std::atomic<bool> rtsi_link_up{false};
+        std::atomic<uint64_t> rtsi_disconnects{0};
+        std::atomic<uint64_t> rtsi_stale_resets{0};
+        std::atomic<uint64_t> rtsi_reconnect_attempts{0};
+        std::atomic<uint64_t> rtsi_reconnects{0};
+        std::atomic<double> rtsi_backoff{0.0};
+
+        // Wakes waitForSample() callers; only touched when someone is waiting
+        mutable std::mutex state_mutex;
+        mutable std::condition_variable state_cv;
+        mutable std::atomic<int> state_waiters{0};
+
+        // Last value written to input_bit_registers0_to_31
+        std::mutex input_bits_mutex;
+        uint32_t input_bits = 0;
+
+        // Streaming servo: setpoint written by callers, sent by servo_thread every RTSI cycle
+        std::mutex servo_mutex;
+        ELITE::vector6d_t servo_setpoint{};
+        std::chrono::steady_clock::time_point servo_setpoint_at;
+        double servo_deadman = 0.0; // s, set by startServo() before servo_thread starts
+        std::atomic<int> servo_mode{SERVO_OFF};
+        std::thread servo_thread;
+
+        // Telemetry recorder fed by rtsi_thread; `recording` lets the loop skip the lock when idle
+        std::mutex recorder_mutex;
+        std::shared_ptr<TelemetryRecorder> recorder;
+        std::atomic<bool> recording{false};
     };
 
 } // namespace ELITE_EXTENSION
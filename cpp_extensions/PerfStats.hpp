@@ -0,0 +1,298 @@
+#ifndef PERF_STATS_HPP
+#define PERF_STATS_HPP
+
+// Hot-path timers and counters shared by vision_cpp_ext and elite_ext.
+//
+//   PERF_SCOPE("edge.canny");            // times the enclosing scope (ns)
+//   PERF_COUNT("alloc.scratch_grow", 1); // adds to a counter
+//   PERF_VALUE("rtsi.sample_age", ns);   // records a value into a histogram
+//
+// Each thread writes only its own block of per-stat histograms (log-linear buckets, 4 per
+// power of two), so recording is a handful of uncontended relaxed atomics and never locks.
+// snapshot() merges all threads' blocks. A thread's block goes to a free list when the thread
+// exits and is reused, counts intact, by the next new thread, so the number of blocks is bounded
+// by the peak number of live recording threads rather than by every thread ever started. Building with PERF_STATS_DISABLED compiles every
+// macro to nothing; snapshot() then returns no stats.
+// Stats live per module: each extension has its own registry.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace PERF_STATS
+{
+
+    enum StatKind
+    {
+        STAT_TIMER = 0,   // nanoseconds
+        STAT_COUNTER = 1, // summed increments
+        STAT_VALUE = 2    // arbitrary non-negative values, unit in the stat name
+    };
+
+    const int MAX_STATS = 48;
+    const int SUB_BUCKETS = 4;                 // per power of two, <= 19% bucket width
+    const int BUCKETS = 44 * SUB_BUCKETS;      // values up to 2^44 (~4.9 h in ns)
+
+    // Bucket of v: exact for v < 4, then 4 log-linear sub-buckets per power of two
+    inline int bucketOf(uint64_t v)
+    {
+        if (v < SUB_BUCKETS)
+            return static_cast<int>(v);
+        int msb = 63;
+        while (!(v >> msb))
+            --msb;
+        int sub = static_cast<int>((v >> (msb - 2)) & (SUB_BUCKETS - 1));
+        return std::min(BUCKETS - 1, (msb - 1) * SUB_BUCKETS + sub);
+    }
+
+    // Upper bound of the values falling into bucket b
+    inline uint64_t bucketUpper(int b)
+    {
+        if (b < SUB_BUCKETS)
+            return static_cast<uint64_t>(b);
+        int msb = b / SUB_BUCKETS + 1;
+        int sub = b % SUB_BUCKETS;
+        return ((static_cast<uint64_t>(SUB_BUCKETS + sub + 1)) << (msb - 2)) - 1;
+    }
+
+    struct StatCell
+    {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> total{0};
+        std::atomic<uint64_t> max{0};
+        std::array<std::atomic<uint64_t>, BUCKETS> buckets{};
+    };
+
+    // One thread's stats, written only by that thread
+    struct ThreadBlock
+    {
+        std::array<StatCell, MAX_STATS> cells;
+    };
+
+    struct StatSnapshot
+    {
+        std::string name;
+        int kind = STAT_TIMER;
+        uint64_t count = 0;
+        uint64_t total = 0;
+        uint64_t max = 0;
+        uint64_t p50 = 0, p90 = 0, p99 = 0; // bucket upper bounds
+    };
+
+    class Registry
+    {
+    public:
+        static Registry &instance()
+        {
+            static Registry r;
+            return r;
+        }
+
+        // Id of a stat, registered on first use. Returns -1 once MAX_STATS are taken.
+        int id(const char *name, int kind)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (int i = 0; i < static_cast<int>(names_.size()); ++i)
+                if (names_[i] == name)
+                    return i;
+            if (static_cast<int>(names_.size()) >= MAX_STATS)
+                return -1;
+            names_.push_back(name);
+            kinds_.push_back(kind);
+            return static_cast<int>(names_.size()) - 1;
+        }
+
+        ThreadBlock &local()
+        {
+            // Hands the block back when the thread exits; its counts stay in the totals
+            struct LocalBlock
+            {
+                ThreadBlock *block = nullptr;
+                ~LocalBlock()
+                {
+                    if (block)
+                        Registry::instance().release(block);
+                }
+            };
+            thread_local LocalBlock local;
+            if (!local.block)
+                local.block = acquire();
+            return *local.block;
+        }
+
+        void record(int id, uint64_t value, uint64_t events = 1)
+        {
+            if (id < 0)
+                return;
+            StatCell &c = local().cells[id];
+            c.count.fetch_add(events, std::memory_order_relaxed);
+            c.total.fetch_add(value, std::memory_order_relaxed);
+            if (value > c.max.load(std::memory_order_relaxed))
+                c.max.store(value, std::memory_order_relaxed);
+            c.buckets[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+        }
+
+        std::vector<StatSnapshot> snapshot()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            std::vector<StatSnapshot> out(names_.size());
+            std::vector<uint64_t> hist(BUCKETS);
+            for (size_t i = 0; i < names_.size(); ++i)
+            {
+                StatSnapshot &s = out[i];
+                s.name = names_[i];
+                s.kind = kinds_[i];
+                std::fill(hist.begin(), hist.end(), 0);
+                for (const auto &b : blocks_)
+                {
+                    const StatCell &c = b->cells[i];
+                    s.count += c.count.load(std::memory_order_relaxed);
+                    s.total += c.total.load(std::memory_order_relaxed);
+                    s.max = std::max(s.max, c.max.load(std::memory_order_relaxed));
+                    for (int k = 0; k < BUCKETS; ++k)
+                        hist[k] += c.buckets[k].load(std::memory_order_relaxed);
+                }
+                uint64_t samples = 0;
+                for (uint64_t h : hist)
+                    samples += h;
+                auto pct = [&](double p)
+                {
+                    uint64_t rank = static_cast<uint64_t>(p * samples);
+                    uint64_t seen = 0;
+                    for (int k = 0; k < BUCKETS; ++k)
+                    {
+                        seen += hist[k];
+                        if (seen > rank)
+                            return std::min(bucketUpper(k), s.max);
+                    }
+                    return s.max;
+                };
+                if (samples)
+                {
+                    s.p50 = pct(0.50);
+                    s.p90 = pct(0.90);
+                    s.p99 = pct(0.99);
+                }
+            }
+            return out;
+        }
+
+        // Zeroes every thread's stats; writers racing with a reset may keep one sample
+        void reset()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto &b : blocks_)
+                for (StatCell &c : b->cells)
+                {
+                    c.count.store(0, std::memory_order_relaxed);
+                    c.total.store(0, std::memory_order_relaxed);
+                    c.max.store(0, std::memory_order_relaxed);
+                    for (auto &h : c.buckets)
+                        h.store(0, std::memory_order_relaxed);
+                }
+        }
+
+    private:
+        ThreadBlock *acquire()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!free_.empty())
+            {
+                ThreadBlock *b = free_.back();
+                free_.pop_back();
+                return b;
+            }
+            blocks_.emplace_back(new ThreadBlock());
+            return blocks_.back().get();
+        }
+
+        void release(ThreadBlock *block)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            free_.push_back(block);
+        }
+
+        std::mutex mutex_;
+        std::vector<std::string> names_;
+        std::vector<int> kinds_;
+        std::vector<std::unique_ptr<ThreadBlock>> blocks_; // every block, live or free
+        std::vector<ThreadBlock *> free_;                  // blocks of exited threads
+    };
+
+    inline uint64_t nowNs()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                         std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+    }
+
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer(int id) : id_(id), start_(nowNs()) {}
+        ~ScopedTimer() { Registry::instance().record(id_, nowNs() - start_); }
+        ScopedTimer(const ScopedTimer &) = delete;
+        ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+    private:
+        int id_;
+        uint64_t start_;
+    };
+
+    inline std::vector<StatSnapshot> snapshot()
+    {
+#ifdef PERF_STATS_DISABLED
+        return {};
+#else
+        return Registry::instance().snapshot();
+#endif
+    }
+
+    inline void reset()
+    {
+#ifndef PERF_STATS_DISABLED
+        Registry::instance().reset();
+#endif
+    }
+
+} // namespace PERF_STATS
+
+#define PERF_STATS_CAT2(a, b) a##b
+#define PERF_STATS_CAT(a, b) PERF_STATS_CAT2(a, b)
+
+#ifdef PERF_STATS_DISABLED
+#define PERF_SCOPE(name)
+#define PERF_COUNT(name, n) \
+    do                      \
+    {                       \
+    } while (0)
+#define PERF_VALUE(name, v) \
+    do                      \
+    {                       \
+    } while (0)
+#else
+// The stat id is looked up once per call site
+#define PERF_SCOPE(name)                                                                                               \
+    static const int PERF_STATS_CAT(perf_id_, __LINE__) = PERF_STATS::Registry::instance().id(name, PERF_STATS::STAT_TIMER); \
+    PERF_STATS::ScopedTimer PERF_STATS_CAT(perf_timer_, __LINE__)(PERF_STATS_CAT(perf_id_, __LINE__))
+#define PERF_COUNT(name, n)                                                                                               \
+    do                                                                                                                    \
+    {                                                                                                                     \
+        static const int perf_id = PERF_STATS::Registry::instance().id(name, PERF_STATS::STAT_COUNTER);                   \
+        PERF_STATS::Registry::instance().record(perf_id, static_cast<uint64_t>(n));                                       \
+    } while (0)
+#define PERF_VALUE(name, v)                                                                                               \
+    do                                                                                                                    \
+    {                                                                                                                     \
+        static const int perf_id = PERF_STATS::Registry::instance().id(name, PERF_STATS::STAT_VALUE);                     \
+        PERF_STATS::Registry::instance().record(perf_id, static_cast<uint64_t>(v));                                       \
+    } while (0)
+#endif
+
+#endif // PERF_STATS_HPP
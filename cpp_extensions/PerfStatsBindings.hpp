@@ -0,0 +1,50 @@
+#ifndef PERF_STATS_BINDINGS_HPP
+#define PERF_STATS_BINDINGS_HPP
+
+#include <pybind11/pybind11.h>
+
+#include "PerfStats.hpp"
+
+namespace PERF_STATS
+{
+
+    // get_perf_stats() -> {name: {kind, count, total, mean, max, p50, p90, p99}} and
+    // reset_perf_stats(). Timers are in ns; PERF_STATS_ENABLED tells whether the module was
+    // built with instrumentation.
+    inline void bindPerfStats(pybind11::module_ &m)
+    {
+        namespace py = pybind11;
+
+        m.def(
+            "get_perf_stats",
+            []()
+            {
+                static const char *KIND_NAMES[] = {"timer_ns", "counter", "value"};
+                py::dict out;
+                for (const StatSnapshot &s : snapshot())
+                {
+                    py::dict d;
+                    d["kind"] = KIND_NAMES[s.kind];
+                    d["count"] = s.count;
+                    d["total"] = s.total;
+                    d["mean"] = s.count ? static_cast<double>(s.total) / s.count : 0.0;
+                    d["max"] = s.max;
+                    d["p50"] = s.p50;
+                    d["p90"] = s.p90;
+                    d["p99"] = s.p99;
+                    out[py::str(s.name)] = d;
+                }
+                return out;
+            },
+            "Per-stage timers (ns), counters and value histograms merged over all threads");
+        m.def("reset_perf_stats", &reset, "Zero all perf stats");
+#ifdef PERF_STATS_DISABLED
+        m.attr("PERF_STATS_ENABLED") = false;
+#else
+        m.attr("PERF_STATS_ENABLED") = true;
+#endif
+    }
+
+} // namespace PERF_STATS
+
+#endif // PERF_STATS_BINDINGS_HPP
@@ -0,0 +1,433 @@
+#ifndef ELITE_POSE_MATH_HPP
+#define ELITE_POSE_MATH_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace ELITE_EXTENSION
+{
+
+    // ==========================================
+    // Minimal 3D Math Helpers for Rotation Logic
+    // ==========================================
+    struct Vec3
+    {
+        double x, y, z;
+        Vec3 operator+(const Vec3 &o) const { return {x + o.x, y + o.y, z + o.z}; }
+        Vec3 operator-(const Vec3 &o) const { return {x - o.x, y - o.y, z - o.z}; }
+        Vec3 operator*(double s) const { return {x * s, y * s, z * s}; }
+        double dot(const Vec3 &o) const { return x * o.x + y * o.y + z * o.z; }
+        Vec3 cross(const Vec3 &o) const { return {y * o.z - z * o.y, z * o.x - x * o.z, x * o.y - y * o.x}; }
+        double length() const { return std::sqrt(x * x + y * y + z * z); }
+        Vec3 normalize() const
+        {
+            double l = length();
+            if (l < 1e-9)
+                return {0, 0, 1};
+            return {x / l, y / l, z / l};
+        }
+    };
+
+    // Convert Rotation Matrix (column major or orthonormal vectors) to Axis-Angle Vector (Rx, Ry, Rz)
+    // R = [Xx Yx Zx]
+    //     [Xy Yy Zy]
+    //     [Xz Yz Zz]
+    inline std::vector<double> matrixToRotVec(const Vec3 &X, const Vec3 &Y, const Vec3 &Z)
+    {
+        // Rotation Matrix elements
+        double r11 = X.x, r12 = Y.x, r13 = Z.x;
+        double r21 = X.y, r22 = Y.y, r23 = Z.y;
+        double r31 = X.z, r32 = Y.z, r33 = Z.z;
+
+        double trace = r11 + r22 + r33;
+        double theta = 0.0;
+        Vec3 axis = {0, 0, 0};
+
+        if (trace >= 3.0 - 1e-6)
+        {
+            // Identity
+            return {0, 0, 0};
+        }
+        else if (trace <= -1.0 + 1e-6)
+        {
+            // 180 degree rotation singularity
+            theta = 3.141592653589793;
+            if (r11 > r22 && r11 > r33)
+                axis = {std::sqrt((r11 + 1) / 2), (r12 + r21) / (2 * std::sqrt((r11 + 1) / 2)), (r13 + r31) / (2 * std::sqrt((r11 + 1) / 2))};
+            else if (r22 > r33)
+                axis = {(r12 + r21) / (2 * std::sqrt((r22 + 1) / 2)), std::sqrt((r22 + 1) / 2), (r23 + r32) / (2 * std::sqrt((r22 + 1) / 2))};
+            else
+                axis = {(r13 + r31) / (2 * std::sqrt((r33 + 1) / 2)), (r23 + r32) / (2 * std::sqrt((r33 + 1) / 2)), std::sqrt((r33 + 1) / 2)};
+        }
+        else
+        {
+            theta = std::acos((trace - 1.0) / 2.0);
+            double s = 2.0 * std::sin(theta);
+            axis.x = (r32 - r23) / s;
+            axis.y = (r13 - r31) / s;
+            axis.z = (r21 - r12) / s;
+        }
+
+        axis = axis.normalize();
+        return {axis.x * theta, axis.y * theta, axis.z * theta};
+    }
+
+    // Convert Axis-Angle (Rx, Ry, Rz) to Matrix (X, Y, Z vectors)
+    inline void rotVecToMatrix(double rx, double ry, double rz, Vec3 &X, Vec3 &Y, Vec3 &Z)
+    {
+        double theta = std::sqrt(rx * rx + ry * ry + rz * rz);
+        if (theta < 1e-6)
+        {
+            X = {1, 0, 0};
+            Y = {0, 1, 0};
+            Z = {0, 0, 1};
+            return;
+        }
+
+        double kx = rx / theta;
+        double ky = ry / theta;
+        double kz = rz / theta;
+
+        double c = std::cos(theta);
+        double s = std::sin(theta);
+        double v = 1 - c;
+
+        X = {kx * kx * v + c, kx * ky * v - kz * s, kx * kz * v + ky * s};
+        Y = {kx * ky * v + kz * s, ky * ky * v + c, ky * kz * v - kx * s};
+        Z = {kx * kz * v - ky * s, ky * kz * v + kx * s, kz * kz * v + c};
+    }
+
+    // Angle (rad) of the relative rotation between two axis-angle vectors
+    inline double rotationDistance(double ax, double ay, double az, double bx, double by, double bz)
+    {
+        Vec3 Xa, Ya, Za, Xb, Yb, Zb;
+        rotVecToMatrix(ax, ay, az, Xa, Ya, Za);
+        rotVecToMatrix(bx, by, bz, Xb, Yb, Zb);
+        // trace(Ra^T * Rb) is the element-wise product sum of the two matrices
+        double trace = Xa.dot(Xb) + Ya.dot(Yb) + Za.dot(Zb);
+        double c = std::max(-1.0, std::min(1.0, (trace - 1.0) / 2.0));
+        return std::acos(c);
+    }
+
+    // ==========================================
+    // Batch pose math over arrays of [x, y, z, rx, ry, rz]
+    // ==========================================
+    // Poses are processed in blocks of POSE_BLOCK: each block is deinterleaved into stack SoA
+    // buffers so the element-wise loops below are branch-free and auto-vectorize at -O3 (AVX2 /
+    // NEON when targeted). sin/cos/atan2 stay per-lane libm calls. Nothing is heap allocated.
+    // Row strides are in doubles; a stride of 0 repeats one pose for the whole batch.
+    // angle_scale converts the rotation vector to radians on input and back on output
+    // (1 for rad, pi/180 for degrees). Matrices are row-major 3x3.
+
+    const size_t POSE_BLOCK = 64;
+
+    struct RotationBlock
+    {
+        alignas(64) double m[9][POSE_BLOCK];
+    };
+
+    // Rodrigues R = I + a K + b K^2 with a = sin(t)/t, b = (1 - cos(t))/t^2, Taylor near t = 0
+    inline void rotVecBlockToMatrix(const double *rx, const double *ry, const double *rz, size_t n, RotationBlock &R)
+    {
+        alignas(64) double a[POSE_BLOCK], b[POSE_BLOCK];
+        for (size_t i = 0; i < n; ++i)
+        {
+            double t2 = rx[i] * rx[i] + ry[i] * ry[i] + rz[i] * rz[i];
+            double t = std::sqrt(t2);
+            bool small = t2 < 1e-8;
+            double inv = 1.0 / (small ? 1.0 : t);
+            a[i] = small ? 1.0 - t2 / 6.0 : std::sin(t) * inv;
+            b[i] = small ? 0.5 - t2 / 24.0 : (1.0 - std::cos(t)) * inv * inv;
+        }
+        for (size_t i = 0; i < n; ++i)
+        {
+            double x = rx[i], y = ry[i], z = rz[i];
+            double xx = x * x, yy = y * y, zz = z * z, xy = x * y, xz = x * z, yz = y * z;
+            R.m[0][i] = 1.0 - b[i] * (yy + zz);
+            R.m[1][i] = b[i] * xy - a[i] * z;
+            R.m[2][i] = b[i] * xz + a[i] * y;
+            R.m[3][i] = b[i] * xy + a[i] * z;
+            R.m[4][i] = 1.0 - b[i] * (xx + zz);
+            R.m[5][i] = b[i] * yz - a[i] * x;
+            R.m[6][i] = b[i] * xz - a[i] * y;
+            R.m[7][i] = b[i] * yz + a[i] * x;
+            R.m[8][i] = 1.0 - b[i] * (xx + yy);
+        }
+    }
+
+    // Matrix log. The general formula r = w t / (2 sin t) loses precision near t = pi,
+    // those lanes are redone from the symmetric part (R + R^T)/2 - cI = (1 - c) k k^T.
+    inline void matrixBlockToRotVec(const RotationBlock &R, size_t n, double *rx, double *ry, double *rz)
+    {
+        const double NEAR_PI_COS = -0.9999;
+        bool any_near_pi = false;
+        for (size_t i = 0; i < n; ++i)
+        {
+            double wx = R.m[7][i] - R.m[5][i];
+            double wy = R.m[2][i] - R.m[6][i];
+            double wz = R.m[3][i] - R.m[1][i];
+            double s = 0.5 * std::sqrt(wx * wx + wy * wy + wz * wz);
+            double c = std::max(-1.0, std::min(1.0, 0.5 * (R.m[0][i] + R.m[4][i] + R.m[8][i] - 1.0)));
+            double t = std::atan2(s, c);
+            double k = s < 1e-9 ? 0.5 : 0.5 * t / s;
+            rx[i] = wx * k;
+            ry[i] = wy * k;
+            rz[i] = wz * k;
+            any_near_pi |= c < NEAR_PI_COS;
+        }
+        if (!any_near_pi)
+            return;
+        for (size_t i = 0; i < n; ++i)
+        {
+            double c = 0.5 * (R.m[0][i] + R.m[4][i] + R.m[8][i] - 1.0);
+            if (c >= NEAR_PI_COS)
+                continue;
+            c = std::max(-1.0, c);
+            double wx = R.m[7][i] - R.m[5][i];
+            double wy = R.m[2][i] - R.m[6][i];
+            double wz = R.m[3][i] - R.m[1][i];
+            double s = 0.5 * std::sqrt(wx * wx + wy * wy + wz * wz);
+            double t = std::atan2(s, c);
+            double d = 1.0 - c;
+            double bxx = R.m[0][i] - c, byy = R.m[4][i] - c, bzz = R.m[8][i] - c;
+            double bxy = 0.5 * (R.m[1][i] + R.m[3][i]);
+            double bxz = 0.5 * (R.m[2][i] + R.m[6][i]);
+            double byz = 0.5 * (R.m[5][i] + R.m[7][i]);
+            Vec3 k;
+            if (bxx >= byy && bxx >= bzz)
+            {
+                double kx = std::sqrt(std::max(0.0, bxx / d));
+                k = {kx, bxy / (d * kx), bxz / (d * kx)};
+            }
+            else if (byy >= bzz)
+            {
+                double ky = std::sqrt(std::max(0.0, byy / d));
+                k = {bxy / (d * ky), ky, byz / (d * ky)};
+            }
+            else
+            {
+                double kz = std::sqrt(std::max(0.0, bzz / d));
+                k = {bxz / (d * kz), byz / (d * kz), kz};
+            }
+            // k is only defined up to sign here, the antisymmetric part picks it
+            if (k.x * wx + k.y * wy + k.z * wz < 0)
+                k = k * -1.0;
+            k = k.normalize();
+            rx[i] = k.x * t;
+            ry[i] = k.y * t;
+            rz[i] = k.z * t;
+        }
+    }
+
+    // C = A * B
+    inline void matMulBlock(const RotationBlock &A, const RotationBlock &B, size_t n, RotationBlock &C)
+    {
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c)
+                for (size_t i = 0; i < n; ++i)
+                    C.m[r * 3 + c][i] = A.m[r * 3][i] * B.m[c][i] + A.m[r * 3 + 1][i] * B.m[3 + c][i] + A.m[r * 3 + 2][i] * B.m[6 + c][i];
+    }
+
+    // C = A^T * B
+    inline void matTMulBlock(const RotationBlock &A, const RotationBlock &B, size_t n, RotationBlock &C)
+    {
+        for (int r = 0; r < 3; ++r)
+            for (int c = 0; c < 3; ++c)
+                for (size_t i = 0; i < n; ++i)
+                    C.m[r * 3 + c][i] = A.m[r][i] * B.m[c][i] + A.m[3 + r][i] * B.m[3 + c][i] + A.m[6 + r][i] * B.m[6 + c][i];
+    }
+
+    // Deinterleaves `width` columns starting at `first` from rows of `stride` doubles into SoA lanes
+    inline void gatherColumns(const double *src, size_t stride, size_t n, int first, int width, double scale, double (*dst)[POSE_BLOCK])
+    {
+        for (int c = 0; c < width; ++c)
+            for (size_t i = 0; i < n; ++i)
+                dst[c][i] = src[i * stride + first + c] * scale;
+    }
+
+    inline void scatterColumns(const double (*src)[POSE_BLOCK], size_t n, int first, int width, double scale, double *dst, size_t stride)
+    {
+        for (int c = 0; c < width; ++c)
+            for (size_t i = 0; i < n; ++i)
+                dst[i * stride + first + c] = src[c][i] * scale;
+    }
+
+    // Rotation vectors (rows of `stride` doubles, rotation at column `first`) to row-major 3x3 matrices
+    inline void rotVecsToMatrices(const double *rv, size_t stride, int first, size_t count, double angle_scale, double *out)
+    {
+        alignas(64) double r[3][POSE_BLOCK];
+        RotationBlock R;
+        for (size_t base = 0; base < count; base += POSE_BLOCK)
+        {
+            size_t n = std::min(POSE_BLOCK, count - base);
+            gatherColumns(rv + base * stride, stride, n, first, 3, angle_scale, r);
+            rotVecBlockToMatrix(r[0], r[1], r[2], n, R);
+            scatterColumns(R.m, n, 0, 9, 1.0, out + base * 9, 9);
+        }
+    }
+
+    // Row-major 3x3 matrices to rotation vectors written at column `first` of rows of `stride` doubles
+    inline void matricesToRotVecs(const double *mat, size_t count, double angle_scale, double *rv, size_t stride, int first)
+    {
+        alignas(64) double r[3][POSE_BLOCK];
+        RotationBlock R;
+        for (size_t base = 0; base < count; base += POSE_BLOCK)
+        {
+            size_t n = std::min(POSE_BLOCK, count - base);
+            gatherColumns(mat + base * 9, 9, n, 0, 9, 1.0, R.m);
+            matrixBlockToRotVec(R, n, r[0], r[1], r[2]);
+            scatterColumns(r, n, first, 3, 1.0 / angle_scale, rv + base * stride, stride);
+        }
+    }
+
+    // Poses to row-major 4x4 homogeneous transforms
+    inline void posesToTransforms(const double *poses, size_t stride, size_t count, double angle_scale, double *out)
+    {
+        alignas(64) double p[6][POSE_BLOCK];
+        RotationBlock R;
+        for (size_t base = 0; base < count; base += POSE_BLOCK)
+        {
+            size_t n = std::min(POSE_BLOCK, count - base);
+            gatherColumns(poses + base * stride, stride, n, 0, 6, 1.0, p);
+            for (size_t i = 0; i < n; ++i)
+                for (int c = 3; c < 6; ++c)
+                    p[c][i] *= angle_scale;
+            rotVecBlockToMatrix(p[3], p[4], p[5], n, R);
+            double *T = out + base * 16;
+            for (size_t i = 0; i < n; ++i)
+            {
+                double *t = T + i * 16;
+                for (int r = 0; r < 3; ++r)
+                {
+                    t[r * 4] = R.m[r * 3][i];
+                    t[r * 4 + 1] = R.m[r * 3 + 1][i];
+                    t[r * 4 + 2] = R.m[r * 3 + 2][i];
+                    t[r * 4 + 3] = p[r][i];
+                }
+                t[12] = t[13] = t[14] = 0.0;
+                t[15] = 1.0;
+            }
+        }
+    }
+
+    // Row-major 4x4 homogeneous transforms to poses
+    inline void transformsToPoses(const double *T, size_t count, double angle_scale, double *out)
+    {
+        alignas(64) double r[3][POSE_BLOCK];
+        RotationBlock R;
+        for (size_t base = 0; base < count; base += POSE_BLOCK)
+        {
+            size_t n = std::min(POSE_BLOCK, count - base);
+            const double *src = T + base * 16;
+            for (int k = 0; k < 9; ++k)
+                for (size_t i = 0; i < n; ++i)
+                    R.m[k][i] = src[i * 16 + (k / 3) * 4 + k % 3];
+            matrixBlockToRotVec(R, n, r[0], r[1], r[2]);
+            double *dst = out + base * 6;
+            for (size_t i = 0; i < n; ++i)
+            {
+                dst[i * 6] = src[i * 16 + 3];
+                dst[i * 6 + 1] = src[i * 16 + 7];
+                dst[i * 6 + 2] = src[i * 16 + 11];
+            }
+            scatterColumns(r, n, 3, 3, 1.0 / angle_scale, dst, 6);
+        }
+    }
+
+    // Composition kinds for composePoses()
+    enum PoseComposition
+    {
+        POSE_TRANS = 0, // p = a * b: position a.t + a.R b.t, rotation a.R b.R (script pose_trans)
+        POSE_ADD = 1    // position a.t + b.t, rotation a.R b.R (script pose_add)
+    };
+
+    inline void composePoses(const double *a, size_t a_stride, const double *b, size_t b_stride, size_t count,
+                             int kind, double angle_scale, double *out)
+    {
+        alignas(64) double pa[6][POSE_BLOCK], pb[6][POSE_BLOCK], po[6][POSE_BLOCK];
+        RotationBlock Ra, Rb, Ro;
+        for (size_t base = 0; base < count; base += POSE_BLOCK)
+        {
+            size_t n = std::min(POSE_BLOCK, count - base);
+            gatherColumns(a + base * a_stride, a_stride, n, 0, 3, 1.0, pa);
+            gatherColumns(a + base * a_stride, a_stride, n, 3, 3, angle_scale, pa + 3);
+            gatherColumns(b + base * b_stride, b_stride, n, 0, 3, 1.0, pb);
+            gatherColumns(b + base * b_stride, b_stride, n, 3, 3, angle_scale, pb + 3);
+            rotVecBlockToMatrix(pa[3], pa[4], pa[5], n, Ra);
+            rotVecBlockToMatrix(pb[3], pb[4], pb[5], n, Rb);
+            matMulBlock(Ra, Rb, n, Ro);
+            if (kind == POSE_TRANS)
+            {
+                for (int r = 0; r < 3; ++r)
+                    for (size_t i = 0; i < n; ++i)
+                        po[r][i] = pa[r][i] + Ra.m[r * 3][i] * pb[0][i] + Ra.m[r * 3 + 1][i] * pb[1][i] + Ra.m[r * 3 + 2][i] * pb[2][i];
+            }
+            else
+            {
+                for (int r = 0; r < 3; ++r)
+                    for (size_t i = 0; i < n; ++i)
+                        po[r][i] = pa[r][i] + pb[r][i];
+            }
+            matrixBlockToRotVec(Ro, n, po[3], po[4], po[5]);
+            scatterColumns(po, n, 0, 3, 1.0, out + base * 6, 6);
+            scatterColumns(po + 3, n, 3, 3, 1.0 / angle_scale, out + base * 6, 6);
+        }
+    }
+
+    // p^-1: rotation R^T (rotation vector negated), position -R^T t
+    inline void invertPoses(const double *p, size_t stride, size_t count, double angle_scale, double *out)
+    {
+        alignas(64) double pp[6][POSE_BLOCK], po[3][POSE_BLOCK];
+        RotationBlock R;
+        for (size_t base = 0; base < count; base += POSE_BLOCK)
+        {
+            size_t n = std::min(POSE_BLOCK, count - base);
+            gatherColumns(p + base * stride, stride, n, 0, 3, 1.0, pp);
+            gatherColumns(p + base * stride, stride, n, 3, 3, angle_scale, pp + 3);
+            rotVecBlockToMatrix(pp[3], pp[4], pp[5], n, R);
+            for (int r = 0; r < 3; ++r)
+                for (size_t i = 0; i < n; ++i)
+                    po[r][i] = -(R.m[r][i] * pp[0][i] + R.m[3 + r][i] * pp[1][i] + R.m[6 + r][i] * pp[2][i]);
+            scatterColumns(po, n, 0, 3, 1.0, out + base * 6, 6);
+            scatterColumns(pp + 3, n, 3, 3, -1.0 / angle_scale, out + base * 6, 6);
+        }
+    }
+
+    // Pose interpolation: position lerp, rotation along the geodesic a.R exp(t log(a.R^T b.R)).
+    // t (stride t_stride, 0 for a scalar) is the fraction from a (0) to b (1).
+    inline void interpolatePoses(const double *a, size_t a_stride, const double *b, size_t b_stride,
+                                 const double *t, size_t t_stride, size_t count, double angle_scale, double *out)
+    {
+        alignas(64) double pa[6][POSE_BLOCK], pb[6][POSE_BLOCK], po[6][POSE_BLOCK], w[3][POSE_BLOCK], f[POSE_BLOCK];
+        RotationBlock Ra, Rb, D;
+        for (size_t base = 0; base < count; base += POSE_BLOCK)
+        {
+            size_t n = std::min(POSE_BLOCK, count - base);
+            gatherColumns(a + base * a_stride, a_stride, n, 0, 3, 1.0, pa);
+            gatherColumns(a + base * a_stride, a_stride, n, 3, 3, angle_scale, pa + 3);
+            gatherColumns(b + base * b_stride, b_stride, n, 0, 3, 1.0, pb);
+            gatherColumns(b + base * b_stride, b_stride, n, 3, 3, angle_scale, pb + 3);
+            for (size_t i = 0; i < n; ++i)
+                f[i] = t[(base + i) * t_stride];
+            rotVecBlockToMatrix(pa[3], pa[4], pa[5], n, Ra);
+            rotVecBlockToMatrix(pb[3], pb[4], pb[5], n, Rb);
+            matTMulBlock(Ra, Rb, n, D);
+            matrixBlockToRotVec(D, n, w[0], w[1], w[2]);
+            for (int c = 0; c < 3; ++c)
+                for (size_t i = 0; i < n; ++i)
+                {
+                    w[c][i] *= f[i];
+                    po[c][i] = pa[c][i] + f[i] * (pb[c][i] - pa[c][i]);
+                }
+            rotVecBlockToMatrix(w[0], w[1], w[2], n, D);
+            matMulBlock(Ra, D, n, Rb);
+            matrixBlockToRotVec(Rb, n, po[3], po[4], po[5]);
+            scatterColumns(po, n, 0, 3, 1.0, out + base * 6, 6);
+            scatterColumns(po + 3, n, 3, 3, 1.0 / angle_scale, out + base * 6, 6);
+        }
+    }
+
+} // namespace ELITE_EXTENSION
+
+#endif // ELITE_POSE_MATH_HPP
@@ -0,0 +1,150 @@
+#include "TelemetryRecorder.hpp"
+#include "EliteRobotController.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+namespace ELITE_EXTENSION
+{
+
+    TelemetryRecorder::~TelemetryRecorder()
+    {
+        close();
+    }
+
+    bool TelemetryRecorder::open(const std::string &path, size_t capacity, double frequency)
+    {
+        close();
+        if (capacity == 0)
+            return false;
+        const size_t size = sizeof(TelemetryFileHeader) + capacity * sizeof(TelemetryRecord);
+        void *base = nullptr;
+
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                                  CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE)
+            return false;
+        const uint64_t size64 = static_cast<uint64_t>(size);
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READWRITE,
+                                            static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64 & 0xFFFFFFFFu), nullptr);
+        if (!mapping)
+        {
+            CloseHandle(file);
+            return false;
+        }
+        base = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+        if (!base)
+        {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+        file_handle = file;
+        mapping_handle = mapping;
+#else
+        // A previous recording of this path may still be mapped by a NumPy view; truncating that
+        // inode would SIGBUS its readers. Unlink it and create a new inode so the old view stays valid.
+        ::unlink(path.c_str());
+        int f = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+        if (f < 0)
+            return false;
+        if (ftruncate(f, static_cast<off_t>(size)) != 0)
+        {
+            ::close(f);
+            return false;
+        }
+        base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, f, 0);
+        if (base == MAP_FAILED)
+        {
+            ::close(f);
+            return false;
+        }
+        fd = f;
+#endif
+
+        mapped_size = size;
+        file_path = path;
+        // The file is newly created, so the mapping starts zeroed
+        header = new (base) TelemetryFileHeader;
+        std::memcpy(header->magic, TELEMETRY_MAGIC, sizeof(header->magic));
+        header->version = 1;
+        header->record_size = sizeof(TelemetryRecord);
+        header->capacity = capacity;
+        header->frequency = frequency;
+        header->start_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::steady_clock::now().time_since_epoch())
+                               .count();
+        header->write_count.store(0, std::memory_order_release);
+        records_ = reinterpret_cast<TelemetryRecord *>(static_cast<char *>(base) + sizeof(TelemetryFileHeader));
+        return true;
+    }
+
+    void TelemetryRecorder::append(const RobotStateSnapshot &snap)
+    {
+        if (!header)
+            return;
+        const uint64_t n = header->write_count.load(std::memory_order_relaxed);
+        TelemetryRecord &rec = records_[n % header->capacity];
+        rec.sequence = snap.sequence;
+        rec.timestamp = snap.timestamp;
+        rec.received_ns = snap.received_ns;
+        for (int i = 0; i < 6; ++i)
+        {
+            rec.tcp_pose[i] = snap.tcp_pose[i];
+            rec.tcp_speed[i] = snap.tcp_speed[i];
+            rec.joint_positions[i] = snap.joint_positions[i];
+            rec.joint_speeds[i] = snap.joint_speeds[i];
+        }
+        rec.robot_mode = snap.robot_mode;
+        rec.runtime_state = snap.runtime_state;
+        rec.output_bit_registers = snap.output_bit_registers;
+        rec.reserved = 0;
+        header->write_count.store(n + 1, std::memory_order_release);
+    }
+
+    void TelemetryRecorder::flush()
+    {
+        if (!header)
+            return;
+#ifdef _WIN32
+        FlushViewOfFile(header, mapped_size);
+#else
+        msync(header, mapped_size, MS_ASYNC);
+#endif
+    }
+
+    void TelemetryRecorder::close()
+    {
+        if (!header)
+            return;
+        flush();
+#ifdef _WIN32
+        UnmapViewOfFile(header);
+        CloseHandle(static_cast<HANDLE>(mapping_handle));
+        CloseHandle(static_cast<HANDLE>(file_handle));
+        mapping_handle = nullptr;
+        file_handle = nullptr;
+#else
+        munmap(header, mapped_size);
+        ::close(fd);
+        fd = -1;
+#endif
+        header = nullptr;
+        records_ = nullptr;
+        mapped_size = 0;
+    }
+
+} // namespace ELITE_EXTENSION
@@ -0,0 +1,94 @@
+#ifndef ELITE_TELEMETRY_RECORDER_HPP
+#define ELITE_TELEMETRY_RECORDER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ELITE_EXTENSION
+{
+
+    struct RobotStateSnapshot;
+
+    // One RTSI sample as stored in the ring file. Fixed 232-byte layout without implicit padding
+    // so the file can be read back with a NumPy structured dtype (see TELEMETRY_MAGIC).
+    struct TelemetryRecord
+    {
+        uint64_t sequence;   // RobotStateSnapshot::sequence
+        double timestamp;    // Controller timestamp (s)
+        int64_t received_ns; // Host steady_clock time (ns)
+        double tcp_pose[6];
+        double tcp_speed[6];
+        double joint_positions[6];
+        double joint_speeds[6];
+        int32_t robot_mode;
+        int32_t runtime_state;
+        uint32_t output_bit_registers;
+        uint32_t reserved;
+    };
+    static_assert(sizeof(TelemetryRecord) == 232, "TelemetryRecord layout is part of the file format");
+
+    // File layout: TelemetryFileHeader (64 bytes), then `capacity` TelemetryRecords.
+    // Record i of the stream lives at slot i % capacity; write_count is bumped after each record.
+    const char TELEMETRY_MAGIC[8] = {'E', 'L', 'T', 'E', 'L', 'E', 'M', '1'};
+
+    struct TelemetryFileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t record_size;
+        uint64_t capacity;
+        std::atomic<uint64_t> write_count;
+        double frequency; // Nominal RTSI frequency (Hz)
+        int64_t start_ns; // steady_clock time recording started (ns)
+        uint8_t reserved[16];
+    };
+    static_assert(sizeof(TelemetryFileHeader) == 64, "TelemetryFileHeader layout is part of the file format");
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "write_count must be lock-free to live in a shared mapping");
+
+    // Memory-mapped ring file written by the RTSI receive thread. Single writer; readers (the
+    // NumPy view) see records as soon as write_count covers them. Once the ring wraps, the slot
+    // at write_count % capacity is the oldest sample and may be overwritten while being read.
+    class TelemetryRecorder
+    {
+    public:
+        TelemetryRecorder() = default;
+        ~TelemetryRecorder();
+        TelemetryRecorder(const TelemetryRecorder &) = delete;
+        TelemetryRecorder &operator=(const TelemetryRecorder &) = delete;
+
+        // Creates path sized for `capacity` records and maps it. Returns false on I/O error.
+        // An existing file is unlinked first on POSIX, so views still mapping it keep the old data;
+        // on Windows a file that is still mapped cannot be replaced and open fails.
+        bool open(const std::string &path, size_t capacity, double frequency);
+        void close();
+        bool isOpen() const { return header != nullptr; }
+
+        // Appends one sample; called from the RTSI thread only
+        void append(const RobotStateSnapshot &snap);
+        // Flushes the mapping to disk (also done by close())
+        void flush();
+
+        const std::string &path() const { return file_path; }
+        size_t capacity() const { return header ? static_cast<size_t>(header->capacity) : 0; }
+        // Total records written, may exceed capacity once the ring wraps
+        uint64_t count() const { return header ? header->write_count.load(std::memory_order_acquire) : 0; }
+        const TelemetryRecord *records() const { return records_; }
+
+    private:
+        std::string file_path;
+        TelemetryFileHeader *header = nullptr;
+        TelemetryRecord *records_ = nullptr;
+        size_t mapped_size = 0;
+#ifdef _WIN32
+        void *file_handle = nullptr;
+        void *mapping_handle = nullptr;
+#else
+        int fd = -1;
+#endif
+    };
+
+} // namespace ELITE_EXTENSION
+
+#endif // ELITE_TELEMETRY_RECORDER_HPP
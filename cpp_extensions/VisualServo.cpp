@@ -0,0 +1,414 @@
+#include "VisualServo.hpp"
+#include "PerfStats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace ELITE_EXTENSION
+{
+
+    namespace
+    {
+
+        const double PI = 3.141592653589793;
+        const int UNDISTORT_ITERATIONS = 10;
+        const int WATCHDOG_TICK_MS = 5;
+
+        int64_t steadyNs()
+        {
+            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+        }
+
+        // All numbers of the array value of "key" in a JSON file, flattened in order. The
+        // calibration files are plain nested numeric arrays, so no general JSON parser is needed.
+        bool readJsonArray(const std::string &path, const std::string &key, std::vector<double> &out, std::string &error)
+        {
+            std::ifstream file(path);
+            if (!file)
+            {
+                error = "cannot open " + path;
+                return false;
+            }
+            std::stringstream buffer;
+            buffer << file.rdbuf();
+            const std::string text = buffer.str();
+
+            size_t pos = text.find("\"" + key + "\"");
+            if (pos != std::string::npos)
+                pos = text.find_first_not_of(" \t\r\n", text.find(':', pos) + 1);
+            if (pos == std::string::npos || text[pos] != '[')
+            {
+                error = path + ": no \"" + key + "\" array";
+                return false;
+            }
+
+            out.clear();
+            int depth = 0;
+            const char *p = text.c_str() + pos;
+            do
+            {
+                if (*p == '[')
+                    ++depth;
+                else if (*p == ']')
+                    --depth;
+                else if (*p == '-' || *p == '+' || *p == '.' || (*p >= '0' && *p <= '9'))
+                {
+                    char *end = nullptr;
+                    out.push_back(std::strtod(p, &end));
+                    p = end;
+                    continue;
+                }
+                else if (*p == '\0')
+                {
+                    error = path + ": unterminated \"" + key + "\" array";
+                    return false;
+                }
+                ++p;
+            } while (depth > 0);
+            return true;
+        }
+
+        // R * v with R given by its columns
+        Vec3 rotate(const Vec3 R[3], const Vec3 &v)
+        {
+            return R[0] * v.x + R[1] * v.y + R[2] * v.z;
+        }
+
+    } // namespace
+
+    void CameraModel::undistort(double u, double v, double &xn, double &yn) const
+    {
+        const double x0 = (u - cx) / fx;
+        const double y0 = (v - cy) / fy;
+        double x = x0, y = y0;
+        for (int i = 0; i < UNDISTORT_ITERATIONS; ++i)
+        {
+            double r2 = x * x + y * y;
+            double icdist = 1.0 / (1.0 + ((k3 * r2 + k2) * r2 + k1) * r2);
+            double dx = 2.0 * p1 * x * y + p2 * (r2 + 2.0 * x * x);
+            double dy = p1 * (r2 + 2.0 * y * y) + 2.0 * p2 * x * y;
+            x = (x0 - dx) * icdist;
+            y = (y0 - dy) * icdist;
+        }
+        xn = x;
+        yn = y;
+    }
+
+    bool loadHandEyeCalibration(const std::string &intrinsics_path, const std::string &dist_coeffs_path,
+                                const std::string &hand_eye_path, HandEyeCalibration &out, std::string &error)
+    {
+        std::vector<double> K, D, T;
+        if (!readJsonArray(intrinsics_path, "intrinsics", K, error) ||
+            !readJsonArray(dist_coeffs_path, "distCoeffs", D, error) ||
+            !readJsonArray(hand_eye_path, "T", T, error))
+            return false;
+        if (K.size() != 9 || K[0] <= 0.0 || K[4] <= 0.0)
+        {
+            error = intrinsics_path + ": intrinsics must be a 3x3 camera matrix";
+            return false;
+        }
+        if (D.size() < 4)
+        {
+            error = dist_coeffs_path + ": distCoeffs needs at least k1, k2, p1, p2";
+            return false;
+        }
+        if (T.size() != 16)
+        {
+            error = hand_eye_path + ": T must be a 4x4 matrix";
+            return false;
+        }
+
+        HandEyeCalibration calib;
+        CameraModel &cam = calib.camera;
+        cam.fx = K[0];
+        cam.cx = K[2];
+        cam.fy = K[4];
+        cam.cy = K[5];
+        cam.k1 = D[0];
+        cam.k2 = D[1];
+        cam.p1 = D[2];
+        cam.p2 = D[3];
+        cam.k3 = D.size() > 4 ? D[4] : 0.0;
+
+        // Row-major 4x4, translation in mm
+        for (int j = 0; j < 3; ++j)
+            calib.R_fc[j] = {T[j], T[4 + j], T[8 + j]};
+        calib.t_fc = Vec3{T[3], T[7], T[11]} * 0.001;
+        const Vec3 *R = calib.R_fc;
+        double det = R[0].dot(R[1].cross(R[2]));
+        if (std::fabs(det - 1.0) > 0.01 || std::fabs(R[0].dot(R[1])) > 0.01 || std::fabs(R[1].dot(R[2])) > 0.01)
+        {
+            error = hand_eye_path + ": T does not hold a rotation";
+            return false;
+        }
+        calib.loaded = true;
+        out = calib;
+        return true;
+    }
+
+    VisualServo::VisualServo(EliteRobotController &controller, const VisualServoConfig &config)
+        : controller(controller), config(config)
+    {
+        native_sink.version = VISUAL_SERVO_LINK_VERSION;
+        native_sink.fn = &VisualServo::sinkCallback;
+        native_sink.ctx = this;
+    }
+
+    VisualServo::~VisualServo()
+    {
+        stop();
+    }
+
+    bool VisualServo::loadCalibration(const std::string &intrinsics_path, const std::string &dist_coeffs_path,
+                                      const std::string &hand_eye_path, std::string &error)
+    {
+        if (isRunning())
+        {
+            error = "calibration cannot change while the servo is running";
+            return false;
+        }
+        return loadHandEyeCalibration(intrinsics_path, dist_coeffs_path, hand_eye_path, calib, error);
+    }
+
+    void VisualServo::setTarget(double u, double v, double angle, bool has_angle)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        target_u = u;
+        target_v = v;
+        target_angle = angle;
+        target_has_angle = has_angle;
+        target_set = true;
+        on_target = 0;
+        stats.converged = false;
+    }
+
+    bool VisualServo::start()
+    {
+        if (!calib.loaded)
+            return false;
+        if (isRunning())
+            return true;
+        // Setpoints arrive once per camera frame, so the deadman follows the measurement timeout
+        if (!controller.startServo(SERVO_SPEED, config.timeout))
+            return false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            last_valid_ns = steadyNs();
+            moving = false;
+            on_target = 0;
+            stats.converged = false;
+        }
+        running.store(true, std::memory_order_release);
+        watchdog_thread = std::thread(&VisualServo::watchdogLoop, this);
+        return true;
+    }
+
+    void VisualServo::stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(watchdog_mutex);
+            if (!running.exchange(false, std::memory_order_acq_rel))
+                return;
+        }
+        watchdog_cv.notify_all();
+        if (watchdog_thread.joinable())
+            watchdog_thread.join();
+        controller.stopServo();
+        std::lock_guard<std::mutex> lock(mutex);
+        moving = false;
+    }
+
+    void VisualServo::sinkCallback(void *ctx, const VisualServoMeasurement *m)
+    {
+        static_cast<VisualServo *>(ctx)->push(*m);
+    }
+
+    void VisualServo::sendSpeed(const ELITE::vector6d_t &speed)
+    {
+        controller.setServoSetpoint(speed);
+    }
+
+    void VisualServo::zeroSpeed()
+    {
+        ELITE::vector6d_t zero{};
+        controller.setServoSetpoint(zero);
+        moving = false;
+    }
+
+    void VisualServo::push(const VisualServoMeasurement &m)
+    {
+        PERF_SCOPE("servo.measurement");
+        if (m.version != VISUAL_SERVO_LINK_VERSION)
+            return;
+        if (!isRunning())
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++stats.received;
+            return;
+        }
+
+        const int64_t now = steadyNs();
+        const double age = now * 1e-9 - m.timestamp;
+        const RobotStateSnapshot snap = controller.getStateSnapshot();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        ++stats.received;
+        ++stats.measurements;
+        if (!m.found || !target_set || !snap.valid())
+        {
+            // Nothing to servo on: hold still rather than keep the last speed
+            if (!m.found)
+                ++stats.lost;
+            on_target = 0;
+            stats.converged = false;
+            if (moving)
+                zeroSpeed();
+            return;
+        }
+        if (age > config.max_latency)
+        {
+            // Left to the watchdog, a single late frame should not jerk the robot to a stop
+            ++stats.stale;
+            return;
+        }
+
+        const ServoCommand cmd = computeCommand(snap.tcp_pose.data(), config.latency_compensation ? snap.tcp_speed.data() : nullptr,
+                                                age, m.x, m.y, m.angle, m.has_angle != 0);
+        stats.last_error_px = cmd.error_px;
+        last_valid_ns = now;
+
+        if (cmd.error_px < config.deadband && (!cmd.use_angle || std::fabs(cmd.angle_deg) < config.angle_deadband))
+        {
+            if (moving)
+                zeroSpeed();
+            if (++on_target >= config.converged_frames && !stats.converged)
+            {
+                stats.converged = true;
+                converged_cv.notify_all();
+            }
+            return;
+        }
+        on_target = 0;
+        stats.converged = false;
+
+        sendSpeed({cmd.v_tcp.x, cmd.v_tcp.y, cmd.v_tcp.z, cmd.w.x, cmd.w.y, cmd.w.z});
+        moving = true;
+        ++stats.applied;
+        stats.last_latency = (steadyNs() * 1e-9) - m.timestamp;
+        PERF_VALUE("servo.latency_ns", stats.last_latency * 1e9);
+    }
+
+    VisualServo::ServoCommand VisualServo::computeCommand(const double *tcp_pose, const double *tcp_speed, double age,
+                                                         double u, double v, double angle, bool has_angle) const
+    {
+        ServoCommand cmd;
+
+        // Camera-frame error (m) on the target plane: positive where the camera has to move
+        const CameraModel &cam = calib.camera;
+        const double Z = config.working_distance;
+        double xn, yn, txn, tyn;
+        cam.undistort(u, v, xn, yn);
+        cam.undistort(target_u, target_v, txn, tyn);
+        Vec3 error = {Z * (xn - txn), Z * (yn - tyn), 0.0};
+
+        // Image angles run from +x towards +y, i.e. about the camera's +z. Lines are undirected,
+        // so the difference is wrapped to [-90, 90) degrees.
+        cmd.use_angle = target_has_angle && has_angle;
+        cmd.angle_deg = 0.0;
+        if (cmd.use_angle)
+        {
+            cmd.angle_deg = std::fmod(angle - target_angle + 90.0, 180.0);
+            if (cmd.angle_deg < 0.0)
+                cmd.angle_deg += 180.0;
+            cmd.angle_deg -= 90.0;
+        }
+        double error_theta = cmd.angle_deg * PI / 180.0;
+
+        // Camera orientation and lever arm in the base frame from the current TCP pose.
+        // rotVecToMatrix yields the rows of R; rotate() wants its columns.
+        Vec3 rows[3], R_bf[3];
+        rotVecToMatrix(tcp_pose[3], tcp_pose[4], tcp_pose[5], rows[0], rows[1], rows[2]);
+        R_bf[0] = {rows[0].x, rows[1].x, rows[2].x};
+        R_bf[1] = {rows[0].y, rows[1].y, rows[2].y};
+        R_bf[2] = {rows[0].z, rows[1].z, rows[2].z};
+        Vec3 R_bc[3];
+        for (int i = 0; i < 3; ++i)
+            R_bc[i] = rotate(R_bf, calib.R_fc[i]);
+        const Vec3 lever = rotate(R_bf, calib.t_fc);
+
+        if (tcp_speed && age > 0.0)
+        {
+            // The camera kept moving since the frame was captured; that part of the error is already corrected
+            Vec3 v_tcp = {tcp_speed[0], tcp_speed[1], tcp_speed[2]};
+            Vec3 w_tcp = {tcp_speed[3], tcp_speed[4], tcp_speed[5]};
+            Vec3 v_cam = v_tcp + w_tcp.cross(lever);
+            error = error - Vec3{R_bc[0].dot(v_cam), R_bc[1].dot(v_cam), 0.0} * age;
+            if (cmd.use_angle)
+                error_theta -= R_bc[2].dot(w_tcp) * age;
+        }
+        cmd.error_px = std::hypot(u - target_u, v - target_v);
+
+        // Proportional camera twist, limited at the camera, then moved to the TCP
+        Vec3 v_cam = (R_bc[0] * error.x + R_bc[1] * error.y) * config.gain;
+        Vec3 w = R_bc[2] * (config.gain * error_theta);
+        double scale = 1.0;
+        if (v_cam.length() > config.max_linear_speed)
+            scale = config.max_linear_speed / v_cam.length();
+        if (w.length() * scale > config.max_angular_speed)
+            scale = config.max_angular_speed / w.length();
+        v_cam = v_cam * scale;
+        cmd.w = w * scale;
+        cmd.v_tcp = v_cam - cmd.w.cross(lever);
+        return cmd;
+    }
+
+    ELITE::vector6d_t VisualServo::command(const double *tcp_pose, double u, double v, double angle, bool has_angle) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        const ServoCommand cmd = computeCommand(tcp_pose, nullptr, 0.0, u, v, angle, has_angle);
+        return {cmd.v_tcp.x, cmd.v_tcp.y, cmd.v_tcp.z, cmd.w.x, cmd.w.y, cmd.w.z};
+    }
+
+    void VisualServo::watchdogLoop()
+    {
+        const int64_t timeout_ns = static_cast<int64_t>(config.timeout * 1e9);
+        std::unique_lock<std::mutex> wake(watchdog_mutex);
+        while (running.load(std::memory_order_acquire))
+        {
+            watchdog_cv.wait_for(wake, std::chrono::milliseconds(WATCHDOG_TICK_MS));
+            std::lock_guard<std::mutex> lock(mutex);
+            if (moving && steadyNs() - last_valid_ns > timeout_ns)
+            {
+                zeroSpeed();
+                on_target = 0;
+                ++stats.timeouts;
+                PERF_COUNT("servo.timeouts", 1);
+            }
+        }
+    }
+
+    bool VisualServo::waitConverged(double timeout_s) const
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return converged_cv.wait_for(lock, std::chrono::duration<double>(timeout_s), [this]
+                                     { return stats.converged; });
+    }
+
+    VisualServoStats VisualServo::getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats;
+    }
+
+    Vec3 VisualServo::pixelToCamera(double u, double v) const
+    {
+        double xn, yn;
+        calib.camera.undistort(u, v, xn, yn);
+        const double Z = config.working_distance;
+        return {xn * Z, yn * Z, Z};
+    }
+
+} // namespace ELITE_EXTENSION
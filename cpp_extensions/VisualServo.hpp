@@ -0,0 +1,154 @@
+#ifndef ELITE_VISUAL_SERVO_HPP
+#define ELITE_VISUAL_SERVO_HPP
+
+#include "EliteRobotController.hpp"
+#include "PoseMath.hpp"
+#include "VisualServoLink.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace ELITE_EXTENSION
+{
+
+    // Pinhole camera with OpenCV's 5-coefficient distortion model (k1, k2, p1, p2, k3)
+    struct CameraModel
+    {
+        double fx = 0.0, fy = 0.0, cx = 0.0, cy = 0.0;
+        double k1 = 0.0, k2 = 0.0, p1 = 0.0, p2 = 0.0, k3 = 0.0;
+
+        // Pixel -> undistorted normalized image coordinates (x/z, y/z), iterated like cv::undistortPoints
+        void undistort(double u, double v, double &xn, double &yn) const;
+    };
+
+    // Eye-in-hand calibration: camera intrinsics plus the camera pose in the flange frame
+    struct HandEyeCalibration
+    {
+        CameraModel camera;
+        Vec3 R_fc[3] = {{1, 0, 0}, {0, 1, 0}, {0, 0, 1}}; // rotation columns (X, Y, Z), as in PoseMath
+        Vec3 t_fc = {0, 0, 0};                            // m
+        bool loaded = false;
+    };
+
+    // Reads the saved calibration: intrinsics.json {"intrinsics": 3x3}, distCoeffs.json
+    // {"distCoeffs": [[k1,k2,p1,p2,k3]]} and T_eye_in_hand_chessboard.json {"T": 4x4, mm}.
+    // Returns false with a message in error if a file is missing or malformed.
+    bool loadHandEyeCalibration(const std::string &intrinsics_path, const std::string &dist_coeffs_path,
+                                const std::string &hand_eye_path, HandEyeCalibration &out, std::string &error);
+
+    struct VisualServoConfig
+    {
+        double working_distance = 0.3;   // m, camera to target plane along the optical axis
+        double gain = 1.0;               // 1/s, speed per unit of camera-frame error
+        double max_linear_speed = 0.05;  // m/s
+        double max_angular_speed = 0.2;  // rad/s
+        double deadband = 0.5;           // px, errors below this count as on target
+        double angle_deadband = 0.1;     // deg
+        double timeout = 0.1;            // s without a usable measurement before the speed is zeroed
+        double max_latency = 0.1;        // s, older measurements (capture to arrival) are dropped
+        int converged_frames = 3;        // consecutive on-target frames for converged()
+        bool latency_compensation = true; // subtract the TCP motion since capture from the error
+    };
+
+    struct VisualServoStats
+    {
+        uint64_t received = 0;     // every measurement delivered, also while stopped
+        uint64_t measurements = 0; // measurements received while running
+        uint64_t applied = 0;      // setpoints sent
+        uint64_t lost = 0;         // frames without a target
+        uint64_t stale = 0;        // dropped for exceeding max_latency
+        uint64_t timeouts = 0;     // watchdog stops
+        double last_error_px = -1.0;
+        double last_latency = -1.0; // s, capture to setpoint
+        bool converged = false;
+    };
+
+    // Closed-loop visual servo: vision measurements (pushed natively through a VisualServoSink
+    // or via push()) become TCP speed setpoints in SERVO_SPEED mode. The pixel error to the
+    // target is undistorted, scaled to metres at working_distance, rotated from the camera into
+    // the base frame through the hand-eye transform and the current RTSI pose, and sent with
+    // proportional gain. Each measurement is handled on the thread that delivers it; a watchdog
+    // zeroes the speed when measurements stop. The TCP is assumed to be the flange the hand-eye
+    // calibration was made against.
+    class VisualServo
+    {
+    public:
+        // The controller must outlive the servo
+        explicit VisualServo(EliteRobotController &controller, const VisualServoConfig &config = VisualServoConfig());
+        ~VisualServo();
+        VisualServo(const VisualServo &) = delete;
+        VisualServo &operator=(const VisualServo &) = delete;
+
+        bool loadCalibration(const std::string &intrinsics_path, const std::string &dist_coeffs_path,
+                             const std::string &hand_eye_path, std::string &error);
+        const HandEyeCalibration &calibration() const { return calib; }
+
+        // Pixel position the target should end up at; angle in degrees, has_angle=false ignores rotation
+        void setTarget(double u, double v, double angle, bool has_angle);
+
+        // Starts SERVO_SPEED on the controller; fails without a calibration or a live RTSI link
+        bool start();
+        void stop();
+        bool isRunning() const { return running.load(std::memory_order_acquire); }
+
+        // Entry point for one measurement; thread-safe, never blocks on the network
+        void push(const VisualServoMeasurement &m);
+        // Sink handed to vision_cpp_ext; valid while this object lives
+        const VisualServoSink *sink() const { return &native_sink; }
+
+        // Waits until converged_frames consecutive measurements were on target
+        bool waitConverged(double timeout_s) const;
+        VisualServoStats getStats() const;
+
+        // Camera-frame point (m) of pixel (u, v) on the plane at working_distance
+        Vec3 pixelToCamera(double u, double v) const;
+
+        // Speed [v, w] (m/s, rad/s, base frame) push() would send for pixel (u, v) with the TCP at
+        // tcp_pose (m, rad), before the deadband and without latency compensation
+        ELITE::vector6d_t command(const double *tcp_pose, double u, double v, double angle, bool has_angle) const;
+
+    private:
+        struct ServoCommand
+        {
+            Vec3 v_tcp, w;    // TCP speed setpoint, base frame
+            double error_px;  // pixel distance to the target
+            double angle_deg; // wrapped angle error
+            bool use_angle;
+        };
+        // Caller holds mutex; tcp_speed null skips the latency compensation
+        ServoCommand computeCommand(const double *tcp_pose, const double *tcp_speed, double age,
+                                    double u, double v, double angle, bool has_angle) const;
+        static void sinkCallback(void *ctx, const VisualServoMeasurement *m);
+        void watchdogLoop();
+        void sendSpeed(const ELITE::vector6d_t &speed);
+        void zeroSpeed();
+
+        EliteRobotController &controller;
+        const VisualServoConfig config;
+        HandEyeCalibration calib;
+        VisualServoSink native_sink;
+
+        // Target and per-measurement state; measurements from several cameras serialise here
+        mutable std::mutex mutex;
+        double target_u = 0.0, target_v = 0.0, target_angle = 0.0;
+        bool target_has_angle = false;
+        bool target_set = false;
+        int64_t last_valid_ns = 0; // steady clock of the last setpoint from a measurement
+        bool moving = false;       // last setpoint was non-zero
+        int on_target = 0;
+        VisualServoStats stats;
+        mutable std::condition_variable converged_cv;
+
+        std::atomic<bool> running{false};
+        std::thread watchdog_thread;
+        std::mutex watchdog_mutex;
+        std::condition_variable watchdog_cv;
+    };
+
+} // namespace ELITE_EXTENSION
+
+#endif // ELITE_VISUAL_SERVO_HPP
@@ -0,0 +1,152 @@
+#ifndef ELITE_VISUAL_SERVO_BINDINGS_HPP
+#define ELITE_VISUAL_SERVO_BINDINGS_HPP
+
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+
+#include "VisualServo.hpp"
+
+#include <chrono>
+#include <memory>
+
+namespace ELITE_EXTENSION
+{
+
+    // Binds VisualServo into m. Python units are mm, mm/s, deg and ms like the controller bindings.
+    // native_sink() returns a capsule that keeps the servo alive for as long as a pipeline holds it.
+    inline void bindVisualServo(pybind11::module_ &m)
+    {
+        namespace py = pybind11;
+        const double DEG = 3.141592653589793 / 180.0;
+
+        py::class_<VisualServo, std::shared_ptr<VisualServo>>(m, "VisualServo")
+            .def(py::init(
+                     [DEG](EliteRobotController &controller, double working_distance_mm, double gain, double max_speed_mm_s,
+                           double max_rot_deg_s, double deadband_px, double angle_deadband_deg, double timeout_ms,
+                           double max_latency_ms, int converged_frames, bool latency_compensation)
+                     {
+                         VisualServoConfig cfg;
+                         cfg.working_distance = working_distance_mm / 1000.0;
+                         cfg.gain = gain;
+                         cfg.max_linear_speed = max_speed_mm_s / 1000.0;
+                         cfg.max_angular_speed = max_rot_deg_s * DEG;
+                         cfg.deadband = deadband_px;
+                         cfg.angle_deadband = angle_deadband_deg;
+                         cfg.timeout = timeout_ms / 1000.0;
+                         cfg.max_latency = max_latency_ms / 1000.0;
+                         cfg.converged_frames = converged_frames;
+                         cfg.latency_compensation = latency_compensation;
+                         if (cfg.working_distance <= 0.0 || cfg.gain <= 0.0)
+                             throw std::invalid_argument("working_distance_mm and gain must be positive");
+                         return std::make_shared<VisualServo>(controller, cfg);
+                     }),
+                 py::arg("controller"), py::arg("working_distance_mm") = 300.0, py::arg("gain") = 1.0,
+                 py::arg("max_speed_mm_s") = 50.0, py::arg("max_rot_deg_s") = 10.0, py::arg("deadband_px") = 0.5,
+                 py::arg("angle_deadband_deg") = 0.1, py::arg("timeout_ms") = 100.0, py::arg("max_latency_ms") = 100.0,
+                 py::arg("converged_frames") = 3, py::arg("latency_compensation") = true,
+                 py::keep_alive<1, 2>())
+            .def(
+                "load_calibration",
+                [](VisualServo &self, const std::string &intrinsics, const std::string &dist_coeffs, const std::string &hand_eye)
+                {
+                    std::string error;
+                    if (!self.loadCalibration(intrinsics, dist_coeffs, hand_eye, error))
+                        throw std::runtime_error(error);
+                },
+                "Load camera intrinsics, distortion and the hand-eye transform (T in mm) from the saved JSON files",
+                py::arg("intrinsics") = "intrinsics.json", py::arg("dist_coeffs") = "distCoeffs.json",
+                py::arg("hand_eye") = "T_eye_in_hand_chessboard.json")
+            .def(
+                "set_target",
+                [](VisualServo &self, double u, double v, py::object angle)
+                {
+                    self.setTarget(u, v, angle.is_none() ? 0.0 : angle.cast<double>(), !angle.is_none());
+                },
+                "Pixel position (and line angle in deg, None ignores rotation) the target should be servoed to",
+                py::arg("u"), py::arg("v"), py::arg("angle") = py::none())
+            .def("start", &VisualServo::start, "Start SERVO_SPEED on the controller and follow the measurements",
+                 py::call_guard<py::gil_scoped_release>())
+            .def("stop", &VisualServo::stop, "Stop following and leave servo mode", py::call_guard<py::gil_scoped_release>())
+            .def_property_readonly("running", &VisualServo::isRunning)
+            .def(
+                "native_sink",
+                [](std::shared_ptr<VisualServo> self)
+                {
+                    // The sink struct lives in the servo; the capsule context owns a reference to it
+                    py::capsule capsule(self->sink(), VISUAL_SERVO_SINK_CAPSULE, [](PyObject *c)
+                                        { delete static_cast<std::shared_ptr<VisualServo> *>(PyCapsule_GetContext(c)); });
+                    PyCapsule_SetContext(capsule.ptr(), new std::shared_ptr<VisualServo>(self));
+                    return capsule;
+                },
+                "Capsule for vision_cpp_ext VisionPipeline.set_servo_sink()")
+            .def(
+                "push",
+                [](VisualServo &self, double x, double y, py::object angle, bool found, double timestamp, int64_t frame_id)
+                {
+                    VisualServoMeasurement meas{};
+                    meas.version = VISUAL_SERVO_LINK_VERSION;
+                    meas.found = found ? 1 : 0;
+                    meas.frame_id = frame_id;
+                    meas.timestamp = timestamp >= 0.0 ? timestamp
+                                                      : std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+                    meas.x = x;
+                    meas.y = y;
+                    meas.has_angle = angle.is_none() ? 0 : 1;
+                    meas.angle = angle.is_none() ? 0.0 : angle.cast<double>();
+                    meas.score = 1.0;
+                    py::gil_scoped_release release;
+                    self.push(meas);
+                },
+                "Feed one measurement from Python (timestamp: time.monotonic() of the capture, < 0 = now)",
+                py::arg("x"), py::arg("y"), py::arg("angle") = py::none(), py::arg("found") = true,
+                py::arg("timestamp") = -1.0, py::arg("frame_id") = -1)
+            .def("wait_converged", &VisualServo::waitConverged, "Wait until the target stayed within the deadband",
+                 py::arg("timeout"), py::call_guard<py::gil_scoped_release>())
+            .def_property_readonly(
+                "stats",
+                [](const VisualServo &self)
+                {
+                    VisualServoStats s = self.getStats();
+                    py::dict d;
+                    d["received"] = s.received;
+                    d["measurements"] = s.measurements;
+                    d["applied"] = s.applied;
+                    d["lost"] = s.lost;
+                    d["stale"] = s.stale;
+                    d["timeouts"] = s.timeouts;
+                    d["last_error_px"] = s.last_error_px;
+                    d["last_latency_ms"] = s.last_latency < 0.0 ? -1.0 : s.last_latency * 1000.0;
+                    d["converged"] = s.converged;
+                    return d;
+                })
+            .def(
+                "pixel_to_camera",
+                [](const VisualServo &self, double u, double v)
+                {
+                    if (!self.calibration().loaded)
+                        throw std::runtime_error("no calibration loaded");
+                    Vec3 p = self.pixelToCamera(u, v);
+                    return py::make_tuple(p.x * 1000.0, p.y * 1000.0, p.z * 1000.0);
+                },
+                "Undistorted camera-frame point (mm) of pixel (u, v) on the plane at working_distance_mm",
+                py::arg("u"), py::arg("v"))
+            .def(
+                "command",
+                [DEG](const VisualServo &self, double u, double v, const std::vector<double> &tcp_pose, py::object angle)
+                {
+                    if (!self.calibration().loaded)
+                        throw std::runtime_error("no calibration loaded");
+                    if (tcp_pose.size() < 6)
+                        throw std::invalid_argument("tcp_pose must be [x,y,z,rx,ry,rz]");
+                    const double pose[6] = {tcp_pose[0] / 1000.0, tcp_pose[1] / 1000.0, tcp_pose[2] / 1000.0,
+                                            tcp_pose[3] * DEG, tcp_pose[4] * DEG, tcp_pose[5] * DEG};
+                    ELITE::vector6d_t s = self.command(pose, u, v, angle.is_none() ? 0.0 : angle.cast<double>(), !angle.is_none());
+                    return std::vector<double>{s[0] * 1000.0, s[1] * 1000.0, s[2] * 1000.0, s[3] / DEG, s[4] / DEG, s[5] / DEG};
+                },
+                "Base-frame TCP speed (mm/s, deg/s) the servo would command for pixel (u, v) at tcp_pose (mm, deg)",
+                py::arg("u"), py::arg("v"), py::arg("tcp_pose"), py::arg("angle") = py::none());
+    }
+
+} // namespace ELITE_EXTENSION
+
+#endif // ELITE_VISUAL_SERVO_BINDINGS_HPP
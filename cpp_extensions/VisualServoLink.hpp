@@ -0,0 +1,46 @@
+#ifndef VISUAL_SERVO_LINK_HPP
+#define VISUAL_SERVO_LINK_HPP
+
+// Native hand-off of vision measurements from vision_cpp_ext to elite_ext.
+//
+// The two extensions are separate modules, so a VisualServo (elite_ext) exposes its input as a
+// PyCapsule named VISUAL_SERVO_SINK_CAPSULE holding a VisualServoSink. Python wires it up once:
+//
+//   pipeline.set_servo_sink(servo.native_sink(), stage)
+//
+// after which the pipeline worker calls sink->fn(sink->ctx, &measurement) for every frame with
+// no Python and no GIL in between. Plain C layout only, the modules may come from different
+// compilers; bump VISUAL_SERVO_LINK_VERSION whenever a struct changes.
+
+#include <cstdint>
+
+#define VISUAL_SERVO_SINK_CAPSULE "elite_ext.visual_servo_sink"
+
+const uint32_t VISUAL_SERVO_LINK_VERSION = 1;
+
+// Target position measured in one frame
+struct VisualServoMeasurement
+{
+    uint32_t version;   // VISUAL_SERVO_LINK_VERSION
+    int32_t found;      // 0: stage found no target in this frame
+    int64_t frame_id;
+    double timestamp;   // capture time, steady clock (s); time.monotonic() on the Python side
+    double x, y;        // target position (pixels, image coordinates)
+    double angle;       // degrees, valid when has_angle
+    double score;       // match confidence or line inlier ratio
+    int32_t camera;     // MultiCameraExecutor camera index, 0 for a lone pipeline
+    int32_t has_angle;
+};
+static_assert(sizeof(VisualServoMeasurement) == 64, "VisualServoMeasurement layout is shared between modules");
+
+// Called on the vision worker thread; must not block and must not touch Python
+typedef void (*VisualServoSinkFn)(void *ctx, const VisualServoMeasurement *measurement);
+
+struct VisualServoSink
+{
+    uint32_t version; // VISUAL_SERVO_LINK_VERSION
+    VisualServoSinkFn fn;
+    void *ctx;
+};
+
+#endif // VISUAL_SERVO_LINK_HPP
@@ -24,7 +24,8 @@ echo Elite Include: %ELITE_INCLUDE%
 echo.
 
 REM 编译命令
-cl.exe /LD /O2 /std:c++17 ^
+REM /GL + /LTCG: 全程序优化（LTO）
+cl.exe /LD /O2 /GL /std:c++17 ^
     /I"%PYTHON_INCLUDE%" ^
     /I"%PYBIND11_INCLUDE%" ^
     /I"%ELITE_INCLUDE%" ^
@@ -32,7 +33,11 @@ cl.exe /LD /O2 /std:c++17 ^
     /DWIN32 /D_WINDOWS /DNDEBUG ^
     /EHsc /MD ^
     elite_ext.cpp ^
-    /link ^
+    EliteRobotController.cpp ^
+    TelemetryRecorder.cpp ^
+    CalibrationLog.cpp ^
+    VisualServo.cpp ^
+    /link /LTCG ^
     /LIBPATH:"%PYTHON_LIBS%" ^
     /LIBPATH:"%ELITE_LIB%" ^
     python311.lib ^
@@ -14,7 +14,7 @@ sys.path.append(os.path.join(os.path.dirname(__file__), 'extensions'))
 # 添加src目录到路径，以便导入日志模块
 sys.path.insert(0, os.path.join(os.path.dirname(__file__), '..', 'src'))
 
-from typing import List, Tuple
+from typing import List, Optional, Sequence, Tuple
 
 try:
     from core.managers.log_manager import info, warning, LogCategory
@@ -27,6 +27,9 @@ except ImportError:
     class LogCategory:
         SOFTWARE = "software"
 
+# 卡尺扫描方向（与 vision_cpp_ext.SCAN_* 一致）
+SCAN_DOWN, SCAN_UP, SCAN_RIGHT, SCAN_LEFT = 0, 1, 2, 3
+
 # 尝试导入C++扩展
 try:
     import vision_cpp_ext
@@ -39,16 +42,20 @@ except ImportError:
 
 def roi_edge_detection_cpp(image: np.ndarray, 
                           roi_x: int, roi_y: int, roi_width: int, roi_height: int,
-                          threshold: int = 127, min_line_length: int = 50) -> List[Tuple[float, float, float]]:
+                          threshold: int = 127, min_line_length: int = 50,
+                          bayer_pattern: int = -1, detector=None, legacy_output: bool = True):
     """
     使用C++扩展的ROI抓边检测
     
     Args:
-        image: 输入图像
+        image: 输入图像（灰度/BGR/BGRA，可为切片等非连续数组，C++端仅转换ROI区域）
         roi_x, roi_y: ROI起始坐标
         roi_width, roi_height: ROI尺寸
         threshold: 边缘检测阈值
         min_line_length: 最小线段长度
+        bayer_pattern: 原始Bayer图像的转换码（vision_cpp_ext.COLOR_Bayer**2GRAY），-1表示非Bayer
+        detector: 可选的 EdgeDetector（见 create_edge_detector），复用其缓冲区避免每帧分配
+        legacy_output: True 返回 (x, y, angle) 元组序列；False 返回 EDGE_DTYPE 结构化数组（无逐项Python对象）
         
     Returns:
         List of (x, y, angle) tuples representing edge points
@@ -56,15 +63,14 @@ def roi_edge_detection_cpp(image: np.ndarray,
     if not CPP_EXTENSION_AVAILABLE:
         raise RuntimeError("C++ extension not available")
     
-    # 转换为灰度图
-    if len(image.shape) == 3:
-        gray = cv2.cvtColor(image, cv2.COLOR_BGR2GRAY)
-    else:
-        gray = image
+    # 调用C++函数（灰度转换在C++端按ROI完成，无整帧拷贝）
+    if detector is not None:
+        return detector.detect(
+            image, roi_x, roi_y, roi_width, roi_height, threshold, min_line_length, bayer_pattern, legacy_output
+        )
     
-    # 调用C++函数
     edge_points = vision_cpp_ext.roi_edge_detection(
-        gray, roi_x, roi_y, roi_width, roi_height, threshold, min_line_length
+        image, roi_x, roi_y, roi_width, roi_height, threshold, min_line_length, bayer_pattern, legacy_output
     )
     
     return edge_points
@@ -73,18 +79,31 @@ def roi_edge_detection_cpp(image: np.ndarray,
 def template_matching_cpp(image: np.ndarray, template: np.ndarray,
                          method: int = cv2.TM_CCOEFF_NORMED, threshold: float = 0.8,
                          multiple_matches: bool = False,
-                         roi_x: int = 0, roi_y: int = 0, roi_width: int = 0, roi_height: int = 0) -> List[Tuple[int, int, float]]:
+                         roi_x: int = 0, roi_y: int = 0, roi_width: int = 0, roi_height: int = 0,
+                         pyramid_levels: int = 0, template_id: int = -1,
+                         bayer_pattern: int = -1, legacy_output: bool = True,
+                         nms_radius: int = -1, max_matches: int = 0):
     """
     使用C++扩展的模板匹配
     
     Args:
-        image: 输入图像
+        image: 输入图像（灰度/BGR/BGRA，可为切片等非连续数组，C++端仅转换ROI区域）
         template: 模板图像
         method: 匹配方法
         threshold: 匹配阈值
-        multiple_matches: 是否检测多个匹配
+        multiple_matches: 是否检测多个匹配（多匹配时使用非极大值抑制，仅返回局部极大值）
         roi_x, roi_y: ROI起始坐标
         roi_width, roi_height: ROI尺寸 (0表示全图)
+        pyramid_levels: 金字塔层数，>0时先在降采样图像上粗匹配再在原图局部精匹配
+        template_id: 模板金字塔缓存ID（>=0时缓存，按模板内容校验，内容变化时自动重建；最多缓存64个）
+        bayer_pattern: 原始Bayer图像的转换码（vision_cpp_ext.COLOR_Bayer**2GRAY），-1表示非Bayer
+        legacy_output: True 返回 (x, y, confidence) 元组序列；False 返回 MATCH_DTYPE 结构化数组
+        nms_radius: 多匹配抑制半径（像素），-1表示模板尺寸的一半，0表示不抑制（返回阈值以上的所有像素）
+        max_matches: 多匹配时最多返回的匹配数，0表示不限制
+
+    行为变更: 多匹配模式以前按行序返回阈值以上的所有像素，置信度为原始得分；现在默认只返回
+    抑制后的局部极大值，按置信度从高到低排列，SQDIFF 类方法的置信度为 1 - 得分（与单匹配一致，
+    阈值判定不变）。依赖旧结果的调用方需传 nms_radius=0，并对 SQDIFF 自行换算回原始得分。
         
     Returns:
         List of (x, y, confidence) tuples representing matches
@@ -92,26 +111,162 @@ def template_matching_cpp(image: np.ndarray, template: np.ndarray,
     if not CPP_EXTENSION_AVAILABLE:
         raise RuntimeError("C++ extension not available")
     
-    # 转换为灰度图
-    if len(image.shape) == 3:
-        gray = cv2.cvtColor(image, cv2.COLOR_BGR2GRAY)
-    else:
-        gray = image
-    
-    if len(template.shape) == 3:
-        template_gray = cv2.cvtColor(template, cv2.COLOR_BGR2GRAY)
-    else:
-        template_gray = template
+    # 调用C++函数（模板可为图像或已注册的 TemplateHandle）
+    if not isinstance(template, np.ndarray):
+        return vision_cpp_ext.template_matching(
+            image, template, method, threshold, multiple_matches,
+            roi_x, roi_y, roi_width, roi_height, pyramid_levels,
+            bayer_pattern=bayer_pattern, legacy_output=legacy_output,
+            nms_radius=nms_radius, max_matches=max_matches
+        )
     
-    # 调用C++函数
     matches = vision_cpp_ext.template_matching(
-        gray, template_gray, method, threshold, multiple_matches,
-        roi_x, roi_y, roi_width, roi_height
+        image, template, method, threshold, multiple_matches,
+        roi_x, roi_y, roi_width, roi_height, pyramid_levels, template_id, bayer_pattern, legacy_output,
+        nms_radius, max_matches
     )
     
     return matches
 
 
+def template_matching_peaks_cpp(image: np.ndarray, template: np.ndarray,
+                               method: int = cv2.TM_CCOEFF_NORMED, threshold: float = 0.8,
+                               roi_x: int = 0, roi_y: int = 0, roi_width: int = 0, roi_height: int = 0,
+                               nms_radius: int = -1, max_matches: int = 0,
+                               bayer_pattern: int = -1) -> np.ndarray:
+    """
+    使用C++扩展的多目标模板匹配（非极大值抑制，仅返回局部极大值）
+    
+    Args:
+        image: 输入图像
+        template: 模板图像
+        method: 匹配方法
+        threshold: 匹配阈值
+        roi_x, roi_y: ROI起始坐标
+        roi_width, roi_height: ROI尺寸 (0表示全图)
+        nms_radius: 抑制半径（像素），-1表示模板尺寸的一半
+        max_matches: 最多返回的匹配数，0表示不限制
+        bayer_pattern: 原始Bayer图像的转换码，-1表示非Bayer
+        
+    Returns:
+        结构化数组，字段为 (x, y, confidence)，按置信度降序排列
+    """
+    if not CPP_EXTENSION_AVAILABLE:
+        raise RuntimeError("C++ extension not available")
+    
+    return vision_cpp_ext.template_matching_peaks(
+        image, template, method, threshold,
+        roi_x, roi_y, roi_width, roi_height, nms_radius, max_matches, bayer_pattern
+    )
+
+
+def template_matching_batch_cpp(image: np.ndarray, templates: Sequence[np.ndarray],
+                               rois: Sequence[Tuple[int, int, int, int]],
+                               methods: Sequence[int], thresholds: Sequence[float],
+                               multiple_matches: bool = False,
+                               nms_radius: int = -1, max_matches: int = 0,
+                               bayer_pattern: int = -1) -> np.ndarray:
+    """
+    使用C++扩展的批量模板匹配（一帧图像，多个模板/ROI任务）
+    
+    Args:
+        image: 输入图像
+        templates: 模板图像列表
+        rois: 每个模板对应的ROI (x, y, width, height)，宽或高为0表示全图
+        methods: 每个模板的匹配方法（长度为1时对所有模板生效）
+        thresholds: 每个模板的匹配阈值（长度为1时对所有模板生效）
+        multiple_matches: 是否检测多个匹配（多匹配时使用非极大值抑制）
+        nms_radius: 抑制半径（像素），-1表示模板尺寸的一半
+        max_matches: 每个任务最多返回的匹配数，0表示不限制
+        bayer_pattern: 原始Bayer图像的转换码，-1表示非Bayer（彩色图像按任务ROI转换）
+        
+    Returns:
+        结构化数组，字段为 (job, x, y, confidence)
+    """
+    if not CPP_EXTENSION_AVAILABLE:
+        raise RuntimeError("C++ extension not available")
+    
+    return vision_cpp_ext.template_matching_batch(
+        image, list(templates), [tuple(r) for r in rois], list(methods), list(thresholds),
+        multiple_matches, nms_radius, max_matches, bayer_pattern
+    )
+
+
+def roi_edge_line_cpp(image: np.ndarray,
+                      roi_x: int, roi_y: int, roi_width: int, roi_height: int,
+                      direction: int = SCAN_DOWN, num_calipers: int = 16, caliper_width: int = 5,
+                      min_contrast: float = 10.0, polarity: int = 0, ransac_threshold: float = 1.5,
+                      bayer_pattern: int = -1, legacy_output: bool = True):
+    """
+    使用C++扩展的卡尺亚像素抓边 + 鲁棒直线拟合
+    
+    Args:
+        image: 输入图像
+        roi_x, roi_y: ROI起始坐标
+        roi_width, roi_height: ROI尺寸
+        direction: 扫描方向 SCAN_DOWN / SCAN_UP / SCAN_RIGHT / SCAN_LEFT
+        num_calipers: 卡尺数量（沿ROI均匀分布）
+        caliper_width: 每个卡尺的平均宽度（像素）
+        min_contrast: 最小边缘梯度
+        polarity: 1 暗到亮, -1 亮到暗（沿扫描方向）, 0 不限
+        ransac_threshold: RANSAC 内点距离阈值（像素）
+        bayer_pattern: 原始Bayer图像的转换码，-1表示非Bayer
+        legacy_output: False 时返回 EDGE_LINE_DTYPE 结构化数组（0或1条记录）
+        
+    Returns:
+        (x, y, angle, residual, inliers)：直线上距ROI中心最近的点、角度（度）、
+        内点RMS距离与内点数；边缘点不足时返回 None
+    """
+    if not CPP_EXTENSION_AVAILABLE:
+        raise RuntimeError("C++ extension not available")
+    
+    return vision_cpp_ext.roi_edge_line(
+        image, roi_x, roi_y, roi_width, roi_height, direction, num_calipers, caliper_width,
+        min_contrast, polarity, ransac_threshold, bayer_pattern, legacy_output
+    )
+
+
+def register_template(template: np.ndarray):
+    """
+    注册模板，返回可重复使用的 TemplateHandle（仅C++扩展支持）
+    
+    句柄持有模板副本及预计算数据（均值/范数、金字塔、频谱），
+    可直接代替模板图像传入 template_matching / template_matching_peaks / template_matching_batch。
+    """
+    if not CPP_EXTENSION_AVAILABLE:
+        raise RuntimeError("C++ extension not available")
+    
+    return vision_cpp_ext.register_template(template)
+
+
+def create_edge_detector(blur_ksize: int = 5, morph_ksize: int = 3):
+    """
+    创建可重复使用的 EdgeDetector（仅C++扩展支持）
+    
+    检测器缓存形态学核，并为每个调用线程保留随最大ROI增长的缓冲区，
+    稳态下每次调用不再分配内存。可传给 roi_edge_detection_cpp 的 detector 参数。
+    """
+    if not CPP_EXTENSION_AVAILABLE:
+        raise RuntimeError("C++ extension not available")
+    
+    return vision_cpp_ext.EdgeDetector(blur_ksize, morph_ksize)
+
+
+
+def create_vision_pipeline(capacity: int = 4, result_capacity: int = 16, bayer_pattern: int = -1,
+                           legacy_output: bool = True):
+    """
+    创建异步视觉流水线 VisionPipeline（仅C++扩展支持）
+    
+    帧经有界SPSC环形缓冲交给工作线程，按配置的阶段（抓边 / 卡尺直线 / 模板匹配）处理，
+    结果通过 set_callback 回调或 poll() 取得。需先添加阶段再调用 start()。
+    legacy_output=False 时各阶段结果为结构化数组。
+    """
+    if not CPP_EXTENSION_AVAILABLE:
+        raise RuntimeError("C++ extension not available")
+    
+    return vision_cpp_ext.VisionPipeline(capacity, result_capacity, bayer_pattern, legacy_output)
+
 # Python实现的备选方案
 def roi_edge_detection_py(image: np.ndarray, 
                          roi_x: int, roi_y: int, roi_width: int, roi_height: int,
@@ -172,10 +327,17 @@ def roi_edge_detection_py(image: np.ndarray,
 def template_matching_py(image: np.ndarray, template: np.ndarray,
                         method: int = cv2.TM_CCOEFF_NORMED, threshold: float = 0.8,
                         multiple_matches: bool = False,
-                        roi_x: int = 0, roi_y: int = 0, roi_width: int = 0, roi_height: int = 0) -> List[Tuple[int, int, float]]:
+                        roi_x: int = 0, roi_y: int = 0, roi_width: int = 0, roi_height: int = 0,
+                        nms_radius: int = -1, max_matches: int = 0) -> List[Tuple[int, int, float]]:
     """
     Python实现的模板匹配（备选方案）
     """
+    if multiple_matches:
+        # 与C++扩展一致: 多匹配只返回非极大值抑制后的局部极大值
+        peaks = template_matching_peaks_py(image, template, method, threshold,
+                                           roi_x, roi_y, roi_width, roi_height, nms_radius, max_matches)
+        return [(int(p['x']), int(p['y']), float(p['confidence'])) for p in peaks]
+    
     # 处理ROI
     h, w = image.shape[:2]
     if roi_width == 0 or roi_height == 0:
@@ -209,37 +371,183 @@ def template_matching_py(image: np.ndarray, template: np.ndarray,
     matches = []
     template_h, template_w = template_gray.shape
     
-    if multiple_matches:
-        # 多匹配检测
-        locations = np.where(result_matrix >= threshold)
-        for pt in zip(*locations[::-1]):
-            # 调整坐标到原图坐标系
-            abs_x = pt[0] + roi_x
-            abs_y = pt[1] + roi_y
-            
-            confidence = result_matrix[pt[1], pt[0]]
-            matches.append((abs_x, abs_y, confidence))
+    # 单一最佳匹配
+    min_val, max_val, min_loc, max_loc = cv2.minMaxLoc(result_matrix)
+    
+    if method in [cv2.TM_SQDIFF, cv2.TM_SQDIFF_NORMED]:
+        match_loc = min_loc
+        confidence = 1 - min_val
     else:
-        # 单一最佳匹配
-        min_val, max_val, min_loc, max_loc = cv2.minMaxLoc(result_matrix)
-        
-        if method in [cv2.TM_SQDIFF, cv2.TM_SQDIFF_NORMED]:
-            match_loc = min_loc
-            confidence = 1 - min_val
-        else:
-            match_loc = max_loc
-            confidence = max_val
+        match_loc = max_loc
+        confidence = max_val
+    
+    if confidence >= threshold:
+        # 调整坐标到原图坐标系
+        abs_x = match_loc[0] + roi_x
+        abs_y = match_loc[1] + roi_y
         
-        if confidence >= threshold:
-            # 调整坐标到原图坐标系
-            abs_x = match_loc[0] + roi_x
-            abs_y = match_loc[1] + roi_y
-            
-            matches.append((abs_x, abs_y, confidence))
+        matches.append((abs_x, abs_y, confidence))
     
     return matches
 
 
+def roi_edge_line_py(image: np.ndarray,
+                     roi_x: int, roi_y: int, roi_width: int, roi_height: int,
+                     direction: int = SCAN_DOWN, num_calipers: int = 16, caliper_width: int = 5,
+                     min_contrast: float = 10.0, polarity: int = 0,
+                     ransac_threshold: float = 1.5) -> Optional[Tuple[float, float, float, float, int]]:
+    """
+    Python实现的卡尺抓边直线拟合（备选方案，最小二乘 + 离群点剔除）
+    """
+    h, w = image.shape[:2]
+    roi_x = max(0, min(roi_x, w - 1))
+    roi_y = max(0, min(roi_y, h - 1))
+    roi_width = min(roi_width, w - roi_x)
+    roi_height = min(roi_height, h - roi_y)
+    
+    roi_image = image[roi_y:roi_y+roi_height, roi_x:roi_x+roi_width]
+    gray = cv2.cvtColor(roi_image, cv2.COLOR_BGR2GRAY) if len(roi_image.shape) == 3 else roi_image
+    gray = gray.astype(np.float32)
+    
+    vertical_scan = direction in (SCAN_DOWN, SCAN_UP)
+    reverse = direction in (SCAN_UP, SCAN_LEFT)
+    if not vertical_scan:
+        gray = gray.T
+    if reverse:
+        gray = gray[::-1]
+    along, across = gray.shape
+    caliper_width = max(1, min(caliper_width, across))
+    num_calipers = max(2, min(num_calipers, across))
+    
+    points = []
+    for k in range(num_calipers):
+        centre = (k + 0.5) * across / num_calipers
+        c0 = int(max(0, min(across - caliper_width, round(centre - 0.5 * caliper_width))))
+        profile = gray[:, c0:c0 + caliper_width].mean(axis=1)
+        if len(profile) < 5:
+            continue
+        grad = np.zeros_like(profile)
+        grad[2:-2] = (profile[4:] + 2 * profile[3:-1] - 2 * profile[1:-3] - profile[:-4]) * 0.125
+        score = grad if polarity > 0 else (-grad if polarity < 0 else np.abs(grad))
+        i = int(np.argmax(score[2:-2])) + 2
+        if score[i] < min_contrast:
+            continue
+        # 抛物线拟合用按该边缘极性取符号的梯度，避免相邻反向边缘拉偏顶点
+        sign = 1.0 if polarity > 0 else (-1.0 if polarity < 0 else (1.0 if grad[i] >= 0 else -1.0))
+        g0, g1, g2 = sign * grad[i - 1:i + 2]
+        denom = g0 - 2 * g1 + g2
+        pos = i + (float(np.clip(0.5 * (g0 - g2) / denom, -0.5, 0.5)) if denom < 0 else 0.0)
+        if reverse:
+            pos = along - 1 - pos
+        mid = c0 + 0.5 * (caliper_width - 1)
+        points.append((roi_x + mid, roi_y + pos) if vertical_scan else (roi_x + pos, roi_y + mid))
+    
+    if len(points) < 2:
+        return None
+    
+    pts = np.array(points, dtype=np.float64)
+    inliers = np.ones(len(pts), dtype=bool)
+    for _ in range(2):
+        centre = pts[inliers].mean(axis=0)
+        _, _, vt = np.linalg.svd(pts[inliers] - centre)
+        normal = np.array([-vt[0][1], vt[0][0]])
+        keep = np.abs((pts - centre) @ normal) <= ransac_threshold
+        if np.count_nonzero(keep) < 2:
+            break
+        inliers = keep
+    
+    centre = pts[inliers].mean(axis=0)
+    _, _, vt = np.linalg.svd(pts[inliers] - centre)
+    dx, dy = vt[0]
+    if dx < 0 or (dx == 0 and dy < 0):
+        dx, dy = -dx, -dy
+    residual = float(np.sqrt(np.mean(((pts[inliers] - centre) @ np.array([-dy, dx])) ** 2)))
+    
+    roi_centre = np.array([roi_x + 0.5 * (roi_width - 1), roi_y + 0.5 * (roi_height - 1)])
+    t = float((roi_centre - centre) @ np.array([dx, dy]))
+    return (float(centre[0] + t * dx), float(centre[1] + t * dy),
+            float(np.degrees(np.arctan2(dy, dx))), residual, int(np.count_nonzero(inliers)))
+
+
+# C++扩展结构化结果的dtype（legacy_output=False）
+EDGE_DTYPE = np.dtype([('x', np.float32), ('y', np.float32), ('angle', np.float32)])
+EDGE_LINE_DTYPE = np.dtype([('x', np.float32), ('y', np.float32), ('angle', np.float32),
+                            ('residual', np.float32), ('inliers', np.int32), ('points', np.int32)])
+MATCH_DTYPE = np.dtype([('x', np.int32), ('y', np.int32), ('confidence', np.float32)])
+
+
+def template_matching_peaks_py(image: np.ndarray, template: np.ndarray,
+                              method: int = cv2.TM_CCOEFF_NORMED, threshold: float = 0.8,
+                              roi_x: int = 0, roi_y: int = 0, roi_width: int = 0, roi_height: int = 0,
+                              nms_radius: int = -1, max_matches: int = 0) -> np.ndarray:
+    """
+    Python实现的多目标模板匹配（备选方案）
+    """
+    h, w = image.shape[:2]
+    if roi_width <= 0 or roi_height <= 0:
+        roi_x, roi_y = 0, 0
+        roi_width, roi_height = w, h
+    else:
+        roi_x = max(0, min(roi_x, w - 1))
+        roi_y = max(0, min(roi_y, h - 1))
+        roi_width = min(roi_width, w - roi_x)
+        roi_height = min(roi_height, h - roi_y)
+    
+    roi_image = image[roi_y:roi_y+roi_height, roi_x:roi_x+roi_width]
+    gray = cv2.cvtColor(roi_image, cv2.COLOR_BGR2GRAY) if len(roi_image.shape) == 3 else roi_image
+    template_gray = cv2.cvtColor(template, cv2.COLOR_BGR2GRAY) if len(template.shape) == 3 else template
+    
+    result = cv2.matchTemplate(gray, template_gray, method)
+    score = 1.0 - result if method in [cv2.TM_SQDIFF, cv2.TM_SQDIFF_NORMED] else result
+    
+    if nms_radius < 0:
+        nms_radius = max(1, min(template_gray.shape[:2]) // 2)
+    
+    mask = score >= threshold
+    if nms_radius > 0:
+        kernel = np.ones((2 * nms_radius + 1, 2 * nms_radius + 1), np.uint8)
+        mask &= score >= cv2.dilate(score, kernel)
+    
+    ys, xs = np.nonzero(mask)
+    order = np.lexsort((xs, ys, -score[ys, xs]))
+    
+    peaks = []
+    for i in order:
+        if max_matches > 0 and len(peaks) >= max_matches:
+            break
+        x, y = int(xs[i]), int(ys[i])
+        if any(abs(px - x) <= nms_radius and abs(py - y) <= nms_radius for px, py, _ in peaks):
+            continue
+        peaks.append((x, y, float(score[y, x])))
+    
+    return np.array([(x + roi_x, y + roi_y, c) for x, y, c in peaks], dtype=MATCH_DTYPE)
+
+
+BATCH_MATCH_DTYPE = np.dtype([('job', np.int32), ('x', np.int32), ('y', np.int32), ('confidence', np.float32)])
+
+
+def template_matching_batch_py(image: np.ndarray, templates: Sequence[np.ndarray],
+                              rois: Sequence[Tuple[int, int, int, int]],
+                              methods: Sequence[int], thresholds: Sequence[float],
+                              multiple_matches: bool = False,
+                              nms_radius: int = -1, max_matches: int = 0) -> np.ndarray:
+    """
+    Python实现的批量模板匹配（备选方案）
+    """
+    records = []
+    for job, (template, roi) in enumerate(zip(templates, rois)):
+        method = methods[0] if len(methods) == 1 else methods[job]
+        threshold = thresholds[0] if len(thresholds) == 1 else thresholds[job]
+        if multiple_matches:
+            matches = template_matching_peaks_py(image, template, method, threshold, *roi, nms_radius, max_matches)
+        else:
+            matches = template_matching_py(image, template, method, threshold, False, *roi)
+        for x, y, confidence in matches:
+            records.append((job, x, y, confidence))
+    
+    return np.array(records, dtype=BATCH_MATCH_DTYPE)
+
+
 # 统一接口函数
 def roi_edge_detection(image: np.ndarray, 
                       roi_x: int, roi_y: int, roi_width: int, roi_height: int,
@@ -253,14 +561,67 @@ def roi_edge_detection(image: np.ndarray,
         return roi_edge_detection_py(image, roi_x, roi_y, roi_width, roi_height, threshold, min_line_length)
 
 
+def roi_edge_line(image: np.ndarray,
+                  roi_x: int, roi_y: int, roi_width: int, roi_height: int,
+                  direction: int = SCAN_DOWN, num_calipers: int = 16, caliper_width: int = 5,
+                  min_contrast: float = 10.0, polarity: int = 0, ransac_threshold: float = 1.5):
+    """
+    卡尺抓边直线拟合统一接口
+    """
+    if CPP_EXTENSION_AVAILABLE:
+        return roi_edge_line_cpp(image, roi_x, roi_y, roi_width, roi_height, direction, num_calipers,
+                                 caliper_width, min_contrast, polarity, ransac_threshold)
+    else:
+        return roi_edge_line_py(image, roi_x, roi_y, roi_width, roi_height, direction, num_calipers,
+                                caliper_width, min_contrast, polarity, ransac_threshold)
+
+
 def template_matching(image: np.ndarray, template: np.ndarray,
                      method: int = cv2.TM_CCOEFF_NORMED, threshold: float = 0.8,
                      multiple_matches: bool = False,
-                     roi_x: int = 0, roi_y: int = 0, roi_width: int = 0, roi_height: int = 0):
+                     roi_x: int = 0, roi_y: int = 0, roi_width: int = 0, roi_height: int = 0,
+                     pyramid_levels: int = 0, template_id: int = -1,
+                     nms_radius: int = -1, max_matches: int = 0):
+    """
+    模板匹配统一接口（pyramid_levels/template_id 仅C++扩展支持）
+
+    多匹配模式默认返回非极大值抑制后的局部极大值，不再是阈值以上的所有像素，
+    参数与行为变更见 template_matching_cpp
+    """
+    if CPP_EXTENSION_AVAILABLE:
+        return template_matching_cpp(image, template, method, threshold, multiple_matches, roi_x, roi_y, roi_width, roi_height,
+                                     pyramid_levels, template_id, nms_radius=nms_radius, max_matches=max_matches)
+    else:
+        return template_matching_py(image, template, method, threshold, multiple_matches, roi_x, roi_y, roi_width, roi_height,
+                                    nms_radius, max_matches)
+
+
+def template_matching_peaks(image: np.ndarray, template: np.ndarray,
+                            method: int = cv2.TM_CCOEFF_NORMED, threshold: float = 0.8,
+                            roi_x: int = 0, roi_y: int = 0, roi_width: int = 0, roi_height: int = 0,
+                            nms_radius: int = -1, max_matches: int = 0) -> np.ndarray:
+    """
+    多目标模板匹配统一接口（非极大值抑制）
+    """
+    if CPP_EXTENSION_AVAILABLE:
+        return template_matching_peaks_cpp(image, template, method, threshold,
+                                           roi_x, roi_y, roi_width, roi_height, nms_radius, max_matches)
+    else:
+        return template_matching_peaks_py(image, template, method, threshold,
+                                          roi_x, roi_y, roi_width, roi_height, nms_radius, max_matches)
+
+
+def template_matching_batch(image: np.ndarray, templates: Sequence[np.ndarray],
+                            rois: Sequence[Tuple[int, int, int, int]],
+                            methods: Sequence[int], thresholds: Sequence[float],
+                            multiple_matches: bool = False,
+                            nms_radius: int = -1, max_matches: int = 0) -> np.ndarray:
     """
-    模板匹配统一接口
+    批量模板匹配统一接口
     """
     if CPP_EXTENSION_AVAILABLE:
-        return template_matching_cpp(image, template, method, threshold, multiple_matches, roi_x, roi_y, roi_width, roi_height)
+        return template_matching_batch_cpp(image, templates, rois, methods, thresholds,
+                                           multiple_matches, nms_radius, max_matches)
     else:
-        return template_matching_py(image, template, method, threshold, multiple_matches, roi_x, roi_y, roi_width, roi_height)
\ No newline at end of file
+        return template_matching_batch_py(image, templates, rois, methods, thresholds,
+                                          multiple_matches, nms_radius, max_matches)
@@ -1,10 +1,14 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/functional.h>
 #include <pybind11/stl.h>
-#include <Elite/DashboardClient.hpp>
-#include <Elite/PrimaryPortInterface.hpp>
-#include <Elite/RtsiIOInterface.hpp>
-#include <Elite/DataType.hpp>
+#include <pybind11/numpy.h>
+#include "EliteRobotController.hpp"
+#include "CalibrationLog.hpp"
+#include "PoseMath.hpp"
+#include "PerfStats.hpp"
+#include "EliteControllerBindings.hpp"
+#include "PerfStatsBindings.hpp"
+#include "VisualServoBindings.hpp"
 #include <iostream>
 #include <fstream>
 #include <thread>
@@ -14,298 +18,219 @@
 #include <sstream>
 #include <iomanip>
 #include <array>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <queue>
+#include <mutex>
 
 namespace py = pybind11;
 using namespace ELITE;
-
-// ==========================================
-// Minimal 3D Math Helpers for Rotation Logic
-// ==========================================
-struct Vec3
-{
-    double x, y, z;
-    Vec3 operator+(const Vec3 &o) const { return {x + o.x, y + o.y, z + o.z}; }
-    Vec3 operator-(const Vec3 &o) const { return {x - o.x, y - o.y, z - o.z}; }
-    Vec3 operator*(double s) const { return {x * s, y * s, z * s}; }
-    double dot(const Vec3 &o) const { return x * o.x + y * o.y + z * o.z; }
-    Vec3 cross(const Vec3 &o) const { return {y * o.z - z * o.y, z * o.x - x * o.z, x * o.y - y * o.x}; }
-    double length() const { return std::sqrt(x * x + y * y + z * z); }
-    Vec3 normalize() const
-    {
-        double l = length();
-        if (l < 1e-9)
-            return {0, 0, 1};
-        return {x / l, y / l, z / l};
-    }
-};
-
-// Convert Rotation Matrix (column major or orthonormal vectors) to Axis-Angle Vector (Rx, Ry, Rz)
-// R = [Xx Yx Zx]
-//     [Xy Yy Zy]
-//     [Xz Yz Zz]
-std::vector<double> matrixToRotVec(const Vec3 &X, const Vec3 &Y, const Vec3 &Z)
-{
-    // Rotation Matrix elements
-    double r11 = X.x, r12 = Y.x, r13 = Z.x;
-    double r21 = X.y, r22 = Y.y, r23 = Z.y;
-    double r31 = X.z, r32 = Y.z, r33 = Z.z;
-
-    double trace = r11 + r22 + r33;
-    double theta = 0.0;
-    Vec3 axis = {0, 0, 0};
-
-    if (trace >= 3.0 - 1e-6)
-    {
-        // Identity
-        return {0, 0, 0};
-    }
-    else if (trace <= -1.0 + 1e-6)
-    {
-        // 180 degree rotation singularity
-        theta = 3.141592653589793;
-        if (r11 > r22 && r11 > r33)
-            axis = {std::sqrt((r11 + 1) / 2), (r12 + r21) / (2 * std::sqrt((r11 + 1) / 2)), (r13 + r31) / (2 * std::sqrt((r11 + 1) / 2))};
-        else if (r22 > r33)
-            axis = {(r12 + r21) / (2 * std::sqrt((r22 + 1) / 2)), std::sqrt((r22 + 1) / 2), (r23 + r32) / (2 * std::sqrt((r22 + 1) / 2))};
-        else
-            axis = {(r13 + r31) / (2 * std::sqrt((r33 + 1) / 2)), (r23 + r32) / (2 * std::sqrt((r33 + 1) / 2)), std::sqrt((r33 + 1) / 2)};
-    }
-    else
-    {
-        theta = std::acos((trace - 1.0) / 2.0);
-        double s = 2.0 * std::sin(theta);
-        axis.x = (r32 - r23) / s;
-        axis.y = (r13 - r31) / s;
-        axis.z = (r21 - r12) / s;
-    }
-
-    axis = axis.normalize();
-    return {axis.x * theta, axis.y * theta, axis.z * theta};
-}
-
-// Convert Axis-Angle (Rx, Ry, Rz) to Matrix (X, Y, Z vectors)
-void rotVecToMatrix(double rx, double ry, double rz, Vec3 &X, Vec3 &Y, Vec3 &Z)
-{
-    double theta = std::sqrt(rx * rx + ry * ry + rz * rz);
-    if (theta < 1e-6)
-    {
-        X = {1, 0, 0};
-        Y = {0, 1, 0};
-        Z = {0, 0, 1};
-        return;
-    }
-
-    double kx = rx / theta;
-    double ky = ry / theta;
-    double kz = rz / theta;
-
-    double c = std::cos(theta);
-    double s = std::sin(theta);
-    double v = 1 - c;
-
-    X = {kx * kx * v + c, kx * ky * v - kz * s, kx * kz * v + ky * s};
-    Y = {kx * ky * v + kz * s, ky * ky * v + c, ky * kz * v - kx * s};
-    Z = {kx * kz * v - ky * s, ky * kz * v + kx * s, kz * kz * v + c};
-}
-// ==========================================
+using namespace ELITE_EXTENSION;
 
 // 9-Point Grid Configuration
 const double GRID_STEP = 0.05; // 50mm spacing
 const double MOVE_SPEED = 0.2; // m/s
 const double MOVE_ACCEL = 0.5; // m/s^2
 
-// Unified Robot Interface Class
-class EliteRobotController
+// Per-point binary logs written by the calibration runs (see CalibrationLog.hpp);
+// calibration_log_tool.py exports them to the old CSV format
+const char *const CALIB_GRID_LOG_PATH = "workspace/calibration_data.calib";
+const char *const CALIB_3D_LOG_PATH = "workspace/calibration_3d_data.calib";
+
+// Trajectory mode capture handshake (boolean register 0 in both directions)
+// robot: output 1 = stopped at capture point; host: input 1 = capture done
+const int CAPTURE_READY_REGISTER = 0;
+const int CAPTURE_ACK_REGISTER = 0;
+const double MIN_BLEND_RADIUS = 0.001; // m, smaller blends are sent as exact stops
+const double BLEND_SEGMENT_FRACTION = 0.4; // blends are clamped to this fraction of the shorter adjacent segment
+
+// RobotFleet synchronized start handshake (boolean register 1 in both directions)
+// robot: output 1 = script loaded and waiting; host: input 1 = go
+const int FLEET_READY_REGISTER = 1;
+const int FLEET_START_REGISTER = 1;
+
+// One waypoint of a compiled path. Capture waypoints always stop exactly.
+struct PathWaypoint
 {
-private:
-    std::string robot_ip;
-    std::unique_ptr<DashboardClient> dashboard;
-    std::unique_ptr<PrimaryPortInterface> primary;
-    std::unique_ptr<RtsiIOInterface> rtsi;
-    bool is_connected = false;
-    double global_speed = 0.5; // 0.0 - 1.0
+    vector6d_t pose; // m, rad
+    bool capture = false;
+    double speed = MOVE_SPEED;
+};
 
+// Pose `distance` (m) back from `to` along the line towards `from`, at most halfway, with
+// the orientation of `to`
+static vector6d_t approachPose(const vector6d_t &from, const vector6d_t &to, double distance)
+{
+    double len = 0;
+    for (int k = 0; k < 3; ++k)
+        len += std::pow(from[k] - to[k], 2);
+    len = std::sqrt(len);
+    vector6d_t p = to;
+    if (len <= 0.0)
+        return p;
+    const double t = std::min(distance, 0.5 * len) / len;
+    for (int k = 0; k < 3; ++k)
+        p[k] += (from[k] - to[k]) * t;
+    return p;
+}
+
+class EliteCalibration
+{
 public:
-    EliteRobotController() {}
+    EliteCalibration() {}
+    EliteRobotController controller; // Reuse the controller logic if needed or keep separate
 
-    ~EliteRobotController()
+    // Helper: Convert vector to string for script
+    std::string vecToString(const vector6d_t &vec)
     {
-        disconnect();
+        std::stringstream ss;
+        ss << "[";
+        for (int i = 0; i < 6; ++i)
+        {
+            ss << vec[i] << (i < 5 ? "," : "");
+        }
+        ss << "]";
+        return ss.str();
     }
 
-    // 1. Connection Management
-    bool connect(const std::string &ip, const std::string &recipe_dir)
+    // Compile waypoints into one script program. Non-capture waypoints are blended with up to
+    // blend_radius (m), clamped to BLEND_SEGMENT_FRACTION of the shorter adjacent segment so blends
+    // never overlap.
+    // Each capture waypoint stops, raises CAPTURE_READY_REGISTER and waits for the host's
+    // CAPTURE_ACK_REGISTER pulse before moving on.
+    std::string compilePathScript(const std::vector<PathWaypoint> &path, double blend_radius, double accel)
     {
-        robot_ip = ip;
-        // Construct paths for recipe files
-        std::string out_recipe = recipe_dir + "/output_recipe.txt";
-        std::string in_recipe = recipe_dir + "/input_recipe.txt";
+        auto seg_len = [&](size_t a, size_t b)
+        {
+            double d = 0;
+            for (int k = 0; k < 3; ++k)
+                d += std::pow(path[a].pose[k] - path[b].pose[k], 2);
+            return std::sqrt(d);
+        };
 
-        try
+        std::stringstream ss;
+        ss << "def calib_path():\n";
+        ss << "  write_output_boolean_register(" << CAPTURE_READY_REGISTER << ", False)\n";
+        for (size_t i = 0; i < path.size(); ++i)
         {
-            dashboard = std::make_unique<DashboardClient>();
-            primary = std::make_unique<PrimaryPortInterface>();
-            // Update rtsi to use the correct recipe paths if needed, here assuming files exist
-            rtsi = std::make_unique<RtsiIOInterface>(out_recipe, in_recipe, 250);
+            double r = 0.0;
+            // First and last waypoints have only one known neighbour, stop there
+            if (!path[i].capture && i > 0 && i + 1 < path.size())
+            {
+                r = std::min(blend_radius, BLEND_SEGMENT_FRACTION * std::min(seg_len(i - 1, i), seg_len(i, i + 1)));
+                if (r < MIN_BLEND_RADIUS)
+                    r = 0.0;
+            }
 
-            bool db_ok = dashboard->connect(ip);
-            bool pri_ok = primary->connect(ip);
-            bool rtsi_ok = rtsi->connect(ip);
+            ss << "  movel(" << vecToString(path[i].pose) << ", a=" << accel << ", v=" << path[i].speed << ", r=" << r << ")\n";
 
-            if (db_ok && pri_ok)
-            { // RTSI might be optional or retryable
-                is_connected = true;
-                // Init Robot
-                dashboard->powerOn();
-                std::this_thread::sleep_for(std::chrono::seconds(2));
-                dashboard->brakeRelease();
-                return true;
+            if (path[i].capture)
+            {
+                ss << "  write_output_boolean_register(" << CAPTURE_READY_REGISTER << ", True)\n"
+                   << "  while not read_input_boolean_register(" << CAPTURE_ACK_REGISTER << "):\n"
+                   << "    sync()\n"
+                   << "  end\n"
+                   << "  write_output_boolean_register(" << CAPTURE_READY_REGISTER << ", False)\n"
+                   << "  while read_input_boolean_register(" << CAPTURE_ACK_REGISTER << "):\n"
+                   << "    sync()\n"
+                   << "  end\n";
             }
         }
-        catch (...)
-        {
-            return false;
-        }
-        return false;
+        ss << "end\n";
+        return ss.str();
     }
 
-    void disconnect()
+    // Use a connected controller's RTSI cache for pose reads and arrival detection instead of
+    // polling get_pose_callback. Pass nullptr to go back to the callback.
+    void setStateSource(EliteRobotController *source)
     {
-        if (primary)
-            primary->disconnect();
-        if (rtsi)
-            rtsi->disconnect();
-        if (dashboard)
-            dashboard->disconnect();
-        is_connected = false;
+        state_source = source;
     }
 
-    bool isConnected() const { return is_connected; }
-
-    // 2. State & Position
-    // Returns [x, y, z, rx, ry, rz] in mm and degrees
-    std::vector<double> getPosition()
+    // Wait until target is reached. Uses the RTSI cache when a state source is attached,
+    // otherwise polls the pose callback every 100 ms.
+    bool waitForArrival(const vector6d_t &target, double pos_tol, double rot_tol, double timeout_s,
+                        const std::function<vector6d_t()> &get_pose)
     {
-        if (!rtsi || !rtsi->isConnected())
-            return {};
+        if (hasStateSource())
+            return state_source->waitForMotionDone(target, pos_tol, rot_tol, timeout_s);
 
-        auto pose = rtsi->getActualTCPPose(); // Returns m, rad
-        if (pose.size() < 6)
-            return {};
+        int ticks = static_cast<int>(timeout_s * 10.0);
+        while (ticks > 0)
+        {
+            vector6d_t cur = get_pose();
+            double dist_sq = 0;
+            for (int k = 0; k < 3; ++k)
+                dist_sq += std::pow(cur[k] - target[k], 2);
+            double rot_sq = 0;
+            for (int k = 3; k < 6; ++k)
+                rot_sq += std::pow(cur[k] - target[k], 2);
+
+            if (std::sqrt(dist_sq) < pos_tol && (rot_tol < 0 || std::sqrt(rot_sq) < rot_tol))
+                return true;
 
-        std::vector<double> ret(6);
-        ret[0] = pose[0] * 1000.0; // m -> mm
-        ret[1] = pose[1] * 1000.0;
-        ret[2] = pose[2] * 1000.0;
-        ret[3] = pose[3] * 57.29578; // rad -> deg
-        ret[4] = pose[4] * 57.29578;
-        ret[5] = pose[5] * 57.29578;
-        return ret;
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            ticks--;
+        }
+        return false;
     }
 
-    std::string getRobotState()
+    // Settle thresholds in SI units, see SettleConfig
+    void setSettleConfig(const SettleConfig &cfg)
     {
-        if (!dashboard)
-            return "Unknown";
-        // This is a simplification; authentic state would query robot status
-        return is_connected ? "Connected" : "Disconnected";
+        settle_config = cfg;
     }
 
-    // 3. Motion Control
-    void setSpeed(double percent)
+    // Measured settle time (s) of every captured point of the last run
+    std::vector<double> getSettleTimes() const
     {
-        global_speed = std::max(0.01, std::min(1.0, percent / 100.0));
-        // Also send speed command to dashboard if supported
-        if (dashboard)
-        {
-            dashboard->setSpeedScaling((int)percent);
-        }
+        return settle_times;
     }
 
-    // Jog: axis (0=X, 1=Y...), direction (+1/-1), distance (mm)
-    bool jog(int axis, int direction, double distance_mm)
+    // Image reference stored with the point being captured; meant to be called from the capture callback
+    void setCaptureImage(const std::string &path)
     {
-        if (!is_connected || !primary)
-            return false;
-
-        // Current Pose
-        auto current_pose = rtsi->getActualTCPPose();
-        if (current_pose.size() < 6)
-            return false;
-
-        // Calculate Target in Base Frame (Simplified logic)
-        // Note: Real jogging might need 'pose_trans' or 'pose_add' based on tool/base frame
-        // Here we assume Base Frame jogging for simplicity or use script command
-
-        double dist_m = distance_mm / 1000.0;
-        double speed_val = global_speed;
-
-        // Generating Script
-        // movel(pose_add(get_actual_tcp_pose(), p[dx, dy, dz, 0, 0, 0]), ...)
-
-        double offsets[6] = {0, 0, 0, 0, 0, 0};
-        if (axis >= 0 && axis < 3)
-        {
-            offsets[axis] = direction * dist_m;
-        }
-
-        std::stringstream ss;
-        ss << "movel(pose_add(get_actual_tcp_pose(), [";
-        for (int i = 0; i < 6; ++i)
-            ss << offsets[i] << (i < 5 ? "," : "");
-        ss << "]), a=0.5, v=" << speed_val << ")";
-
-        return primary->sendScript(ss.str());
+        std::lock_guard<std::mutex> lock(capture_image_mutex);
+        capture_image = path;
     }
 
-    // MoveTo: x,y,z (mm), rx,ry,rz (deg)
-    bool moveTo(double x, double y, double z, double rx, double ry, double rz)
+    // Binary log of the last run, empty before the first run
+    std::string getLogPath() const
     {
-        if (!is_connected || !primary)
-            return false;
-
-        std::stringstream ss;
-        // Use list [...] instead of p[...] to avoid builtin_function subscript error
-        ss << "movel(["
-           << x / 1000.0 << "," << y / 1000.0 << "," << z / 1000.0 << ","
-           << rx / 57.29578 << "," << ry / 57.29578 << "," << rz / 57.29578
-           << "], a=0.5, v=" << global_speed << ")";
-
-        return primary->sendScript(ss.str());
+        return log_path;
     }
 
-    bool stop()
+    // Wait for the robot to settle before a capture. max_wait_ms is the old fixed delay and
+    // stays the upper bound; without an RTSI source, or when arrival at the capture pose was not
+    // confirmed (the arm may still stand at the previous pose and look settled), it is simply slept.
+    double waitForSettle(int max_wait_ms, bool arrived = true)
     {
-        if (!primary)
-            return false;
-        return primary->sendScript("stopj(2.0)");
+        double max_wait_s = max_wait_ms / 1000.0;
+        double settle_time_s = max_wait_s;
+        if (settle_config.enabled && arrived && hasStateSource())
+            state_source->waitForSettle(settle_config, max_wait_s, settle_time_s);
+        else
+            std::this_thread::sleep_for(std::chrono::milliseconds(max_wait_ms));
+        settle_times.push_back(settle_time_s);
+        return settle_time_s;
     }
 
-    // 4. Calibration (Example)
-    bool runCalibrationStep(int point_id)
+    // Wait for arrival at a capture pose just commanded, then for the arm to settle there.
+    // Settle detection starts only after arrival at this target is confirmed. Returns arrived.
+    bool waitForCapturePose(const vector6d_t &target, double pos_tol, double rot_tol, double timeout_s,
+                            int max_settle_ms, const std::function<vector6d_t()> &get_pose, double &settle_s)
     {
-        // Logic for moving to calibration point 'point_id'
-        return true;
+        bool arrived = waitForArrival(target, pos_tol, rot_tol, timeout_s, get_pose);
+        settle_s = waitForSettle(max_settle_ms, arrived);
+        return arrived;
     }
-};
 
-class EliteCalibration
-{
-public:
-    EliteCalibration() {}
-    EliteRobotController controller; // Reuse the controller logic if needed or keep separate
-
-    // Helper: Convert vector to string for script
-    std::string vecToString(const vector6d_t &vec)
+    // True once the attached controller has published a sample
+    bool hasStateSource() const
     {
-        std::stringstream ss;
-        ss << "[";
-        for (int i = 0; i < 6; ++i)
-        {
-            ss << vec[i] << (i < 5 ? "," : "");
-        }
-        ss << "]";
-        return ss.str();
+        return state_source && state_source->getStateSnapshot().valid();
     }
 
     bool connect(const std::string &ip, const std::string &recipe_dir)
@@ -354,6 +279,8 @@ public:
         // Helper to get current pose in Meters/Radians from Python
         auto get_current_pose_m_rad = [&]() -> vector6d_t
         {
+            if (hasStateSource())
+                return state_source->getStateSnapshot().tcp_pose;
             if (!get_pose_callback)
                 return {0, 0, 0, 0, 0, 0};
 
@@ -386,7 +313,7 @@ public:
         }
 
         log("[C++] Starting 9-Point Calibration (YOZ Plane, Lens X+)...");
-        log("Using External Pose Data from Python (RTSI Bypass)");
+        log(hasStateSource() ? "Using RTSI State Cache" : "Using External Pose Data from Python (RTSI Bypass)");
 
         // Get center point (Current Pose)
         vector6d_t center_pose = get_current_pose_m_rad();
@@ -395,7 +322,7 @@ public:
         double cz = center_pose[2];
 
         std::vector<vector6d_t> points;
-        std::vector<std::string> data_lines;
+        settle_times.clear();
 
         std::vector<double> steps = {-GRID_STEP, 0, GRID_STEP};
 
@@ -410,6 +337,10 @@ public:
             }
         }
 
+        std::stringstream desc_ss;
+        desc_ss << "grid step=" << GRID_STEP << " center=" << vecToString(center_pose);
+        openLog(CALIB_GRID_LOG_PATH, points.size(), CALIB_RUN_GRID, desc_ss.str(), log);
+
         for (size_t i = 0; i < points.size(); ++i)
         {
             int point_idx = i + 1;
@@ -418,32 +349,18 @@ public:
             log(ss.str());
 
             std::string script = "movel(" + vecToString(points[i]) + ", a=" + std::to_string(MOVE_ACCEL) + ", v=" + std::to_string(MOVE_SPEED) + ")\n";
-            primary->sendScript(script);
+            sendPrimaryScript(script);
 
             // Wait for arrival
-            int timeout = 100; // 10 seconds
-            while (timeout > 0)
-            {
-                vector6d_t cur = get_current_pose_m_rad();
-                double dist_sq = 0;
-                for (int k = 0; k < 3; ++k)
-                    dist_sq += std::pow(cur[k] - points[i][k], 2);
-
-                if (std::sqrt(dist_sq) < 0.002)
-                    break;
-
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                timeout--;
-            }
-
-            if (timeout <= 0)
+            if (!waitForArrival(points[i], 0.002, -1.0, 10.0, get_current_pose_m_rad))
             {
                 log("Timeout waiting for robot to reach point");
                 break;
             }
 
             // Wait for stability
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            double settle_s = waitForSettle(500);
+            log("Settled in " + std::to_string(static_cast<int>(settle_s * 1000.0)) + " ms");
 
             auto current_pose = get_current_pose_m_rad();
 
@@ -453,118 +370,48 @@ public:
                     << current_pose[1] << ", " << current_pose[2] << ", "
                     << current_pose[3] << ", " << current_pose[4] << ", " << current_pose[5];
 
-            data_lines.push_back(data_ss.str());
             log("Point " + std::to_string(point_idx) + " Data: " + data_ss.str());
 
             log("Triggering Camera Capture (Callback)...");
+            uint32_t flags = 0;
+            setCaptureImage("");
             if (capture_callback)
             {
                 try
                 {
                     capture_callback(point_idx);
+                    flags |= CALIB_POINT_CAPTURED;
                 }
                 catch (const std::exception &e)
                 {
+                    flags |= CALIB_POINT_CAPTURE_FAILED;
                     log(std::string("Capture callback error: ") + e.what());
                 }
             }
+            appendPoint(point_idx, current_pose, points[i], settle_s, flags, log);
             log("Capture Done.");
         }
 
-        // Save Data to File
-        std::string filename = "workspace/calibration_data.txt";
-        std::ofstream outfile(filename);
-        if (outfile.is_open())
-        {
-            outfile << "PointID, X, Y, Z, Rx, Ry, Rz\n";
-            for (const auto &line : data_lines)
-                outfile << line << "\n";
-            outfile.close();
-            log("Calibration data saved to: " + filename);
-        }
-        else
-        {
-            log("Failed to open file for writing: " + filename);
-        }
+        closeLog("Calibration", log);
 
         log("Calibration finished. Returning to center...");
         std::string script_home = "movel(" + vecToString(center_pose) + ", a=0.5, v=0.2)\n";
-        primary->sendScript(script_home);
+        sendPrimaryScript(script_home);
     }
 
-    void run_3d_calibration(int layers,
-                            double base_width, double top_width, double height, double tilt_angle,
-                            std::string direction,
-                            const std::function<void(std::string)> &log_callback,
-                            const std::function<void(int)> &capture_callback,
-                            const std::function<std::vector<double>()> &get_pose_callback)
+    // Pyramid grid around center_pose (m, rad): base targets keep the center orientation, the
+    // capture pose of each (its dither) is tilted inward. Widths and height in mm, tilt in deg.
+    void buildPyramidPoses(const vector6d_t &center_pose, int layers, double base_width, double top_width,
+                           double height, double tilt_angle, const std::string &direction,
+                           std::vector<vector6d_t> &targets, std::vector<vector6d_t> &dithers) const
     {
-        // Simple Logger Wrapper
-        auto log = [&](const std::string &msg)
-        {
-            if (log_callback)
-                log_callback(msg);
-            else
-                std::cout << msg << std::endl;
-        };
-
-        if (!dashboard || !primary)
-        {
-            log("Error: Not connected (nullptr check)");
-            return;
-        }
-
-        // Helper to get current pose in Meters/Radians from Python
-        auto get_current_pose_m_rad = [&]() -> vector6d_t
-        {
-            if (!get_pose_callback)
-                return {0, 0, 0, 0, 0, 0};
-
-            // Call into Python (GIL re-acquired automatically)
-            std::vector<double> p = get_pose_callback();
-
-            if (p.size() < 6)
-                return {0, 0, 0, 0, 0, 0};
-            vector6d_t ret;
-            // Convert mm -> m, deg -> rad
-            ret[0] = p[0] / 1000.0;
-            ret[1] = p[1] / 1000.0;
-            ret[2] = p[2] / 1000.0;
-            ret[3] = p[3] / 57.29578; // 180 / PI approx
-            ret[4] = p[4] / 57.29578;
-            ret[5] = p[5] / 57.29578;
-            return ret;
-        };
-
-        // Ensure Robot is Ready
-        if (!dashboard->powerOn())
-        {
-            log("Failed to power on");
-            return;
-        }
-        if (!dashboard->brakeRelease())
-        {
-            log("Failed to release brake");
-            return;
-        }
-
-        log("[C++] Starting 3D Pyramid Calibration...");
-        std::stringstream info_ss;
-        info_ss << "Layers: " << layers << ", Base: " << base_width << ", Top: " << top_width
-                << ", Height: " << height << ", Tilt: " << tilt_angle << ", Dir: " << direction;
-        log(info_ss.str());
-
-        // Get center point (Current Pose)
-        vector6d_t center_pose = get_current_pose_m_rad();
-
-        std::vector<vector6d_t> points;
-        std::vector<std::string> data_lines;
+        targets.clear();
+        dithers.clear();
 
         // Convert inputs mm -> m, deg -> rad
         double base_width_m = base_width / 1000.0;
         double top_width_m = top_width / 1000.0;
         double height_m = height / 1000.0;
-        double tilt_rad = tilt_angle / 57.29578;
 
         // Direction Logic Configuration
         int ax_h = 2;  // Height Axis (Default Z)
@@ -637,8 +484,6 @@ public:
             {1.0, 1.0},   // corner 2: 右上
             {1.0, -1.0}}; // corner 3: 右下（修正）
 
-        std::vector<vector6d_t> targets;
-
         // Simpler Implementation: No Rotation Logic
         // We do NOT use LookAt or Tilt.
         // Orientation is kept identical to center_pose.
@@ -675,32 +520,9 @@ public:
             }
         }
 
-        // Execute Motion
+        // Capture poses: each base target tilted inward
         for (size_t i = 0; i < targets.size(); ++i)
         {
-            int point_idx = i + 1;
-            std::stringstream ss;
-            ss << "Processing Point " << point_idx << " (" << (i + 1) << "/" << targets.size() << ")";
-            log(ss.str());
-
-            // 1. Move to Base Point (Grid Position, Fixed Orientation)
-            std::string script = "movel(" + vecToString(targets[i]) + ", a=" + std::to_string(MOVE_ACCEL) + ", v=" + std::to_string(MOVE_SPEED) + ")\n";
-            primary->sendScript(script);
-
-            // Wait for Base Arrival
-            int timeout = 200;
-            while (timeout > 0)
-            {
-                vector6d_t cur = get_current_pose_m_rad();
-                double dist_sq = 0;
-                for (int k = 0; k < 3; ++k)
-                    dist_sq += std::pow(cur[k] - targets[i][k], 2);
-                if (std::sqrt(dist_sq) < 0.002)
-                    break;
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                timeout--;
-            }
-
             // 2. Apply Inward Tilt (法兰盘向心倾斜)
             // 计算当前点在金字塔中的位置
             int layer_idx = i / 4;  // 哪一层 (0, 1, 2, ...)
@@ -731,35 +553,119 @@ public:
             // Tiny Z shift to help MoveL interpolation
             p_dither[2] += 0.0001;
 
-            log(" - Adjusting Orientation...");
-            std::string script_dither = "movel(" + vecToString(p_dither) + ", a=0.5, v=0.1)\n"; // Slower for adjustment
-            primary->sendScript(script_dither);
+            dithers.push_back(p_dither);
+        }
+    }
+
+    // Trajectory mode path for a pyramid grid. A capture pose is only a tilt away from its base
+    // target, so a blend at the base itself would be clamped to nothing. Each capture is approached
+    // instead through a pass-through waypoint on the line from the previous capture to the base,
+    // far enough back for a full blend_radius (m) blend; the tilt happens on the short approach.
+    std::vector<PathWaypoint> buildPyramidPath(const vector6d_t &center_pose, const std::vector<vector6d_t> &targets,
+                                               const std::vector<vector6d_t> &dithers, double blend_radius) const
+    {
+        std::vector<PathWaypoint> path;
+        for (size_t i = 0; i < targets.size(); ++i)
+        {
+            const vector6d_t &from = i > 0 ? dithers[i - 1] : center_pose;
+            path.push_back({approachPose(from, targets[i], blend_radius / BLEND_SEGMENT_FRACTION), false, MOVE_SPEED});
+            path.push_back({dithers[i], true, 0.1}); // Slower for adjustment
+        }
+        path.push_back({center_pose, false, 0.2});
+        return path;
+    }
 
-            // Wait for Dither Arrival (Check Rotation too)
-            timeout = 50;
-            while (timeout > 0)
-            {
-                vector6d_t cur = get_current_pose_m_rad();
-                double dist_sq = 0;
-                // Check XYZ
-                for (int k = 0; k < 3; ++k)
-                    dist_sq += std::pow(cur[k] - p_dither[k], 2);
-                // Check Rot (approx)
-                double rot_sq = 0;
-                for (int k = 3; k < 6; ++k)
-                    rot_sq += std::pow(cur[k] - p_dither[k], 2);
-
-                if (std::sqrt(dist_sq) < 0.002 && std::sqrt(rot_sq) < 0.05)
-                    break;
+    // Script run_3d_calibration uploads in trajectory mode for a grid around center_pose (m, rad)
+    std::string compilePyramidScript(const vector6d_t &center_pose, int layers, double base_width, double top_width,
+                                     double height, double tilt_angle, const std::string &direction, double blend_radius)
+    {
+        std::vector<vector6d_t> targets;
+        std::vector<vector6d_t> dithers;
+        buildPyramidPoses(center_pose, layers, base_width, top_width, height, tilt_angle, direction, targets, dithers);
+        return compilePathScript(buildPyramidPath(center_pose, targets, dithers, blend_radius / 1000.0),
+                                 blend_radius / 1000.0, MOVE_ACCEL);
+    }
 
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                timeout--;
-            }
+    void run_3d_calibration(int layers,
+                            double base_width, double top_width, double height, double tilt_angle,
+                            std::string direction,
+                            const std::function<void(std::string)> &log_callback,
+                            const std::function<void(int)> &capture_callback,
+                            const std::function<std::vector<double>()> &get_pose_callback,
+                            bool trajectory_mode = false,
+                            double blend_radius = 10.0)
+    {
+        // Simple Logger Wrapper
+        auto log = [&](const std::string &msg)
+        {
+            if (log_callback)
+                log_callback(msg);
+            else
+                std::cout << msg << std::endl;
+        };
+
+        if (!dashboard || !primary)
+        {
+            log("Error: Not connected (nullptr check)");
+            return;
+        }
+
+        // Helper to get current pose in Meters/Radians from Python
+        auto get_current_pose_m_rad = [&]() -> vector6d_t
+        {
+            if (hasStateSource())
+                return state_source->getStateSnapshot().tcp_pose;
+            if (!get_pose_callback)
+                return {0, 0, 0, 0, 0, 0};
+
+            // Call into Python (GIL re-acquired automatically)
+            std::vector<double> p = get_pose_callback();
+
+            if (p.size() < 6)
+                return {0, 0, 0, 0, 0, 0};
+            vector6d_t ret;
+            // Convert mm -> m, deg -> rad
+            ret[0] = p[0] / 1000.0;
+            ret[1] = p[1] / 1000.0;
+            ret[2] = p[2] / 1000.0;
+            ret[3] = p[3] / 57.29578; // 180 / PI approx
+            ret[4] = p[4] / 57.29578;
+            ret[5] = p[5] / 57.29578;
+            return ret;
+        };
+
+        // Ensure Robot is Ready
+        if (!dashboard->powerOn())
+        {
+            log("Failed to power on");
+            return;
+        }
+        if (!dashboard->brakeRelease())
+        {
+            log("Failed to release brake");
+            return;
+        }
+
+        log("[C++] Starting 3D Pyramid Calibration...");
+        std::stringstream info_ss;
+        info_ss << "Layers: " << layers << ", Base: " << base_width << ", Top: " << top_width
+                << ", Height: " << height << ", Tilt: " << tilt_angle << ", Dir: " << direction;
+        log(info_ss.str());
 
-            // Stabilization before Capture (统一1.5秒)
-            std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+        // Get center point (Current Pose)
+        vector6d_t center_pose = get_current_pose_m_rad();
 
-            // 3. Capture (At Dithered Pose)
+        settle_times.clear();
+
+        std::vector<vector6d_t> targets;
+        std::vector<vector6d_t> dithers;
+        buildPyramidPoses(center_pose, layers, base_width, top_width, height, tilt_angle, direction, targets, dithers);
+
+        openLog(CALIB_3D_LOG_PATH, dithers.size(), CALIB_RUN_PYRAMID, info_ss.str(), log);
+
+        // 3. Capture (At Dithered Pose), logged with the commanded pose and settle time
+        auto capture_point = [&](int point_idx, const vector6d_t &target, double settle_s, bool arrived)
+        {
             auto current_pose = get_current_pose_m_rad();
             std::stringstream data_ss;
             data_ss << point_idx << ", "
@@ -767,89 +673,593 @@ public:
                     << current_pose[1] << ", " << current_pose[2] << ", "
                     << current_pose[3] << ", " << current_pose[4] << ", " << current_pose[5];
 
-            data_lines.push_back(data_ss.str());
             log("Point " + std::to_string(point_idx) + " Data: " + data_ss.str());
 
             log("Triggering Capture...");
+            uint32_t flags = arrived ? 0 : CALIB_POINT_NOT_ARRIVED;
+            setCaptureImage("");
             if (capture_callback)
             {
                 try
                 {
                     capture_callback(point_idx);
+                    flags |= CALIB_POINT_CAPTURED;
                 }
                 catch (const std::exception &e)
                 {
+                    flags |= CALIB_POINT_CAPTURE_FAILED;
                     log(std::string("Capture error: ") + e.what());
                 }
             }
+            appendPoint(point_idx, current_pose, target, settle_s, flags, log);
+        };
 
-            // 4. Restore to Base (Optional, but user requested "Restore")
-            log(" - Restoring...");
-            primary->sendScript(script); // Reuse base script
+        if (trajectory_mode && !hasStateSource())
+        {
+            log("Trajectory mode needs an RTSI state source, falling back to point-by-point motion");
+            trajectory_mode = false;
+        }
 
-            // Wait for Restore
-            timeout = 50;
-            while (timeout > 0)
+        if (trajectory_mode)
+        {
+            // One program for the whole grid: approach waypoints are blended, capture poses are
+            // exact stops. The separate restore move is dropped, the next approach does it.
+            std::vector<PathWaypoint> path = buildPyramidPath(center_pose, targets, dithers, blend_radius / 1000.0);
+
+            log("Uploading blended trajectory (" + std::to_string(path.size()) + " waypoints)...");
+            state_source->setInputBitRegister(CAPTURE_ACK_REGISTER, false);
+            sendPrimaryScript(compilePathScript(path, blend_radius / 1000.0, MOVE_ACCEL));
+
+            for (size_t i = 0; i < targets.size(); ++i)
             {
-                vector6d_t cur = get_current_pose_m_rad();
-                double dist_sq = 0;
-                for (int k = 0; k < 3; ++k)
-                    dist_sq += std::pow(cur[k] - targets[i][k], 2);
-                if (std::sqrt(dist_sq) < 0.002)
+                int point_idx = i + 1;
+                std::stringstream ss;
+                ss << "Processing Point " << point_idx << " (" << (i + 1) << "/" << targets.size() << ")";
+                log(ss.str());
+
+                // The path runs from the previous capture through the next base target
+                if (!state_source->waitForOutputBit(CAPTURE_READY_REGISTER, true, 60.0))
+                {
+                    log("Timeout waiting for capture point, stopping trajectory");
+                    sendPrimaryScript("stopj(2.0)");
+                    break;
+                }
+
+                // Stabilization before Capture (最长1.5秒)
+                double settle_s = waitForSettle(1500);
+                log(" - Settled in " + std::to_string(static_cast<int>(settle_s * 1000.0)) + " ms");
+                capture_point(point_idx, dithers[i], settle_s, true);
+
+                // Release the robot: ack high until it drops READY, then clear ack
+                state_source->setInputBitRegister(CAPTURE_ACK_REGISTER, true);
+                bool released = state_source->waitForOutputBit(CAPTURE_READY_REGISTER, false, 5.0);
+                state_source->setInputBitRegister(CAPTURE_ACK_REGISTER, false);
+                if (!released)
+                {
+                    log("Robot did not acknowledge capture, stopping trajectory");
+                    sendPrimaryScript("stopj(2.0)");
                     break;
-                std::this_thread::sleep_for(std::chrono::milliseconds(100));
-                timeout--;
+                }
             }
         }
-
-        // Save Data
-        std::string filename = "workspace/calibration_3d_data.txt";
-        std::ofstream outfile(filename);
-        if (outfile.is_open())
+        else
         {
-            outfile << "PointID, X, Y, Z, Rx, Ry, Rz\n";
-            for (const auto &line : data_lines)
-                outfile << line << "\n";
-            outfile.close();
-            log("3D Calibration data saved to: " + filename);
+            // Execute Motion
+            for (size_t i = 0; i < targets.size(); ++i)
+            {
+                int point_idx = i + 1;
+                std::stringstream ss;
+                ss << "Processing Point " << point_idx << " (" << (i + 1) << "/" << targets.size() << ")";
+                log(ss.str());
+
+                // 1. Move to Base Point (Grid Position, Fixed Orientation)
+                std::string script = "movel(" + vecToString(targets[i]) + ", a=" + std::to_string(MOVE_ACCEL) + ", v=" + std::to_string(MOVE_SPEED) + ")\n";
+                sendPrimaryScript(script);
+
+                // Wait for Base Arrival
+                waitForArrival(targets[i], 0.002, -1.0, 20.0, get_current_pose_m_rad);
+
+                log(" - Adjusting Orientation...");
+                std::string script_dither = "movel(" + vecToString(dithers[i]) + ", a=0.5, v=0.1)\n"; // Slower for adjustment
+                sendPrimaryScript(script_dither);
+
+                // Wait for Dither Arrival (Check Rotation too), then Stabilization before Capture (最长1.5秒)
+                double settle_s = 0.0;
+                bool arrived = waitForCapturePose(dithers[i], 0.002, 0.05, 5.0, 1500, get_current_pose_m_rad, settle_s);
+                log(" - Settled in " + std::to_string(static_cast<int>(settle_s * 1000.0)) + " ms");
+                capture_point(point_idx, dithers[i], settle_s, arrived);
+
+                // 4. Restore to Base (Optional, but user requested "Restore")
+                log(" - Restoring...");
+                sendPrimaryScript(script); // Reuse base script
+
+                // Wait for Restore (orientation too, the position barely changes)
+                waitForArrival(targets[i], 0.002, 0.05, 5.0, get_current_pose_m_rad);
+            }
         }
-        else
+
+        closeLog("3D Calibration", log);
+
+        if (trajectory_mode)
         {
-            log("Failed to open file: " + filename);
+            // The uploaded path already ends at the center pose
+            log("Calibration finished.");
+            return;
         }
 
         log("Calibration finished. Returning to center...");
         std::string script_home = "movel(" + vecToString(center_pose) + ", a=0.5, v=0.2)\n";
-        primary->sendScript(script_home);
+        sendPrimaryScript(script_home);
     }
 
 private:
+    void sendPrimaryScript(const std::string &script)
+    {
+        PERF_SCOPE("script.send");
+        primary->sendScript(script);
+    }
+
+    // Starts the run's point log; the run goes on without it if the file can't be created
+    void openLog(const std::string &path, size_t points, int kind, const std::string &description,
+                 const std::function<void(const std::string &)> &log)
+    {
+        log_path = path;
+        if (!calib_log.open(path, points, kind, description))
+            log("Failed to open calibration log for writing: " + path);
+    }
+
+    // Appends one captured point (flushed to disk) with the image set by the capture callback
+    void appendPoint(int point_idx, const vector6d_t &pose, const vector6d_t &target, double settle_s, uint32_t flags,
+                     const std::function<void(const std::string &)> &log)
+    {
+        if (!calib_log.isOpen())
+            return;
+        CalibrationRecord rec{};
+        rec.point_id = point_idx;
+        rec.captured_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                              std::chrono::system_clock::now().time_since_epoch())
+                              .count();
+        rec.settle_time = settle_s;
+        for (int k = 0; k < 6; ++k)
+        {
+            rec.tcp_pose[k] = pose[k];
+            rec.target_pose[k] = target[k];
+        }
+        {
+            std::lock_guard<std::mutex> lock(capture_image_mutex);
+            if (!copyFixedString(rec.image, sizeof(rec.image), capture_image))
+                flags |= CALIB_POINT_IMAGE_TRUNCATED;
+        }
+        rec.flags = flags;
+        if (!calib_log.append(rec))
+            log("Failed to append point " + std::to_string(point_idx) + " to " + log_path);
+    }
+
+    void closeLog(const std::string &run, const std::function<void(const std::string &)> &log)
+    {
+        if (!calib_log.isOpen())
+            return;
+        const uint64_t points = calib_log.count();
+        calib_log.close();
+        log(run + " data saved to: " + log_path + " (" + std::to_string(points) +
+            " points, export with calibration_log_tool.py)");
+    }
+
     std::string robot_ip;
     std::unique_ptr<DashboardClient> dashboard;
     std::unique_ptr<PrimaryPortInterface> primary;
-    // RTSI removed
+    // RTSI removed, state comes from an attached controller or the Python callback
+    EliteRobotController *state_source = nullptr;
+    SettleConfig settle_config;
+    std::vector<double> settle_times;
+
+    CalibrationLog calib_log;
+    std::string log_path;
+    std::mutex capture_image_mutex;
+    std::string capture_image;
+};
+
+// ==========================================
+// Multi-Robot Fleet
+// ==========================================
+
+// Fixed-size worker pool for fanning blocking robot I/O out across arms
+class TaskPool
+{
+public:
+    explicit TaskPool(size_t workers)
+    {
+        for (size_t i = 0; i < std::max<size_t>(1, workers); ++i)
+            threads.emplace_back([this]
+                                 { workerLoop(); });
+    }
+
+    ~TaskPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto &t : threads)
+            t.join();
+    }
+
+    template <typename F>
+    auto submit(F &&fn) -> std::future<decltype(fn())>
+    {
+        using R = decltype(fn());
+        auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn));
+        std::future<R> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            tasks.emplace([task]
+                          { (*task)(); });
+        }
+        cv.notify_one();
+        return result;
+    }
+
+    size_t size() const { return threads.size(); }
+
+private:
+    void workerLoop()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cv.wait(lock, [this]
+                        { return stopping || !tasks.empty(); });
+                if (stopping && tasks.empty())
+                    return;
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+
+    std::vector<std::thread> threads;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping = false;
+};
+
+// Manages several arms: concurrent bring-up, one-call state snapshots and synchronized moves.
+// Blocking per-robot work runs on one shared pool instead of a Python thread per arm.
+class RobotFleet
+{
+public:
+    explicit RobotFleet(int workers = 0)
+        : pool(workers > 0 ? workers : std::max(2u, std::thread::hardware_concurrency())) {}
+
+    ~RobotFleet()
+    {
+        disconnectAll();
+    }
+
+    // Returns the index of the new robot
+    int addRobot(const std::string &ip, const std::string &recipe_dir)
+    {
+        robots.push_back(std::make_unique<EliteRobotController>());
+        ips.push_back(ip);
+        recipe_dirs.push_back(recipe_dir);
+        return static_cast<int>(robots.size()) - 1;
+    }
+
+    size_t size() const { return robots.size(); }
+
+    EliteRobotController &robot(size_t index)
+    {
+        if (index >= robots.size())
+            throw std::out_of_range("robot index out of range");
+        return *robots[index];
+    }
+
+    // Brings every arm up concurrently, returns per-robot success
+    std::vector<bool> connectAll(double timeout_s)
+    {
+        for (size_t i = 0; i < robots.size(); ++i)
+            robots[i]->connectAsync(ips[i], recipe_dirs[i], timeout_s);
+        std::vector<bool> ok(robots.size());
+        for (size_t i = 0; i < robots.size(); ++i)
+            ok[i] = robots[i]->waitConnected(timeout_s + 1.0) == CONNECT_READY;
+        return ok;
+    }
+
+    void disconnectAll()
+    {
+        forEach([](EliteRobotController &r)
+                { r.disconnect(); return true; });
+    }
+
+    // Latest cached state of every arm, read in one pass
+    std::vector<RobotStateSnapshot> getStates() const
+    {
+        std::vector<RobotStateSnapshot> states;
+        states.reserve(robots.size());
+        for (const auto &r : robots)
+            states.push_back(r->getStateSnapshot());
+        return states;
+    }
+
+    // Moves every arm to its pose (m, rad). With synchronized set, each arm's script waits on
+    // FLEET_START_REGISTER and all are released in the same RTSI cycle once every arm is ready.
+    std::vector<bool> moveAll(const std::vector<vector6d_t> &poses, double speed, double accel, bool synchronized, double timeout_s)
+    {
+        if (poses.size() != robots.size())
+            throw std::invalid_argument("need one pose per robot");
+
+        std::vector<bool> ok = forEach([&](EliteRobotController &r, size_t i)
+                                       {
+            if (synchronized && !r.setInputBitRegister(FLEET_START_REGISTER, false))
+                return false;
+            return r.sendScript(moveScript(poses[i], speed, accel, synchronized)); });
+        if (!synchronized)
+            return ok;
+
+        // Release only when every arm is parked at the start barrier
+        std::vector<bool> ready = forEach([&](EliteRobotController &r, size_t i)
+                                          { return ok[i] && r.waitForOutputBit(FLEET_READY_REGISTER, true, timeout_s); });
+        bool all_ready = std::all_of(ready.begin(), ready.end(), [](bool b)
+                                     { return b; });
+        if (!all_ready)
+        {
+            stopAll();
+            return ready;
+        }
+
+        for (auto &r : robots)
+            r->setInputBitRegister(FLEET_START_REGISTER, true);
+        std::vector<bool> started = forEach([&](EliteRobotController &r)
+                                            { return r.waitForOutputBit(FLEET_READY_REGISTER, false, timeout_s); });
+        for (auto &r : robots)
+            r->setInputBitRegister(FLEET_START_REGISTER, false);
+        return started;
+    }
+
+    std::vector<bool> waitAllMotionDone(const std::vector<vector6d_t> &targets, double pos_tol, double rot_tol, double timeout_s)
+    {
+        if (targets.size() != robots.size())
+            throw std::invalid_argument("need one target per robot");
+        return forEach([&](EliteRobotController &r, size_t i)
+                       { return r.waitForMotionDone(targets[i], pos_tol, rot_tol, timeout_s); });
+    }
+
+    std::vector<bool> stopAll()
+    {
+        return forEach([](EliteRobotController &r)
+                       { return r.stop(); });
+    }
+
+private:
+    // Runs fn on every robot through the pool and collects the results in robot order
+    template <typename F>
+    std::vector<bool> forEach(F &&fn)
+    {
+        std::vector<std::future<bool>> pending;
+        pending.reserve(robots.size());
+        for (size_t i = 0; i < robots.size(); ++i)
+        {
+            EliteRobotController *r = robots[i].get();
+            if constexpr (std::is_invocable_v<F, EliteRobotController &, size_t>)
+                pending.push_back(pool.submit([&fn, r, i]
+                                              { return static_cast<bool>(fn(*r, i)); }));
+            else
+                pending.push_back(pool.submit([&fn, r]
+                                              { return static_cast<bool>(fn(*r)); }));
+        }
+        std::vector<bool> results(pending.size());
+        for (size_t i = 0; i < pending.size(); ++i)
+        {
+            try
+            {
+                results[i] = pending[i].get();
+            }
+            catch (...)
+            {
+                results[i] = false;
+            }
+        }
+        return results;
+    }
+
+    static std::string moveScript(const vector6d_t &pose, double speed, double accel, bool synchronized)
+    {
+        std::stringstream ss;
+        ss << "def fleet_move():\n";
+        if (synchronized)
+        {
+            ss << "  write_output_boolean_register(" << FLEET_READY_REGISTER << ", True)\n"
+               << "  while not read_input_boolean_register(" << FLEET_START_REGISTER << "):\n"
+               << "    sync()\n"
+               << "  end\n"
+               << "  write_output_boolean_register(" << FLEET_READY_REGISTER << ", False)\n";
+        }
+        ss << "  movel([";
+        for (int i = 0; i < 6; ++i)
+            ss << pose[i] << (i < 5 ? "," : "");
+        ss << "], a=" << accel << ", v=" << speed << ")\n"
+           << "end\n";
+        return ss.str();
+    }
+
+    TaskPool pool;
+    std::vector<std::unique_ptr<EliteRobotController>> robots;
+    std::vector<std::string> ips;
+    std::vector<std::string> recipe_dirs;
 };
 
 PYBIND11_MODULE(elite_ext, m)
 {
     m.doc() = "Elite Robot C++ Extensions with Unified Interface";
 
-    // Bind the Unified Controller Class
-    py::class_<EliteRobotController>(m, "EliteRobotController")
-        .def(py::init<>())
-        .def("connect", &EliteRobotController::connect, "Connect to robot", py::arg("ip"), py::arg("recipe_dir") = "config")
-        .def("disconnect", &EliteRobotController::disconnect, "Disconnect from robot")
-        .def("is_connected", &EliteRobotController::isConnected, "Check connection status")
-        .def("get_position", &EliteRobotController::getPosition, "Get current position [x,y,z,rx,ry,rz] (mm, deg)")
-        .def("set_speed", &EliteRobotController::setSpeed, "Set global speed percent (0-100)")
-        .def("jog", &EliteRobotController::jog, "Jog robot axis", py::arg("axis"), py::arg("direction"), py::arg("distance_mm"))
-        .def("move_to", &EliteRobotController::moveTo, "Move to target pose (mm, deg)")
-        .def("stop", &EliteRobotController::stop, "Emergency stop");
+    // Controller and RobotStateSnapshot, shared with elite_ext_new.cpp
+    bindEliteRobotController(m);
+    bindPoseMath(m);
+    bindVisualServo(m);
+    PERF_STATS::bindPerfStats(m);
+
+    // (N,6) [x,y,z,rx,ry,rz] in mm/deg -> m/rad
+    auto to_si_poses = [](const std::vector<std::vector<double>> &poses)
+    {
+        std::vector<vector6d_t> out(poses.size());
+        for (size_t n = 0; n < poses.size(); ++n)
+        {
+            if (poses[n].size() < 6)
+                throw std::invalid_argument("poses must be [x,y,z,rx,ry,rz]");
+            for (int i = 0; i < 3; ++i)
+            {
+                out[n][i] = poses[n][i] / 1000.0;
+                out[n][i + 3] = poses[n][i + 3] / 57.29578;
+            }
+        }
+        return out;
+    };
+
+    py::class_<RobotFleet>(m, "RobotFleet")
+        .def(py::init<int>(), py::arg("workers") = 0)
+        .def("add_robot", &RobotFleet::addRobot, "Add a robot, returns its index", py::arg("ip"), py::arg("recipe_dir") = "config")
+        .def("__len__", &RobotFleet::size)
+        .def("robot", &RobotFleet::robot, "Controller of robot i", py::arg("index"), py::return_value_policy::reference_internal)
+        .def("connect_all", &RobotFleet::connectAll, "Connect all robots concurrently, returns per-robot success",
+             py::arg("timeout") = CONNECT_TIMEOUT, py::call_guard<py::gil_scoped_release>())
+        .def("disconnect_all", &RobotFleet::disconnectAll, py::call_guard<py::gil_scoped_release>())
+        .def(
+            "get_states",
+            [](const RobotFleet &self)
+            {
+                std::vector<RobotStateSnapshot> states = self.getStates();
+                const py::ssize_t n = static_cast<py::ssize_t>(states.size());
+                py::array_t<double> tcp_pose({n, py::ssize_t(6)}), tcp_speed({n, py::ssize_t(6)});
+                py::array_t<double> joints({n, py::ssize_t(6)}), joint_speeds({n, py::ssize_t(6)});
+                py::array_t<double> timestamp(n), age(n);
+                py::array_t<uint64_t> sequence(n);
+                py::array_t<int32_t> robot_mode(n);
+                auto tp = tcp_pose.mutable_unchecked<2>(), ts = tcp_speed.mutable_unchecked<2>();
+                auto jp = joints.mutable_unchecked<2>(), js = joint_speeds.mutable_unchecked<2>();
+                for (py::ssize_t r = 0; r < n; ++r)
+                {
+                    const RobotStateSnapshot &st = states[r];
+                    for (py::ssize_t k = 0; k < 6; ++k)
+                    {
+                        tp(r, k) = st.tcp_pose[k];
+                        ts(r, k) = st.tcp_speed[k];
+                        jp(r, k) = st.joint_positions[k];
+                        js(r, k) = st.joint_speeds[k];
+                    }
+                    timestamp.mutable_at(r) = st.timestamp;
+                    age.mutable_at(r) = st.age();
+                    sequence.mutable_at(r) = st.sequence;
+                    robot_mode.mutable_at(r) = st.robot_mode;
+                }
+                py::dict out;
+                out["tcp_pose"] = tcp_pose;
+                out["tcp_speed"] = tcp_speed;
+                out["joint_positions"] = joints;
+                out["joint_speeds"] = joint_speeds;
+                out["timestamp"] = timestamp;
+                out["age"] = age;
+                out["sequence"] = sequence;
+                out["robot_mode"] = robot_mode;
+                return out;
+            },
+            "Cached state of all robots as (N,6) arrays (m, rad) plus per-robot timestamp/age/sequence/robot_mode")
+        .def(
+            "move_all",
+            [to_si_poses](RobotFleet &self, const std::vector<std::vector<double>> &poses, double speed, double accel, bool synchronized, double timeout)
+            {
+                std::vector<vector6d_t> targets = to_si_poses(poses);
+                py::gil_scoped_release release;
+                return self.moveAll(targets, speed / 1000.0, accel / 1000.0, synchronized, timeout);
+            },
+            "Move robot i to poses[i] (mm, deg); synchronized starts all arms in the same RTSI cycle",
+            py::arg("poses"), py::arg("speed") = 200.0, py::arg("accel") = 500.0, py::arg("synchronized") = true, py::arg("timeout") = 5.0)
+        .def(
+            "wait_all_motion_done",
+            [to_si_poses](RobotFleet &self, const std::vector<std::vector<double>> &targets, double pos_tol, double rot_tol, double timeout)
+            {
+                std::vector<vector6d_t> t = to_si_poses(targets);
+                py::gil_scoped_release release;
+                return self.waitAllMotionDone(t, pos_tol / 1000.0, rot_tol < 0 ? -1.0 : rot_tol / 57.29578, timeout);
+            },
+            "Wait until every robot reaches its target (mm, deg)",
+            py::arg("targets"), py::arg("pos_tol") = 2.0, py::arg("rot_tol") = 3.0, py::arg("timeout") = 10.0)
+        .def("stop_all", &RobotFleet::stopAll, py::call_guard<py::gil_scoped_release>());
 
     py::class_<EliteCalibration>(m, "EliteCalibration")
         .def(py::init<>())
-        .def("connect", &EliteCalibration::connect)
-        .def("disconnect", &EliteCalibration::disconnect)
+        .def("connect", &EliteCalibration::connect, py::call_guard<py::gil_scoped_release>())
+        .def("disconnect", &EliteCalibration::disconnect, py::call_guard<py::gil_scoped_release>())
+        .def(
+            "set_settle_detection",
+            [](EliteCalibration &self, bool enabled, double linear_speed, double angular_speed, double jitter, double rot_jitter, int samples)
+            {
+                // mm, deg -> m, rad
+                SettleConfig cfg;
+                cfg.enabled = enabled;
+                cfg.linear_speed = linear_speed / 1000.0;
+                cfg.angular_speed = angular_speed / 57.29578;
+                cfg.jitter = jitter / 1000.0;
+                cfg.rot_jitter = rot_jitter / 57.29578;
+                cfg.samples = std::max(1, samples);
+                self.setSettleConfig(cfg);
+            },
+            "Configure capture settle detection (mm/s, deg/s, mm, deg, consecutive RTSI samples)",
+            py::arg("enabled") = true, py::arg("linear_speed") = 0.5, py::arg("angular_speed") = 0.3,
+            py::arg("jitter") = 0.05, py::arg("rot_jitter") = 0.03, py::arg("samples") = 25)
+        .def("get_settle_times", &EliteCalibration::getSettleTimes, "Measured settle time (s) per captured point of the last run")
+        .def("set_capture_image", &EliteCalibration::setCaptureImage,
+             "Record the image saved for the point being captured (call from capture_callback)", py::arg("path"))
+        .def("get_log_path", &EliteCalibration::getLogPath, "Binary point log of the last run (CalibrationLog)")
+        .def("set_state_source", &EliteCalibration::setStateSource,
+             "Read poses from a connected EliteRobotController's RTSI cache (None to use get_pose_callback)",
+             py::arg("controller").none(true), py::keep_alive<1, 2>())
+        .def(
+            "wait_for_capture_pose",
+            [](EliteCalibration &self, const std::vector<double> &target, double pos_tol, double rot_tol, double timeout, int max_settle_ms)
+            {
+                if (target.size() < 6)
+                    throw std::invalid_argument("target must be [x,y,z,rx,ry,rz]");
+                if (!self.hasStateSource())
+                    throw std::runtime_error("wait_for_capture_pose needs a state source with RTSI samples");
+                vector6d_t t;
+                for (int i = 0; i < 3; ++i)
+                {
+                    t[i] = target[i] / 1000.0;
+                    t[i + 3] = target[i + 3] / 57.29578;
+                }
+                double settle_s = 0.0;
+                py::gil_scoped_release release;
+                bool arrived = self.waitForCapturePose(t, pos_tol / 1000.0, rot_tol < 0 ? -1.0 : rot_tol / 57.29578, timeout,
+                                                       max_settle_ms, {}, settle_s);
+                return std::make_pair(arrived, settle_s);
+            },
+            "Wait for a just-commanded capture pose (mm, deg), then for settling; returns (arrived, settle_s)",
+            py::arg("target"), py::arg("pos_tol") = 2.0, py::arg("rot_tol") = 3.0, py::arg("timeout") = 5.0,
+            py::arg("max_settle_ms") = 1500)
+        .def(
+            "compile_pyramid_script",
+            [](EliteCalibration &self, const std::vector<double> &center_pose, int layers, double base_width,
+               double top_width, double height, double tilt_angle, const std::string &direction, double blend_radius)
+            {
+                if (center_pose.size() != 6)
+                    throw std::invalid_argument("center_pose must be [x,y,z,rx,ry,rz]");
+                vector6d_t c;
+                for (int i = 0; i < 3; ++i)
+                {
+                    c[i] = center_pose[i] / 1000.0;
+                    c[i + 3] = center_pose[i + 3] / 57.29578;
+                }
+                return self.compilePyramidScript(c, layers, base_width, top_width, height, tilt_angle, direction, blend_radius);
+            },
+            "Script that run_3d_calibration uploads in trajectory mode for a grid around center_pose (mm, deg)",
+            py::arg("center_pose"), py::arg("layers") = 2, py::arg("base_width") = 100.0, py::arg("top_width") = 50.0,
+            py::arg("height") = 50.0, py::arg("tilt_angle") = 0.0, py::arg("direction") = "Z+",
+            py::arg("blend_radius") = 10.0)
         .def("run_calibration", &EliteCalibration::run_calibration,
              py::call_guard<py::gil_scoped_release>(),
              py::arg("log_callback"), py::arg("capture_callback"), py::arg("get_pose_callback"))
@@ -861,5 +1271,7 @@ PYBIND11_MODULE(elite_ext, m)
              py::arg("height") = 50.0,
              py::arg("tilt_angle") = 0.0,
              py::arg("direction") = "Z+",
-             py::arg("log_callback"), py::arg("capture_callback"), py::arg("get_pose_callback"));
+             py::arg("log_callback"), py::arg("capture_callback"), py::arg("get_pose_callback"),
+             py::arg("trajectory_mode") = false,
+             py::arg("blend_radius") = 10.0);
 }
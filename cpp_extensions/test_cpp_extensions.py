@@ -218,6 +218,1104 @@ def test_error_handling():
         print(f"✗ 错误处理测试失败: {e}")
         return False
 
+def test_template_matching_batch():
+    """测试批量模板匹配功能"""
+    print("\n" + "=" * 50)
+    print("测试6: 批量模板匹配")
+    print("=" * 50)
+    
+    try:
+        import vision_cpp_ext
+        
+        main_image = np.random.randint(0, 256, (480, 640), dtype=np.uint8)
+        template_a = np.random.randint(0, 256, (40, 40), dtype=np.uint8)
+        template_b = np.random.randint(0, 256, (30, 60), dtype=np.uint8)
+        main_image[100:140, 200:240] = template_a
+        main_image[300:330, 400:460] = template_b
+        
+        templates = [template_a, template_b, template_a]
+        rois = [(150, 50, 200, 200), (0, 0, 0, 0), (400, 250, 200, 200)]
+        
+        start_time = time.time()
+        matches = vision_cpp_ext.template_matching_batch(
+            main_image, templates, rois,
+            [vision_cpp_ext.TM_CCOEFF_NORMED], [0.8], False
+        )
+        end_time = time.time()
+        
+        print(f"✓ 批量模板匹配执行成功")
+        print(f"  处理时间: {(end_time - start_time) * 1000:.2f} ms")
+        print(f"  匹配结果: {matches}")
+        
+        found = {int(m['job']): (int(m['x']), int(m['y'])) for m in matches}
+        if found.get(0) != (200, 100) or found.get(1) != (400, 300) or 2 in found:
+            print("✗ 批量匹配结果与预期不符")
+            return False
+        
+        return True
+        
+    except Exception as e:
+        print(f"✗ 批量模板匹配测试失败: {e}")
+        return False
+
+def test_template_matching_peaks():
+    """测试多目标模板匹配的非极大值抑制"""
+    print("\n" + "=" * 50)
+    print("测试7: 多目标匹配峰值提取")
+    print("=" * 50)
+    
+    try:
+        import vision_cpp_ext
+        
+        main_image = np.random.randint(0, 256, (480, 640), dtype=np.uint8)
+        template = np.random.randint(0, 256, (40, 40), dtype=np.uint8)
+        positions = [(50, 60), (300, 200), (500, 400)]
+        for x, y in positions:
+            main_image[y:y+40, x:x+40] = template
+        
+        start_time = time.time()
+        peaks = vision_cpp_ext.template_matching_peaks(
+            main_image, template, vision_cpp_ext.TM_CCOEFF_NORMED, 0.6,
+            0, 0, 0, 0, 10, 0
+        )
+        end_time = time.time()
+        
+        print(f"✓ 峰值提取执行成功")
+        print(f"  处理时间: {(end_time - start_time) * 1000:.2f} ms")
+        print(f"  峰值数量: {len(peaks)}")
+        
+        found = sorted((int(p['x']), int(p['y'])) for p in peaks)
+        if found != sorted(positions):
+            print(f"✗ 峰值位置与预期不符: {found}")
+            return False
+        
+        limited = vision_cpp_ext.template_matching_peaks(
+            main_image, template, vision_cpp_ext.TM_SQDIFF_NORMED, 0.9,
+            0, 0, 0, 0, -1, 1
+        )
+        if len(limited) != 1 or limited[0]['confidence'] < 0.99:
+            print(f"✗ max_matches限制无效: {limited}")
+            return False
+        
+        # template_matching 的多匹配模式同样只返回局部极大值
+        multiple = vision_cpp_ext.template_matching(
+            main_image, template, vision_cpp_ext.TM_CCOEFF_NORMED, 0.6, True, 0, 0, 0, 0
+        )
+        if sorted(tuple(m[:2]) for m in multiple) != sorted(positions):
+            print(f"✗ 多匹配未做非极大值抑制: {len(multiple)} 个结果")
+            return False
+        best = vision_cpp_ext.template_matching(
+            main_image, template, vision_cpp_ext.TM_CCOEFF_NORMED, 0.6, True, 0, 0, 0, 0, max_matches=1
+        )
+        if len(best) != 1:
+            print(f"✗ 多匹配 max_matches 无效: {best}")
+            return False
+        
+        return True
+        
+    except Exception as e:
+        print(f"✗ 峰值提取测试失败: {e}")
+        return False
+
+def test_template_matching_pyramid():
+    """测试金字塔粗精匹配"""
+    print("\n" + "=" * 50)
+    print("测试8: 金字塔模板匹配")
+    print("=" * 50)
+    
+    try:
+        import vision_cpp_ext
+        
+        # 平滑的随机纹理，降采样后仍可匹配
+        main_image = cv2.GaussianBlur(np.random.randint(0, 256, (960, 1280), dtype=np.uint8), (7, 7), 0)
+        template = main_image[413:493, 707:807].copy()
+        
+        start_time = time.time()
+        full = vision_cpp_ext.template_matching(
+            main_image, template, vision_cpp_ext.TM_CCOEFF_NORMED, 0.8, False, 0, 0, 0, 0
+        )
+        full_time = time.time() - start_time
+        
+        start_time = time.time()
+        coarse = vision_cpp_ext.template_matching(
+            main_image, template, vision_cpp_ext.TM_CCOEFF_NORMED, 0.8, False, 0, 0, 0, 0,
+            pyramid_levels=2, template_id=1
+        )
+        pyramid_time = time.time() - start_time
+        
+        # 第二次调用复用缓存的模板金字塔
+        cached = vision_cpp_ext.template_matching(
+            main_image, template, vision_cpp_ext.TM_CCOEFF_NORMED, 0.8, False, 0, 0, 0, 0,
+            pyramid_levels=2, template_id=1
+        )
+        # 同一ID换了模板内容: 缓存按内容校验，不应沿用旧金字塔
+        other = main_image[100:180, 200:300].copy()
+        replaced = vision_cpp_ext.template_matching(
+            main_image, other, vision_cpp_ext.TM_CCOEFF_NORMED, 0.8, False, 0, 0, 0, 0,
+            pyramid_levels=2, template_id=1
+        )
+        # ROI 宽度小于两倍的降采样模板时回退为全分辨率匹配，多匹配结果与非金字塔路径一致
+        odd = main_image[413:494, 707:808].copy()
+        small_args = (main_image, odd, vision_cpp_ext.TM_CCOEFF_NORMED, 0.3, True, 707, 380, 101, 150)
+        fallback_match = vision_cpp_ext.template_matching(*small_args, pyramid_levels=2, template_id=2) == \
+            vision_cpp_ext.template_matching(*small_args)
+        vision_cpp_ext.clear_template_cache()
+        
+        print(f"  全分辨率: {full} ({full_time * 1000:.2f} ms)")
+        print(f"  金字塔: {coarse} ({pyramid_time * 1000:.2f} ms)")
+        
+        if len(coarse) != 1 or tuple(coarse[0][:2]) != (707, 413) or tuple(cached[0][:2]) != (707, 413):
+            print("✗ 金字塔匹配位置与预期不符")
+            return False
+        if len(replaced) != 1 or tuple(replaced[0][:2]) != (200, 100):
+            print(f"✗ 同ID更换模板后仍使用旧金字塔: {replaced}")
+            return False
+        if not fallback_match:
+            print("✗ 小ROI回退路径的多匹配结果与非金字塔路径不一致")
+            return False
+        
+        print("✓ 金字塔模板匹配执行成功")
+        return True
+        
+    except Exception as e:
+        print(f"✗ 金字塔模板匹配测试失败: {e}")
+        return False
+
+def test_template_handle():
+    """测试注册模板句柄（与直接传入模板结果一致）"""
+    print("\n" + "=" * 50)
+    print("测试9: 模板句柄")
+    print("=" * 50)
+    
+    try:
+        import vision_cpp_ext
+        
+        main_image = cv2.GaussianBlur(np.random.randint(0, 256, (480, 640), dtype=np.uint8), (5, 5), 0)
+        template = main_image[150:230, 300:380].copy()
+        handle = vision_cpp_ext.register_template(template)
+        print(f"  模板句柄: {handle.width}x{handle.height}, mean={handle.mean:.2f}")
+        
+        methods = [
+            vision_cpp_ext.TM_SQDIFF, vision_cpp_ext.TM_SQDIFF_NORMED,
+            vision_cpp_ext.TM_CCORR, vision_cpp_ext.TM_CCORR_NORMED,
+            vision_cpp_ext.TM_CCOEFF, vision_cpp_ext.TM_CCOEFF_NORMED,
+        ]
+        for method in methods:
+            # 阈值取极小值以便总能返回最佳匹配位置
+            expected = vision_cpp_ext.template_matching(main_image, template, method, -1e30, False, 0, 0, 0, 0)
+            actual = vision_cpp_ext.template_matching(main_image, handle, method, -1e30, False, 0, 0, 0, 0)
+            if tuple(expected[0][:2]) != tuple(actual[0][:2]):
+                print(f"✗ 方法 {method} 结果不一致: {expected} vs {actual}")
+                return False
+            if not np.isclose(expected[0][2], actual[0][2], rtol=1e-3, atol=1e-3):
+                print(f"✗ 方法 {method} 置信度不一致: {expected} vs {actual}")
+                return False
+        
+        batch = vision_cpp_ext.template_matching_batch(
+            main_image, [handle], [(0, 0, 0, 0)], [vision_cpp_ext.TM_CCOEFF_NORMED], [0.9]
+        )
+        if len(batch) != 1 or (int(batch[0]['x']), int(batch[0]['y'])) != (300, 150):
+            print(f"✗ 句柄批量匹配结果与预期不符: {batch}")
+            return False
+        
+        print("✓ 模板句柄结果与直接匹配一致")
+        return True
+        
+    except Exception as e:
+        print(f"✗ 模板句柄测试失败: {e}")
+        return False
+
+def test_color_and_strided_input():
+    """测试彩色/非连续数组输入（与灰度连续输入结果一致）"""
+    print("\n" + "=" * 50)
+    print("测试10: 彩色与非连续输入")
+    print("=" * 50)
+    
+    try:
+        import vision_cpp_ext
+        
+        bgr = cv2.GaussianBlur(np.random.randint(0, 256, (480, 640, 3), dtype=np.uint8), (5, 5), 0)
+        cv2.rectangle(bgr, (200, 150), (400, 300), (255, 255, 255), 3)
+        gray = cv2.cvtColor(bgr, cv2.COLOR_BGR2GRAY)
+        template = gray[150:230, 300:380].copy()
+        
+        # BGR输入在C++端按ROI转换灰度
+        expected = vision_cpp_ext.template_matching(gray, template, vision_cpp_ext.TM_CCOEFF_NORMED, 0.9, False, 0, 0, 0, 0)
+        actual = vision_cpp_ext.template_matching(bgr, template, vision_cpp_ext.TM_CCOEFF_NORMED, 0.9, False, 0, 0, 0, 0)
+        if [tuple(m[:2]) for m in expected] != [tuple(m[:2]) for m in actual]:
+            print(f"✗ BGR输入匹配结果不一致: {expected} vs {actual}")
+            return False
+        
+        edges_gray = vision_cpp_ext.roi_edge_detection(gray, 150, 100, 300, 250, 50, 30)
+        edges_bgr = vision_cpp_ext.roi_edge_detection(bgr, 150, 100, 300, 250, 50, 30)
+        if len(edges_gray) != len(edges_bgr):
+            print(f"✗ BGR输入抓边结果不一致: {len(edges_gray)} vs {len(edges_bgr)}")
+            return False
+        
+        # 非连续切片（隔列采样）无需Python端拷贝
+        strided = gray[:, ::2]
+        packed = np.ascontiguousarray(strided)
+        tmpl_small = packed[150:230, 150:190].copy()
+        expected = vision_cpp_ext.template_matching(packed, tmpl_small, vision_cpp_ext.TM_CCOEFF_NORMED, 0.9, False, 0, 0, 0, 0)
+        actual = vision_cpp_ext.template_matching(strided, tmpl_small, vision_cpp_ext.TM_CCOEFF_NORMED, 0.9, False, 0, 0, 0, 0)
+        if [tuple(m[:2]) for m in expected] != [tuple(m[:2]) for m in actual]:
+            print(f"✗ 非连续输入匹配结果不一致: {expected} vs {actual}")
+            return False
+        
+        print(f"✓ 彩色/非连续输入结果一致 (匹配 {len(actual)} 个, 边缘 {len(edges_bgr)} 条)")
+        return True
+        
+    except Exception as e:
+        print(f"✗ 彩色与非连续输入测试失败: {e}")
+        return False
+
+def test_edge_detector():
+    """测试可复用的 EdgeDetector（与 roi_edge_detection 结果一致）"""
+    print("\n" + "=" * 50)
+    print("测试11: EdgeDetector 缓冲区复用")
+    print("=" * 50)
+    
+    try:
+        import vision_cpp_ext
+        
+        test_image = np.zeros((480, 640), dtype=np.uint8)
+        cv2.rectangle(test_image, (200, 150), (400, 300), 255, 2)
+        cv2.line(test_image, (100, 100), (500, 400), 128, 3)
+        
+        detector = vision_cpp_ext.EdgeDetector()
+        detector.reserve(300, 250)
+        reserved = detector.scratch_bytes
+        
+        for roi in [(150, 100, 300, 250), (180, 120, 120, 60), (150, 100, 300, 250)]:
+            expected = vision_cpp_ext.roi_edge_detection(test_image, *roi, 50, 30)
+            actual = detector.detect(test_image, *roi, 50, 30)
+            if list(expected) != list(actual):
+                print(f"✗ ROI {roi} 结果不一致: {len(expected)} vs {len(actual)}")
+                return False
+        
+        if detector.scratch_bytes != reserved:
+            print(f"✗ 预留后缓冲区仍在增长: {reserved} -> {detector.scratch_bytes}")
+            return False
+        
+        # 大量短生命周期线程调用后，缓冲区只按并发数保留（最多8组），不随线程数增长
+        import threading
+        for _ in range(4):
+            workers = [threading.Thread(target=detector.detect, args=(test_image, 150, 100, 300, 250, 50, 30))
+                       for _ in range(16)]
+            for w in workers:
+                w.start()
+            for w in workers:
+                w.join()
+        if detector.scratch_bytes > 8 * reserved:
+            print(f"✗ 多线程调用后缓冲区未受限: {detector.scratch_bytes} 字节")
+            return False
+        
+        print(f"✓ EdgeDetector 结果一致，缓冲区 {reserved} 字节未再增长")
+        return True
+        
+    except Exception as e:
+        print(f"✗ EdgeDetector 测试失败: {e}")
+        return False
+
+def test_fused_edge_path():
+    """测试小ROI融合路径（与通用路径输出格式一致）"""
+    print("\n" + "=" * 50)
+    print("测试12: 小ROI融合抓边")
+    print("=" * 50)
+    
+    try:
+        import vision_cpp_ext
+        
+        test_image = np.full((480, 640), 40, dtype=np.uint8)
+        cv2.rectangle(test_image, (200, 150), (400, 300), 220, 2)
+        test_image = cv2.add(test_image, np.random.randint(0, 10, test_image.shape, dtype=np.uint8))
+        
+        roi = (220, 120, 160, 60)  # 顶边附近的窄条
+        fused = vision_cpp_ext.EdgeDetector()
+        general = vision_cpp_ext.EdgeDetector(fused_max_area=0)
+        if roi[2] * roi[3] > fused.fused_max_area:
+            print("✗ 测试ROI超出融合路径面积上限")
+            return False
+        
+        fused_edges = fused.detect(test_image, *roi, 50, 30)
+        general_edges = general.detect(test_image, *roi, 50, 30)
+        if len(fused_edges) == 0 or len(general_edges) == 0:
+            print(f"✗ 未检测到边缘: 融合 {len(fused_edges)}, 通用 {len(general_edges)}")
+            return False
+        
+        for mid_x, mid_y, angle in fused_edges:
+            if abs(mid_y - 150) > 3 or min(abs(angle), 180 - abs(angle)) > 5:
+                print(f"✗ 融合路径检测到偏离顶边的线段: ({mid_x:.1f}, {mid_y:.1f}, {angle:.1f})")
+                return False
+        
+        print(f"✓ 融合路径 {len(fused_edges)} 条线段, 通用路径 {len(general_edges)} 条线段")
+        return True
+        
+    except Exception as e:
+        print(f"✗ 融合抓边测试失败: {e}")
+        return False
+
+def test_roi_edge_line():
+    """测试卡尺亚像素抓边直线拟合"""
+    print("\n" + "=" * 50)
+    print("测试13: 卡尺抓边直线拟合")
+    print("=" * 50)
+    
+    try:
+        import vision_cpp_ext
+        
+        # 斜率0.05的暗/亮分界线，上方暗、下方亮
+        slope, intercept = 0.05, 200.3
+        yy, xx = np.mgrid[0:480, 0:640]
+        test_image = np.where(yy > intercept + slope * xx, 200, 50).astype(np.uint8)
+        test_image = cv2.GaussianBlur(test_image, (5, 5), 1.0)
+        test_image[160, 300:320] = 255  # ROI内的亮线干扰
+        
+        roi = (200, 150, 200, 120)
+        result = vision_cpp_ext.roi_edge_line(test_image, *roi, direction=vision_cpp_ext.SCAN_DOWN, polarity=1)
+        if result is None:
+            print("✗ 未拟合出直线")
+            return False
+        
+        x, y, angle, residual, inliers = result
+        expected_angle = np.degrees(np.arctan(slope))
+        # 像素级阶梯边缘，拟合直线应落在真实分界线半像素以内
+        if abs(y - (intercept + slope * x)) > 0.5 or abs(angle - expected_angle) > 0.5:
+            print(f"✗ 拟合结果偏差过大: ({x:.2f}, {y:.2f}, {angle:.2f}), 期望角度 {expected_angle:.2f}")
+            return False
+        if residual > 0.5 or inliers < 12:
+            print(f"✗ 残差过大或内点过少: residual={residual:.3f}, inliers={inliers}")
+            return False
+        
+        flat = np.full((480, 640), 128, dtype=np.uint8)
+        if vision_cpp_ext.roi_edge_line(flat, *roi) is not None:
+            print("✗ 平坦图像不应拟合出直线")
+            return False
+        
+        print(f"✓ 直线 ({x:.2f}, {y:.2f}), 角度 {angle:.2f}°, 残差 {residual:.3f}, 内点 {inliers}")
+        return True
+        
+    except Exception as e:
+        print(f"✗ 卡尺抓边测试失败: {e}")
+        return False
+
+def test_vision_pipeline():
+    """测试异步视觉流水线（结果与同步调用一致）"""
+    print("\n" + "=" * 50)
+    print("测试14: 异步视觉流水线")
+    print("=" * 50)
+    
+    try:
+        import vision_cpp_ext
+        
+        main_image = cv2.GaussianBlur(np.random.randint(0, 256, (480, 640), dtype=np.uint8), (5, 5), 0)
+        cv2.rectangle(main_image, (200, 150), (400, 300), 255, 2)
+        template = main_image[150:230, 300:380].copy()
+        handle = vision_cpp_ext.register_template(template)
+        
+        pipeline = vision_cpp_ext.VisionPipeline(capacity=4)
+        edge_stage = pipeline.add_edge_stage(150, 100, 300, 250, 50, 30)
+        match_stage = pipeline.add_match_stage(handle, threshold=0.9)
+        pipeline.start()
+        
+        frame_count = 6
+        submitted = 0
+        for i in range(frame_count):
+            while not pipeline.submit(main_image, frame_id=i):
+                time.sleep(0.001)  # 环形缓冲已满时稍等
+            submitted += 1
+        
+        results = []
+        while len(results) < submitted:
+            result = pipeline.poll(timeout_ms=2000)
+            if result is None:
+                break
+            results.append(result)
+        pipeline.stop()
+        
+        if [r['frame_id'] for r in results] != list(range(frame_count)):
+            print(f"✗ 帧顺序或数量错误: {[r['frame_id'] for r in results]}")
+            return False
+        
+        expected_edges = vision_cpp_ext.roi_edge_detection(main_image, 150, 100, 300, 250, 50, 30)
+        expected_matches = vision_cpp_ext.template_matching(main_image, handle, vision_cpp_ext.TM_CCOEFF_NORMED, 0.9, False, 0, 0, 0, 0)
+        for r in results:
+            if list(r['stages'][edge_stage]['edges']) != list(expected_edges):
+                print(f"✗ 帧 {r['frame_id']} 抓边结果与同步调用不一致")
+                return False
+            if [tuple(m[:2]) for m in r['stages'][match_stage]['matches']] != [tuple(m[:2]) for m in expected_matches]:
+                print(f"✗ 帧 {r['frame_id']} 匹配结果与同步调用不一致")
+                return False
+        
+        latency = np.mean([r['latency_ms'] for r in results])
+        print(f"✓ 流水线处理 {pipeline.processed} 帧, 平均延迟 {latency:.2f}ms")
+        return True
+        
+    except Exception as e:
+        print(f"✗ 异步视觉流水线测试失败: {e}")
+        return False
+
+def test_structured_output():
+    """测试结构化数组输出（与旧的元组输出一致）"""
+    print("\n" + "=" * 50)
+    print("测试15: 结构化数组输出")
+    print("=" * 50)
+    
+    try:
+        import vision_cpp_ext
+        
+        main_image = cv2.GaussianBlur(np.random.randint(0, 256, (480, 640), dtype=np.uint8), (5, 5), 0)
+        cv2.rectangle(main_image, (200, 150), (400, 300), 255, 2)
+        template = main_image[150:230, 300:380].copy()
+        
+        legacy = vision_cpp_ext.roi_edge_detection(main_image, 150, 100, 300, 250, 50, 30)
+        edges = vision_cpp_ext.roi_edge_detection(main_image, 150, 100, 300, 250, 50, 30, legacy_output=False)
+        if edges.dtype.names != ('x', 'y', 'angle') or len(edges) != len(legacy):
+            print(f"✗ 抓边结构化输出格式错误: {edges.dtype}")
+            return False
+        if not np.allclose(np.array([tuple(e) for e in edges]).reshape(-1, 3), np.array(legacy).reshape(-1, 3)):
+            print("✗ 抓边结构化输出与元组输出不一致")
+            return False
+        
+        legacy = vision_cpp_ext.template_matching(main_image, template, vision_cpp_ext.TM_CCOEFF_NORMED, 0.5, True, 0, 0, 0, 0)
+        matches = vision_cpp_ext.template_matching(main_image, template, vision_cpp_ext.TM_CCOEFF_NORMED, 0.5, True,
+                                                   0, 0, 0, 0, legacy_output=False)
+        if matches.dtype.names != ('x', 'y', 'confidence') or len(matches) != len(legacy):
+            print(f"✗ 匹配结构化输出格式错误: {matches.dtype}, {len(matches)} vs {len(legacy)}")
+            return False
+        if [(int(m['x']), int(m['y'])) for m in matches] != [tuple(m[:2]) for m in legacy]:
+            print("✗ 匹配结构化输出与元组输出不一致")
+            return False
+        
+        line = vision_cpp_ext.roi_edge_line(main_image, 220, 120, 160, 60, legacy_output=False)
+        if line.dtype.names != ('x', 'y', 'angle', 'residual', 'inliers', 'points') or len(line) > 1:
+            print(f"✗ 直线结构化输出格式错误: {line.dtype}")
+            return False
+        
+        print(f"✓ 结构化输出一致 (边缘 {len(edges)}, 匹配 {len(matches)}, 直线 {len(line)})")
+        return True
+        
+    except Exception as e:
+        print(f"✗ 结构化数组输出测试失败: {e}")
+        return False
+
+def test_pose_math_batch():
+    """测试批量位姿运算（elite_ext，与 cv2.Rodrigues 对照）"""
+    print("\n" + "=" * 50)
+    print("测试16: 批量位姿运算")
+    print("=" * 50)
+    
+    try:
+        import elite_ext
+    except ImportError as e:
+        print(f"- 跳过: elite_ext 不可用 ({e})")
+        return True
+    
+    try:
+        rng = np.random.default_rng(0)
+        poses = np.hstack([rng.uniform(-0.5, 0.5, (500, 3)), rng.uniform(-2.0, 2.0, (500, 3))])
+        poses[0, 3:] = [0.0, 0.0, np.pi]  # 180度奇异点
+        
+        R = elite_ext.rotvec_to_matrix(poses)
+        ref = np.array([cv2.Rodrigues(p[3:])[0] for p in poses])
+        if R.shape != (500, 3, 3) or not np.allclose(R, ref, atol=1e-9):
+            print("✗ rotvec_to_matrix 与 cv2.Rodrigues 不一致")
+            return False
+        if not np.allclose(elite_ext.rotvec_to_matrix(elite_ext.matrix_to_rotvec(R)), R, atol=1e-9):
+            print("✗ matrix_to_rotvec 往返误差过大")
+            return False
+        
+        T = elite_ext.pose_to_matrix(poses)
+        expected = T @ T
+        composed = elite_ext.pose_to_matrix(elite_ext.pose_trans(poses, poses))
+        if not np.allclose(composed, expected, atol=1e-9):
+            print("✗ pose_trans 与矩阵乘法不一致")
+            return False
+        if not np.allclose(elite_ext.pose_trans(poses, elite_ext.pose_inv(poses)), 0.0, atol=1e-9):
+            print("✗ pose_inv 错误")
+            return False
+        added = elite_ext.pose_add(poses, poses[1])
+        if not np.allclose(added[:, :3], poses[:, :3] + poses[1, :3]):
+            print("✗ pose_add 位置错误")
+            return False
+        
+        a, b = poses[1], poses[2]
+        path = elite_ext.interpolate_pose(a, b, np.linspace(0.0, 1.0, 11))
+        if path.shape != (11, 6) or not np.allclose(elite_ext.pose_to_matrix(path[[0, -1]]), T[1:3], atol=1e-9):
+            print("✗ interpolate_pose 端点错误")
+            return False
+        deg = elite_ext.pose_to_matrix(np.hstack([poses[:, :3], np.degrees(poses[:, 3:])]), degrees=True)
+        if not np.allclose(deg, T, atol=1e-9):
+            print("✗ degrees=True 换算错误")
+            return False
+        
+        start = time.time()
+        elite_ext.pose_trans(np.tile(poses, (200, 1)), poses[3])
+        print(f"✓ 批量位姿运算正确 (100000 次 pose_trans 耗时 {(time.time() - start) * 1000:.1f}ms)")
+        return True
+        
+    except Exception as e:
+        print(f"✗ 批量位姿运算测试失败: {e}")
+        return False
+
+def test_perf_stats():
+    """测试热路径计时与计数器"""
+    print("\n" + "=" * 50)
+    print("测试17: 性能统计")
+    print("=" * 50)
+    
+    try:
+        import vision_cpp_ext
+        
+        if not vision_cpp_ext.PERF_STATS_ENABLED:
+            if vision_cpp_ext.get_perf_stats():
+                print("✗ 关闭插桩时仍返回统计")
+                return False
+            print("- 跳过: 编译时关闭了 PERF_STATS")
+            return True
+        
+        test_image = np.zeros((480, 640), dtype=np.uint8)
+        cv2.rectangle(test_image, (150, 150), (450, 350), 255, 2)
+        vision_cpp_ext.reset_perf_stats()
+        for _ in range(10):
+            vision_cpp_ext.roi_edge_detection(test_image, 100, 100, 400, 300, 50, 30)
+        stats = vision_cpp_ext.get_perf_stats()
+        
+        entry = stats.get("vision.roi_edge_detection")
+        if not entry or entry["kind"] != "timer_ns" or entry["count"] != 10:
+            print(f"✗ 入口计时错误: {entry}")
+            return False
+        if stats["edge.hough_lines"]["count"] != 10:
+            print("✗ 阶段计时次数错误")
+            return False
+        if not (entry["p50"] <= entry["p99"] <= entry["max"]) or entry["total"] < stats["edge.hough_lines"]["total"]:
+            print(f"✗ 分位数/总耗时不一致: {entry}")
+            return False
+        
+        vision_cpp_ext.reset_perf_stats()
+        if vision_cpp_ext.get_perf_stats()["vision.roi_edge_detection"]["count"] != 0:
+            print("✗ reset_perf_stats 未清零")
+            return False
+        
+        print(f"✓ 性能统计正常 (抓边 p50 {entry['p50'] / 1000:.1f}us, 共 {len(stats)} 项)")
+        return True
+        
+    except Exception as e:
+        print(f"✗ 性能统计测试失败: {e}")
+        return False
+
+def test_cpu_dispatch():
+    """测试各SIMD级别的融合抓边结果一致"""
+    print("\n" + "=" * 50)
+    print("测试18: CPU运行时分派")
+    print("=" * 50)
+    
+    try:
+        import vision_cpp_ext
+        
+        test_image = cv2.GaussianBlur(np.random.randint(0, 256, (480, 640), dtype=np.uint8), (5, 5), 0)
+        cv2.rectangle(test_image, (200, 150), (400, 300), 255, 2)
+        
+        detected = vision_cpp_ext.get_cpu_dispatch()
+        levels = ["scalar", "sse4.2", "avx2", "avx512", "neon"]
+        reference = None
+        used = []
+        try:
+            for level in levels:
+                active = vision_cpp_ext.set_cpu_dispatch(level)
+                if active in used:
+                    continue
+                used.append(active)
+                # 宽度取奇数，覆盖向量化主循环和标量尾部
+                result = vision_cpp_ext.roi_edge_detection(test_image, 150, 100, 251, 201, 50, 30)
+                if reference is None:
+                    reference = result
+                elif result != reference:
+                    print(f"✗ {active} 与 scalar 结果不一致")
+                    return False
+        finally:
+            vision_cpp_ext.set_cpu_dispatch(detected)
+        
+        print(f"✓ 分派级别 {detected}，已比较: {', '.join(used)}")
+        return True
+        
+    except Exception as e:
+        print(f"✗ CPU分派测试失败: {e}")
+        return False
+
+def test_multi_camera_executor():
+    """测试多相机并行执行器（按时间戳合并）"""
+    print("\n" + "=" * 50)
+    print("测试19: 多相机并行执行器")
+    print("=" * 50)
+    
+    try:
+        import vision_cpp_ext
+        
+        main_image = cv2.GaussianBlur(np.random.randint(0, 256, (480, 640), dtype=np.uint8), (5, 5), 0)
+        cv2.rectangle(main_image, (200, 150), (400, 300), 255, 2)
+        handle = vision_cpp_ext.register_template(main_image[150:230, 300:380].copy())
+        
+        camera_count = 3
+        executor = vision_cpp_ext.MultiCameraExecutor(sync_tolerance_ms=1.0, max_wait_ms=500)
+        for i in range(camera_count):
+            cam = executor.add_camera(capacity=4, core=i)
+            cam.add_edge_stage(150, 100, 300, 250, 50, 30)
+            cam.add_match_stage(handle, threshold=0.9)
+        executor.start()
+        
+        frame_count = 5
+        for f in range(frame_count):
+            timestamp = 100.0 + f * 0.04  # 同一触发的所有相机共用一个时间戳
+            for c in range(camera_count):
+                while not executor.submit(c, main_image, timestamp=timestamp, frame_id=f):
+                    time.sleep(0.001)
+        
+        sets = []
+        while len(sets) < frame_count:
+            frame_set = executor.poll(timeout_ms=2000)
+            if frame_set is None:
+                break
+            sets.append(frame_set)
+        pinned = [executor.camera(i).pinned for i in range(camera_count)]
+        executor.stop()
+        
+        if len(sets) != frame_count or not all(s['complete'] for s in sets):
+            print(f"✗ 合并帧数或完整性错误: {len(sets)}, {[s['complete'] for s in sets]}")
+            return False
+        if [s['timestamp'] for s in sets] != sorted(s['timestamp'] for s in sets):
+            print("✗ 合并结果未按时间戳排序")
+            return False
+        
+        expected_edges = list(vision_cpp_ext.roi_edge_detection(main_image, 150, 100, 300, 250, 50, 30))
+        for s in sets:
+            frame_ids = {cam['frame_id'] for cam in s['cameras']}
+            if len(frame_ids) != 1:
+                print(f"✗ 同一帧组内混入了不同帧: {frame_ids}")
+                return False
+            if any(list(cam['stages'][0]['edges']) != expected_edges for cam in s['cameras']):
+                print("✗ 相机结果与同步调用不一致")
+                return False
+
+        # stop 时尚未凑齐的帧组应作为不完整帧组交付，而不是被丢弃
+        partial = vision_cpp_ext.MultiCameraExecutor(sync_tolerance_ms=1.0, max_wait_ms=60000)
+        for i in range(2):
+            partial.add_camera(capacity=4).add_edge_stage(150, 100, 300, 250, 50, 30)
+        partial.start()
+        while not partial.submit(0, main_image, timestamp=200.0, frame_id=7):
+            time.sleep(0.001)
+        deadline = time.time() + 2.0
+        while partial.camera(0).processed < 1 and time.time() < deadline:
+            time.sleep(0.001)
+        partial.stop()
+        flushed = partial.poll(timeout_ms=0)
+        if (flushed is None or flushed['complete'] or flushed['cameras'][1] is not None
+                or flushed['cameras'][0]['frame_id'] != 7 or partial.incomplete != 1):
+            print(f"✗ stop 时未交付不完整帧组: {flushed}, incomplete={partial.incomplete}")
+            return False
+
+        # 超时已交付的帧组之后才到的结果不能再生成更早的帧组（保证按时间戳顺序）
+        ordered = vision_cpp_ext.MultiCameraExecutor(sync_tolerance_ms=1.0, max_wait_ms=20)
+        for i in range(2):
+            ordered.add_camera(capacity=4).add_edge_stage(150, 100, 300, 250, 50, 30)
+        ordered.start()
+        while not ordered.submit(0, main_image, timestamp=300.0, frame_id=1):
+            time.sleep(0.001)
+        first = ordered.poll(timeout_ms=2000)
+        while not ordered.submit(1, main_image, timestamp=300.0, frame_id=1):
+            time.sleep(0.001)
+        deadline = time.time() + 2.0
+        while ordered.late_results < 1 and time.time() < deadline:
+            time.sleep(0.001)
+        late_set = ordered.poll(timeout_ms=100)
+        ordered.stop()
+        if first is None or first['complete'] or late_set is not None or ordered.late_results != 1:
+            print(f"✗ 迟到结果处理错误: {first}, {late_set}, late={ordered.late_results}")
+            return False
+
+        print(f"✓ {camera_count} 路相机合并 {executor.merged} 组, 绑核 {pinned}")
+        return True
+        
+    except Exception as e:
+        print(f"✗ 多相机执行器测试失败: {e}")
+        return False
+
+def test_roi_tracker():
+    """测试帧间ROI跟踪（小窗口搜索与全ROI回退）"""
+    print("\n" + "=" * 50)
+    print("测试20: 帧间ROI跟踪")
+    print("=" * 50)
+    
+    try:
+        import vision_cpp_ext
+        
+        background = cv2.GaussianBlur(np.random.randint(0, 256, (480, 640), dtype=np.uint8), (5, 5), 0)
+        target = cv2.GaussianBlur(np.random.randint(0, 256, (40, 40), dtype=np.uint8), (3, 3), 0)
+        handle = vision_cpp_ext.register_template(target)
+        
+        def frame_with_target(x, y):
+            frame = background.copy()
+            frame[y:y + 40, x:x + 40] = target
+            return frame
+        
+        tracker = vision_cpp_ext.TemplateTracker(handle, 0, 0, 640, 480, threshold=0.9)
+        positions = [(100 + 3 * i, 200 + i) for i in range(30)]
+        for x, y in positions:
+            found = tracker.track(frame_with_target(x, y))
+            if len(found) != 1 or tuple(found[0][:2]) != (x, y):
+                print(f"✗ 跟踪位置错误: 期望 {(x, y)}, 得到 {found}")
+                return False
+        
+        stats = tracker.stats
+        if stats['full_searches'] != 1 or stats['search_area_ratio'] > 0.2:
+            print(f"✗ 稳态未使用小窗口搜索: {stats}")
+            return False
+        
+        # 目标跳出搜索窗口后应回退到全ROI重新找到
+        found = tracker.track(frame_with_target(500, 50))
+        if len(found) != 1 or tuple(found[0][:2]) != (500, 50) or tracker.stats['fallbacks'] != 1:
+            print(f"✗ 跳变后未回退到全ROI: {found}, {tracker.stats}")
+            return False
+        
+        edge_image = np.zeros((480, 640), dtype=np.uint8)
+        edge_tracker = vision_cpp_ext.EdgeTracker(0, 0, 640, 480, 50, 30)
+        for i in range(10):
+            frame = edge_image.copy()
+            cv2.line(frame, (100, 200 + i), (500, 200 + i), 255, 3)
+            edges = edge_tracker.track(frame)
+            if len(edges) == 0 or not all(abs(e[1] - (200 + i)) <= 3 for e in edges):
+                print(f"✗ 边缘跟踪结果错误: 第 {i} 帧 {edges}")
+                return False
+        
+        print(f"✓ 跟踪搜索面积比 {stats['search_area_ratio']:.3f}, 边缘 {edge_tracker.stats['search_area_ratio']:.3f}")
+        return True
+        
+    except Exception as e:
+        print(f"✗ ROI跟踪测试失败: {e}")
+        return False
+
+def test_visual_servo_link():
+    """测试视觉流水线到 elite_ext.VisualServo 的原生连接（无需机器人）"""
+    print("\n" + "=" * 50)
+    print("测试21: 视觉伺服连接")
+    print("=" * 50)
+    
+    try:
+        import vision_cpp_ext
+        import elite_ext
+    except ImportError as e:
+        print(f"- 跳过: elite_ext 不可用 ({e})")
+        return True
+    
+    try:
+        calib_dir = current_dir.parent
+        robot = elite_ext.EliteRobotController()
+        servo = elite_ext.VisualServo(robot, working_distance_mm=300)
+        servo.load_calibration(str(calib_dir / "intrinsics.json"), str(calib_dir / "distCoeffs.json"),
+                               str(calib_dir / "T_eye_in_hand_chessboard.json"))
+        
+        # 主点处的像素应落在光轴上
+        x, y, z = servo.pixel_to_camera(323.994426, 241.155806)
+        if abs(x) > 1e-6 or abs(y) > 1e-6 or abs(z - 300.0) > 1e-9:
+            print(f"✗ 主点换算错误: {(x, y, z)}")
+            return False
+        if servo.start():
+            print("✗ 未连接机器人时不应启动伺服")
+            return False
+        
+        # 非单位姿态下的基坐标系速度: 目标在图像 +x 方向时应沿相机 x 轴 (转到基坐标系) 运动
+        import json
+        with open(calib_dir / "T_eye_in_hand_chessboard.json", encoding='utf-8') as f:
+            R_fc = np.array(json.load(f)["T"])[:3, :3]
+        servo.set_target(323.994426, 241.155806)
+        for rotvec_deg in ([0.0, 0.0, 90.0], [20.0, -30.0, 90.0]):
+            R_bf = cv2.Rodrigues(np.radians(rotvec_deg))[0]
+            expected = R_bf @ R_fc[:, 0]
+            speed = np.array(servo.command(373.994426, 241.155806, [400.0, 0.0, 300.0] + rotvec_deg))
+            v = speed[:3]
+            if np.linalg.norm(v) < 1.0 or np.dot(v / np.linalg.norm(v), expected) < 0.999 or np.any(speed[3:] != 0.0):
+                print(f"✗ 姿态 {rotvec_deg} 下伺服速度方向错误: {speed}, 期望方向 {expected}")
+                return False
+        
+        main_image = cv2.GaussianBlur(np.random.randint(0, 256, (480, 640), dtype=np.uint8), (5, 5), 0)
+        handle = vision_cpp_ext.register_template(main_image[200:240, 300:340].copy())
+        pipeline = vision_cpp_ext.VisionPipeline(capacity=4)
+        edge_stage = pipeline.add_edge_stage(150, 100, 300, 250, 50, 30)
+        match_stage = pipeline.add_match_stage(handle, threshold=0.9)
+        
+        for bad in ((object(), match_stage), (servo.native_sink(), edge_stage)):
+            try:
+                pipeline.set_servo_sink(*bad)
+                print("✗ 无效的伺服连接未报错")
+                return False
+            except RuntimeError:
+                pass
+        
+        pipeline.set_servo_sink(servo.native_sink(), match_stage)
+        pipeline.start()
+        frame_count = 5
+        for i in range(frame_count):
+            while not pipeline.submit(main_image, frame_id=i):
+                time.sleep(0.001)
+        for _ in range(frame_count):
+            if pipeline.poll(timeout_ms=2000) is None:
+                break
+        pipeline.stop()
+        
+        stats = servo.stats
+        if stats['received'] != frame_count or stats['measurements'] != 0:
+            print(f"✗ 伺服未收到流水线测量值: {stats}")
+            return False
+        
+        print(f"✓ 流水线 {frame_count} 帧直接送达伺服")
+        return True
+        
+    except Exception as e:
+        print(f"✗ 视觉伺服连接测试失败: {e}")
+        return False
+
+def test_calibration_log():
+    """测试二进制标定日志（逐点追加、零拷贝读取与CSV导出）"""
+    print("\n" + "=" * 50)
+    print("测试22: 标定数据日志")
+    print("=" * 50)
+    
+    try:
+        import elite_ext
+    except ImportError as e:
+        print(f"- 跳过: elite_ext 不可用 ({e})")
+        return True
+    
+    try:
+        import tempfile
+        sys.path.insert(0, str(current_dir.parent))
+        import calibration_log_tool
+        
+        if calibration_log_tool.CALIB_LOG_DTYPE != elite_ext.CALIB_LOG_DTYPE or \
+                calibration_log_tool.CALIB_LOG_HEADER_DTYPE.itemsize != elite_ext.CALIB_LOG_HEADER_SIZE:
+            print("✗ Python 端记录格式与 C++ 不一致")
+            return False
+        
+        with tempfile.TemporaryDirectory() as tmp:
+            path = os.path.join(tmp, "calib.calib")
+            log = elite_ext.CalibrationLog()
+            if not log.open(path, capacity=4, kind=elite_ext.CALIB_RUN_PYRAMID, description="layers=5"):
+                print("✗ 无法创建标定日志")
+                return False
+            
+            # 超出初始容量后应自动扩容，且每个点写入后文件即可读
+            point_count = 20
+            for i in range(point_count):
+                pose = [100.0 + i, 200.0, 300.0, 180.0, 0.0, float(i)]
+                log.append(i + 1, pose, settle_time=0.25, image=f"captures/calib_pt{i + 1}.jpg")
+                if i == 9:
+                    header, records = calibration_log_tool.load_calibration_log(path)
+                    if header['count'] != 10:
+                        print(f"✗ 写入中途读取到 {header['count']} 个点")
+                        return False
+            log.close()
+            
+            header, records = calibration_log_tool.load_calibration_log(path)
+            if header['count'] != point_count or header['description'] != "layers=5" or header['kind'] != "3D pyramid":
+                print(f"✗ 日志头错误: {header}")
+                return False
+            if not np.allclose(records['tcp_pose'][:, 0], (100.0 + np.arange(point_count)) / 1000.0) or \
+                    not np.allclose(records['tcp_pose'][:, 5], np.radians(np.arange(point_count)), atol=1e-6):
+                print("✗ 读取的位姿与写入不一致")
+                return False
+            if records['image'][3] != b"captures/calib_pt4.jpg" or not np.all(records['flags'] == elite_ext.CALIB_POINT_CAPTURED):
+                print("✗ 图像引用或标志位错误")
+                return False
+            
+            csv_path = os.path.join(tmp, "calib.txt")
+            calibration_log_tool.export_csv(path, csv_path)
+            del records
+            with open(csv_path, encoding='utf-8') as f:
+                lines = f.read().splitlines()
+            if lines[0] != "PointID, X, Y, Z, Rx, Ry, Rz" or len(lines) != point_count + 1 or \
+                    lines[1] != "1, 0.100000, 0.200000, 0.300000, 3.141593, 0.000000, 0.000000":
+                print(f"✗ CSV导出格式错误: {lines[:2]}")
+                return False
+        
+        print(f"✓ {point_count} 点逐点落盘, 零拷贝读取与CSV导出一致")
+        return True
+        
+    except Exception as e:
+        print(f"✗ 标定日志测试失败: {e}")
+        return False
+
+def test_hand_eye_calibration():
+    """测试原生手眼与畸变标定求解（合成数据）"""
+    print("\n" + "=" * 50)
+    print("测试23: 手眼标定求解")
+    print("=" * 50)
+    
+    try:
+        import vision_cpp_ext
+        import tempfile
+        
+        # 棋盘格检测: 渲染一张 10x7 方格 (9x6 内角点) 的图像
+        board_img = np.full((480, 640), 255, dtype=np.uint8)
+        for r in range(7):
+            for c in range(10):
+                if (r + c) % 2 == 0:
+                    board_img[60 + r * 40:100 + r * 40, 120 + c * 40:160 + c * 40] = 0
+        with tempfile.TemporaryDirectory() as tmp:
+            path = os.path.join(tmp, "board.png")
+            cv2.imwrite(path, board_img)
+            found, image_size = vision_cpp_ext.find_chessboard_corners([path, os.path.join(tmp, "missing.png")], (9, 6))
+        if image_size != (640, 480) or found[0] is None or found[0].shape != (54, 2) or found[1] is not None:
+            print(f"✗ 棋盘格检测结果错误: {image_size}, {[None if f is None else f.shape for f in found]}")
+            return False
+        # 角点起始方向不固定，只比较范围
+        lo, hi = found[0].min(axis=0), found[0].max(axis=0)
+        if np.abs(lo - [160, 100]).max() > 1.0 or np.abs(hi - [480, 300]).max() > 1.0:
+            print(f"✗ 角点位置错误: {lo} - {hi}")
+            return False
+        
+        # 合成数据: 已知内参、畸变、手眼矩阵与标定板位姿，生成各视角下的机械臂位姿与角点
+        def transform(rvec, t):
+            T = np.eye(4)
+            T[:3, :3] = cv2.Rodrigues(np.asarray(rvec, dtype=np.float64))[0]
+            T[:3, 3] = t
+            return T
+        
+        rng = np.random.default_rng(7)
+        K = np.array([[605.0, 0, 324.0], [0, 606.0, 241.0], [0, 0, 1]])
+        dist = np.array([-0.05, 0.12, 0.0005, -0.0005, -0.1])
+        X = transform([0.01, -0.01, -1.56], [50.9, 34.4, 38.6])     # 法兰 -> 相机 (mm)
+        W = transform([np.pi * 0.97, 0.04, 0.1], [450.0, 120.0, 0.0])  # 基座 -> 标定板 (mm)
+        board = np.array([[c * 20.0, r * 20.0, 0.0] for r in range(6) for c in range(9)])
+        
+        poses, corners = [], []
+        for i in range(20):
+            cam_T_board = transform(rng.normal(0, [0.25, 0.25, 0.5]),
+                                    [rng.normal(-80, 20), rng.normal(-50, 20), rng.normal(380, 40)])
+            base_T_flange = W @ np.linalg.inv(cam_T_board) @ np.linalg.inv(X)
+            rvec = cv2.Rodrigues(base_T_flange[:3, :3])[0].ravel()
+            poses.append(np.concatenate([base_T_flange[:3, 3] / 1000.0, rvec]))
+            pts, _ = cv2.projectPoints(board, cv2.Rodrigues(cam_T_board[:3, :3])[0], cam_T_board[:3, 3], K, dist)
+            corners.append((pts.reshape(-1, 2) + rng.normal(0, 0.1, (54, 2))).astype(np.float32))
+        corners[5] = None  # 未检测到棋盘格的点被跳过
+        
+        result = vision_cpp_ext.calibrate_hand_eye(np.array(poses), corners, (9, 6), 20.0, (640, 480),
+                                                   rotation_vector=True)
+        T = np.array(result['T'])
+        t_err = np.linalg.norm(T[:3, 3] - X[:3, 3])
+        r_err = np.degrees(np.linalg.norm(cv2.Rodrigues(T[:3, :3].T @ X[:3, :3])[0]))
+        fx = result['intrinsics'][0][0]
+        if result['views_used'] != 19 or result['view_errors'][5] != -1.0 or len(result['distCoeffs'][0]) != 5:
+            print(f"✗ 视图统计错误: {result['views_used']}, {result['view_errors']}")
+            return False
+        if result['rms'] > 0.3 or t_err > 1.0 or r_err > 0.2 or abs(fx - 605.0) > 3.0:
+            print(f"✗ 求解精度不足: rms={result['rms']:.3f}px, t={t_err:.3f}mm, r={r_err:.3f}deg, fx={fx:.1f}")
+            return False
+        
+        print(f"✓ {result['views_used']} 视图, 重投影 {result['initial_rms']:.2f} -> {result['rms']:.3f}px, "
+              f"手眼误差 {t_err:.2f}mm / {r_err:.3f}deg, 耗时 {result['elapsed_ms']:.1f}ms")
+        return True
+        
+    except Exception as e:
+        print(f"✗ 手眼标定测试失败: {e}")
+        return False
+
+def test_capture_settle_after_arrival():
+    """测试采集前的到位与稳定等待（注入状态代替机器人）"""
+    print("\n" + "=" * 50)
+    print("测试24: 到位后再检测稳定")
+    print("=" * 50)
+    
+    try:
+        import elite_ext
+        import threading
+    except ImportError as e:
+        print(f"- 跳过: elite_ext 不可用 ({e})")
+        return True
+    
+    try:
+        robot = elite_ext.EliteRobotController()
+        calib = elite_ext.EliteCalibration()
+        start = [400.0, 0.0, 300.0, 180.0, 0.0, 0.0]
+        # 与起点几乎相同的目标 (抖动点仅偏 0.1mm)，起点本身就在容差内且静止
+        target = [400.1, 0.0, 300.0, 180.0, 0.0, 0.0]
+        robot.inject_state(start)
+        calib.set_state_source(robot)
+        calib.set_settle_config(samples=5)
+        
+        result = {}
+        def wait():
+            result['value'] = calib.wait_for_capture_pose(target, timeout=3.0, max_settle_ms=1500)
+            result['done_at'] = time.perf_counter()
+        waiter = threading.Thread(target=wait)
+        waiter.start()
+        
+        # 运动尚未开始: 机械臂静止在起点，不应判为到位或稳定
+        t_end = time.perf_counter() + 0.3
+        while time.perf_counter() < t_end:
+            robot.inject_state(start)
+            time.sleep(0.004)
+        if 'value' in result:
+            print(f"✗ 运动开始前就已返回: {result['value']}")
+            return False
+        
+        moved_at = time.perf_counter()
+        for _ in range(10):
+            robot.inject_state(target, [1.0, 0.0, 0.0, 0.0, 0.0, 0.0], playing=True)
+            time.sleep(0.004)
+        while waiter.is_alive() and time.perf_counter() - moved_at < 2.0:
+            robot.inject_state(target)
+            time.sleep(0.004)
+        waiter.join()
+        
+        arrived, settle_s = result['value']
+        if not arrived or result['done_at'] < moved_at or settle_s >= 1.5:
+            print(f"✗ 到位/稳定判断错误: arrived={arrived}, settle={settle_s:.3f}s")
+            return False
+        
+        print(f"✓ 运动开始后才判到位，稳定耗时 {settle_s * 1000:.0f}ms")
+        return True
+        
+    except Exception as e:
+        print(f"✗ 到位稳定测试失败: {e}")
+        return False
+
+def test_pyramid_trajectory_blends():
+    """测试轨迹模式的金字塔路径确实带过渡半径（不再逐点停止）"""
+    print("\n" + "=" * 50)
+    print("测试25: 轨迹模式过渡半径")
+    print("=" * 50)
+    
+    try:
+        import elite_ext
+        import re
+    except ImportError as e:
+        print(f"- 跳过: elite_ext 不可用 ({e})")
+        return True
+    
+    try:
+        calib = elite_ext.EliteCalibration()
+        center = [400.0, 0.0, 300.0, 180.0, 0.0, 0.0]
+        script = calib.compile_pyramid_script(center, layers=3, base_width=100.0, top_width=50.0, height=50.0,
+                                              tilt_angle=10.0, blend_radius=10.0)
+        radii = [float(r) for r in re.findall(r"movel\(.*r=([-0-9.e]+)\)", script)]
+        captures = script.count("write_output_boolean_register(0, True)")
+        
+        # 每个拍照点前一个过渡点，首个过渡点与回到中心点无前后邻点，按精确停止处理
+        if captures != 12 or len(radii) != 2 * captures + 1:
+            print(f"✗ 路径点数错误: {captures} 个拍照点, {len(radii)} 条 movel")
+            return False
+        blended = [r for r in radii if r > 0]
+        if len(blended) != captures - 1 or any(r > 0.010 + 1e-9 for r in blended):
+            print(f"✗ 过渡半径错误: {radii}")
+            return False
+        
+        print(f"✓ {captures} 个拍照点, {len(blended)} 处过渡 (r={min(blended) * 1000:.1f}~{max(blended) * 1000:.1f}mm)")
+        return True
+        
+    except Exception as e:
+        print(f"✗ 轨迹过渡测试失败: {e}")
+        return False
+
 def main():
     """主测试函数"""
     print("C++扩展功能测试")
@@ -237,7 +1335,27 @@ def main():
         test_roi_edge_detection,
         test_template_matching,
         test_performance_comparison,
-        test_error_handling
+        test_error_handling,
+        test_template_matching_batch,
+        test_template_matching_peaks,
+        test_template_matching_pyramid,
+        test_template_handle,
+        test_color_and_strided_input,
+        test_edge_detector,
+        test_fused_edge_path,
+        test_roi_edge_line,
+        test_vision_pipeline,
+        test_structured_output,
+        test_pose_math_batch,
+        test_perf_stats,
+        test_cpu_dispatch,
+        test_multi_camera_executor,
+        test_roi_tracker,
+        test_visual_servo_link,
+        test_calibration_log,
+        test_hand_eye_calibration,
+        test_capture_settle_after_arrival,
+        test_pyramid_trajectory_blends
     ]
     
     passed = 0
@@ -0,0 +1,238 @@
+// Google Benchmark suite for the vision_cpp_ext kernels.
+//
+// Times the roi_edge_detection and template_matching paths (single and multiple matches, all
+// six TM_* methods) across ROI and template sizes, calling the kernels directly rather than
+// through Python. Each benchmark reports calls/s (items_per_second), ROI pixels/s and p50/p99
+// per-call latency in microseconds. Output is JSON unless another --benchmark_format is given.
+//
+//   vision_bench [--frames=DIR] [benchmark flags]
+//
+// DIR (or VISION_BENCH_FRAMES) holds recorded production frames (png/jpg/bmp/tif). They are
+// used round-robin; without them a synthetic 1280x1024 frame is generated.
+
+#define VISION_CPP_EXT_NO_MODULE
+#include "vision_cpp_ext.cpp"
+
+#include <benchmark/benchmark.h>
+#include <opencv2/imgcodecs.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+namespace
+{
+
+    std::vector<cv::Mat> bench_frames;
+
+    const int ROI_SIZES[] = {64, 128, 256, 512};
+    const int TEMPLATE_SIZES[] = {16, 32, 64};
+    const int EDGE_THRESHOLD = 50;
+    const int EDGE_MIN_LINE_LENGTH = 30;
+    const float MATCH_THRESHOLD = 0.8f;
+
+    const struct
+    {
+        int method;
+        const char *name;
+    } MATCH_METHODS[] = {
+        {cv::TM_SQDIFF, "TM_SQDIFF"},
+        {cv::TM_SQDIFF_NORMED, "TM_SQDIFF_NORMED"},
+        {cv::TM_CCORR, "TM_CCORR"},
+        {cv::TM_CCORR_NORMED, "TM_CCORR_NORMED"},
+        {cv::TM_CCOEFF, "TM_CCOEFF"},
+        {cv::TM_CCOEFF_NORMED, "TM_CCOEFF_NORMED"},
+    };
+
+    // Same kind of scene as test_cpp_extensions.py: smoothed noise with a few strong edges
+    cv::Mat syntheticFrame()
+    {
+        cv::Mat frame(1024, 1280, CV_8UC1);
+        cv::RNG rng(12345);
+        rng.fill(frame, cv::RNG::UNIFORM, 0, 256);
+        cv::GaussianBlur(frame, frame, cv::Size(5, 5), 0);
+        cv::rectangle(frame, cv::Point(400, 300), cv::Point(800, 600), 255, 2);
+        cv::circle(frame, cv::Point(900, 700), 80, 0, 3);
+        cv::line(frame, cv::Point(100, 900), cv::Point(1200, 850), 200, 2);
+        return frame;
+    }
+
+    void loadFrames(const std::string &dir)
+    {
+        if (!dir.empty())
+        {
+            std::vector<cv::String> files;
+            for (const char *ext : {"png", "jpg", "bmp", "tif"})
+            {
+                std::vector<cv::String> found;
+                cv::glob(dir + "/*." + ext, found, false);
+                files.insert(files.end(), found.begin(), found.end());
+            }
+            std::sort(files.begin(), files.end());
+            for (const auto &f : files)
+            {
+                cv::Mat img = cv::imread(f, cv::IMREAD_UNCHANGED);
+                if (!img.empty() && img.depth() == CV_8U && (img.channels() == 1 || img.channels() == 3 || img.channels() == 4))
+                    bench_frames.push_back(img);
+            }
+            if (bench_frames.empty())
+                std::fprintf(stderr, "vision_bench: no usable frames in %s, using a synthetic frame\n", dir.c_str());
+        }
+        if (bench_frames.empty())
+            bench_frames.push_back(syntheticFrame());
+    }
+
+    // size x size ROI centred in the frame, clamped to it
+    cv::Rect centredRoi(const cv::Mat &frame, int size)
+    {
+        int w = std::min(size, frame.cols);
+        int h = std::min(size, frame.rows);
+        return cv::Rect((frame.cols - w) / 2, (frame.rows - h) / 2, w, h);
+    }
+
+    // Per-call latencies of one benchmark run, reported as counters on the state
+    class LatencyRecorder
+    {
+    public:
+        explicit LatencyRecorder(benchmark::State &state) : state_(state) {}
+
+        template <typename F>
+        void time(F &&f)
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            f();
+            auto t1 = std::chrono::steady_clock::now();
+            samples_.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+        }
+
+        void report(int64_t pixels_per_call)
+        {
+            if (samples_.empty())
+                return;
+            std::sort(samples_.begin(), samples_.end());
+            auto pct = [this](double p)
+            {
+                size_t i = std::min(samples_.size() - 1, static_cast<size_t>(p * (samples_.size() - 1) + 0.5));
+                return samples_[i];
+            };
+            state_.counters["p50_us"] = pct(0.50);
+            state_.counters["p99_us"] = pct(0.99);
+            state_.counters["pixels_per_s"] = benchmark::Counter(static_cast<double>(state_.iterations() * pixels_per_call),
+                                                                 benchmark::Counter::kIsRate);
+            state_.SetItemsProcessed(state_.iterations()); // items_per_second = calls/s
+        }
+
+    private:
+        benchmark::State &state_;
+        std::vector<double> samples_;
+    };
+
+    // roi_edge_detection: same path as the Python entry point, fresh scratch buffers per call
+    void BM_RoiEdgeDetection(benchmark::State &state, int roi_size)
+    {
+        static const cv::Mat kernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3));
+        LatencyRecorder latency(state);
+        size_t frame = 0;
+        int64_t pixels = 0;
+        for (auto _ : state)
+        {
+            const cv::Mat &img = bench_frames[frame++ % bench_frames.size()];
+            ImageView view = viewMat(img);
+            cv::Rect roi = centredRoi(img, roi_size);
+            pixels = roi.area();
+            latency.time([&]
+                         {
+                             EdgeScratch scratch;
+                             detectEdges(view, roi, EDGE_THRESHOLD, EDGE_MIN_LINE_LENGTH, 5, kernel, FUSED_EDGE_MAX_AREA, scratch);
+                             benchmark::DoNotOptimize(scratch.edge_points.data()); });
+        }
+        latency.report(pixels);
+    }
+
+    // template_matching without pyramid: ROI extraction, matchTemplate and result scan.
+    // The template is cut from the middle of each frame so there is always one true match.
+    void BM_TemplateMatching(benchmark::State &state, int roi_size, int template_size, int method, bool multiple)
+    {
+        std::vector<cv::Mat> templates;
+        for (const auto &img : bench_frames)
+            templates.push_back(extractGray(viewMat(img))(centredRoi(img, template_size)).clone());
+
+        LatencyRecorder latency(state);
+        size_t frame = 0;
+        int64_t pixels = 0;
+        for (auto _ : state)
+        {
+            size_t i = frame++ % bench_frames.size();
+            const cv::Mat &img = bench_frames[i];
+            const cv::Mat &tmpl = templates[i];
+            ImageView view = viewMat(img);
+            cv::Rect roi = centredRoi(img, std::max(roi_size, template_size));
+            pixels = roi.area();
+            latency.time([&]
+                         {
+                             cv::Mat roi_img = extractGrayRoi(view, roi);
+                             cv::Mat result;
+                             std::vector<MatchResult> found;
+                             matchInRoi(roi_img, roi.tl(), tmpl, nullptr, method, MATCH_THRESHOLD, multiple, nullptr, result, found);
+                             benchmark::DoNotOptimize(found.data()); });
+        }
+        latency.report(pixels);
+    }
+
+    void registerBenchmarks()
+    {
+        for (int roi : ROI_SIZES)
+            benchmark::RegisterBenchmark(("roi_edge_detection/roi:" + std::to_string(roi)).c_str(), BM_RoiEdgeDetection, roi)
+                ->Unit(benchmark::kMicrosecond);
+
+        for (bool multiple : {false, true})
+            for (const auto &m : MATCH_METHODS)
+                for (int roi : ROI_SIZES)
+                    for (int tmpl : TEMPLATE_SIZES)
+                    {
+                        if (tmpl >= roi)
+                            continue;
+                        std::string name = std::string("template_matching/") + (multiple ? "multiple/" : "single/") + m.name +
+                                           "/roi:" + std::to_string(roi) + "/template:" + std::to_string(tmpl);
+                        benchmark::RegisterBenchmark(name.c_str(), BM_TemplateMatching, roi, tmpl, m.method, multiple)
+                            ->Unit(benchmark::kMicrosecond);
+                    }
+    }
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    // Pull out our own flag and default to JSON output
+    std::string frames_dir;
+    if (const char *env = std::getenv("VISION_BENCH_FRAMES"))
+        frames_dir = env;
+    std::vector<char *> args;
+    bool has_format = false;
+    for (int i = 0; i < argc; ++i)
+    {
+        if (std::strncmp(argv[i], "--frames=", 9) == 0)
+        {
+            frames_dir = argv[i] + 9;
+            continue;
+        }
+        if (std::strncmp(argv[i], "--benchmark_format=", 19) == 0)
+            has_format = true;
+        args.push_back(argv[i]);
+    }
+    static char json_format[] = "--benchmark_format=json";
+    if (!has_format)
+        args.push_back(json_format);
+    int bench_argc = static_cast<int>(args.size());
+
+    loadFrames(frames_dir);
+    registerBenchmarks();
+
+    benchmark::Initialize(&bench_argc, args.data());
+    if (benchmark::ReportUnrecognizedArguments(bench_argc, args.data()))
+        return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -6,189 +6,4381 @@
 #include <cmath>
 #include <tuple>
 #include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <cfloat>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <functional>
+#include <string>
+
+#include "PerfStats.hpp"
+#include "PerfStatsBindings.hpp"
+
+#include "CpuDispatch.hpp"
+#include "VisualServoLink.hpp"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 namespace py = pybind11;
 
-// ROI Edge Detection Function
-py::tuple roi_edge_detection(
-    py::array_t<uint8_t> image,
-    int roi_x, int roi_y, int roi_width, int roi_height,
-    int threshold, int min_line_length)
-{
+// ==========================================
+// Image input: strided, multi-channel and Bayer arrays
+// ==========================================
+
+// Borrowed view of a NumPy image. Strides come from the array, so sliced and
+// non-contiguous views are read correctly without a Python-side copy.
+struct ImageView
+{
+    const uint8_t *data = nullptr;
+    int rows = 0;
+    int cols = 0;
+    int channels = 1;        // 1 (gray or Bayer mosaic), 3 (BGR) or 4 (BGRA)
+    py::ssize_t row_step = 0; // strides in bytes
+    py::ssize_t col_step = 0;
+    py::ssize_t ch_step = 0;
+    int bayer_code = -1; // cv::COLOR_Bayer**2GRAY for a raw mosaic, -1 otherwise
+
+    cv::Rect bounds() const { return cv::Rect(0, 0, cols, rows); }
+};
+
+static bool isBayerCode(int code)
+{
+    return code == cv::COLOR_BayerBG2GRAY || code == cv::COLOR_BayerGB2GRAY ||
+           code == cv::COLOR_BayerRG2GRAY || code == cv::COLOR_BayerGR2GRAY;
+}
+
+static ImageView viewImage(const py::array_t<uint8_t> &image, int bayer_pattern = -1)
+{
+    PERF_SCOPE("py.view_image");
+    py::buffer_info buf = image.request();
+
+    // Safety check for dimensions
+    if (buf.ndim != 2 && buf.ndim != 3)
+    {
+        throw std::runtime_error("Number of dimensions must be two or three");
+    }
+
+    ImageView view;
+    view.data = (const uint8_t *)buf.ptr;
+    view.rows = (int)buf.shape[0];
+    view.cols = (int)buf.shape[1];
+    view.channels = buf.ndim == 3 ? (int)buf.shape[2] : 1;
+    view.row_step = buf.strides[0];
+    view.col_step = buf.strides[1];
+    view.ch_step = buf.ndim == 3 ? buf.strides[2] : 1;
+
+    if (view.rows <= 0 || view.cols <= 0)
+        throw std::runtime_error("Image is empty");
+    if (view.channels != 1 && view.channels != 3 && view.channels != 4)
+        throw std::runtime_error("Image must have 1, 3 (BGR) or 4 (BGRA) channels");
+
+    if (bayer_pattern >= 0)
+    {
+        if (!isBayerCode(bayer_pattern))
+            throw std::runtime_error("bayer_pattern must be one of the COLOR_Bayer**2GRAY codes");
+        if (view.channels != 1)
+            throw std::runtime_error("Bayer input must be a single channel mosaic");
+        view.bayer_code = bayer_pattern;
+    }
+
+    return view;
+}
+
+// Copy region of an arbitrarily strided view into dst (already region-sized, packed channels)
+static void gatherRegion(const ImageView &view, const cv::Rect &region, cv::Mat &dst)
+{
+    for (int y = 0; y < region.height; ++y)
+    {
+        const uint8_t *src = view.data + (region.y + y) * view.row_step + region.x * view.col_step;
+        uint8_t *out = dst.ptr<uint8_t>(y);
+        for (int x = 0; x < region.width; ++x)
+        {
+            for (int c = 0; c < view.channels; ++c)
+                out[x * view.channels + c] = src[x * view.col_step + c * view.ch_step];
+        }
+    }
+}
+
+// Borrowed view of an 8-bit Mat with 1, 3 or 4 channels
+static ImageView viewMat(const cv::Mat &mat, int bayer_code = -1)
+{
+    ImageView view;
+    view.data = mat.data;
+    view.rows = mat.rows;
+    view.cols = mat.cols;
+    view.channels = mat.channels();
+    view.row_step = (py::ssize_t)mat.step;
+    view.col_step = (py::ssize_t)mat.elemSize();
+    view.ch_step = 1;
+    view.bayer_code = bayer_code;
+    return view;
+}
+
+// rows x cols header over a reusable buffer that only ever grows. The header is
+// continuous and has no parent ROI, so filters never read stale bytes past it.
+static cv::Mat scratchMat(cv::Mat &buf, int rows, int cols, int type)
+{
+    const size_t bytes = (size_t)rows * cols * CV_ELEM_SIZE(type);
+    if (buf.empty() || buf.total() < bytes)
+    {
+        PERF_COUNT("alloc.scratch_grow", bytes);
+        buf.create(1, (int)bytes, CV_8U);
+    }
+    return cv::Mat(rows, cols, type, buf.data);
+}
+
+// Reusable buffers for extractGrayRoi
+struct GrayScratch
+{
+    cv::Mat packed;
+    cv::Mat gray;
+};
+
+// True if the view can be wrapped as a cv::Mat without copying
+static bool isMatCompatible(const ImageView &view)
+{
+    return view.row_step > 0 && view.col_step == view.channels && (view.channels == 1 || view.ch_step == 1);
+}
+
+// Grayscale pixels of roi. Only the ROI, grown by 'margin' pixels where the image allows,
+// is read and converted. The returned Mat covers exactly roi and its parent holds the
+// margin, so OpenCV filters see the real neighbours at the ROI border. Plain 8-bit
+// grayscale input with pixel-contiguous rows is returned without a copy. With scratch,
+// any copy or conversion goes into its buffers instead of fresh allocations.
+static cv::Mat extractGrayRoi(const ImageView &view, const cv::Rect &roi, int margin = 0,
+                              GrayScratch *scratch = nullptr)
+{
+    cv::Rect region = cv::Rect(roi.x - margin, roi.y - margin, roi.width + 2 * margin, roi.height + 2 * margin) & view.bounds();
+
+    if (view.bayer_code >= 0)
+    {
+        // Start on even coordinates so the mosaic phase matches the whole-frame pattern
+        int x0 = region.x & ~1;
+        int y0 = region.y & ~1;
+        region = cv::Rect(x0, y0, region.x + region.width - x0, region.y + region.height - y0);
+    }
+
+    cv::Mat packed;
+    if (isMatCompatible(view))
+    {
+        packed = cv::Mat(region.height, region.width, CV_8UC(view.channels),
+                         (void *)(view.data + region.y * view.row_step + region.x * view.col_step),
+                         (size_t)view.row_step);
+    }
+    else
+    {
+        // Arbitrary strides: gather just the region into a packed buffer
+        if (scratch)
+            packed = scratchMat(scratch->packed, region.height, region.width, CV_8UC(view.channels));
+        else
+        {
+            PERF_COUNT("alloc.roi_copy", region.area() * view.channels);
+            packed.create(region.height, region.width, CV_8UC(view.channels));
+        }
+        gatherRegion(view, region, packed);
+    }
+
+    cv::Mat gray;
+    if (view.bayer_code >= 0 || view.channels != 1)
+    {
+        if (scratch)
+            gray = scratchMat(scratch->gray, region.height, region.width, CV_8UC1);
+        else
+            PERF_COUNT("alloc.roi_gray", region.area()); // allocated by cvtColor below
+    }
+
+    if (view.bayer_code >= 0)
+        cv::cvtColor(packed, gray, view.bayer_code);
+    else if (view.channels == 3)
+        cv::cvtColor(packed, gray, cv::COLOR_BGR2GRAY);
+    else if (view.channels == 4)
+        cv::cvtColor(packed, gray, cv::COLOR_BGRA2GRAY);
+    else
+        gray = packed;
+
+    return gray(cv::Rect(roi.x - region.x, roi.y - region.y, roi.width, roi.height));
+}
+
+// Whole image (e.g. a template) as grayscale
+static cv::Mat extractGray(const ImageView &view)
+{
+    return extractGrayRoi(view, view.bounds());
+}
+
+
+// ==========================================
+// ROI edge detection
+// ==========================================
+
+// Fused small-ROI path: 5x5 Gaussian blur, Canny (aperture 3, L1 gradient) and a 3x3
+// MORPH_CLOSE in one streaming pass over rolling row buffers, so a small ROI is read
+// from memory once and every intermediate stays in cache. The arithmetic follows
+// OpenCV's 8-bit kernels (bit-exact fixed-point Gaussian, REPLICATE Sobel, CANNY_SHIFT
+// non-maximum suppression, 8-connected hysteresis, constant-border morphology).
+// The inner loops pick an SSE4.2, AVX2 or AVX-512 variant at runtime from CPU_DISPATCH::level()
+// (NEON on arm64), with a scalar tail and fallback.
+static const int FUSED_EDGE_MAX_AREA = 256 * 256;
+
+struct FusedEdgeScratch
+{
+    cv::Mat padded;               // ROI with the 2 pixel blur border
+    std::vector<uint16_t> hrows;  // 5 horizontally blurred rows
+    std::vector<uint8_t> brows;   // 3 blurred rows, replicated one pixel left/right
+    std::vector<int16_t> dx, dy;  // 2 rows of Sobel derivatives
+    std::vector<int16_t> mag;     // 3 magnitude rows + 1 zero row, zero padded
+    std::vector<uint8_t> map;     // Canny state: 0 candidate, 1 not an edge, 2 edge
+    std::vector<uint8_t> dilated; // padded dilation result
+    std::vector<uint8_t> tmp;
+    std::vector<uint8_t *> stack;
+
+    // Grow (never shrink) the buffers for an ROI of cols x rows
+    void reserve(int cols, int rows)
+    {
+        const size_t row = (size_t)cols + 2;
+        const size_t area = row * ((size_t)rows + 2);
+        growTo(hrows, 5 * (size_t)cols);
+        growTo(brows, 3 * row);
+        growTo(dx, 2 * (size_t)cols);
+        growTo(dy, 2 * (size_t)cols);
+        growTo(mag, 4 * row);
+        growTo(map, area);
+        growTo(dilated, area);
+        growTo(tmp, row);
+        scratchMat(padded, rows + 4, cols + 4, CV_8UC1);
+    }
+
+    size_t bytes() const
+    {
+        return padded.total() + hrows.size() * sizeof(uint16_t) + brows.size() +
+               (dx.size() + dy.size() + mag.size()) * sizeof(int16_t) +
+               map.size() + dilated.size() + tmp.size();
+    }
+
+private:
+    template <typename T>
+    static void growTo(std::vector<T> &v, size_t n)
+    {
+        if (v.size() < n)
+            v.resize(n);
+    }
+};
+
+// Hand-written SIMD kernels for the fused edge path. Each x86 tier processes whole vectors and
+// returns where it stopped; the scalar loop finishes the row. The tier is picked per call from
+// CPU_DISPATCH::level(), so one build runs on SSE4.2, AVX2 and AVX-512 machines alike.
+
+#if defined(CPU_DISPATCH_X86)
+CPU_TARGET_SSE42 static int gaussRow5Sse42(const uint8_t *p, uint16_t *out, int n)
+{
+    int x = 0;
+    for (; x + 8 <= n; x += 8)
+    {
+        __m128i a = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)(p + x)));
+        __m128i b = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)(p + x + 1)));
+        __m128i c = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)(p + x + 2)));
+        __m128i d = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)(p + x + 3)));
+        __m128i e = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)(p + x + 4)));
+        __m128i s = _mm_add_epi16(_mm_add_epi16(a, e), _mm_slli_epi16(_mm_add_epi16(b, d), 2));
+        s = _mm_add_epi16(s, _mm_add_epi16(_mm_slli_epi16(c, 2), _mm_slli_epi16(c, 1)));
+        _mm_storeu_si128((__m128i *)(out + x), s);
+    }
+    return x;
+}
+
+CPU_TARGET_AVX2 static int gaussRow5Avx2(const uint8_t *p, uint16_t *out, int n)
+{
+    int x = 0;
+    for (; x + 16 <= n; x += 16)
+    {
+        __m256i a = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(p + x)));
+        __m256i b = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(p + x + 1)));
+        __m256i c = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(p + x + 2)));
+        __m256i d = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(p + x + 3)));
+        __m256i e = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(p + x + 4)));
+        __m256i s = _mm256_add_epi16(_mm256_add_epi16(a, e), _mm256_slli_epi16(_mm256_add_epi16(b, d), 2));
+        s = _mm256_add_epi16(s, _mm256_add_epi16(_mm256_slli_epi16(c, 2), _mm256_slli_epi16(c, 1)));
+        _mm256_storeu_si256((__m256i *)(out + x), s);
+    }
+    return x;
+}
+
+CPU_TARGET_AVX512 static int gaussRow5Avx512(const uint8_t *p, uint16_t *out, int n)
+{
+    int x = 0;
+    for (; x + 32 <= n; x += 32)
+    {
+        __m512i a = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i *)(p + x)));
+        __m512i b = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i *)(p + x + 1)));
+        __m512i c = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i *)(p + x + 2)));
+        __m512i d = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i *)(p + x + 3)));
+        __m512i e = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i *)(p + x + 4)));
+        __m512i s = _mm512_add_epi16(_mm512_add_epi16(a, e), _mm512_slli_epi16(_mm512_add_epi16(b, d), 2));
+        s = _mm512_add_epi16(s, _mm512_add_epi16(_mm512_slli_epi16(c, 2), _mm512_slli_epi16(c, 1)));
+        _mm512_storeu_si512((void *)(out + x), s);
+    }
+    return x;
+}
+
+CPU_TARGET_SSE42 static int gaussCol5Sse42(const uint16_t *h0, const uint16_t *h1, const uint16_t *h2,
+                                           const uint16_t *h3, const uint16_t *h4, uint8_t *out, int n)
+{
+    int x = 0;
+    const __m128i half = _mm_set1_epi16(128);
+    for (; x + 8 <= n; x += 8)
+    {
+        __m128i c = _mm_loadu_si128((const __m128i *)(h2 + x));
+        __m128i s = _mm_add_epi16(_mm_loadu_si128((const __m128i *)(h0 + x)), _mm_loadu_si128((const __m128i *)(h4 + x)));
+        s = _mm_add_epi16(s, _mm_slli_epi16(_mm_add_epi16(_mm_loadu_si128((const __m128i *)(h1 + x)),
+                                                          _mm_loadu_si128((const __m128i *)(h3 + x))), 2));
+        s = _mm_add_epi16(s, _mm_add_epi16(_mm_slli_epi16(c, 2), _mm_slli_epi16(c, 1)));
+        s = _mm_srli_epi16(_mm_add_epi16(s, half), 8);
+        _mm_storel_epi64((__m128i *)(out + x), _mm_packus_epi16(s, s));
+    }
+    return x;
+}
+
+CPU_TARGET_AVX2 static int gaussCol5Avx2(const uint16_t *h0, const uint16_t *h1, const uint16_t *h2,
+                                         const uint16_t *h3, const uint16_t *h4, uint8_t *out, int n)
+{
+    int x = 0;
+    const __m256i half = _mm256_set1_epi16(128);
+    for (; x + 16 <= n; x += 16)
+    {
+        __m256i c = _mm256_loadu_si256((const __m256i *)(h2 + x));
+        __m256i s = _mm256_add_epi16(_mm256_loadu_si256((const __m256i *)(h0 + x)), _mm256_loadu_si256((const __m256i *)(h4 + x)));
+        s = _mm256_add_epi16(s, _mm256_slli_epi16(_mm256_add_epi16(_mm256_loadu_si256((const __m256i *)(h1 + x)),
+                                                                   _mm256_loadu_si256((const __m256i *)(h3 + x))), 2));
+        s = _mm256_add_epi16(s, _mm256_add_epi16(_mm256_slli_epi16(c, 2), _mm256_slli_epi16(c, 1)));
+        s = _mm256_srli_epi16(_mm256_add_epi16(s, half), 8);
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(s, s), 0xD8);
+        _mm_storeu_si128((__m128i *)(out + x), _mm256_castsi256_si128(packed));
+    }
+    return x;
+}
+
+CPU_TARGET_AVX512 static int gaussCol5Avx512(const uint16_t *h0, const uint16_t *h1, const uint16_t *h2,
+                                             const uint16_t *h3, const uint16_t *h4, uint8_t *out, int n)
+{
+    int x = 0;
+    const __m512i half = _mm512_set1_epi16(128);
+    for (; x + 32 <= n; x += 32)
+    {
+        __m512i c = _mm512_loadu_si512((const void *)(h2 + x));
+        __m512i s = _mm512_add_epi16(_mm512_loadu_si512((const void *)(h0 + x)), _mm512_loadu_si512((const void *)(h4 + x)));
+        s = _mm512_add_epi16(s, _mm512_slli_epi16(_mm512_add_epi16(_mm512_loadu_si512((const void *)(h1 + x)),
+                                                                   _mm512_loadu_si512((const void *)(h3 + x))), 2));
+        s = _mm512_add_epi16(s, _mm512_add_epi16(_mm512_slli_epi16(c, 2), _mm512_slli_epi16(c, 1)));
+        s = _mm512_srli_epi16(_mm512_add_epi16(s, half), 8);
+        _mm256_storeu_si256((__m256i *)(out + x), _mm512_maskz_cvtepi16_epi8(~(__mmask32)0, s)); // values are <= 255
+    }
+    return x;
+}
+
+CPU_TARGET_SSE42 static int sobelRowSse42(const uint8_t *b0, const uint8_t *b1, const uint8_t *b2,
+                                          int16_t *dx, int16_t *dy, int16_t *mag, int n)
+{
+    int x = 0;
+    for (; x + 8 <= n; x += 8)
+    {
+        __m128i p0 = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)(b0 + x)));
+        __m128i p1 = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)(b0 + x + 1)));
+        __m128i p2 = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)(b0 + x + 2)));
+        __m128i q0 = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)(b1 + x)));
+        __m128i q2 = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)(b1 + x + 2)));
+        __m128i r0 = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)(b2 + x)));
+        __m128i r1 = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)(b2 + x + 1)));
+        __m128i r2 = _mm_cvtepu8_epi16(_mm_loadl_epi64((const __m128i *)(b2 + x + 2)));
+        __m128i gx = _mm_add_epi16(_mm_add_epi16(_mm_sub_epi16(p2, p0), _mm_sub_epi16(r2, r0)),
+                                   _mm_slli_epi16(_mm_sub_epi16(q2, q0), 1));
+        __m128i gy = _mm_sub_epi16(_mm_add_epi16(_mm_add_epi16(r0, r2), _mm_slli_epi16(r1, 1)),
+                                   _mm_add_epi16(_mm_add_epi16(p0, p2), _mm_slli_epi16(p1, 1)));
+        _mm_storeu_si128((__m128i *)(dx + x), gx);
+        _mm_storeu_si128((__m128i *)(dy + x), gy);
+        _mm_storeu_si128((__m128i *)(mag + x), _mm_add_epi16(_mm_abs_epi16(gx), _mm_abs_epi16(gy)));
+    }
+    return x;
+}
+
+CPU_TARGET_AVX2 static int sobelRowAvx2(const uint8_t *b0, const uint8_t *b1, const uint8_t *b2,
+                                        int16_t *dx, int16_t *dy, int16_t *mag, int n)
+{
+    int x = 0;
+    for (; x + 16 <= n; x += 16)
+    {
+        __m256i p0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(b0 + x)));
+        __m256i p1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(b0 + x + 1)));
+        __m256i p2 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(b0 + x + 2)));
+        __m256i q0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(b1 + x)));
+        __m256i q2 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(b1 + x + 2)));
+        __m256i r0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(b2 + x)));
+        __m256i r1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(b2 + x + 1)));
+        __m256i r2 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(b2 + x + 2)));
+        __m256i gx = _mm256_add_epi16(_mm256_add_epi16(_mm256_sub_epi16(p2, p0), _mm256_sub_epi16(r2, r0)),
+                                      _mm256_slli_epi16(_mm256_sub_epi16(q2, q0), 1));
+        __m256i gy = _mm256_sub_epi16(_mm256_add_epi16(_mm256_add_epi16(r0, r2), _mm256_slli_epi16(r1, 1)),
+                                      _mm256_add_epi16(_mm256_add_epi16(p0, p2), _mm256_slli_epi16(p1, 1)));
+        _mm256_storeu_si256((__m256i *)(dx + x), gx);
+        _mm256_storeu_si256((__m256i *)(dy + x), gy);
+        _mm256_storeu_si256((__m256i *)(mag + x), _mm256_add_epi16(_mm256_abs_epi16(gx), _mm256_abs_epi16(gy)));
+    }
+    return x;
+}
+
+CPU_TARGET_AVX512 static int sobelRowAvx512(const uint8_t *b0, const uint8_t *b1, const uint8_t *b2,
+                                            int16_t *dx, int16_t *dy, int16_t *mag, int n)
+{
+    int x = 0;
+    for (; x + 32 <= n; x += 32)
+    {
+        __m512i p0 = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i *)(b0 + x)));
+        __m512i p1 = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i *)(b0 + x + 1)));
+        __m512i p2 = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i *)(b0 + x + 2)));
+        __m512i q0 = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i *)(b1 + x)));
+        __m512i q2 = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i *)(b1 + x + 2)));
+        __m512i r0 = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i *)(b2 + x)));
+        __m512i r1 = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i *)(b2 + x + 1)));
+        __m512i r2 = _mm512_cvtepu8_epi16(_mm256_loadu_si256((const __m256i *)(b2 + x + 2)));
+        __m512i gx = _mm512_add_epi16(_mm512_add_epi16(_mm512_sub_epi16(p2, p0), _mm512_sub_epi16(r2, r0)),
+                                      _mm512_slli_epi16(_mm512_sub_epi16(q2, q0), 1));
+        __m512i gy = _mm512_sub_epi16(_mm512_add_epi16(_mm512_add_epi16(r0, r2), _mm512_slli_epi16(r1, 1)),
+                                      _mm512_add_epi16(_mm512_add_epi16(p0, p2), _mm512_slli_epi16(p1, 1)));
+        _mm512_storeu_si512((void *)(dx + x), gx);
+        _mm512_storeu_si512((void *)(dy + x), gy);
+        _mm512_storeu_si512((void *)(mag + x), _mm512_add_epi16(_mm512_abs_epi16(gx), _mm512_abs_epi16(gy)));
+    }
+    return x;
+}
+
+template <bool IsMax>
+CPU_TARGET_SSE42 static int extremum3Sse42(const uint8_t *a, const uint8_t *b, const uint8_t *c, uint8_t *out, int n)
+{
+    int x = 0;
+    for (; x + 16 <= n; x += 16)
+    {
+        __m128i va = _mm_loadu_si128((const __m128i *)(a + x));
+        __m128i vb = _mm_loadu_si128((const __m128i *)(b + x));
+        __m128i vc = _mm_loadu_si128((const __m128i *)(c + x));
+        __m128i r = IsMax ? _mm_max_epu8(_mm_max_epu8(va, vb), vc) : _mm_min_epu8(_mm_min_epu8(va, vb), vc);
+        _mm_storeu_si128((__m128i *)(out + x), r);
+    }
+    return x;
+}
+
+template <bool IsMax>
+CPU_TARGET_AVX2 static int extremum3Avx2(const uint8_t *a, const uint8_t *b, const uint8_t *c, uint8_t *out, int n)
+{
+    int x = 0;
+    for (; x + 32 <= n; x += 32)
+    {
+        __m256i va = _mm256_loadu_si256((const __m256i *)(a + x));
+        __m256i vb = _mm256_loadu_si256((const __m256i *)(b + x));
+        __m256i vc = _mm256_loadu_si256((const __m256i *)(c + x));
+        __m256i r = IsMax ? _mm256_max_epu8(_mm256_max_epu8(va, vb), vc) : _mm256_min_epu8(_mm256_min_epu8(va, vb), vc);
+        _mm256_storeu_si256((__m256i *)(out + x), r);
+    }
+    return x;
+}
+
+template <bool IsMax>
+CPU_TARGET_AVX512 static int extremum3Avx512(const uint8_t *a, const uint8_t *b, const uint8_t *c, uint8_t *out, int n)
+{
+    int x = 0;
+    for (; x + 64 <= n; x += 64)
+    {
+        __m512i va = _mm512_loadu_si512((const void *)(a + x));
+        __m512i vb = _mm512_loadu_si512((const void *)(b + x));
+        __m512i vc = _mm512_loadu_si512((const void *)(c + x));
+        __m512i r = IsMax ? _mm512_max_epu8(_mm512_max_epu8(va, vb), vc) : _mm512_min_epu8(_mm512_min_epu8(va, vb), vc);
+        _mm512_storeu_si512((void *)(out + x), r);
+    }
+    return x;
+}
+#endif // CPU_DISPATCH_X86
+
+// out[x] = p[x] + 4 p[x+1] + 6 p[x+2] + 4 p[x+3] + p[x+4]
+static void gaussRow5(const uint8_t *p, uint16_t *out, int n)
+{
+    int x = 0;
+#if defined(CPU_DISPATCH_X86)
+    const int level = CPU_DISPATCH::level();
+    if (level >= CPU_DISPATCH::CPU_AVX512)
+        x = gaussRow5Avx512(p, out, n);
+    else if (level == CPU_DISPATCH::CPU_AVX2)
+        x = gaussRow5Avx2(p, out, n);
+    else if (level == CPU_DISPATCH::CPU_SSE42)
+        x = gaussRow5Sse42(p, out, n);
+#elif defined(__ARM_NEON)
+    if (CPU_DISPATCH::level() == CPU_DISPATCH::CPU_NEON)
+        for (; x + 8 <= n; x += 8)
+        {
+            uint16x8_t s = vaddl_u8(vld1_u8(p + x), vld1_u8(p + x + 4));
+            s = vaddq_u16(s, vshlq_n_u16(vaddl_u8(vld1_u8(p + x + 1), vld1_u8(p + x + 3)), 2));
+            s = vmlaq_n_u16(s, vmovl_u8(vld1_u8(p + x + 2)), 6);
+            vst1q_u16(out + x, s);
+        }
+#endif
+    for (; x < n; ++x)
+        out[x] = (uint16_t)(p[x] + p[x + 4] + 4 * (p[x + 1] + p[x + 3]) + 6 * p[x + 2]);
+}
+
+// out[x] = (h0 + 4 h1 + 6 h2 + 4 h3 + h4 + 128) >> 8, i.e. OpenCV's rounding of the 5x5 kernel
+static void gaussCol5(const uint16_t *h0, const uint16_t *h1, const uint16_t *h2,
+                      const uint16_t *h3, const uint16_t *h4, uint8_t *out, int n)
+{
+    int x = 0;
+#if defined(CPU_DISPATCH_X86)
+    const int level = CPU_DISPATCH::level();
+    if (level >= CPU_DISPATCH::CPU_AVX512)
+        x = gaussCol5Avx512(h0, h1, h2, h3, h4, out, n);
+    else if (level == CPU_DISPATCH::CPU_AVX2)
+        x = gaussCol5Avx2(h0, h1, h2, h3, h4, out, n);
+    else if (level == CPU_DISPATCH::CPU_SSE42)
+        x = gaussCol5Sse42(h0, h1, h2, h3, h4, out, n);
+#elif defined(__ARM_NEON)
+    if (CPU_DISPATCH::level() == CPU_DISPATCH::CPU_NEON)
+        for (; x + 8 <= n; x += 8)
+        {
+            uint16x8_t s = vaddq_u16(vld1q_u16(h0 + x), vld1q_u16(h4 + x));
+            s = vaddq_u16(s, vshlq_n_u16(vaddq_u16(vld1q_u16(h1 + x), vld1q_u16(h3 + x)), 2));
+            s = vmlaq_n_u16(s, vld1q_u16(h2 + x), 6);
+            s = vaddq_u16(s, vdupq_n_u16(128));
+            vst1_u8(out + x, vshrn_n_u16(s, 8));
+        }
+#endif
+    for (; x < n; ++x)
+        out[x] = (uint8_t)((h0[x] + h4[x] + 4 * (h1[x] + h3[x]) + 6 * h2[x] + 128) >> 8);
+}
+
+// 3x3 Sobel derivatives and L1 magnitude of the middle row. b0..b2 are blurred rows
+// padded by one replicated pixel on each side; mag is written at mag[x].
+static void sobelRow(const uint8_t *b0, const uint8_t *b1, const uint8_t *b2,
+                     int16_t *dx, int16_t *dy, int16_t *mag, int n)
+{
+    int x = 0;
+#if defined(CPU_DISPATCH_X86)
+    const int level = CPU_DISPATCH::level();
+    if (level >= CPU_DISPATCH::CPU_AVX512)
+        x = sobelRowAvx512(b0, b1, b2, dx, dy, mag, n);
+    else if (level == CPU_DISPATCH::CPU_AVX2)
+        x = sobelRowAvx2(b0, b1, b2, dx, dy, mag, n);
+    else if (level == CPU_DISPATCH::CPU_SSE42)
+        x = sobelRowSse42(b0, b1, b2, dx, dy, mag, n);
+#elif defined(__ARM_NEON)
+    if (CPU_DISPATCH::level() == CPU_DISPATCH::CPU_NEON)
+        for (; x + 8 <= n; x += 8)
+        {
+            int16x8_t p0 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(b0 + x)));
+            int16x8_t p1 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(b0 + x + 1)));
+            int16x8_t p2 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(b0 + x + 2)));
+            int16x8_t q0 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(b1 + x)));
+            int16x8_t q2 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(b1 + x + 2)));
+            int16x8_t r0 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(b2 + x)));
+            int16x8_t r1 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(b2 + x + 1)));
+            int16x8_t r2 = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(b2 + x + 2)));
+            int16x8_t gx = vaddq_s16(vaddq_s16(vsubq_s16(p2, p0), vsubq_s16(r2, r0)), vshlq_n_s16(vsubq_s16(q2, q0), 1));
+            int16x8_t gy = vsubq_s16(vaddq_s16(vaddq_s16(r0, r2), vshlq_n_s16(r1, 1)),
+                                     vaddq_s16(vaddq_s16(p0, p2), vshlq_n_s16(p1, 1)));
+            vst1q_s16(dx + x, gx);
+            vst1q_s16(dy + x, gy);
+            vst1q_s16(mag + x, vaddq_s16(vabsq_s16(gx), vabsq_s16(gy)));
+        }
+#endif
+    for (; x < n; ++x)
+    {
+        int gx = (b0[x + 2] - b0[x]) + 2 * (b1[x + 2] - b1[x]) + (b2[x + 2] - b2[x]);
+        int gy = (b2[x] + 2 * b2[x + 1] + b2[x + 2]) - (b0[x] + 2 * b0[x + 1] + b0[x + 2]);
+        dx[x] = (int16_t)gx;
+        dy[x] = (int16_t)gy;
+        mag[x] = (int16_t)(std::abs(gx) + std::abs(gy));
+    }
+}
+
+// out[x] = max(a[x], b[x], c[x]) (or min)
+template <bool IsMax>
+static void extremum3(const uint8_t *a, const uint8_t *b, const uint8_t *c, uint8_t *out, int n)
+{
+    int x = 0;
+#if defined(CPU_DISPATCH_X86)
+    const int level = CPU_DISPATCH::level();
+    if (level >= CPU_DISPATCH::CPU_AVX512)
+        x = extremum3Avx512<IsMax>(a, b, c, out, n);
+    else if (level == CPU_DISPATCH::CPU_AVX2)
+        x = extremum3Avx2<IsMax>(a, b, c, out, n);
+    else if (level == CPU_DISPATCH::CPU_SSE42)
+        x = extremum3Sse42<IsMax>(a, b, c, out, n);
+#elif defined(__ARM_NEON)
+    if (CPU_DISPATCH::level() == CPU_DISPATCH::CPU_NEON)
+        for (; x + 16 <= n; x += 16)
+        {
+            uint8x16_t va = vld1q_u8(a + x), vb = vld1q_u8(b + x), vc = vld1q_u8(c + x);
+            vst1q_u8(out + x, IsMax ? vmaxq_u8(vmaxq_u8(va, vb), vc) : vminq_u8(vminq_u8(va, vb), vc));
+        }
+#endif
+    for (; x < n; ++x)
+        out[x] = IsMax ? std::max(std::max(a[x], b[x]), c[x]) : std::min(std::min(a[x], b[x]), c[x]);
+}
+
+// Equivalent of GaussianBlur(5x5, 0) -> Canny(low, high) -> morphologyEx(MORPH_CLOSE, 3x3 rect)
+// on roi_img, whose parent must hold the 2 pixel blur border where the image has one.
+static cv::Mat fusedBlurCannyClose(const cv::Mat &roi_img, int low, int high, cv::Mat &edges_buf, FusedEdgeScratch &f)
+{
+    const int CANNY_SHIFT = 15;
+    const int TG22 = (int)(0.4142135623730950488016887242097 * (1 << CANNY_SHIFT) + 0.5);
+
+    const int W = roi_img.cols;
+    const int H = roi_img.rows;
+    const size_t row = (size_t)W + 2;
+    f.reserve(W, H);
+
+    if (low > high)
+        std::swap(low, high);
+
+    // Blur border taken from the parent image, reflected where the image ends
+    cv::Mat padded = scratchMat(f.padded, H + 4, W + 4, CV_8UC1);
+    cv::copyMakeBorder(roi_img, padded, 2, 2, 2, 2, cv::BORDER_REFLECT_101);
+
+    uint16_t *hrows = f.hrows.data();
+    uint8_t *brows = f.brows.data();
+    int16_t *mag = f.mag.data();
+    uint8_t *map = f.map.data();
+
+    // Horizontally blurred padded row p lives in slot p % 5, blurred row r in slot r % 3
+    auto blurRow = [&](int r)
+    {
+        gaussRow5(padded.ptr<uint8_t>(r + 4), hrows + ((r + 4) % 5) * W, W);
+        uint8_t *b = brows + (r % 3) * row;
+        gaussCol5(hrows + (r % 5) * W, hrows + ((r + 1) % 5) * W, hrows + ((r + 2) % 5) * W,
+                  hrows + ((r + 3) % 5) * W, hrows + ((r + 4) % 5) * W, b + 1, W);
+        b[0] = b[1];
+        b[W + 1] = b[W];
+    };
+    auto blurred = [&](int r) { return brows + (std::min(std::max(r, 0), H - 1) % 3) * row; };
+    auto magRow = [&](int r) { return mag + (r < 0 || r >= H ? 3 : r % 3) * row; };
+
+    std::fill(mag + 3 * row, mag + 4 * row, (int16_t)0);
+    std::memset(map, 1, row);
+    std::memset(map + (size_t)(H + 1) * row, 1, row);
+    f.stack.clear();
+
+    for (int p = 0; p < 4; ++p)
+        gaussRow5(padded.ptr<uint8_t>(p), hrows + p * W, W);
+    blurRow(0);
+
+    for (int y = 0; y <= H; ++y)
+    {
+        if (y < H)
+        {
+            if (y + 1 < H)
+                blurRow(y + 1);
+            int16_t *m = magRow(y);
+            m[0] = m[W + 1] = 0;
+            sobelRow(blurred(y - 1), blurred(y), blurred(y + 1),
+                     f.dx.data() + (y & 1) * W, f.dy.data() + (y & 1) * W, m + 1, W);
+        }
+        if (y == 0)
+            continue;
+
+        // Non-maximum suppression for row y - 1
+        const int r = y - 1;
+        const int16_t *mp = magRow(r - 1) + 1;
+        const int16_t *ma = magRow(r) + 1;
+        const int16_t *mn = magRow(r + 1) + 1;
+        const int16_t *gx = f.dx.data() + (r & 1) * W;
+        const int16_t *gy = f.dy.data() + (r & 1) * W;
+        uint8_t *mrow = map + (size_t)(r + 1) * row + 1;
+        mrow[-1] = mrow[W] = 1;
+
+        for (int x = 0; x < W; ++x)
+        {
+            const int m = ma[x];
+            bool edge = false;
+            if (m > low)
+            {
+                const int xs = gx[x];
+                const int ys = gy[x];
+                const int ax = std::abs(xs);
+                const int ay = std::abs(ys) << CANNY_SHIFT;
+                const int tg22x = ax * TG22;
+                if (ay < tg22x)
+                {
+                    edge = m > ma[x - 1] && m >= ma[x + 1];
+                }
+                else
+                {
+                    const int tg67x = tg22x + (ax << (CANNY_SHIFT + 1));
+                    if (ay > tg67x)
+                    {
+                        edge = m > mp[x] && m >= mn[x];
+                    }
+                    else
+                    {
+                        const int s = (xs ^ ys) < 0 ? -1 : 1;
+                        edge = m > mp[x - s] && m > mn[x + s];
+                    }
+                }
+            }
+
+            if (!edge)
+                mrow[x] = 1;
+            else if (m > high)
+            {
+                mrow[x] = 2;
+                f.stack.push_back(mrow + x);
+            }
+            else
+                mrow[x] = 0;
+        }
+    }
+
+    // Hysteresis: grow strong edges through 8-connected candidates
+    const ptrdiff_t step = (ptrdiff_t)row;
+    while (!f.stack.empty())
+    {
+        uint8_t *m = f.stack.back();
+        f.stack.pop_back();
+        const ptrdiff_t offsets[8] = {-step - 1, -step, -step + 1, -1, 1, step - 1, step, step + 1};
+        for (ptrdiff_t o : offsets)
+        {
+            if (m[o] == 0)
+            {
+                m[o] = 2;
+                f.stack.push_back(m + o);
+            }
+        }
+    }
+
+    // Edge image in place of the map with a zero border: outside pixels never win a dilation
+    const size_t area = row * ((size_t)H + 2);
+    for (size_t i = 0; i < area; ++i)
+        map[i] = map[i] == 2 ? 255 : 0;
+
+    // Closing: dilate into a 255-bordered buffer (outside pixels never win the erosion), then erode
+    uint8_t *dil = f.dilated.data();
+    uint8_t *tmp = f.tmp.data();
+    std::memset(dil, 255, row);
+    std::memset(dil + (size_t)(H + 1) * row, 255, row);
+    for (int y = 0; y < H; ++y)
+    {
+        const uint8_t *src = map + (size_t)y * row;
+        uint8_t *dst = dil + (size_t)(y + 1) * row;
+        extremum3<true>(src, src + row, src + 2 * row, tmp, (int)row);
+        extremum3<true>(tmp, tmp + 1, tmp + 2, dst + 1, W);
+        dst[0] = dst[W + 1] = 255;
+    }
+
+    cv::Mat edges = scratchMat(edges_buf, H, W, CV_8UC1);
+    for (int y = 0; y < H; ++y)
+    {
+        const uint8_t *src = dil + (size_t)y * row;
+        extremum3<false>(src, src + row, src + 2 * row, tmp, (int)row);
+        extremum3<false>(tmp, tmp + 1, tmp + 2, edges.ptr<uint8_t>(y), W);
+    }
+
+    return edges;
+}
+
+// ==========================================
+// Result arrays
+// ==========================================
+
+// Hand a vector's buffer to NumPy without copying; the array owns the vector via a capsule
+template <typename T>
+static py::array_t<T> moveToArray(std::vector<T> &&values)
+{
+    PERF_SCOPE("py.to_array");
+    auto *owner = new std::vector<T>(std::move(values));
+    py::capsule free_when_done(owner, [](void *p) { delete static_cast<std::vector<T> *>(p); });
+    return py::array_t<T>((py::ssize_t)owner->size(), owner->data(), free_when_done);
+}
+
+// Copy into a fresh structured array (for buffers that are reused afterwards)
+template <typename T>
+static py::array_t<T> copyToArray(const std::vector<T> &values)
+{
+    PERF_SCOPE("py.to_array");
+    py::array_t<T> out((py::ssize_t)values.size());
+    std::copy(values.begin(), values.end(), out.mutable_data());
+    return out;
+}
+
+// One roi_edge_detection segment: midpoint and angle in degrees
+struct EdgeResult
+{
+    float x;
+    float y;
+    float angle;
+};
+
+// Legacy output: tuple of (x, y, angle) tuples
+static py::tuple toEdgeTuples(const std::vector<EdgeResult> &edges)
+{
+    PERF_SCOPE("py.to_tuples");
+    std::vector<std::tuple<float, float, float>> edge_points;
+    edge_points.reserve(edges.size());
+    for (const auto &e : edges)
+        edge_points.emplace_back(e.x, e.y, e.angle);
+
+    return py::cast(edge_points);
+}
+
+// Scratch buffers for one edge detection call. They grow to the largest ROI seen
+// and are reused afterwards.
+struct EdgeScratch
+{
+    GrayScratch input;
+    cv::Mat blurred;
+    cv::Mat edges;
+    FusedEdgeScratch fused;
+    std::vector<cv::Vec4i> lines;
+    std::vector<EdgeResult> edge_points;
+};
+
+// Clamp the ROI to the image the way roi_edge_detection always has
+static cv::Rect clampEdgeRoi(const ImageView &view, int roi_x, int roi_y, int roi_width, int roi_height)
+{
+    roi_x = std::max(0, std::min(roi_x, view.cols - 1));
+    roi_y = std::max(0, std::min(roi_y, view.rows - 1));
+    roi_width = std::min(roi_width, view.cols - roi_x);
+    roi_height = std::min(roi_height, view.rows - roi_y);
+
+    if (roi_width <= 0 || roi_height <= 0)
+        throw std::runtime_error("ROI width and height must be positive");
+
+    return cv::Rect(roi_x, roi_y, roi_width, roi_height);
+}
+
+// Blur -> Canny -> close -> HoughLinesP on roi, leaving (mid_x, mid_y, angle) records in
+// image coordinates in s.edge_points
+static void detectEdges(const ImageView &view, const cv::Rect &roi,
+                        int threshold, int min_line_length,
+                        int blur_ksize, const cv::Mat &kernel, int fused_max_area, EdgeScratch &s)
+{
+    // Extract ROI (with the border the blur reads outside the ROI)
+    cv::Mat roi_img;
+    {
+        PERF_SCOPE("edge.extract_roi");
+        roi_img = extractGrayRoi(view, roi, blur_ksize / 2, &s.input);
+    }
+
+    cv::Mat edges;
+    if (blur_ksize == 5 && kernel.rows == 3 && kernel.cols == 3 && roi.area() <= fused_max_area)
+    {
+        // Small ROI: blur, Canny and closing in one cache-resident pass
+        PERF_SCOPE("edge.fused_blur_canny_close");
+        edges = fusedBlurCannyClose(roi_img, threshold, threshold * 2, s.edges, s.fused);
+    }
+    else
+    {
+        // Gaussian Blur
+        cv::Mat blurred = scratchMat(s.blurred, roi.height, roi.width, CV_8UC1);
+        {
+            PERF_SCOPE("edge.gaussian_blur");
+            cv::GaussianBlur(roi_img, blurred, cv::Size(blur_ksize, blur_ksize), 0);
+        }
+
+        // Canny Edge Detection
+        edges = scratchMat(s.edges, roi.height, roi.width, CV_8UC1);
+        {
+            PERF_SCOPE("edge.canny");
+            cv::Canny(blurred, edges, threshold, threshold * 2);
+        }
+
+        // Morphology
+        PERF_SCOPE("edge.morphology");
+        cv::morphologyEx(edges, edges, cv::MORPH_CLOSE, kernel);
+    }
+
+    // Hough Lines
+    PERF_SCOPE("edge.hough_lines");
+    s.lines.clear();
+    cv::HoughLinesP(edges, s.lines, 1, CV_PI / 180, 50, min_line_length, 10);
+
+    // Prepare results
+    s.edge_points.clear();
+
+    for (const auto &line : s.lines)
+    {
+        int x1 = line[0];
+        int y1 = line[1];
+        int x2 = line[2];
+        int y2 = line[3];
+
+        // Midpoint
+        float mid_x = (x1 + x2) / 2.0f;
+        float mid_y = (y1 + y2) / 2.0f;
+
+        // Angle
+        float angle = std::atan2((float)(y2 - y1), (float)(x2 - x1)) * 180.0f / (float)CV_PI;
+
+        // Adjust to global coordinates
+        mid_x += roi.x;
+        mid_y += roi.y;
+
+        s.edge_points.push_back({mid_x, mid_y, angle});
+    }
+}
+
+// ROI Edge Detection Function
+// Returns a structured array (x, y, angle), or the legacy tuple of tuples when legacy_output is set
+py::object roi_edge_detection(
+    py::array_t<uint8_t> image,
+    int roi_x, int roi_y, int roi_width, int roi_height,
+    int threshold, int min_line_length, int bayer_pattern, bool legacy_output)
+{
+    PERF_SCOPE("vision.roi_edge_detection");
+
+    // Get image info (strided / BGR / BGRA / Bayer input is converted per ROI)
+    ImageView view = viewImage(image, bayer_pattern);
+    cv::Rect roi = clampEdgeRoi(view, roi_x, roi_y, roi_width, roi_height);
+
+    static const cv::Mat kernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3));
+
+    // Reused across calls on the same thread; the array gets a copy so the buffers stay
+    static thread_local EdgeScratch scratch;
+    detectEdges(view, roi, threshold, min_line_length, 5, kernel, FUSED_EDGE_MAX_AREA, scratch);
+
+    if (legacy_output)
+        return toEdgeTuples(scratch.edge_points);
+    return copyToArray(scratch.edge_points);
+}
+
+// Idle scratch sets an EdgeDetector keeps; more concurrent callers allocate and drop their own
+const size_t EDGE_SCRATCH_POOL_MAX = 8;
+
+// Reusable roi_edge_detection: caches the morphology kernel and lends each call a set of
+// scratch buffers from a small pool, so steady-state calls on ROIs no larger than
+// those already seen allocate nothing on our side (OpenCV's Canny/Hough internals
+// still use their own temporaries). The pool is sized by concurrent callers, not by every
+// thread that ever called. Calls release the GIL. ROIs of at most
+// fused_max_area pixels take the fused path when the default 5x5 blur / 3x3 closing
+// are used; 0 forces the general OpenCV path.
+class EdgeDetector
+{
+public:
+    EdgeDetector(int blur_ksize, int morph_ksize, int fused_max_area)
+        : blur_ksize_(blur_ksize), morph_ksize_(morph_ksize), fused_max_area_(fused_max_area)
+    {
+        if (blur_ksize <= 0 || blur_ksize % 2 == 0)
+            throw std::runtime_error("blur_ksize must be a positive odd number");
+        if (morph_ksize <= 0)
+            throw std::runtime_error("morph_ksize must be positive");
+        kernel_ = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(morph_ksize, morph_ksize));
+    }
+
+    int blurKsize() const { return blur_ksize_; }
+    int morphKsize() const { return morph_ksize_; }
+    int fusedMaxArea() const { return fused_max_area_; }
+
+    py::object detect(py::array_t<uint8_t> image,
+                      int roi_x, int roi_y, int roi_width, int roi_height,
+                      int threshold, int min_line_length, int bayer_pattern, bool legacy_output)
+    {
+        ImageView view = viewImage(image, bayer_pattern);
+        cv::Rect roi = clampEdgeRoi(view, roi_x, roi_y, roi_width, roi_height);
+
+        std::unique_ptr<EdgeScratch> s = acquireScratch();
+        {
+            py::gil_scoped_release release;
+            detectEdges(view, roi, threshold, min_line_length, blur_ksize_, kernel_, fused_max_area_, *s);
+        }
+
+        // The scratch vector is reused, so the array gets a copy
+        py::object out = legacy_output ? py::object(toEdgeTuples(s->edge_points)) : py::object(copyToArray(s->edge_points));
+        releaseScratch(std::move(s));
+        return out;
+    }
+
+    // Grow a pooled buffer set up front so the first frames do not allocate
+    void reserve(int max_width, int max_height, int channels)
+    {
+        if (max_width <= 0 || max_height <= 0)
+            throw std::runtime_error("max_width and max_height must be positive");
+        if (channels != 1 && channels != 3 && channels != 4)
+            throw std::runtime_error("channels must be 1, 3 or 4");
+
+        std::unique_ptr<EdgeScratch> lease = acquireScratch();
+        EdgeScratch &s = *lease;
+        const int margin = blur_ksize_ / 2 + 1; // +1 for Bayer even alignment
+        const int w = max_width + 2 * margin;
+        const int h = max_height + 2 * margin;
+        scratchMat(s.input.packed, h, w, CV_8UC(channels));
+        scratchMat(s.input.gray, h, w, CV_8UC1);
+        scratchMat(s.blurred, max_height, max_width, CV_8UC1);
+        scratchMat(s.edges, max_height, max_width, CV_8UC1);
+
+        // The fused path only sees ROIs up to fused_max_area pixels
+        const int fused_rows = std::min(max_height, fused_max_area_ / max_width);
+        if (fused_rows > 0)
+            s.fused.reserve(max_width, fused_rows);
+        releaseScratch(std::move(lease));
+    }
+
+    // Bytes currently held by the pooled (idle) scratch buffers
+    size_t scratchBytes() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        size_t bytes = 0;
+        for (const auto &ptr : scratch_)
+        {
+            const EdgeScratch &s = *ptr;
+            bytes += s.input.packed.total() + s.input.gray.total() + s.blurred.total() + s.edges.total() + s.fused.bytes();
+        }
+        return bytes;
+    }
+
+private:
+    // Most recently returned set first: it is the one most likely grown to the current ROI size
+    std::unique_ptr<EdgeScratch> acquireScratch()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (scratch_.empty())
+            return std::unique_ptr<EdgeScratch>(new EdgeScratch());
+        std::unique_ptr<EdgeScratch> s = std::move(scratch_.back());
+        scratch_.pop_back();
+        return s;
+    }
+
+    void releaseScratch(std::unique_ptr<EdgeScratch> s)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (scratch_.size() < EDGE_SCRATCH_POOL_MAX)
+            scratch_.push_back(std::move(s));
+    }
+
+    int blur_ksize_;
+    int morph_ksize_;
+    int fused_max_area_;
+    cv::Mat kernel_;
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<EdgeScratch>> scratch_; // idle sets, at most EDGE_SCRATCH_POOL_MAX
+};
+
+// ==========================================
+// Caliper edge scan and line fit
+// ==========================================
+
+// Scan directions for roi_edge_line: each caliper reads a profile in this direction
+enum ScanDirection
+{
+    SCAN_DOWN = 0,  // top to bottom, finds a roughly horizontal edge
+    SCAN_UP = 1,    // bottom to top
+    SCAN_RIGHT = 2, // left to right, finds a roughly vertical edge
+    SCAN_LEFT = 3   // right to left
+};
+
+struct EdgeLine
+{
+    float x, y;       // point on the line closest to the ROI centre (image coordinates)
+    float angle;      // degrees, same convention as roi_edge_detection
+    float residual;   // RMS distance of the inliers to the line (pixels)
+    int32_t inliers;
+    int32_t points;   // caliper edges found before the fit
+};
+
+// Strongest sub-pixel edge in a caliper profile, or -1 if none passes min_contrast.
+// polarity > 0 wants dark -> light along the scan, < 0 light -> dark, 0 either.
+static float caliperEdge(const std::vector<float> &profile, std::vector<float> &grad,
+                         float min_contrast, int polarity)
+{
+    const int n = (int)profile.size();
+    if (n < 5)
+        return -1.0f;
+
+    // [1 2 1] smoothing folded into a central difference: g[i] = (p[i+2] + 2p[i+1] - 2p[i-1] - p[i-2]) / 8
+    grad.assign(n, 0.0f);
+    for (int i = 2; i < n - 2; ++i)
+        grad[i] = (profile[i + 2] + 2.0f * profile[i + 1] - 2.0f * profile[i - 1] - profile[i - 2]) * 0.125f;
+
+    int best = -1;
+    float best_mag = min_contrast;
+    for (int i = 2; i < n - 2; ++i)
+    {
+        const float g = polarity > 0 ? grad[i] : polarity < 0 ? -grad[i] : std::abs(grad[i]);
+        if (g >= best_mag)
+        {
+            best_mag = g;
+            best = i;
+        }
+    }
+    if (best < 0)
+        return -1.0f;
+
+    // Parabola through the peak and its neighbours, on the gradient signed for the peak's
+    // polarity so an adjacent edge of the opposite sign does not pull the vertex
+    const float sign = polarity > 0 ? 1.0f : polarity < 0 ? -1.0f : (grad[best] >= 0.0f ? 1.0f : -1.0f);
+    const float g0 = sign * grad[best - 1];
+    const float g1 = sign * grad[best];
+    const float g2 = sign * grad[best + 1];
+    const float denom = g0 - 2.0f * g1 + g2;
+    float offset = denom < 0.0f ? 0.5f * (g0 - g2) / denom : 0.0f;
+    offset = std::max(-0.5f, std::min(0.5f, offset));
+
+    return best + offset;
+}
+
+// Total least squares line through pts[idx]; returns the RMS perpendicular distance
+static float leastSquaresLine(const std::vector<cv::Point2f> &pts, const std::vector<int> &idx,
+                              cv::Point2f &centre, cv::Point2f &dir)
+{
+    double sx = 0, sy = 0;
+    for (int i : idx)
+    {
+        sx += pts[i].x;
+        sy += pts[i].y;
+    }
+    const double cx = sx / idx.size();
+    const double cy = sy / idx.size();
+
+    double sxx = 0, sxy = 0, syy = 0;
+    for (int i : idx)
+    {
+        const double dx = pts[i].x - cx;
+        const double dy = pts[i].y - cy;
+        sxx += dx * dx;
+        sxy += dx * dy;
+        syy += dy * dy;
+    }
+
+    // Major axis of the scatter
+    const double theta = 0.5 * std::atan2(2.0 * sxy, sxx - syy);
+    centre = cv::Point2f((float)cx, (float)cy);
+    dir = cv::Point2f((float)std::cos(theta), (float)std::sin(theta));
+
+    // The minor eigenvalue is the summed squared distance to the line
+    const double tr = 0.5 * (sxx + syy);
+    const double det = std::sqrt(std::max(0.0, 0.25 * (sxx - syy) * (sxx - syy) + sxy * sxy));
+    return (float)std::sqrt(std::max(0.0, tr - det) / idx.size());
+}
+
+// RANSAC over point pairs followed by a least squares refit of the inliers
+static bool fitLineRansac(const std::vector<cv::Point2f> &pts, float inlier_dist, int max_iterations,
+                          cv::Point2f &centre, cv::Point2f &dir, float &residual, std::vector<int> &inliers)
+{
+    const int n = (int)pts.size();
+    if (n < 2)
+        return false;
+
+    std::vector<int> candidate;
+    candidate.reserve(n);
+    inliers.clear();
+
+    auto collect = [&](const cv::Point2f &p, const cv::Point2f &d, std::vector<int> &out)
+    {
+        out.clear();
+        for (int i = 0; i < n; ++i)
+        {
+            const float dist = std::abs((pts[i].x - p.x) * d.y - (pts[i].y - p.y) * d.x);
+            if (dist <= inlier_dist)
+                out.push_back(i);
+        }
+    };
+
+    auto tryPair = [&](int a, int b)
+    {
+        cv::Point2f d = pts[b] - pts[a];
+        const float len = std::sqrt(d.x * d.x + d.y * d.y);
+        if (len < 1e-6f)
+            return;
+        d *= 1.0f / len;
+        collect(pts[a], d, candidate);
+        if (candidate.size() > inliers.size())
+            inliers.swap(candidate);
+    };
+
+    // Few calipers: try every pair; otherwise sample with a fixed seed so results are repeatable
+    const int pairs = n * (n - 1) / 2;
+    if (pairs <= max_iterations)
+    {
+        for (int a = 0; a < n; ++a)
+            for (int b = a + 1; b < n; ++b)
+                tryPair(a, b);
+    }
+    else
+    {
+        cv::RNG rng(0x2545F491);
+        for (int it = 0; it < max_iterations && (int)inliers.size() < n; ++it)
+        {
+            int a = rng.uniform(0, n);
+            int b = rng.uniform(0, n - 1);
+            if (b >= a)
+                ++b;
+            tryPair(a, b);
+        }
+    }
+
+    if (inliers.size() < 2)
+        return false;
+
+    // Refit, then take the inliers of the refined line once more
+    residual = leastSquaresLine(pts, inliers, centre, dir);
+    collect(centre, dir, candidate);
+    if (candidate.size() >= inliers.size())
+    {
+        inliers.swap(candidate);
+        residual = leastSquaresLine(pts, inliers, centre, dir);
+    }
+    return true;
+}
+
+// Scan num_calipers evenly spaced profiles (each averaged over caliper_width pixels)
+// across roi, locate the strongest sub-pixel edge in each and fit one line to them.
+static bool scanEdgeLine(const cv::Mat &roi_img, cv::Point offset, int direction,
+                         int num_calipers, int caliper_width, float min_contrast, int polarity,
+                         float ransac_threshold, EdgeLine &line)
+{
+    const bool vertical_scan = direction == SCAN_DOWN || direction == SCAN_UP;
+    const bool reverse = direction == SCAN_UP || direction == SCAN_LEFT;
+    const int across = vertical_scan ? roi_img.cols : roi_img.rows; // caliper placement axis
+    const int along = vertical_scan ? roi_img.rows : roi_img.cols;  // profile length
+
+    caliper_width = std::max(1, std::min(caliper_width, across));
+    num_calipers = std::max(2, std::min(num_calipers, across));
+
+    std::vector<float> profile(along), grad;
+    std::vector<cv::Point2f> pts;
+    pts.reserve(num_calipers);
+
+    for (int k = 0; k < num_calipers; ++k)
+    {
+        // Caliper k covers [c0, c0 + caliper_width) across the scan
+        const float centre = (k + 0.5f) * across / num_calipers;
+        const int c0 = std::max(0, std::min(across - caliper_width, (int)std::lround(centre - 0.5f * caliper_width)));
+
+        std::fill(profile.begin(), profile.end(), 0.0f);
+        if (vertical_scan)
+        {
+            for (int y = 0; y < along; ++y)
+            {
+                const uint8_t *row = roi_img.ptr<uint8_t>(y) + c0;
+                int sum = 0;
+                for (int c = 0; c < caliper_width; ++c)
+                    sum += row[c];
+                profile[reverse ? along - 1 - y : y] = (float)sum / caliper_width;
+            }
+        }
+        else
+        {
+            for (int c = 0; c < caliper_width; ++c)
+            {
+                const uint8_t *row = roi_img.ptr<uint8_t>(c0 + c);
+                for (int x = 0; x < along; ++x)
+                    profile[reverse ? along - 1 - x : x] += row[x];
+            }
+            for (float &v : profile)
+                v /= caliper_width;
+        }
+
+        float pos = caliperEdge(profile, grad, min_contrast, polarity);
+        if (pos < 0.0f)
+            continue;
+        if (reverse)
+            pos = along - 1 - pos;
+
+        const float mid = c0 + 0.5f * (caliper_width - 1);
+        pts.emplace_back(vertical_scan ? cv::Point2f(offset.x + mid, offset.y + pos)
+                                       : cv::Point2f(offset.x + pos, offset.y + mid));
+    }
+
+    line.points = (int)pts.size();
+
+    cv::Point2f centre, dir;
+    std::vector<int> inliers;
+    if (!fitLineRansac(pts, ransac_threshold, 64, centre, dir, line.residual, inliers))
+        return false;
+
+    // Orient like roi_edge_detection's segments: left to right (or top to bottom when vertical)
+    if (dir.x < 0.0f || (dir.x == 0.0f && dir.y < 0.0f))
+        dir = -dir;
+
+    // Report the point of the line nearest the ROI centre
+    const cv::Point2f roi_centre(offset.x + 0.5f * (roi_img.cols - 1), offset.y + 0.5f * (roi_img.rows - 1));
+    const cv::Point2f v = roi_centre - centre;
+    const float t = v.x * dir.x + v.y * dir.y;
+
+    line.x = centre.x + t * dir.x;
+    line.y = centre.y + t * dir.y;
+    line.angle = std::atan2(dir.y, dir.x) * 180.0f / (float)CV_PI;
+    line.inliers = (int)inliers.size();
+    return true;
+}
+
+// ROI edge line: sub-pixel caliper edges + robust line fit.
+// Returns a structured array with one (x, y, angle, residual, inliers, points) record, empty when
+// fewer than two edges are found; legacy_output returns (x, y, angle, residual, inliers) or None.
+py::object roi_edge_line(
+    py::array_t<uint8_t> image,
+    int roi_x, int roi_y, int roi_width, int roi_height,
+    int direction, int num_calipers, int caliper_width,
+    float min_contrast, int polarity, float ransac_threshold, int bayer_pattern, bool legacy_output)
+{
+    PERF_SCOPE("vision.roi_edge_line");
+    if (direction < SCAN_DOWN || direction > SCAN_LEFT)
+        throw std::runtime_error("Unknown scan direction");
+
+    ImageView view = viewImage(image, bayer_pattern);
+    cv::Rect roi = clampEdgeRoi(view, roi_x, roi_y, roi_width, roi_height);
+
+    EdgeLine line;
+    bool found;
+    {
+        py::gil_scoped_release release;
+        cv::Mat roi_img = extractGrayRoi(view, roi);
+        found = scanEdgeLine(roi_img, roi.tl(), direction, num_calipers, caliper_width,
+                             min_contrast, polarity, ransac_threshold, line);
+    }
+
+    if (!legacy_output)
+        return copyToArray(found ? std::vector<EdgeLine>{line} : std::vector<EdgeLine>());
+
+    if (!found)
+        return py::none();
+
+    return py::make_tuple(line.x, line.y, line.angle, line.residual, line.inliers);
+}
+
+// Single match in image coordinates
+struct MatchResult
+{
+    int32_t x;
+    int32_t y;
+    float confidence;
+};
+
+// Match produced by template_matching_batch, tagged with its job index
+struct BatchMatchResult
+{
+    int32_t job;
+    int32_t x;
+    int32_t y;
+    float confidence;
+};
+
+static bool isSqdiffMethod(int method)
+{
+    return method == cv::TM_SQDIFF || method == cv::TM_SQDIFF_NORMED;
+}
+
+static bool isNormedMethod(int method)
+{
+    return method == cv::TM_SQDIFF_NORMED || method == cv::TM_CCORR_NORMED || method == cv::TM_CCOEFF_NORMED;
+}
+
+// Clamp a template matching ROI to the image; an empty ROI selects the whole image
+static cv::Rect clampMatchRoi(int img_cols, int img_rows,
+                              int roi_x, int roi_y, int roi_width, int roi_height)
+{
+    if (roi_width <= 0 || roi_height <= 0)
+        return cv::Rect(0, 0, img_cols, img_rows);
+
+    roi_x = std::max(0, std::min(roi_x, img_cols - 1));
+    roi_y = std::max(0, std::min(roi_y, img_rows - 1));
+    roi_width = std::min(roi_width, img_cols - roi_x);
+    roi_height = std::min(roi_height, img_rows - roi_y);
+    return cv::Rect(roi_x, roi_y, roi_width, roi_height);
+}
+
+// Peak extraction settings for multiple-match mode
+struct PeakOptions
+{
+    int nms_radius; // suppression radius in pixels (Chebyshev distance), 0 reports every pixel above threshold
+    int max_count;  // maximum number of peaks to return, 0 for no limit
+};
+
+// Default suppression radius: half the smaller template side
+static int defaultNmsRadius(const cv::Mat &tmpl)
+{
+    return std::max(1, std::min(tmpl.cols, tmpl.rows) / 2);
+}
+
+// Extract the local maxima of a matchTemplate score map and append them, strongest first
+// (with nms_radius 0 there is no local-maximum test: every pixel above threshold is reported).
+// Scores are normalised so higher is better (1 - value for the SQDIFF methods, matching the
+// single-match confidence). Thresholding and the local-maximum test are vectorised OpenCV
+// passes; only the surviving candidates are visited in scalar code for the greedy NMS.
+static void extractPeaks(const cv::Mat &result, int method, float threshold,
+                         const PeakOptions &opts, cv::Point offset,
+                         std::vector<MatchResult> &peaks)
+{
+    cv::Mat score;
+    if (isSqdiffMethod(method))
+        cv::subtract(cv::Scalar::all(1.0), result, score);
+    else
+        score = result;
+
+    cv::Mat mask;
+    cv::compare(score, (double)threshold, mask, cv::CMP_GE);
+
+    const int radius = std::max(0, opts.nms_radius);
+    if (radius > 0)
+    {
+        // A pixel is a local maximum if it equals the max of its (2r+1)^2 neighbourhood
+        cv::Mat dilated, is_max;
+        cv::Mat kernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(2 * radius + 1, 2 * radius + 1));
+        cv::dilate(score, dilated, kernel);
+        cv::compare(score, dilated, is_max, cv::CMP_GE);
+        cv::bitwise_and(mask, is_max, mask);
+    }
+
+    std::vector<cv::Point> locs;
+    cv::findNonZero(mask, locs);
+
+    std::vector<std::pair<float, cv::Point>> candidates;
+    candidates.reserve(locs.size());
+    for (const auto &p : locs)
+        candidates.emplace_back(score.at<float>(p), p);
+
+    // Strongest first; ties resolved in row-major order so the output is deterministic
+    std::sort(candidates.begin(), candidates.end(), [](const auto &a, const auto &b)
+    {
+        if (a.first != b.first)
+            return a.first > b.first;
+        return a.second.y != b.second.y ? a.second.y < b.second.y : a.second.x < b.second.x;
+    });
+
+    // Accepted peaks are more than 'radius' apart, so a grid with cell size 'radius'
+    // holds at most one of them per cell and a candidate only has to check its 3x3 cells.
+    const int cell = std::max(1, radius);
+    const int grid_cols = score.cols / cell + 1;
+    const int grid_rows = score.rows / cell + 1;
+    std::vector<int> grid(radius > 0 ? (size_t)grid_cols * grid_rows : 0, -1);
+
+    const size_t first = peaks.size();
+    for (const auto &c : candidates)
+    {
+        if (opts.max_count > 0 && peaks.size() - first >= (size_t)opts.max_count)
+            break;
+
+        const cv::Point &p = c.second;
+        if (radius > 0)
+        {
+            const int gx = p.x / cell;
+            const int gy = p.y / cell;
+            bool suppressed = false;
+            for (int dy = -1; dy <= 1 && !suppressed; ++dy)
+            {
+                for (int dx = -1; dx <= 1 && !suppressed; ++dx)
+                {
+                    const int cx = gx + dx;
+                    const int cy = gy + dy;
+                    if (cx < 0 || cy < 0 || cx >= grid_cols || cy >= grid_rows)
+                        continue;
+                    const int idx = grid[(size_t)cy * grid_cols + cx];
+                    if (idx < 0)
+                        continue;
+                    const MatchResult &q = peaks[idx];
+                    suppressed = std::abs(q.x - offset.x - p.x) <= radius &&
+                                 std::abs(q.y - offset.y - p.y) <= radius;
+                }
+            }
+            if (suppressed)
+                continue;
+            grid[(size_t)gy * grid_cols + gx] = (int)peaks.size();
+        }
+
+        peaks.push_back({p.x + offset.x, p.y + offset.y, c.first});
+    }
+}
+
+// ==========================================
+// Coarse-to-fine (image pyramid) matching
+// ==========================================
+
+// Template pyramids stop once the template would drop below this size
+const int PYRAMID_MIN_TEMPLATE_SIDE = 8;
+// Normalised methods accept coarse candidates this far below the final threshold
+const float PYRAMID_COARSE_SLACK = 0.15f;
+// Coarse candidates refined at full resolution (single / multiple match mode)
+const int PYRAMID_SINGLE_CANDIDATES = 4;
+const int PYRAMID_MAX_CANDIDATES = 256;
+
+struct TemplatePyramid
+{
+    std::vector<cv::Mat> levels; // levels[0] is the full resolution template
+};
+
+static std::shared_ptr<TemplatePyramid> buildTemplatePyramid(const cv::Mat &tmpl, int max_levels)
+{
+    auto pyr = std::make_shared<TemplatePyramid>();
+    pyr->levels.push_back(tmpl);
+    while ((int)pyr->levels.size() <= max_levels)
+    {
+        const cv::Mat &prev = pyr->levels.back();
+        if ((prev.cols + 1) / 2 < PYRAMID_MIN_TEMPLATE_SIDE || (prev.rows + 1) / 2 < PYRAMID_MIN_TEMPLATE_SIDE)
+            break;
+        cv::Mat down;
+        cv::pyrDown(prev, down);
+        pyr->levels.push_back(down);
+    }
+    return pyr;
+}
+
+// True if pyr has max_levels levels below the base, or cannot get any deeper
+static bool pyramidCovers(const TemplatePyramid &pyr, int max_levels)
+{
+    const cv::Mat &last = pyr.levels.back();
+    return (int)pyr.levels.size() > max_levels ||
+           (last.cols + 1) / 2 < PYRAMID_MIN_TEMPLATE_SIDE ||
+           (last.rows + 1) / 2 < PYRAMID_MIN_TEMPLATE_SIDE;
+}
+
+// Templates at least this large are correlated through the cached DFT spectrum;
+// smaller ones go through cv::matchTemplate on the handle's own copy
+const int HANDLE_DFT_MIN_AREA = 48 * 48;
+// DFT spectra kept per handle, least recently used first to go. The block size follows the
+// ROI size, so a tracker with a varying search window would otherwise add one per frame.
+const size_t HANDLE_SPECTRUM_CACHE_CAPACITY = 8;
+
+// Template registered once from Python (register_template). Owns a private copy of
+// the template and keeps everything that only depends on it across calls: sum / mean /
+// norm for the normalised methods, the image pyramid and the DFT spectra of recent block sizes.
+class TemplateHandle
+{
+public:
+    explicit TemplateHandle(const cv::Mat &tmpl) : templ(tmpl.clone())
+    {
+        const double area = (double)templ.total();
+        templ_sum = cv::sum(templ)[0];
+        templ_sq_sum = templ.dot(templ);
+        templ_mean = templ_sum / area;
+        templ_var_sum = std::max(templ_sq_sum - templ_sum * templ_sum / area, 0.0);
+    }
+
+    const cv::Mat &image() const { return templ; }
+    int width() const { return templ.cols; }
+    int height() const { return templ.rows; }
+    double mean() const { return templ_mean; }
+    double stddev() const { return std::sqrt(templ_var_sum / (double)templ.total()); }
+
+    std::shared_ptr<const TemplatePyramid> pyramid(int max_levels) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!templ_pyramid || !pyramidCovers(*templ_pyramid, max_levels))
+            templ_pyramid = buildTemplatePyramid(templ, max_levels);
+        return templ_pyramid;
+    }
+
+    // Same output as cv::matchTemplate(img, image(), result, method)
+    void matchTemplate(const cv::Mat &img, cv::Mat &result, int method) const
+    {
+        if ((int)templ.total() < HANDLE_DFT_MIN_AREA)
+        {
+            cv::matchTemplate(img, templ, result, method);
+            return;
+        }
+
+        if (method == cv::TM_CCOEFF_NORMED && templ_var_sum < DBL_EPSILON)
+        {
+            // Flat template: OpenCV defines the normalised correlation as 1 everywhere
+            result.create(img.rows - templ.rows + 1, img.cols - templ.cols + 1, CV_32F);
+            result.setTo(cv::Scalar::all(1.0));
+            return;
+        }
+
+        crossCorr(img, result);
+        if (method == cv::TM_CCORR)
+            return;
+        normalise(img, result, method);
+    }
+
+private:
+    // DFT of the zero padded template for one block size, computed on first use and kept in
+    // a small LRU list (most recent first)
+    cv::Mat spectrum(const cv::Size &dft_size) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto it = spectra.begin(); it != spectra.end(); ++it)
+        {
+            if (it->first == dft_size)
+            {
+                spectra.splice(spectra.begin(), spectra, it);
+                return it->second;
+            }
+        }
+
+        cv::Mat padded = cv::Mat::zeros(dft_size, CV_32F);
+        templ.convertTo(padded(cv::Rect(0, 0, templ.cols, templ.rows)), CV_32F);
+        cv::dft(padded, padded, 0, templ.rows);
+        spectra.emplace_front(dft_size, padded);
+        if (spectra.size() > HANDLE_SPECTRUM_CACHE_CAPACITY)
+            spectra.pop_back();
+        return padded;
+    }
+
+    // Valid-region cross-correlation, computed block-wise like OpenCV's crossCorr but
+    // with the template spectrum reused from the cache
+    void crossCorr(const cv::Mat &img, cv::Mat &corr) const
+    {
+        const cv::Size corr_size(img.cols - templ.cols + 1, img.rows - templ.rows + 1);
+        corr.create(corr_size, CV_32F);
+
+        cv::Size block(cvRound(templ.cols * 4.5), cvRound(templ.rows * 4.5));
+        block.width = std::min(std::max(block.width, 256 - templ.cols + 1), corr_size.width);
+        block.height = std::min(std::max(block.height, 256 - templ.rows + 1), corr_size.height);
+
+        const cv::Size dft_size(cv::getOptimalDFTSize(block.width + templ.cols - 1),
+                                cv::getOptimalDFTSize(block.height + templ.rows - 1));
+        // Use all of the (possibly larger) optimal DFT size
+        block.width = std::min(dft_size.width - templ.cols + 1, corr_size.width);
+        block.height = std::min(dft_size.height - templ.rows + 1, corr_size.height);
+
+        const cv::Mat templ_spectrum = spectrum(dft_size);
+        cv::Mat dft_img(dft_size, CV_32F);
+        cv::Mat dft_prod;
+
+        for (int y = 0; y < corr_size.height; y += block.height)
+        {
+            for (int x = 0; x < corr_size.width; x += block.width)
+            {
+                const int bw = std::min(block.width, corr_size.width - x);
+                const int bh = std::min(block.height, corr_size.height - y);
+                const cv::Rect src(x, y, bw + templ.cols - 1, bh + templ.rows - 1);
+
+                dft_img.setTo(cv::Scalar::all(0));
+                img(src).convertTo(dft_img(cv::Rect(0, 0, src.width, src.height)), CV_32F);
+                cv::dft(dft_img, dft_img, 0, src.height);
+                cv::mulSpectrums(dft_img, templ_spectrum, dft_prod, 0, true);
+                cv::dft(dft_prod, dft_prod, cv::DFT_INVERSE | cv::DFT_SCALE | cv::DFT_REAL_OUTPUT, bh);
+                dft_prod(cv::Rect(0, 0, bw, bh)).copyTo(corr(cv::Rect(x, y, bw, bh)));
+            }
+        }
+    }
+
+    // Turn the raw correlation into the requested method's score using window sums from
+    // integral images and the precomputed template statistics (mirrors OpenCV's formulas)
+    void normalise(const cv::Mat &img, cv::Mat &result, int method) const
+    {
+        // 0: CCORR family, 1: CCOEFF family, 2: SQDIFF family
+        int num_type = 2;
+        if (method == cv::TM_CCORR || method == cv::TM_CCORR_NORMED)
+            num_type = 0;
+        else if (method == cv::TM_CCOEFF || method == cv::TM_CCOEFF_NORMED)
+            num_type = 1;
+        const bool normed = isNormedMethod(method);
+        const double inv_area = 1.0 / (double)templ.total();
+        const double t_mean = num_type == 1 ? templ_mean : 0.0;
+        const double t_norm = std::sqrt(num_type == 1 ? templ_var_sum : templ_sq_sum);
+
+        cv::Mat sum, sqsum;
+        cv::integral(img, sum, sqsum, CV_64F, CV_64F);
+
+        const int w = templ.cols;
+        const int h = templ.rows;
+        for (int y = 0; y < result.rows; ++y)
+        {
+            float *rrow = result.ptr<float>(y);
+            const double *p0 = sum.ptr<double>(y);
+            const double *p1 = sum.ptr<double>(y + h);
+            const double *q0 = sqsum.ptr<double>(y);
+            const double *q1 = sqsum.ptr<double>(y + h);
+
+            for (int x = 0; x < result.cols; ++x)
+            {
+                double num = rrow[x];
+                double wnd_mean2 = 0.0;
+                double wnd_sum2 = 0.0;
+
+                if (num_type == 1)
+                {
+                    double t = p0[x] - p0[x + w] - p1[x] + p1[x + w];
+                    wnd_mean2 = t * t * inv_area;
+                    num -= t * t_mean;
+                }
+
+                if (normed || num_type == 2)
+                {
+                    wnd_sum2 = q0[x] - q0[x + w] - q1[x] + q1[x + w];
+                    if (num_type == 2)
+                        num = std::max(wnd_sum2 - 2.0 * num + templ_sq_sum, 0.0);
+                }
+
+                if (normed)
+                {
+                    double diff2 = std::max(wnd_sum2 - wnd_mean2, 0.0);
+                    double t = diff2 <= std::min(0.5, 10 * FLT_EPSILON * wnd_sum2) ? 0.0 : std::sqrt(diff2) * t_norm;
+                    if (std::fabs(num) < t)
+                        num /= t;
+                    else if (std::fabs(num) < t * 1.125)
+                        num = num > 0 ? 1 : -1;
+                    else
+                        num = method != cv::TM_SQDIFF_NORMED ? 0 : 1;
+                }
+
+                rrow[x] = (float)num;
+            }
+        }
+    }
+
+    cv::Mat templ;
+    double templ_sum;
+    double templ_sq_sum;
+    double templ_mean;
+    double templ_var_sum; // sum of squared deviations from the mean
+
+    mutable std::mutex mutex;
+    mutable std::shared_ptr<const TemplatePyramid> templ_pyramid;
+    mutable std::list<std::pair<cv::Size, cv::Mat>> spectra;
+};
+
+
+// Run matchTemplate on roi_img (the ROI pixels, whose top-left corner is 'offset' in the
+// image) and append the matches in image coordinates to matches.
+// Multiple-match mode reports the NMS-filtered local maxima (see extractPeaks); 'peaks' holds
+// the radius/count settings, nullptr uses the template-derived defaults.
+// When handle is set, tmpl must be handle->image() and the handle's cached data is used.
+// result is caller-owned so it can be reused between calls.
+static void matchInRoi(const cv::Mat &roi_img, cv::Point offset,
+                       const cv::Mat &tmpl, const TemplateHandle *handle,
+                       int method, float threshold, bool multiple_matches,
+                       const PeakOptions *peaks,
+                       cv::Mat &result, std::vector<MatchResult> &matches)
+{
+    {
+        PERF_SCOPE("match.match_template");
+        if (handle)
+            handle->matchTemplate(roi_img, result, method);
+        else
+            cv::matchTemplate(roi_img, tmpl, result, method);
+    }
+
+    PERF_SCOPE("match.extract_results");
+    const bool sqdiff = isSqdiffMethod(method);
+
+    if (multiple_matches)
+    {
+        const PeakOptions defaults{defaultNmsRadius(tmpl), 0};
+        extractPeaks(result, method, threshold, peaks ? *peaks : defaults, offset, matches);
+    }
+    else
+    {
+        double min_val, max_val;
+        cv::Point min_loc, max_loc;
+        cv::minMaxLoc(result, &min_val, &max_val, &min_loc, &max_loc);
+
+        float confidence = (float)(sqdiff ? (1.0 - min_val) : max_val);
+
+        if (confidence >= threshold)
+        {
+            const cv::Point &loc = sqdiff ? min_loc : max_loc;
+            matches.push_back({loc.x + offset.x, loc.y + offset.y, confidence});
+        }
+    }
+}
+
+// Pyramids cached by template_id, least recently used evicted beyond this many entries
+const size_t TEMPLATE_CACHE_CAPACITY = 64;
+
+struct CachedTemplatePyramid
+{
+    uint64_t content_hash; // hashTemplate() of the template the pyramid was built from
+    std::shared_ptr<const TemplatePyramid> pyramid;
+    std::list<int64_t>::iterator lru; // position in template_pyramid_lru
+};
+
+static std::mutex template_pyramid_mutex;
+static std::list<int64_t> template_pyramid_lru; // most recently used first
+static std::unordered_map<int64_t, CachedTemplatePyramid> template_pyramid_cache;
+
+// FNV-1a over the template rows (the template may be a strided view) and its size
+static uint64_t hashTemplate(const cv::Mat &tmpl)
+{
+    const uint64_t prime = 1099511628211ull;
+    uint64_t h = 1469598103934665603ull;
+    const size_t row_bytes = (size_t)tmpl.cols * tmpl.elemSize();
+    for (int y = 0; y < tmpl.rows; ++y)
+    {
+        const uint8_t *row = tmpl.ptr<uint8_t>(y);
+        for (size_t i = 0; i < row_bytes; ++i)
+            h = (h ^ row[i]) * prime;
+    }
+    h = (h ^ (uint64_t)tmpl.cols) * prime;
+    return (h ^ (uint64_t)tmpl.rows) * prime;
+}
+
+// Return the pyramid for tmpl, cached under template_id when template_id >= 0.
+// Entries are checked against a hash of the template content, so passing a different
+// template under an old ID rebuilds the pyramid instead of matching a stale one.
+static std::shared_ptr<const TemplatePyramid> getTemplatePyramid(const cv::Mat &tmpl, int64_t template_id, int max_levels)
+{
+    if (template_id < 0)
+        return buildTemplatePyramid(tmpl, max_levels);
+
+    const uint64_t content_hash = hashTemplate(tmpl);
+    {
+        std::lock_guard<std::mutex> lock(template_pyramid_mutex);
+        auto it = template_pyramid_cache.find(template_id);
+        // Reuse unless the template changed or a deeper pyramid could be built
+        if (it != template_pyramid_cache.end() && it->second.content_hash == content_hash &&
+            pyramidCovers(*it->second.pyramid, max_levels))
+        {
+            template_pyramid_lru.splice(template_pyramid_lru.begin(), template_pyramid_lru, it->second.lru);
+            return it->second.pyramid;
+        }
+    }
+
+    // The cached pyramid outlives the caller's buffer, so it owns a copy of the template
+    std::shared_ptr<const TemplatePyramid> pyr = buildTemplatePyramid(tmpl.clone(), max_levels);
+
+    std::lock_guard<std::mutex> lock(template_pyramid_mutex);
+    auto it = template_pyramid_cache.find(template_id);
+    if (it != template_pyramid_cache.end())
+    {
+        it->second.content_hash = content_hash;
+        it->second.pyramid = pyr;
+        template_pyramid_lru.splice(template_pyramid_lru.begin(), template_pyramid_lru, it->second.lru);
+        return pyr;
+    }
+
+    template_pyramid_lru.push_front(template_id);
+    template_pyramid_cache.emplace(template_id, CachedTemplatePyramid{content_hash, pyr, template_pyramid_lru.begin()});
+    while (template_pyramid_cache.size() > TEMPLATE_CACHE_CAPACITY)
+    {
+        template_pyramid_cache.erase(template_pyramid_lru.back());
+        template_pyramid_lru.pop_back();
+    }
+    return pyr;
+}
+
+// Match at the coarsest usable pyramid level, then refine each candidate in a small
+// full resolution window. Single-match mode returns the best refined match; multiple-match
+// mode returns one refined match per peak, merged and limited per 'peaks' as in matchInRoi.
+// A ROI too small for any coarse level is matched exactly like the non-pyramid path.
+static void matchPyramid(const cv::Mat &roi_img, cv::Point offset,
+                         const TemplatePyramid &pyr, const TemplateHandle *handle,
+                         int method, float threshold, bool multiple_matches,
+                         const PeakOptions *peaks, std::vector<MatchResult> &matches)
+{
+    PERF_SCOPE("match.pyramid");
+    const cv::Mat &tmpl = pyr.levels[0];
+    const bool sqdiff = isSqdiffMethod(method);
+
+    // Deepest level at which the downsampled ROI still holds the template
+    int level = (int)pyr.levels.size() - 1;
+    while (level > 0 && ((roi_img.cols >> level) < pyr.levels[level].cols || (roi_img.rows >> level) < pyr.levels[level].rows))
+        level--;
+
+    if (level == 0)
+    {
+        cv::Mat result;
+        matchInRoi(roi_img, offset, tmpl, handle, method, threshold, multiple_matches, peaks, result, matches);
+        return;
+    }
+
+    cv::Mat coarse = roi_img;
+    for (int l = 0; l < level; ++l)
+    {
+        cv::Mat down;
+        cv::pyrDown(coarse, down);
+        coarse = down;
+    }
+
+    cv::Mat result;
+    cv::matchTemplate(coarse, pyr.levels[level], result, method);
+
+    // Unnormalised scores scale with the template area, so only the candidate count limits them
+    float coarse_threshold = isNormedMethod(method) ? threshold - PYRAMID_COARSE_SLACK : -std::numeric_limits<float>::max();
+    PeakOptions coarse_opts{defaultNmsRadius(pyr.levels[level]),
+                            multiple_matches ? PYRAMID_MAX_CANDIDATES : PYRAMID_SINGLE_CANDIDATES};
+    std::vector<MatchResult> candidates;
+    extractPeaks(result, method, coarse_threshold, coarse_opts, cv::Point(0, 0), candidates);
+
+    // Each coarse pixel covers 2^level full resolution pixels; search twice that around it
+    const int scale = 1 << level;
+    const int margin = 2 * scale;
+    const cv::Rect roi_bounds(0, 0, roi_img.cols, roi_img.rows);
+
+    std::vector<MatchResult> refined;
+    cv::Mat window_result;
+    for (const auto &c : candidates)
+    {
+        cv::Rect window(c.x * scale - margin, c.y * scale - margin, tmpl.cols + 2 * margin, tmpl.rows + 2 * margin);
+        window &= roi_bounds;
+        if (window.width < tmpl.cols || window.height < tmpl.rows)
+            continue;
+
+        cv::matchTemplate(roi_img(window), tmpl, window_result, method);
+
+        double min_val, max_val;
+        cv::Point min_loc, max_loc;
+        cv::minMaxLoc(window_result, &min_val, &max_val, &min_loc, &max_loc);
+
+        float confidence = (float)(sqdiff ? (1.0 - min_val) : max_val);
+        if (confidence < threshold)
+            continue;
+
+        const cv::Point &loc = sqdiff ? min_loc : max_loc;
+        refined.push_back({offset.x + window.x + loc.x, offset.y + window.y + loc.y, confidence});
+    }
+
+    std::stable_sort(refined.begin(), refined.end(), [](const MatchResult &a, const MatchResult &b)
+    {
+        return a.confidence > b.confidence;
+    });
+
+    if (!multiple_matches)
+    {
+        if (!refined.empty())
+            matches.push_back(refined.front());
+        return;
+    }
+
+    // Neighbouring coarse candidates can refine to the same location
+    const PeakOptions opts = peaks ? *peaks : PeakOptions{defaultNmsRadius(tmpl), 0};
+    const int radius = std::max(0, opts.nms_radius);
+    const size_t first = matches.size();
+    for (const auto &r : refined)
+    {
+        if (opts.max_count > 0 && matches.size() - first >= (size_t)opts.max_count)
+            break;
+        bool duplicate = false;
+        for (size_t i = first; i < matches.size() && !duplicate; ++i)
+            duplicate = std::abs(matches[i].x - r.x) <= radius && std::abs(matches[i].y - r.y) <= radius;
+        if (!duplicate)
+            matches.push_back(r);
+    }
+}
+
+// Drop all cached template pyramids
+void clear_template_cache()
+{
+    std::lock_guard<std::mutex> lock(template_pyramid_mutex);
+    template_pyramid_cache.clear();
+    template_pyramid_lru.clear();
+}
+
+static std::shared_ptr<TemplateHandle> register_template(py::array_t<uint8_t> template_img, int bayer_pattern)
+{
+    // TemplateHandle keeps its own copy, so colour input is converted here once
+    return std::make_shared<TemplateHandle>(extractGray(viewImage(template_img, bayer_pattern)));
+}
+
+// Legacy output: tuple of (x, y, confidence) tuples
+static py::tuple toMatchTuples(const std::vector<MatchResult> &found)
+{
+    PERF_SCOPE("py.to_tuples");
+    std::vector<std::tuple<int, int, float>> matches;
+    matches.reserve(found.size());
+    for (const auto &m : found)
+        matches.emplace_back(m.x, m.y, m.confidence);
+
+    return py::cast(matches);
+}
+
+static py::object toMatchOutput(std::vector<MatchResult> &&found, bool legacy_output)
+{
+    if (legacy_output)
+        return toMatchTuples(found);
+    return moveToArray(std::move(found));
+}
+
+// Template Matching Function
+// Returns a structured array (x, y, confidence), or the legacy tuple of tuples when legacy_output is set.
+// multiple_matches reports local maxima only, nms_radius/max_matches as in template_matching_peaks.
+py::object template_matching(
+    py::array_t<uint8_t> image,
+    py::array_t<uint8_t> template_img,
+    int method, float threshold, bool multiple_matches,
+    int roi_x, int roi_y, int roi_width, int roi_height,
+    int pyramid_levels, int64_t template_id, int bayer_pattern, bool legacy_output,
+    int nms_radius, int max_matches)
+{
+    PERF_SCOPE("vision.template_matching");
+
+    ImageView view = viewImage(image, bayer_pattern);
+    cv::Mat tmpl = extractGray(viewImage(template_img));
+
+    cv::Rect roi = clampMatchRoi(view.cols, view.rows, roi_x, roi_y, roi_width, roi_height);
+    cv::Mat roi_img = extractGrayRoi(view, roi);
+    PeakOptions opts{nms_radius < 0 ? defaultNmsRadius(tmpl) : nms_radius, max_matches};
+
+    // Match
+    std::vector<MatchResult> found;
+    if (pyramid_levels > 0)
+    {
+        auto pyr = getTemplatePyramid(tmpl, template_id, pyramid_levels);
+        matchPyramid(roi_img, roi.tl(), *pyr, nullptr, method, threshold, multiple_matches, &opts, found);
+    }
+    else
+    {
+        cv::Mat result;
+        matchInRoi(roi_img, roi.tl(), tmpl, nullptr, method, threshold, multiple_matches, &opts, result, found);
+    }
+
+    return toMatchOutput(std::move(found), legacy_output);
+}
+
+// Template Matching against a registered TemplateHandle (no per-call template copy)
+py::object template_matching_handle(
+    py::array_t<uint8_t> image,
+    const TemplateHandle &handle,
+    int method, float threshold, bool multiple_matches,
+    int roi_x, int roi_y, int roi_width, int roi_height,
+    int pyramid_levels, int bayer_pattern, bool legacy_output,
+    int nms_radius, int max_matches)
+{
+    PERF_SCOPE("vision.template_matching");
+    ImageView view = viewImage(image, bayer_pattern);
+    cv::Rect roi = clampMatchRoi(view.cols, view.rows, roi_x, roi_y, roi_width, roi_height);
+    PeakOptions opts{nms_radius < 0 ? defaultNmsRadius(handle.image()) : nms_radius, max_matches};
+
+    std::vector<MatchResult> found;
+    {
+        py::gil_scoped_release release;
+        cv::Mat roi_img = extractGrayRoi(view, roi);
+        if (pyramid_levels > 0)
+        {
+            auto pyr = handle.pyramid(pyramid_levels);
+            matchPyramid(roi_img, roi.tl(), *pyr, &handle, method, threshold, multiple_matches, &opts, found);
+        }
+        else
+        {
+            cv::Mat result;
+            matchInRoi(roi_img, roi.tl(), handle.image(), &handle, method, threshold, multiple_matches, &opts, result, found);
+        }
+    }
+
+    return toMatchOutput(std::move(found), legacy_output);
+}
+
+// Template Matching with peak extraction
+// Reports only the local maxima above threshold, suppressing neighbours within nms_radius
+// (nms_radius < 0 uses half the template size). Returns a structured array (x, y, confidence).
+static py::array_t<MatchResult> matchPeaks(
+    const ImageView &view, const cv::Mat &tmpl, const TemplateHandle *handle,
+    int method, float threshold,
+    int roi_x, int roi_y, int roi_width, int roi_height,
+    int nms_radius, int max_matches)
+{
+    cv::Rect roi = clampMatchRoi(view.cols, view.rows, roi_x, roi_y, roi_width, roi_height);
+    PeakOptions opts{nms_radius < 0 ? defaultNmsRadius(tmpl) : nms_radius, max_matches};
+
+    std::vector<MatchResult> peaks;
+    {
+        py::gil_scoped_release release;
+        cv::Mat roi_img = extractGrayRoi(view, roi);
+        cv::Mat result;
+        matchInRoi(roi_img, roi.tl(), tmpl, handle, method, threshold, true, &opts, result, peaks);
+    }
+
+    return moveToArray(std::move(peaks));
+}
+
+py::array_t<MatchResult> template_matching_peaks(
+    py::array_t<uint8_t> image,
+    py::array_t<uint8_t> template_img,
+    int method, float threshold,
+    int roi_x, int roi_y, int roi_width, int roi_height,
+    int nms_radius, int max_matches, int bayer_pattern)
+{
+    return matchPeaks(viewImage(image, bayer_pattern), extractGray(viewImage(template_img)), nullptr, method, threshold,
+                      roi_x, roi_y, roi_width, roi_height, nms_radius, max_matches);
+}
+
+py::array_t<MatchResult> template_matching_peaks_handle(
+    py::array_t<uint8_t> image,
+    const TemplateHandle &handle,
+    int method, float threshold,
+    int roi_x, int roi_y, int roi_width, int roi_height,
+    int nms_radius, int max_matches, int bayer_pattern)
+{
+    return matchPeaks(viewImage(image, bayer_pattern), handle.image(), &handle, method, threshold,
+                      roi_x, roi_y, roi_width, roi_height, nms_radius, max_matches);
+}
+
+// Batched Template Matching Function
+// Runs one (template, ROI, method, threshold) job per template against the same frame.
+// Jobs are spread over OpenCV's thread pool with the GIL released; all matches are
+// returned in one structured array with fields (job, x, y, confidence).
+// Multiple-match jobs use peak extraction (see template_matching_peaks).
+// Colour or Bayer frames are converted per job ROI, never as a whole frame.
+// handles is either empty or parallel to tmpls.
+static py::array_t<BatchMatchResult> matchBatch(
+    py::array_t<uint8_t> image,
+    const std::vector<cv::Mat> &tmpls,
+    const std::vector<const TemplateHandle *> &handles,
+    const std::vector<std::array<int, 4>> &rois,
+    const std::vector<int> &methods,
+    const std::vector<float> &thresholds,
+    bool multiple_matches, int nms_radius, int max_matches, int bayer_pattern)
+{
+    const size_t job_count = tmpls.size();
+
+    if (rois.size() != job_count)
+        throw std::runtime_error("rois must have one (x, y, width, height) entry per template");
+    if (methods.size() != job_count && methods.size() != 1)
+        throw std::runtime_error("methods must have one entry per template or a single entry");
+    if (thresholds.size() != job_count && thresholds.size() != 1)
+        throw std::runtime_error("thresholds must have one entry per template or a single entry");
+
+    for (int method : methods)
+    {
+        if (method < cv::TM_SQDIFF || method > cv::TM_CCOEFF_NORMED)
+            throw std::runtime_error("Unknown template matching method");
+    }
+
+    ImageView view = viewImage(image, bayer_pattern);
+
+    std::vector<std::vector<MatchResult>> job_matches(job_count);
+
+    {
+        py::gil_scoped_release release;
+
+        cv::parallel_for_(cv::Range(0, (int)job_count), [&](const cv::Range &range)
+        {
+            cv::Mat result;
+            for (int i = range.start; i < range.end; ++i)
+            {
+                const auto &r = rois[i];
+                cv::Rect roi = clampMatchRoi(view.cols, view.rows, r[0], r[1], r[2], r[3]);
+
+                // A template larger than its ROI cannot match; skip instead of throwing from a worker
+                if (tmpls[i].empty() || tmpls[i].cols > roi.width || tmpls[i].rows > roi.height)
+                    continue;
+
+                int method = methods.size() == 1 ? methods[0] : methods[i];
+                float threshold = thresholds.size() == 1 ? thresholds[0] : thresholds[i];
+                const TemplateHandle *handle = handles.empty() ? nullptr : handles[i];
+                PeakOptions opts{nms_radius < 0 ? defaultNmsRadius(tmpls[i]) : nms_radius, max_matches};
+                cv::Mat roi_img = extractGrayRoi(view, roi);
+                matchInRoi(roi_img, roi.tl(), tmpls[i], handle, method, threshold, multiple_matches, &opts, result, job_matches[i]);
+            }
+        });
+    }
+
+    size_t total = 0;
+    for (const auto &jm : job_matches)
+        total += jm.size();
+
+    py::array_t<BatchMatchResult> out((py::ssize_t)total);
+    BatchMatchResult *dst = out.mutable_data();
+    for (size_t i = 0; i < job_count; ++i)
+    {
+        for (const auto &m : job_matches[i])
+            *dst++ = {(int32_t)i, m.x, m.y, m.confidence};
+    }
+
+    return out;
+}
+
+py::array_t<BatchMatchResult> template_matching_batch(
+    py::array_t<uint8_t> image,
+    const std::vector<py::array_t<uint8_t>> &templates,
+    const std::vector<std::array<int, 4>> &rois,
+    const std::vector<int> &methods,
+    const std::vector<float> &thresholds,
+    bool multiple_matches, int nms_radius, int max_matches, int bayer_pattern)
+{
+    // Wrap (or convert) every template while we still hold the GIL; the arrays in
+    // 'templates' keep the buffers alive for the duration of the call.
+    std::vector<cv::Mat> tmpls;
+    tmpls.reserve(templates.size());
+    for (const auto &t : templates)
+        tmpls.push_back(extractGray(viewImage(t)));
+
+    return matchBatch(image, tmpls, {}, rois, methods, thresholds, multiple_matches, nms_radius, max_matches, bayer_pattern);
+}
+
+py::array_t<BatchMatchResult> template_matching_batch_handles(
+    py::array_t<uint8_t> image,
+    const std::vector<std::shared_ptr<TemplateHandle>> &templates,
+    const std::vector<std::array<int, 4>> &rois,
+    const std::vector<int> &methods,
+    const std::vector<float> &thresholds,
+    bool multiple_matches, int nms_radius, int max_matches, int bayer_pattern)
+{
+    std::vector<cv::Mat> tmpls;
+    std::vector<const TemplateHandle *> handles;
+    tmpls.reserve(templates.size());
+    handles.reserve(templates.size());
+    for (const auto &t : templates)
+    {
+        if (!t)
+            throw std::runtime_error("Template handle is None");
+        tmpls.push_back(t->image());
+        handles.push_back(t.get());
+    }
+
+    return matchBatch(image, tmpls, handles, rois, methods, thresholds, multiple_matches, nms_radius, max_matches, bayer_pattern);
+}
+
+// ==========================================
+// Frame-to-frame ROI tracking
+// ==========================================
+
+// Constant-velocity prediction of a tracked box and the adaptive margin searched around it.
+// The margin follows the observed motion and prediction error, staying within [min, max].
+struct TrackState
+{
+    bool active = false;
+    cv::Point2f center;
+    cv::Point2f velocity; // px per frame
+    cv::Size size;
+    float margin = 0.0f;
+
+    // Predicted box grown by the margin, clipped to full
+    cv::Rect window(const cv::Rect &full) const
+    {
+        const cv::Point2f c = center + velocity;
+        const float hw = size.width * 0.5f + margin;
+        const float hh = size.height * 0.5f + margin;
+        cv::Rect r((int)std::floor(c.x - hw), (int)std::floor(c.y - hh),
+                   (int)std::ceil(2.0f * hw) + 1, (int)std::ceil(2.0f * hh) + 1);
+        return r & full;
+    }
+
+    void reset(const cv::Point2f &c, const cv::Size &s, float min_margin)
+    {
+        active = true;
+        center = c;
+        velocity = cv::Point2f(0.0f, 0.0f);
+        size = s;
+        margin = min_margin;
+    }
+
+    void update(const cv::Point2f &c, const cv::Size &s, float min_margin, float max_margin)
+    {
+        const cv::Point2f predicted = center + velocity;
+        const float err = (float)cv::norm(c - predicted);
+        velocity = 0.5f * (c - center) + 0.5f * velocity;
+        center = c;
+        size = s;
+        const float speed = (float)cv::norm(velocity);
+        margin = std::min(max_margin, std::max(min_margin, min_margin + 2.0f * (speed + err)));
+    }
+};
+
+// Search statistics shared by the trackers
+struct TrackStats
+{
+    uint64_t frames = 0;
+    uint64_t local_searches = 0;
+    uint64_t full_searches = 0;
+    uint64_t fallbacks = 0; // local searches that lost the target and fell back to the full ROI
+    double searched_area = 0.0;
+    double full_area = 0.0;
+
+    double areaRatio() const { return full_area > 0.0 ? searched_area / full_area : 0.0; }
+};
+
+// Stateful template_matching: after a hit, only a window around the predicted position is
+// searched. A miss (confidence below threshold) or a peak on the window edge (the target may
+// lie outside it) re-runs the full ROI search, optionally via the pyramid. Calls release the GIL.
+class TemplateTracker
+{
+public:
+    TemplateTracker(std::shared_ptr<TemplateHandle> handle, int roi_x, int roi_y, int roi_width, int roi_height,
+                    int method, float threshold, float min_margin, float max_margin, int pyramid_levels,
+                    int bayer_pattern, bool legacy_output)
+        : handle_(std::move(handle)), roi_(roi_x, roi_y, roi_width, roi_height), method_(method), threshold_(threshold),
+          min_margin_(std::max(1.0f, min_margin)), max_margin_(std::max(min_margin_, max_margin)),
+          pyramid_levels_(pyramid_levels), bayer_pattern_(bayer_pattern), legacy_output_(legacy_output)
+    {
+        if (!handle_)
+            throw std::runtime_error("Template handle is None");
+        if (method < cv::TM_SQDIFF || method > cv::TM_CCOEFF_NORMED)
+            throw std::runtime_error("Unknown template matching method");
+    }
+
+    py::object track(py::array_t<uint8_t> image)
+    {
+        PERF_SCOPE("track.template");
+        ImageView view = viewImage(image, bayer_pattern_);
+        const cv::Rect full = clampMatchRoi(view.cols, view.rows, roi_.x, roi_.y, roi_.width, roi_.height);
+        const TemplateHandle &h = *handle_;
+
+        std::vector<MatchResult> found;
+        {
+            py::gil_scoped_release release;
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++stats_.frames;
+            stats_.full_area += full.area();
+            last_full_ = full;
+            const bool fits = h.width() <= full.width && h.height() <= full.height;
+            if (!fits)
+                state_.active = false;
+
+            if (state_.active)
+            {
+                const cv::Rect win = state_.window(full);
+                if (win.width >= h.width() && win.height >= h.height())
+                {
+                    ++stats_.local_searches;
+                    stats_.searched_area += win.area();
+                    cv::Mat roi_img = extractGrayRoi(view, win, 0, &input_);
+                    matchInRoi(roi_img, win.tl(), h.image(), &h, method_, threshold_, false, nullptr, result_, found);
+                    if (!found.empty() && onWindowEdge(found[0], win, full, h))
+                        found.clear();
+                    if (!found.empty())
+                        state_.update(centerOf(found[0], h), cv::Size(h.width(), h.height()), min_margin_, max_margin_);
+                    else
+                        ++stats_.fallbacks;
+                }
+            }
+
+            if (found.empty() && fits)
+            {
+                ++stats_.full_searches;
+                stats_.searched_area += full.area();
+                cv::Mat roi_img = extractGrayRoi(view, full, 0, &input_);
+                if (pyramid_levels_ > 0)
+                    matchPyramid(roi_img, full.tl(), *h.pyramid(pyramid_levels_), &h, method_, threshold_, false, nullptr, found);
+                else
+                    matchInRoi(roi_img, full.tl(), h.image(), &h, method_, threshold_, false, nullptr, result_, found);
+                if (!found.empty())
+                    state_.reset(centerOf(found[0], h), cv::Size(h.width(), h.height()), min_margin_);
+                else
+                    state_.active = false;
+            }
+        }
+
+        return toMatchOutput(std::move(found), legacy_output_);
+    }
+
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        state_.active = false;
+    }
+
+    bool tracking() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return state_.active;
+    }
+
+    // Window the next frame will search, (x, y, w, h); the full ROI when not tracking. Assumes
+    // the next frame has the same size as the last one.
+    std::array<int, 4> nextWindow() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const cv::Rect full = last_full_.area() > 0 ? last_full_ : roi_;
+        const cv::Rect r = state_.active ? state_.window(full) : full;
+        return {r.x, r.y, r.width, r.height};
+    }
+
+    TrackStats stats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+private:
+    static cv::Point2f centerOf(const MatchResult &m, const TemplateHandle &h)
+    {
+        return cv::Point2f(m.x + h.width() * 0.5f, m.y + h.height() * 0.5f);
+    }
+
+    // Best match on a side of the window that is not also the full ROI's side
+    static bool onWindowEdge(const MatchResult &m, const cv::Rect &win, const cv::Rect &full, const TemplateHandle &h)
+    {
+        const int max_x = win.x + win.width - h.width();
+        const int max_y = win.y + win.height - h.height();
+        return (m.x == win.x && win.x > full.x) || (m.y == win.y && win.y > full.y) ||
+               (m.x == max_x && win.x + win.width < full.x + full.width) ||
+               (m.y == max_y && win.y + win.height < full.y + full.height);
+    }
+
+    std::shared_ptr<TemplateHandle> handle_;
+    cv::Rect roi_;
+    int method_;
+    float threshold_;
+    float min_margin_;
+    float max_margin_;
+    int pyramid_levels_;
+    int bayer_pattern_;
+    bool legacy_output_;
+
+    mutable std::mutex mutex_;
+    TrackState state_;
+    TrackStats stats_;
+    cv::Rect last_full_; // full ROI clamped to the last frame
+    GrayScratch input_;
+    cv::Mat result_;
+};
+
+// Stateful roi_edge_detection: after at least min_edges lines are found, the next frame only
+// searches the predicted bounding box of those lines plus the adaptive margin, falling back to
+// the full ROI when too few lines are found there. Calls release the GIL.
+class EdgeTracker
+{
+public:
+    EdgeTracker(int roi_x, int roi_y, int roi_width, int roi_height, int threshold, int min_line_length,
+                int min_edges, float min_margin, float max_margin, int bayer_pattern, bool legacy_output)
+        : roi_(roi_x, roi_y, roi_width, roi_height), threshold_(threshold), min_line_length_(min_line_length),
+          min_edges_(std::max(1, min_edges)), min_margin_(std::max(1.0f, min_margin)),
+          max_margin_(std::max(min_margin_, max_margin)), bayer_pattern_(bayer_pattern), legacy_output_(legacy_output)
+    {
+        kernel_ = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3));
+    }
+
+    py::object track(py::array_t<uint8_t> image)
+    {
+        PERF_SCOPE("track.edges");
+        ImageView view = viewImage(image, bayer_pattern_);
+        const cv::Rect full = clampEdgeRoi(view, roi_.x, roi_.y, roi_.width, roi_.height);
+
+        std::vector<EdgeResult> edges;
+        {
+            py::gil_scoped_release release;
+            std::lock_guard<std::mutex> lock(mutex_);
+            ++stats_.frames;
+            stats_.full_area += full.area();
+            last_full_ = full;
+
+            bool found = false;
+            if (state_.active)
+            {
+                const cv::Rect win = state_.window(full);
+                if (win.width > 0 && win.height > 0)
+                {
+                    ++stats_.local_searches;
+                    stats_.searched_area += win.area();
+                    detectEdges(view, win, threshold_, min_line_length_, 5, kernel_, FUSED_EDGE_MAX_AREA, scratch_);
+                    found = (int)scratch_.edge_points.size() >= min_edges_;
+                    if (found)
+                    {
+                        cv::Rect box = linesBox(win.tl());
+                        state_.update(boxCenter(box), box.size(), min_margin_, max_margin_);
+                    }
+                    else
+                    {
+                        ++stats_.fallbacks;
+                    }
+                }
+            }
+
+            if (!found)
+            {
+                ++stats_.full_searches;
+                stats_.searched_area += full.area();
+                detectEdges(view, full, threshold_, min_line_length_, 5, kernel_, FUSED_EDGE_MAX_AREA, scratch_);
+                if ((int)scratch_.edge_points.size() >= min_edges_)
+                {
+                    cv::Rect box = linesBox(full.tl());
+                    state_.reset(boxCenter(box), box.size(), min_margin_);
+                }
+                else
+                {
+                    state_.active = false;
+                }
+            }
+            edges = scratch_.edge_points;
+        }
+
+        if (legacy_output_)
+            return toEdgeTuples(edges);
+        return moveToArray(std::move(edges));
+    }
+
+    void reset()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        state_.active = false;
+    }
+
+    bool tracking() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return state_.active;
+    }
+
+    std::array<int, 4> nextWindow() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const cv::Rect full = last_full_.area() > 0 ? last_full_ : roi_;
+        const cv::Rect r = state_.active ? state_.window(full) : full;
+        return {r.x, r.y, r.width, r.height};
+    }
+
+    TrackStats stats() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return stats_;
+    }
+
+private:
+    // Bounding box of the last detection's line segments in image coordinates
+    cv::Rect linesBox(cv::Point offset) const
+    {
+        int x0 = std::numeric_limits<int>::max(), y0 = x0;
+        int x1 = std::numeric_limits<int>::min(), y1 = x1;
+        for (const auto &l : scratch_.lines)
+        {
+            x0 = std::min(x0, std::min(l[0], l[2]));
+            y0 = std::min(y0, std::min(l[1], l[3]));
+            x1 = std::max(x1, std::max(l[0], l[2]));
+            y1 = std::max(y1, std::max(l[1], l[3]));
+        }
+        return cv::Rect(x0 + offset.x, y0 + offset.y, x1 - x0 + 1, y1 - y0 + 1);
+    }
+
+    static cv::Point2f boxCenter(const cv::Rect &box)
+    {
+        return cv::Point2f(box.x + box.width * 0.5f, box.y + box.height * 0.5f);
+    }
+
+    cv::Rect roi_;
+    int threshold_;
+    int min_line_length_;
+    int min_edges_;
+    float min_margin_;
+    float max_margin_;
+    int bayer_pattern_;
+    bool legacy_output_;
+    cv::Mat kernel_;
+
+    mutable std::mutex mutex_;
+    TrackState state_;
+    TrackStats stats_;
+    cv::Rect last_full_; // full ROI clamped to the last frame
+    EdgeScratch scratch_;
+};
+
+static py::dict trackStatsToDict(const TrackStats &s)
+{
+    py::dict d;
+    d["frames"] = s.frames;
+    d["local_searches"] = s.local_searches;
+    d["full_searches"] = s.full_searches;
+    d["fallbacks"] = s.fallbacks;
+    d["search_area_ratio"] = s.areaRatio(); // searched pixels / full ROI pixels over all frames
+    return d;
+}
+
+// ==========================================
+// Asynchronous vision pipeline
+// ==========================================
+
+// Bounded single-producer / single-consumer ring. The producer fills producerSlot()
+// in place and publishes it with push(); the consumer reads consumerSlot() and
+// releases it with pop(). Slots are reused, so their buffers are allocated once.
+template <typename T>
+class SpscRing
+{
+public:
+    explicit SpscRing(size_t capacity) : slots_(capacity + 1) {}
+
+    size_t capacity() const { return slots_.size() - 1; }
+
+    size_t size() const
+    {
+        const size_t head = head_.load(std::memory_order_acquire);
+        const size_t tail = tail_.load(std::memory_order_acquire);
+        return (tail + slots_.size() - head) % slots_.size();
+    }
+
+    // Next free slot, or nullptr when the ring is full
+    T *producerSlot()
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if ((tail + 1) % slots_.size() == head_.load(std::memory_order_acquire))
+            return nullptr;
+        return &slots_[tail];
+    }
+
+    void push()
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        tail_.store((tail + 1) % slots_.size(), std::memory_order_release);
+    }
+
+    // Oldest filled slot, or nullptr when the ring is empty
+    T *consumerSlot()
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire))
+            return nullptr;
+        return &slots_[head];
+    }
+
+    void pop()
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        head_.store((head + 1) % slots_.size(), std::memory_order_release);
+    }
+
+private:
+    std::vector<T> slots_;
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+};
+
+enum PipelineStageKind
+{
+    STAGE_EDGES = 0,      // roi_edge_detection
+    STAGE_EDGE_LINE = 1,  // roi_edge_line
+    STAGE_MATCH = 2       // template_matching with a TemplateHandle
+};
+
+struct PipelineStage
+{
+    int kind = STAGE_EDGES;
+    cv::Rect roi; // as given; clamped per frame
+
+    // STAGE_EDGES
+    int threshold = 0;
+    int min_line_length = 0;
+
+    // STAGE_EDGE_LINE
+    int direction = SCAN_DOWN;
+    int num_calipers = 16;
+    int caliper_width = 5;
+    float min_contrast = 10.0f;
+    int polarity = 0;
+    float ransac_threshold = 1.5f;
+
+    // STAGE_MATCH
+    std::shared_ptr<TemplateHandle> handle;
+    int method = cv::TM_CCOEFF_NORMED;
+    float match_threshold = 0.8f;
+    bool multiple_matches = false;
+    PeakOptions peaks{0, 0};
+    int pyramid_levels = 0;
+
+    // Per-stage buffers; a stage only ever runs on one thread at a time
+    EdgeScratch scratch;
+    cv::Mat result;
+};
+
+struct StageResult
+{
+    std::vector<EdgeResult> edges;
+    EdgeLine line;
+    bool line_found = false;
+    std::vector<MatchResult> matches;
+    std::string error;
+};
+
+struct PipelineFrame
+{
+    cv::Mat image;
+    int64_t frame_id = 0;
+    double timestamp = 0.0; // capture time (s), from the caller or the submit time
+    std::chrono::steady_clock::time_point submitted;
+};
+
+struct FrameResult
+{
+    int64_t frame_id = 0;
+    double timestamp = 0.0;
+    double latency_ms = 0.0;
+    std::vector<StageResult> stages;
+};
+
+// steady_clock in seconds, the default frame timestamp
+static double steadySeconds()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Pins the calling thread to one logical core. Best effort: false where the core does not exist
+// or the platform has no hard affinity (macOS).
+static bool pinCurrentThread(int core)
+{
+    if (core < 0)
+        return false;
+#if defined(_WIN32)
+    if (core >= (int)(sizeof(DWORD_PTR) * 8))
+        return false;
+    return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << core) != 0;
+#elif defined(__linux__)
+    if (core >= CPU_SETSIZE)
+        return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    return false;
+#endif
+}
+
+// Frames go through an SPSC ring to a worker thread that runs the configured stages
+// (in parallel over OpenCV's thread pool) and hands the results to a callback or to a
+// bounded queue drained by poll(). Frame N+1 is processed while the caller still
+// consumes frame N. Configure the stages before start().
+class VisionPipeline
+{
+public:
+    VisionPipeline(int capacity, int result_capacity, int bayer_pattern, bool legacy_output)
+        : frames_(std::max(1, capacity)), result_capacity_(std::max(1, result_capacity)),
+          bayer_pattern_(bayer_pattern), legacy_output_(legacy_output)
+    {
+        if (bayer_pattern >= 0 && !isBayerCode(bayer_pattern))
+            throw std::runtime_error("bayer_pattern must be one of the COLOR_Bayer**2GRAY codes");
+        kernel_ = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3));
+    }
+
+    ~VisionPipeline()
+    {
+        // Python may be tearing us down with the GIL held; the worker may need it for a callback
+        if (Py_IsInitialized() && PyGILState_Check())
+        {
+            py::gil_scoped_release release;
+            stopWorker();
+        }
+        else
+        {
+            stopWorker();
+        }
+    }
+
+    int addEdgeStage(int roi_x, int roi_y, int roi_width, int roi_height, int threshold, int min_line_length)
+    {
+        PipelineStage &st = newStage(STAGE_EDGES, roi_x, roi_y, roi_width, roi_height);
+        st.threshold = threshold;
+        st.min_line_length = min_line_length;
+        return (int)stages_.size() - 1;
+    }
+
+    int addEdgeLineStage(int roi_x, int roi_y, int roi_width, int roi_height,
+                         int direction, int num_calipers, int caliper_width,
+                         float min_contrast, int polarity, float ransac_threshold)
+    {
+        if (direction < SCAN_DOWN || direction > SCAN_LEFT)
+            throw std::runtime_error("Unknown scan direction");
+        PipelineStage &st = newStage(STAGE_EDGE_LINE, roi_x, roi_y, roi_width, roi_height);
+        st.direction = direction;
+        st.num_calipers = num_calipers;
+        st.caliper_width = caliper_width;
+        st.min_contrast = min_contrast;
+        st.polarity = polarity;
+        st.ransac_threshold = ransac_threshold;
+        return (int)stages_.size() - 1;
+    }
+
+    int addMatchStage(std::shared_ptr<TemplateHandle> handle,
+                      int roi_x, int roi_y, int roi_width, int roi_height,
+                      int method, float threshold, bool multiple_matches, int pyramid_levels,
+                      int nms_radius, int max_matches)
+    {
+        if (!handle)
+            throw std::runtime_error("Template handle is None");
+        if (method < cv::TM_SQDIFF || method > cv::TM_CCOEFF_NORMED)
+            throw std::runtime_error("Unknown template matching method");
+        PipelineStage &st = newStage(STAGE_MATCH, roi_x, roi_y, roi_width, roi_height);
+        st.handle = std::move(handle);
+        st.method = method;
+        st.match_threshold = threshold;
+        st.multiple_matches = multiple_matches;
+        st.peaks = {nms_radius < 0 ? defaultNmsRadius(st.handle->image()) : nms_radius, max_matches};
+        st.pyramid_levels = pyramid_levels;
+        return (int)stages_.size() - 1;
+    }
+
+    void start()
+    {
+        if (running_)
+            return;
+
+        // Frames left over from a previous run are stale; we are the only consumer until the worker starts
+        while (frames_.consumerSlot())
+            frames_.pop();
+
+        stop_requested_ = false;
+        running_ = true;
+        worker_ = std::thread(&VisionPipeline::run, this);
+    }
+
+    void stop()
+    {
+        py::gil_scoped_release release;
+        stopWorker();
+    }
+
+    bool running() const { return running_; }
+
+    // Copy the frame into the ring. Returns false (and counts a drop) when the ring is full.
+    // timestamp < 0 stamps the frame with the submit time (steady clock, s).
+    bool submit(py::array_t<uint8_t> image, int64_t frame_id, double timestamp)
+    {
+        if (!running_)
+            throw std::runtime_error("VisionPipeline is not running; call start() first");
+
+        ImageView view = viewImage(image, bayer_pattern_);
+
+        {
+            py::gil_scoped_release release;
+
+            // Concurrent submit() calls are serialised so the ring keeps a single producer
+            std::lock_guard<std::mutex> producer(submit_mutex_);
+            PipelineFrame *slot = frames_.producerSlot();
+            if (!slot)
+            {
+                ++dropped_;
+                return false;
+            }
+
+            slot->image.create(view.rows, view.cols, CV_8UC(view.channels));
+            if (isMatCompatible(view))
+                cv::Mat(view.rows, view.cols, CV_8UC(view.channels), (void *)view.data, (size_t)view.row_step).copyTo(slot->image);
+            else
+                gatherRegion(view, view.bounds(), slot->image);
+
+            slot->frame_id = frame_id >= 0 ? frame_id : next_frame_id_;
+            next_frame_id_ = slot->frame_id + 1;
+            slot->submitted = std::chrono::steady_clock::now();
+            slot->timestamp = timestamp >= 0.0 ? timestamp : steadySeconds();
+            frames_.push();
+        }
+
+        // Taking the lock orders the push before a waiting worker re-checks the ring
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+        }
+        wake_.notify_one();
+        return true;
+    }
+
+    // Next result, waiting up to timeout_ms (0 returns immediately, < 0 waits forever). None on timeout.
+    py::object poll(int timeout_ms)
+    {
+        FrameResult result;
+        bool found = false;
+        {
+            py::gil_scoped_release release;
+            std::unique_lock<std::mutex> lock(results_mutex_);
+            auto ready = [this] { return !results_.empty(); };
+            if (timeout_ms < 0)
+                results_ready_.wait(lock, [&] { return ready() || !running_; });
+            else if (timeout_ms > 0)
+                results_ready_.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready);
+            if (!results_.empty())
+            {
+                result = std::move(results_.front());
+                results_.pop_front();
+                found = true;
+            }
+        }
+
+        if (!found)
+            return py::none();
+        return toPython(result);
+    }
+
+    // Deliver results to callback(result) on the worker thread instead of the poll queue.
+    // callback_ is only touched with the GIL held.
+    void setCallback(py::object callback)
+    {
+        callback_ = callback.is_none() ? py::object() : callback;
+        has_callback_ = (bool)callback_;
+    }
+
+    // Forward `stage` of every frame to a native sink (elite_ext VisualServo.native_sink()) from
+    // the worker thread, ahead of the normal delivery and without the GIL. None unlinks.
+    void setServoSink(py::object capsule, int stage, int camera)
+    {
+        if (running_)
+            throw std::runtime_error("The servo sink cannot change while the pipeline is running");
+        if (capsule.is_none())
+        {
+            servo_sink_ = nullptr;
+            servo_owner_ = py::object();
+            return;
+        }
+        if (!PyCapsule_IsValid(capsule.ptr(), VISUAL_SERVO_SINK_CAPSULE))
+            throw std::runtime_error("sink must be a VisualServo.native_sink() capsule");
+        auto *sink = static_cast<const VisualServoSink *>(PyCapsule_GetPointer(capsule.ptr(), VISUAL_SERVO_SINK_CAPSULE));
+        if (!sink || sink->version != VISUAL_SERVO_LINK_VERSION || !sink->fn)
+            throw std::runtime_error("VisualServo sink version mismatch; rebuild vision_cpp_ext and elite_ext together");
+        if (stage < 0 || stage >= (int)stages_.size())
+            throw std::runtime_error("Stage index out of range");
+        if (stages_[stage]->kind == STAGE_EDGES)
+            throw std::runtime_error("Edge stages have no single target; link an edge line or match stage");
+        servo_owner_ = capsule; // keeps the VisualServo alive
+        servo_sink_ = sink;
+        servo_stage_ = stage;
+        servo_camera_ = camera;
+    }
+
+    size_t pending() const { return frames_.size(); }
+    size_t capacity() const { return frames_.capacity(); }
+    size_t stageCount() const { return stages_.size(); }
+    uint64_t processed() const { return processed_; }
+    uint64_t dropped() const { return dropped_; }
+    uint64_t droppedResults() const { return dropped_results_; }
+    uint64_t lateResults() const { return late_results_; }
+    int core() const { return core_; }
+    bool pinned() const { return pinned_; }
+
+private:
+    friend class MultiCameraExecutor;
+
+    PipelineStage &newStage(int kind, int roi_x, int roi_y, int roi_width, int roi_height)
+    {
+        if (running_)
+            throw std::runtime_error("Stages cannot be added while the pipeline is running");
+        stages_.emplace_back(new PipelineStage());
+        PipelineStage &st = *stages_.back();
+        st.kind = kind;
+        st.roi = cv::Rect(roi_x, roi_y, roi_width, roi_height);
+        return st;
+    }
+
+    void stopWorker()
+    {
+        if (worker_.joinable() && std::this_thread::get_id() == worker_.get_id())
+            throw std::runtime_error("VisionPipeline cannot be stopped from its own callback");
+
+        {
+            std::lock_guard<std::mutex> lock(wake_mutex_);
+            stop_requested_ = true;
+        }
+        wake_.notify_all();
+        if (worker_.joinable())
+            worker_.join();
+        {
+            std::lock_guard<std::mutex> lock(results_mutex_);
+            running_ = false;
+        }
+        results_ready_.notify_all();
+    }
+
+    void runStage(PipelineStage &st, const ImageView &view, StageResult &out)
+    {
+        PERF_SCOPE("pipeline.stage");
+        try
+        {
+            if (st.kind == STAGE_EDGES)
+            {
+                cv::Rect roi = clampEdgeRoi(view, st.roi.x, st.roi.y, st.roi.width, st.roi.height);
+                detectEdges(view, roi, st.threshold, st.min_line_length, 5, kernel_, FUSED_EDGE_MAX_AREA, st.scratch);
+                out.edges = st.scratch.edge_points;
+            }
+            else if (st.kind == STAGE_EDGE_LINE)
+            {
+                cv::Rect roi = clampEdgeRoi(view, st.roi.x, st.roi.y, st.roi.width, st.roi.height);
+                cv::Mat roi_img = extractGrayRoi(view, roi, 0, &st.scratch.input);
+                out.line_found = scanEdgeLine(roi_img, roi.tl(), st.direction, st.num_calipers, st.caliper_width,
+                                              st.min_contrast, st.polarity, st.ransac_threshold, out.line);
+            }
+            else
+            {
+                cv::Rect roi = clampMatchRoi(view.cols, view.rows, st.roi.x, st.roi.y, st.roi.width, st.roi.height);
+                const TemplateHandle &handle = *st.handle;
+                if (handle.width() > roi.width || handle.height() > roi.height)
+                    return;
+                cv::Mat roi_img = extractGrayRoi(view, roi, 0, &st.scratch.input);
+                if (st.pyramid_levels > 0)
+                    matchPyramid(roi_img, roi.tl(), *handle.pyramid(st.pyramid_levels), &handle,
+                                 st.method, st.match_threshold, st.multiple_matches, &st.peaks, out.matches);
+                else
+                    matchInRoi(roi_img, roi.tl(), handle.image(), &handle, st.method, st.match_threshold,
+                               st.multiple_matches, &st.peaks, st.result, out.matches);
+            }
+        }
+        catch (const std::exception &e)
+        {
+            out.error = e.what();
+        }
+    }
+
+    void run()
+    {
+        pinned_ = pinCurrentThread(core_);
+        while (!stop_requested_)
+        {
+            PipelineFrame *frame = frames_.consumerSlot();
+            if (!frame)
+            {
+                std::unique_lock<std::mutex> lock(wake_mutex_);
+                wake_.wait(lock, [this] { return stop_requested_ || frames_.consumerSlot() != nullptr; });
+                if (stop_requested_)
+                    break;
+                continue;
+            }
+
+            FrameResult result;
+            result.frame_id = frame->frame_id;
+            result.timestamp = frame->timestamp;
+            result.stages.resize(stages_.size());
+
+            const ImageView view = viewMat(frame->image, bayer_pattern_);
+            if (parallel_stages_)
+            {
+                cv::parallel_for_(cv::Range(0, (int)stages_.size()), [&](const cv::Range &range)
+                {
+                    for (int i = range.start; i < range.end; ++i)
+                        runStage(*stages_[i], view, result.stages[i]);
+                });
+            }
+            else
+            {
+                // One worker per camera: stay on this (possibly pinned) thread
+                for (size_t i = 0; i < stages_.size(); ++i)
+                    runStage(*stages_[i], view, result.stages[i]);
+            }
+
+            result.latency_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - frame->submitted).count();
+            frames_.pop();
+            ++processed_;
+
+            if (servo_sink_)
+                forwardToServo(result);
+            deliver(std::move(result));
+        }
+    }
+
+    // Fitted line or best match of the linked stage as one servo measurement
+    void forwardToServo(const FrameResult &result)
+    {
+        PERF_SCOPE("pipeline.servo_sink");
+        const PipelineStage &st = *stages_[servo_stage_];
+        const StageResult &sr = result.stages[servo_stage_];
+        VisualServoMeasurement m{};
+        m.version = VISUAL_SERVO_LINK_VERSION;
+        m.frame_id = result.frame_id;
+        m.timestamp = result.timestamp;
+        m.camera = servo_camera_;
+        if (st.kind == STAGE_EDGE_LINE)
+        {
+            m.found = sr.error.empty() && sr.line_found;
+            m.x = sr.line.x;
+            m.y = sr.line.y;
+            m.angle = sr.line.angle;
+            m.has_angle = 1;
+            m.score = sr.line.points > 0 ? (double)sr.line.inliers / sr.line.points : 0.0;
+        }
+        else if (sr.error.empty() && !sr.matches.empty())
+        {
+            // Matches are top-left corners; the servo tracks the template centre
+            auto best = std::max_element(sr.matches.begin(), sr.matches.end(),
+                                         [](const MatchResult &a, const MatchResult &b) { return a.confidence < b.confidence; });
+            m.found = 1;
+            m.x = best->x + (st.handle->width() - 1) * 0.5;
+            m.y = best->y + (st.handle->height() - 1) * 0.5;
+            m.score = best->confidence;
+        }
+        servo_sink_->fn(servo_sink_->ctx, &m);
+    }
+
+    void deliver(FrameResult &&result)
+    {
+        if (sink_)
+        {
+            sink_(std::move(result));
+            return;
+        }
+        if (has_callback_)
+        {
+            py::gil_scoped_acquire acquire;
+            if (callback_)
+            {
+                try
+                {
+                    callback_(toPython(result));
+                }
+                catch (py::error_already_set &e)
+                {
+                    // Never let a Python exception escape the worker thread
+                    e.discard_as_unraisable("VisionPipeline callback");
+                }
+                return;
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(results_mutex_);
+            if (results_.size() >= result_capacity_)
+            {
+                results_.pop_front();
+                ++dropped_results_;
+            }
+            results_.push_back(std::move(result));
+        }
+        results_ready_.notify_one();
+    }
+
+    // Result vectors are moved into the arrays, so result is left empty
+    py::dict toPython(FrameResult &result) const
+    {
+        py::list stages;
+        for (size_t i = 0; i < result.stages.size(); ++i)
+        {
+            StageResult &sr = result.stages[i];
+            py::dict d;
+            d["kind"] = stages_[i]->kind;
+            if (stages_[i]->kind == STAGE_EDGES)
+            {
+                d["edges"] = legacy_output_ ? py::object(toEdgeTuples(sr.edges)) : py::object(moveToArray(std::move(sr.edges)));
+            }
+            else if (stages_[i]->kind == STAGE_EDGE_LINE)
+            {
+                if (!legacy_output_)
+                    d["line"] = copyToArray(sr.line_found ? std::vector<EdgeLine>{sr.line} : std::vector<EdgeLine>());
+                else if (sr.line_found)
+                    d["line"] = py::make_tuple(sr.line.x, sr.line.y, sr.line.angle, sr.line.residual, sr.line.inliers);
+                else
+                    d["line"] = py::none();
+            }
+            else
+            {
+                d["matches"] = toMatchOutput(std::move(sr.matches), legacy_output_);
+            }
+            if (!sr.error.empty())
+                d["error"] = sr.error;
+            stages.append(d);
+        }
+
+        py::dict out;
+        out["frame_id"] = result.frame_id;
+        out["timestamp"] = result.timestamp;
+        out["latency_ms"] = result.latency_ms;
+        out["stages"] = stages;
+        return out;
+    }
+
+    SpscRing<PipelineFrame> frames_;
+    std::vector<std::unique_ptr<PipelineStage>> stages_;
+    cv::Mat kernel_;
+    size_t result_capacity_;
+    int bayer_pattern_;
+    bool legacy_output_;
+    int64_t next_frame_id_ = 0;
+
+    std::thread worker_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stop_requested_{false}; // set under wake_mutex_
+    std::mutex wake_mutex_;
+    std::condition_variable wake_;
+
+    mutable std::mutex results_mutex_;
+    std::condition_variable results_ready_;
+    std::deque<FrameResult> results_;
+
+    std::mutex submit_mutex_;
+    py::object callback_;
+    std::atomic<bool> has_callback_{false};
+
+    std::atomic<uint64_t> processed_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> dropped_results_{0};
+
+    // Set by MultiCameraExecutor before start()
+    std::function<void(FrameResult &&)> sink_; // replaces callback/queue delivery
+    int core_ = -1;
+    bool parallel_stages_ = true;
+    std::atomic<bool> pinned_{false};
+
+    // Native servo link, set while stopped
+    py::object servo_owner_;
+    const VisualServoSink *servo_sink_ = nullptr;
+    int servo_stage_ = 0;
+    int servo_camera_ = 0;
+};
+
+// One VisionPipeline per camera, each with its own worker thread (optionally pinned to a core)
+// running that camera's stages inline, so N cameras use N cores. Per-camera results are merged
+// into frame sets by timestamp: a result joins the oldest open set within sync_tolerance_ms, and
+// sets are emitted in timestamp order once every camera has contributed or moved past them, or
+// after max_wait_ms with the missing cameras left as None. stop() flushes the sets still open.
+// Sets are emitted in timestamp order: a result that matches no open set and is not newer than
+// the last emitted set (beyond the tolerance) came too late and is counted in late_results.
+class MultiCameraExecutor
+{
+public:
+    MultiCameraExecutor(double sync_tolerance_ms, double max_wait_ms, int result_capacity, bool legacy_output)
+        : tolerance_(std::max(0.0, sync_tolerance_ms) * 1e-3), max_wait_(std::max(0.0, max_wait_ms) * 1e-3),
+          result_capacity_(std::max(1, result_capacity)), legacy_output_(legacy_output)
+    {
+    }
+
+    ~MultiCameraExecutor()
+    {
+        if (Py_IsInitialized() && PyGILState_Check())
+        {
+            py::gil_scoped_release release;
+            stopAll();
+        }
+        else
+        {
+            stopAll();
+        }
+    }
+
+    // The returned pipeline is configured with add_*_stage like a standalone one; frames go
+    // through submit(camera, ...) or the pipeline's own submit(). core < 0 leaves it unpinned.
+    VisionPipeline &addCamera(int capacity, int core, int bayer_pattern)
+    {
+        if (running_)
+            throw std::runtime_error("Cameras cannot be added while the executor is running");
+        cameras_.emplace_back(new VisionPipeline(capacity, 1, bayer_pattern, legacy_output_));
+        VisionPipeline &cam = *cameras_.back();
+        const int index = (int)cameras_.size() - 1;
+        cam.core_ = core;
+        cam.parallel_stages_ = false;
+        cam.sink_ = [this, index](FrameResult &&r) { onResult(index, std::move(r)); };
+        {
+            std::lock_guard<std::mutex> lock(merge_mutex_);
+            latest_.push_back(-std::numeric_limits<double>::infinity());
+        }
+        return cam;
+    }
+
+    void start()
+    {
+        if (running_)
+            return;
+        if (cameras_.empty())
+            throw std::runtime_error("MultiCameraExecutor has no cameras");
+        {
+            std::lock_guard<std::mutex> lock(merge_mutex_);
+            open_.clear();
+            latest_.assign(cameras_.size(), -std::numeric_limits<double>::infinity());
+            emitted_until_ = -std::numeric_limits<double>::infinity();
+            stop_requested_ = false;
+        }
+        running_ = true;
+        merger_ = std::thread(&MultiCameraExecutor::mergeLoop, this);
+        for (auto &cam : cameras_)
+            cam->start();
+    }
+
+    void stop()
+    {
+        py::gil_scoped_release release;
+        stopAll();
+    }
+
+    bool running() const { return running_; }
+
+    bool submit(int camera, py::array_t<uint8_t> image, double timestamp, int64_t frame_id)
+    {
+        if (camera < 0 || camera >= (int)cameras_.size())
+            throw std::runtime_error("Camera index out of range");
+        return cameras_[camera]->submit(image, frame_id, timestamp);
+    }
+
+    // Next merged frame set, waiting up to timeout_ms (0 returns immediately, < 0 waits forever). None on timeout.
+    py::object poll(int timeout_ms)
+    {
+        FrameSet set;
+        bool found = false;
+        {
+            py::gil_scoped_release release;
+            std::unique_lock<std::mutex> lock(results_mutex_);
+            auto ready = [this] { return !results_.empty(); };
+            if (timeout_ms < 0)
+                results_ready_.wait(lock, [&] { return ready() || !running_; });
+            else if (timeout_ms > 0)
+                results_ready_.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready);
+            if (!results_.empty())
+            {
+                set = std::move(results_.front());
+                results_.pop_front();
+                found = true;
+            }
+        }
+
+        if (!found)
+            return py::none();
+        return toPython(set);
+    }
 
-    // Get image info
-    py::buffer_info buf = image.request();
-    // Assuming 8-bit single channel image
+    // Deliver frame sets to callback(set) on the merge thread instead of the poll queue
+    void setCallback(py::object callback)
+    {
+        callback_ = callback.is_none() ? py::object() : callback;
+        has_callback_ = (bool)callback_;
+    }
 
-    // Safety check for dimensions
-    if (buf.ndim != 2 && buf.ndim != 3)
+    VisionPipeline &camera(int index)
     {
-        throw std::runtime_error("Number of dimensions must be two or three");
+        if (index < 0 || index >= (int)cameras_.size())
+            throw std::runtime_error("Camera index out of range");
+        return *cameras_[index];
     }
 
-    cv::Mat img(buf.shape[0], buf.shape[1], CV_8UC1, (uint8_t *)buf.ptr);
+    size_t cameraCount() const { return cameras_.size(); }
+    uint64_t merged() const { return merged_; }
+    uint64_t incomplete() const { return incomplete_; }
+    uint64_t droppedResults() const { return dropped_results_; }
+
+private:
+    struct FrameSet
+    {
+        double timestamp = 0.0; // first result's timestamp
+        std::vector<FrameResult> results;
+        std::vector<char> have;
+        size_t count = 0;
+        std::chrono::steady_clock::time_point deadline;
+    };
 
-    // Clamp ROI
-    roi_x = std::max(0, std::min(roi_x, img.cols - 1));
-    roi_y = std::max(0, std::min(roi_y, img.rows - 1));
-    roi_width = std::min(roi_width, img.cols - roi_x);
-    roi_height = std::min(roi_height, img.rows - roi_y);
+    void stopAll()
+    {
+        if (merger_.joinable() && std::this_thread::get_id() == merger_.get_id())
+            throw std::runtime_error("MultiCameraExecutor cannot be stopped from its own callback");
 
-    // Extract ROI
-    cv::Rect roi(roi_x, roi_y, roi_width, roi_height);
-    cv::Mat roi_img = img(roi);
+        // Cameras first so no result arrives after the merge thread is gone
+        for (auto &cam : cameras_)
+            cam->stopWorker();
+        {
+            std::lock_guard<std::mutex> lock(merge_mutex_);
+            stop_requested_ = true;
+        }
+        merge_wake_.notify_all();
+        if (merger_.joinable())
+            merger_.join();
+        {
+            std::lock_guard<std::mutex> lock(results_mutex_);
+            running_ = false;
+        }
+        results_ready_.notify_all();
+    }
 
-    // Gaussian Blur
-    cv::Mat blurred;
-    cv::GaussianBlur(roi_img, blurred, cv::Size(5, 5), 0);
+    // Called on camera worker threads. A camera pipeline started on its own before the executor
+    // has no merge thread to emit its results, so they are ignored until start().
+    void onResult(int camera, FrameResult &&result)
+    {
+        if (!running_)
+            return;
+        {
+            std::lock_guard<std::mutex> lock(merge_mutex_);
+            const double ts = result.timestamp;
+            latest_[camera] = std::max(latest_[camera], ts);
 
-    // Canny Edge Detection
-    cv::Mat edges;
-    cv::Canny(blurred, edges, threshold, threshold * 2);
+            // Oldest open set this camera has not filled yet and whose timestamp is close enough
+            auto it = open_.begin();
+            for (; it != open_.end(); ++it)
+                if (!it->have[camera] && std::abs(it->timestamp - ts) <= tolerance_)
+                    break;
+            if (it == open_.end())
+            {
+                // Belongs to a set already emitted, or would be emitted out of timestamp order
+                if (ts <= emitted_until_ + tolerance_)
+                {
+                    ++late_results_;
+                    return;
+                }
+                // Keep open_ sorted by timestamp
+                auto pos = std::find_if(open_.begin(), open_.end(), [ts](const FrameSet &s) { return s.timestamp > ts; });
+                it = open_.insert(pos, FrameSet());
+                it->timestamp = ts;
+                it->results.resize(cameras_.size());
+                it->have.assign(cameras_.size(), 0);
+                it->deadline = std::chrono::steady_clock::now() +
+                               std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(max_wait_));
+            }
+            it->results[camera] = std::move(result);
+            it->have[camera] = 1;
+            ++it->count;
+        }
+        merge_wake_.notify_one();
+    }
 
-    // Morphology
-    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3));
-    cv::morphologyEx(edges, edges, cv::MORPH_CLOSE, kernel);
+    // A set is done when each camera filled it or already delivered a later frame (cameras
+    // process their frames in order, so they will not come back to it)
+    bool isSettled(const FrameSet &set) const
+    {
+        for (size_t c = 0; c < cameras_.size(); ++c)
+            if (!set.have[c] && latest_[c] <= set.timestamp + tolerance_)
+                return false;
+        return true;
+    }
 
-    // Hough Lines
-    std::vector<cv::Vec4i> lines;
-    cv::HoughLinesP(edges, lines, 1, CV_PI / 180, 50, min_line_length, 10);
+    void mergeLoop()
+    {
+        std::unique_lock<std::mutex> lock(merge_mutex_);
+        while (!stop_requested_)
+        {
+            std::vector<FrameSet> ready;
+            const auto now = std::chrono::steady_clock::now();
+            while (!open_.empty() && (isSettled(open_.front()) || open_.front().deadline <= now))
+            {
+                emitted_until_ = std::max(emitted_until_, open_.front().timestamp);
+                ready.push_back(std::move(open_.front()));
+                open_.pop_front();
+            }
 
-    // Prepare results
-    std::vector<std::tuple<float, float, float>> edge_points;
+            if (!ready.empty())
+            {
+                lock.unlock();
+                for (auto &set : ready)
+                    deliver(std::move(set));
+                lock.lock();
+                continue;
+            }
+
+            if (open_.empty())
+                merge_wake_.wait(lock);
+            else
+                merge_wake_.wait_until(lock, open_.front().deadline);
+        }
+
+        // Cameras are already stopped, so sets still open will never fill up: flush them as
+        // incomplete rather than dropping results that were merged so far
+        std::deque<FrameSet> rest;
+        rest.swap(open_);
+        lock.unlock();
+        for (auto &set : rest)
+            deliver(std::move(set));
+    }
 
-    for (const auto &line : lines)
+    void deliver(FrameSet &&set)
     {
-        int x1 = line[0];
-        int y1 = line[1];
-        int x2 = line[2];
-        int y2 = line[3];
+        ++merged_;
+        if (set.count < cameras_.size())
+            ++incomplete_;
 
-        // Midpoint
-        float mid_x = (x1 + x2) / 2.0f;
-        float mid_y = (y1 + y2) / 2.0f;
+        if (has_callback_)
+        {
+            py::gil_scoped_acquire acquire;
+            if (callback_)
+            {
+                try
+                {
+                    callback_(toPython(set));
+                }
+                catch (py::error_already_set &e)
+                {
+                    e.discard_as_unraisable("MultiCameraExecutor callback");
+                }
+                return;
+            }
+        }
 
-        // Angle
-        float angle = std::atan2((float)(y2 - y1), (float)(x2 - x1)) * 180.0f / (float)CV_PI;
+        {
+            std::lock_guard<std::mutex> lock(results_mutex_);
+            if (results_.size() >= result_capacity_)
+            {
+                results_.pop_front();
+                ++dropped_results_;
+            }
+            results_.push_back(std::move(set));
+        }
+        results_ready_.notify_one();
+    }
 
-        // Adjust to global coordinates
-        mid_x += roi_x;
-        mid_y += roi_y;
+    py::dict toPython(FrameSet &set) const
+    {
+        py::list cams;
+        for (size_t c = 0; c < cameras_.size(); ++c)
+            cams.append(set.have[c] ? py::object(cameras_[c]->toPython(set.results[c])) : py::object(py::none()));
 
-        edge_points.emplace_back(mid_x, mid_y, angle);
+        py::dict out;
+        out["timestamp"] = set.timestamp;
+        out["complete"] = set.count == cameras_.size();
+        out["cameras"] = cams;
+        return out;
     }
 
-    return py::cast(edge_points);
+    std::vector<std::unique_ptr<VisionPipeline>> cameras_;
+    double tolerance_; // s
+    double max_wait_;  // s
+    size_t result_capacity_;
+    bool legacy_output_;
+
+    std::thread merger_;
+    std::atomic<bool> running_{false};
+    bool stop_requested_ = false; // guarded by merge_mutex_
+    std::mutex merge_mutex_;
+    std::condition_variable merge_wake_;
+    std::deque<FrameSet> open_;   // sorted by timestamp
+    std::vector<double> latest_; // newest timestamp delivered per camera
+    double emitted_until_ = -std::numeric_limits<double>::infinity(); // timestamp of the last emitted set
+
+    std::mutex results_mutex_;
+    std::condition_variable results_ready_;
+    std::deque<FrameSet> results_;
+
+    py::object callback_;
+    std::atomic<bool> has_callback_{false};
+
+    std::atomic<uint64_t> merged_{0};
+    std::atomic<uint64_t> incomplete_{0};
+    std::atomic<uint64_t> dropped_results_{0};
+    std::atomic<uint64_t> late_results_{0};
+};
+
+// ==========================================
+// Camera and hand-eye calibration
+// ==========================================
+// Eye-in-hand calibration from chessboard views: intrinsics and distortion by Levenberg–Marquardt
+// over all views, the AX=XB hand-eye solve, then a reprojection refinement of the hand-eye
+// transform through the robot poses. Per-view residuals and Jacobians are evaluated on OpenCV's
+// thread pool. Lengths are mm like the saved JSON files; robot poses are [x, y, z, rx, ry, rz]
+// in m and rad as the calibration log stores them.
+
+static const int CALIB_DIST_COEFFS = 5; // k1, k2, p1, p2, k3 (distCoeffs.json)
+
+// Chessboard inner corners in the board frame (z = 0), in findChessboardCorners order
+static std::vector<cv::Point3d> chessboardPoints(cv::Size pattern, double square_size)
+{
+    std::vector<cv::Point3d> pts;
+    pts.reserve(pattern.area());
+    for (int r = 0; r < pattern.height; ++r)
+        for (int c = 0; c < pattern.width; ++c)
+            pts.emplace_back(c * square_size, r * square_size, 0.0);
+    return pts;
 }
 
-// Template Matching Function
-py::tuple template_matching(
-    py::array_t<uint8_t> image,
-    py::array_t<uint8_t> template_img,
-    int method, float threshold, bool multiple_matches,
-    int roi_x, int roi_y, int roi_width, int roi_height)
+static cv::Matx44d rigidTransform(const cv::Matx33d &R, const cv::Vec3d &t)
 {
+    return cv::Matx44d(R(0, 0), R(0, 1), R(0, 2), t[0],
+                       R(1, 0), R(1, 1), R(1, 2), t[1],
+                       R(2, 0), R(2, 1), R(2, 2), t[2],
+                       0.0, 0.0, 0.0, 1.0);
+}
 
-    py::buffer_info img_buf = image.request();
-    cv::Mat img(img_buf.shape[0], img_buf.shape[1], CV_8UC1, (uint8_t *)img_buf.ptr);
+static cv::Matx33d rotationOf(const cv::Matx44d &T) { return T.get_minor<3, 3>(0, 0); }
+static cv::Vec3d translationOf(const cv::Matx44d &T) { return cv::Vec3d(T(0, 3), T(1, 3), T(2, 3)); }
 
-    py::buffer_info tmpl_buf = template_img.request();
-    cv::Mat tmpl(tmpl_buf.shape[0], tmpl_buf.shape[1], CV_8UC1, (uint8_t *)tmpl_buf.ptr);
+static cv::Matx44d invertRigid(const cv::Matx44d &T)
+{
+    const cv::Matx33d Rt = rotationOf(T).t();
+    return rigidTransform(Rt, -(Rt * translationOf(T)));
+}
 
-    int img_rows = img.rows;
-    int img_cols = img.cols;
+// [r, t] -> 4x4, rotation vector r
+static cv::Matx44d rvecToTransform(const cv::Vec3d &r, const cv::Vec3d &t)
+{
+    cv::Matx33d R;
+    cv::Rodrigues(r, R);
+    return rigidTransform(R, t);
+}
 
-    if (roi_width <= 0 || roi_height <= 0)
-    {
-        roi_x = 0;
-        roi_y = 0;
-        roi_width = img_cols;
-        roi_height = img_rows;
-    }
-    else
+// Robot TCP pose (m, rad) as a 4x4 in mm. Angles are RPY, R = Rz * Ry * Rx as
+// manual_correction_tool reads Elite poses, or a rotation vector.
+static cv::Matx44d robotPoseToTransform(const double *p, bool rotation_vector)
+{
+    const cv::Vec3d t(p[0] * 1000.0, p[1] * 1000.0, p[2] * 1000.0);
+    if (rotation_vector)
+        return rvecToTransform(cv::Vec3d(p[3], p[4], p[5]), t);
+
+    const double cx = std::cos(p[3]), sx = std::sin(p[3]);
+    const double cy = std::cos(p[4]), sy = std::sin(p[4]);
+    const double cz = std::cos(p[5]), sz = std::sin(p[5]);
+    const cv::Matx33d Rx(1, 0, 0, 0, cx, -sx, 0, sx, cx);
+    const cv::Matx33d Ry(cy, 0, sy, 0, 1, 0, -sy, 0, cy);
+    const cv::Matx33d Rz(cz, -sz, 0, sz, cz, 0, 0, 0, 1);
+    return rigidTransform(Rz * Ry * Rx, t);
+}
+
+// Chordal mean of rotations: the sum projected back onto SO(3)
+static cv::Matx33d meanRotation(const std::vector<cv::Matx33d> &rotations)
+{
+    cv::Matx33d sum = cv::Matx33d::zeros();
+    for (const auto &R : rotations)
+        sum += R;
+    cv::Mat w, u, vt;
+    cv::SVD::compute(cv::Mat(sum), w, u, vt);
+    cv::Mat R = u * vt;
+    if (cv::determinant(R) < 0)
     {
-        roi_x = std::max(0, std::min(roi_x, img_cols - 1));
-        roi_y = std::max(0, std::min(roi_y, img_rows - 1));
-        roi_width = std::min(roi_width, img_cols - roi_x);
-        roi_height = std::min(roi_height, img_rows - roi_y);
+        cv::Mat last = u.col(2);
+        last *= -1.0;
+        R = u * vt;
     }
+    return cv::Matx33d(R);
+}
 
-    cv::Rect roi(roi_x, roi_y, roi_width, roi_height);
-    cv::Mat roi_img = img(roi);
+static cv::Matx33d skew(const cv::Point3d &v)
+{
+    return cv::Matx33d(0, -v.z, v.y, v.z, 0, -v.x, -v.y, v.x, 0);
+}
 
-    // Match
-    cv::Mat result;
-    cv::matchTemplate(roi_img, tmpl, result, method);
+// Where the LM below spends its time on one view: residuals (reprojection minus detection, px)
+// and their Jacobian, split into the parameters shared by all views and the view's own
+struct LmViewNormal
+{
+    cv::Mat A, B, C;  // Jg'Jg, Jg'Jl, Jl'Jl
+    cv::Mat ga, gl;   // Jg'r, Jl'r
+    double cost = 0.0;
+};
 
-    std::vector<std::tuple<int, int, float>> matches;
+struct LmReport
+{
+    int iterations = 0;
+    double initial_rms = 0.0; // px
+    double final_rms = 0.0;
+    bool converged = false;
+};
 
-    if (multiple_matches)
+// Levenberg–Marquardt over GLOBAL parameters shared by every view plus LOCAL parameters per
+// view. A problem provides viewCount(), pointCount(), evaluate(view, r, Jg, Jl) (Jacobians may be
+// null) and apply(dg, dl). The normal equations are block-arrow shaped, so the per-view blocks are
+// eliminated with the Schur complement and only a GLOBAL-sized system is solved.
+template <typename Problem>
+static LmReport levenbergMarquardt(Problem &problem, int max_iterations, double tolerance)
+{
+    const int G = Problem::GLOBAL, L = Problem::LOCAL;
+    const int n = problem.viewCount();
+    const double points = std::max(1, problem.pointCount());
+    std::vector<LmViewNormal> normals(n);
+    std::vector<double> costs(n);
+
+    auto linearize = [&]()
     {
-        for (int y = 0; y < result.rows; y++)
+        PERF_SCOPE("calib.linearize");
+        cv::parallel_for_(cv::Range(0, n), [&](const cv::Range &range)
         {
-            for (int x = 0; x < result.cols; x++)
+            cv::Mat r, Jg, Jl;
+            for (int v = range.start; v < range.end; ++v)
             {
-                float val = result.at<float>(y, x);
-                bool match_found = false;
-
-                if (method == cv::TM_SQDIFF || method == cv::TM_SQDIFF_NORMED)
+                problem.evaluate(v, r, &Jg, L > 0 ? &Jl : nullptr);
+                LmViewNormal &nv = normals[v];
+                nv.A = Jg.t() * Jg;
+                nv.ga = Jg.t() * r;
+                nv.cost = r.dot(r);
+                if (L > 0)
                 {
-                    if (val <= (1.0f - threshold))
-                        match_found = true;
-                }
-                else
-                {
-                    if (val >= threshold)
-                        match_found = true;
+                    nv.B = Jg.t() * Jl;
+                    nv.C = Jl.t() * Jl;
+                    nv.gl = Jl.t() * r;
                 }
+            }
+        });
+        double cost = 0.0;
+        for (const auto &nv : normals)
+            cost += nv.cost;
+        return cost;
+    };
+
+    auto evaluateCost = [&](const Problem &p)
+    {
+        PERF_SCOPE("calib.residuals");
+        cv::parallel_for_(cv::Range(0, n), [&](const cv::Range &range)
+        {
+            cv::Mat r;
+            for (int v = range.start; v < range.end; ++v)
+            {
+                p.evaluate(v, r, nullptr, nullptr);
+                costs[v] = r.dot(r);
+            }
+        });
+        double cost = 0.0;
+        for (double c : costs)
+            cost += c;
+        return cost;
+    };
+
+    LmReport report;
+    double cost = linearize();
+    report.initial_rms = std::sqrt(cost / points);
+    double lambda = 1e-3;
+    std::vector<cv::Mat> dl(L > 0 ? n : 0), C_inv(L > 0 ? n : 0);
+
+    for (; report.iterations < max_iterations; ++report.iterations)
+    {
+        cv::Mat A = cv::Mat::zeros(G, G, CV_64F), ga = cv::Mat::zeros(G, 1, CV_64F);
+        for (const auto &nv : normals)
+        {
+            A += nv.A;
+            ga += nv.ga;
+        }
+
+        bool accepted = false;
+        double new_cost = cost;
+        while (!accepted && lambda < 1e10)
+        {
+            // Marquardt scaling: damp each parameter relative to its own curvature
+            cv::Mat S = A.clone(), rhs = -ga;
+            for (int i = 0; i < G; ++i)
+                S.at<double>(i, i) += lambda * std::max(A.at<double>(i, i), 1e-9);
 
-                if (match_found)
+            std::vector<cv::Mat> BC(L > 0 ? n : 0);
+            for (int v = 0; v < (L > 0 ? n : 0); ++v)
+            {
+                cv::Mat C = normals[v].C.clone();
+                for (int i = 0; i < L; ++i)
+                    C.at<double>(i, i) += lambda * std::max(normals[v].C.at<double>(i, i), 1e-9);
+                C_inv[v] = C.inv(cv::DECOMP_CHOLESKY);
+                BC[v] = normals[v].B * C_inv[v];
+                S -= BC[v] * normals[v].B.t();
+                rhs += BC[v] * normals[v].gl;
+            }
+
+            cv::Mat dg;
+            if (!cv::solve(S, rhs, dg, cv::DECOMP_CHOLESKY))
+            {
+                lambda *= 10.0;
+                continue;
+            }
+            for (int v = 0; v < (L > 0 ? n : 0); ++v)
+                dl[v] = -C_inv[v] * (normals[v].gl + normals[v].B.t() * dg);
+
+            Problem trial = problem;
+            trial.apply(dg, dl);
+            new_cost = evaluateCost(trial);
+            if (new_cost < cost)
+            {
+                problem = std::move(trial);
+                lambda = std::max(lambda * 0.1, 1e-12);
+                accepted = true;
+            }
+            else
+            {
+                lambda *= 10.0;
+            }
+        }
+
+        // No step lowers the cost any more: at the minimum to numerical precision
+        if (!accepted)
+        {
+            report.converged = true;
+            break;
+        }
+        const double decrease = (cost - new_cost) / std::max(cost, 1e-300);
+        cost = linearize();
+        if (decrease < tolerance)
+        {
+            report.converged = true;
+            ++report.iterations;
+            break;
+        }
+    }
+
+    report.final_rms = std::sqrt(cost / points);
+    return report;
+}
+
+// Intrinsics, distortion and every board pose (rvec, tvec in the camera)
+struct IntrinsicsProblem
+{
+    enum { GLOBAL = 4 + CALIB_DIST_COEFFS, LOCAL = 6 };
+
+    const std::vector<cv::Point3d> *board;
+    const std::vector<std::vector<cv::Point2f>> *corners;
+    cv::Matx33d K;
+    cv::Vec<double, CALIB_DIST_COEFFS> dist;
+    std::vector<cv::Vec6d> poses;
+
+    int viewCount() const { return (int)poses.size(); }
+    int pointCount() const { return (int)(board->size() * poses.size()); }
+
+    void evaluate(int v, cv::Mat &r, cv::Mat *Jg, cv::Mat *Jl) const
+    {
+        const cv::Vec3d rvec(poses[v][0], poses[v][1], poses[v][2]), tvec(poses[v][3], poses[v][4], poses[v][5]);
+        std::vector<cv::Point2d> proj; // projectPoints output follows the input depth
+        cv::Mat J;
+        if (Jg)
+            cv::projectPoints(*board, rvec, tvec, K, dist, proj, J);
+        else
+            cv::projectPoints(*board, rvec, tvec, K, dist, proj);
+
+        const auto &img = (*corners)[v];
+        r.create((int)proj.size() * 2, 1, CV_64F);
+        for (size_t j = 0; j < proj.size(); ++j)
+        {
+            r.at<double>((int)j * 2) = proj[j].x - img[j].x;
+            r.at<double>((int)j * 2 + 1) = proj[j].y - img[j].y;
+        }
+        // projectPoints columns: rvec, tvec, fx fy, cx cy, distortion
+        if (Jg)
+            J.colRange(6, 6 + GLOBAL).copyTo(*Jg);
+        if (Jl)
+            J.colRange(0, 6).copyTo(*Jl);
+    }
+
+    void apply(const cv::Mat &dg, const std::vector<cv::Mat> &dl)
+    {
+        K(0, 0) += dg.at<double>(0);
+        K(1, 1) += dg.at<double>(1);
+        K(0, 2) += dg.at<double>(2);
+        K(1, 2) += dg.at<double>(3);
+        for (int k = 0; k < CALIB_DIST_COEFFS; ++k)
+            dist[k] += dg.at<double>(4 + k);
+        for (size_t v = 0; v < poses.size(); ++v)
+            for (int k = 0; k < 6; ++k)
+                poses[v][k] += dl[v].at<double>(k);
+    }
+};
+
+// Hand-eye X (flange -> camera) and the fixed board pose W (base -> board), the camera model
+// held fixed: camera_T_board = X^-1 * flange_T_base * W. Both transforms are updated by right
+// multiplication with a small motion [r, t], which keeps the Jacobian analytic and free of
+// rotation vector singularities.
+struct HandEyeProblem
+{
+    enum { GLOBAL = 12, LOCAL = 0 };
+
+    const std::vector<cv::Point3d> *board;
+    const std::vector<std::vector<cv::Point2f>> *corners;
+    const std::vector<cv::Matx44d> *base_T_flange;
+    cv::Matx33d K;
+    cv::Vec<double, CALIB_DIST_COEFFS> dist;
+    cv::Matx44d flange_T_cam;
+    cv::Matx44d base_T_board;
+
+    int viewCount() const { return (int)base_T_flange->size(); }
+    int pointCount() const { return (int)(board->size() * base_T_flange->size()); }
+
+    cv::Matx44d cameraToBoard(int v) const
+    {
+        return invertRigid(flange_T_cam) * invertRigid((*base_T_flange)[v]) * base_T_board;
+    }
+
+    void evaluate(int v, cv::Mat &r, cv::Mat *Jg, cv::Mat *) const
+    {
+        const cv::Matx44d T = cameraToBoard(v);
+        const cv::Matx33d R = rotationOf(T);
+        const cv::Vec3d t = translationOf(T);
+
+        // Project the board points already in the camera frame: the tvec columns of the
+        // projectPoints Jacobian are then d(pixel)/d(point)
+        std::vector<cv::Point3d> pc(board->size());
+        for (size_t j = 0; j < pc.size(); ++j)
+        {
+            const cv::Vec3d p = R * cv::Vec3d((*board)[j]) + t;
+            pc[j] = cv::Point3d(p[0], p[1], p[2]);
+        }
+        std::vector<cv::Point2d> proj;
+        cv::Mat J;
+        const cv::Vec3d zero(0.0, 0.0, 0.0);
+        if (Jg)
+            cv::projectPoints(pc, zero, zero, K, dist, proj, J);
+        else
+            cv::projectPoints(pc, zero, zero, K, dist, proj);
+
+        const auto &img = (*corners)[v];
+        r.create((int)proj.size() * 2, 1, CV_64F);
+        if (Jg)
+            Jg->create((int)proj.size() * 2, GLOBAL, CV_64F);
+        for (size_t j = 0; j < proj.size(); ++j)
+        {
+            const int row = (int)j * 2;
+            r.at<double>(row) = proj[j].x - img[j].x;
+            r.at<double>(row + 1) = proj[j].y - img[j].y;
+            if (!Jg)
+                continue;
+
+            // d(point)/d(motion): X' = X * [r, t] moves the point by [p]x r - t,
+            // W' = W * [r, t] by R (t - [b]x r), b the board point
+            const double *j0 = J.ptr<double>(row) + 3, *j1 = J.ptr<double>(row + 1) + 3;
+            const cv::Matx23d Jp(j0[0], j0[1], j0[2], j1[0], j1[1], j1[2]);
+            const cv::Matx23d dx_r = Jp * skew(pc[j]);
+            const cv::Matx23d dx_t = -Jp;
+            const cv::Matx23d dw_r = -(Jp * R * skew((*board)[j]));
+            const cv::Matx23d dw_t = Jp * R;
+            for (int i = 0; i < 2; ++i)
+            {
+                double *out = Jg->ptr<double>(row + i);
+                for (int k = 0; k < 3; ++k)
                 {
-                    matches.emplace_back(x + roi_x, y + roi_y, val);
+                    out[k] = dx_r(i, k);
+                    out[3 + k] = dx_t(i, k);
+                    out[6 + k] = dw_r(i, k);
+                    out[9 + k] = dw_t(i, k);
                 }
             }
         }
     }
-    else
+
+    void apply(const cv::Mat &dg, const std::vector<cv::Mat> &)
     {
-        double min_val, max_val;
-        cv::Point min_loc, max_loc;
-        cv::minMaxLoc(result, &min_val, &max_val, &min_loc, &max_loc);
+        const double *d = dg.ptr<double>();
+        flange_T_cam = flange_T_cam * rvecToTransform(cv::Vec3d(d[0], d[1], d[2]), cv::Vec3d(d[3], d[4], d[5]));
+        base_T_board = base_T_board * rvecToTransform(cv::Vec3d(d[6], d[7], d[8]), cv::Vec3d(d[9], d[10], d[11]));
+    }
+};
 
-        float confidence = (float)((method == cv::TM_SQDIFF || method == cv::TM_SQDIFF_NORMED) ? (1.0 - min_val) : max_val);
+// Detects chessboard inner corners in each image file on OpenCV's thread pool. Returns a list
+// with an (N, 2) float32 array per image (None where the board wasn't found or the image size
+// differs from the first readable image) and that image size (width, height).
+static py::tuple find_chessboard_corners(const std::vector<std::string> &image_paths,
+                                         std::pair<int, int> pattern_size, bool subpix)
+{
+    const cv::Size pattern(pattern_size.first, pattern_size.second);
+    if (pattern.width < 2 || pattern.height < 2)
+        throw std::runtime_error("pattern_size must be the inner corner count (cols, rows), both >= 2");
 
-        if (confidence >= threshold)
+    const int n = (int)image_paths.size();
+    std::vector<std::vector<cv::Point2f>> found(n);
+    std::vector<cv::Size> sizes(n);
+    std::vector<char> ok(n, 0);
+    {
+        py::gil_scoped_release release;
+        PERF_SCOPE("calib.find_corners");
+        cv::parallel_for_(cv::Range(0, n), [&](const cv::Range &range)
+        {
+            for (int i = range.start; i < range.end; ++i)
+            {
+                cv::Mat gray = cv::imread(image_paths[i], cv::IMREAD_GRAYSCALE);
+                if (gray.empty())
+                    continue;
+                sizes[i] = gray.size();
+                if (!cv::findChessboardCorners(gray, pattern, found[i],
+                                               cv::CALIB_CB_ADAPTIVE_THRESH | cv::CALIB_CB_NORMALIZE_IMAGE))
+                    continue;
+                if (subpix)
+                    cv::cornerSubPix(gray, found[i], cv::Size(11, 11), cv::Size(-1, -1),
+                                     cv::TermCriteria(cv::TermCriteria::EPS + cv::TermCriteria::COUNT, 30, 0.01));
+                ok[i] = 1;
+            }
+        });
+    }
+
+    cv::Size image_size;
+    for (int i = 0; i < n && image_size.area() == 0; ++i)
+        image_size = sizes[i];
+
+    py::list corners;
+    for (int i = 0; i < n; ++i)
+    {
+        if (!ok[i] || sizes[i] != image_size)
         {
-            int abs_x = min_loc.x + roi_x;
-            int abs_y = min_loc.y + roi_y;
+            corners.append(py::none());
+            continue;
+        }
+        py::array_t<float> arr({(py::ssize_t)found[i].size(), (py::ssize_t)2});
+        std::memcpy(arr.mutable_data(), found[i].data(), found[i].size() * sizeof(cv::Point2f));
+        corners.append(arr);
+    }
+    return py::make_tuple(corners, py::make_tuple(image_size.width, image_size.height));
+}
+
+static py::list matrixToList(const double *values, int rows, int cols)
+{
+    py::list out;
+    for (int r = 0; r < rows; ++r)
+    {
+        py::list row;
+        for (int c = 0; c < cols; ++c)
+            row.append(values[r * cols + c]);
+        out.append(row);
+    }
+    return out;
+}
+
+static int handEyeMethod(const std::string &name)
+{
+    if (name == "tsai")
+        return cv::CALIB_HAND_EYE_TSAI;
+    if (name == "park")
+        return cv::CALIB_HAND_EYE_PARK;
+    if (name == "horaud")
+        return cv::CALIB_HAND_EYE_HORAUD;
+    if (name == "andreff")
+        return cv::CALIB_HAND_EYE_ANDREFF;
+    if (name == "daniilidis")
+        return cv::CALIB_HAND_EYE_DANIILIDIS;
+    throw std::runtime_error("Unknown hand-eye method: " + name);
+}
+
+// Eye-in-hand calibration from robot poses and the chessboard corners seen at each pose.
+// corners[i] is an (N, 2) array in findChessboardCorners order or None to skip pose i.
+// camera_matrix / dist_coeffs seed the solve (and are kept as-is with refine_intrinsics=False).
+// Returns a dict whose intrinsics, distCoeffs and T entries match intrinsics.json,
+// distCoeffs.json and T_eye_in_hand_chessboard.json.
+static py::dict calibrate_hand_eye(
+    py::array_t<double, py::array::c_style | py::array::forcecast> robot_poses,
+    const py::list &corners, std::pair<int, int> pattern_size, double square_size,
+    std::pair<int, int> image_size, py::object camera_matrix, py::object dist_coeffs,
+    bool refine_intrinsics, bool rotation_vector, const std::string &method, int max_iterations)
+{
+    const auto start = std::chrono::steady_clock::now();
+    const cv::Size pattern(pattern_size.first, pattern_size.second);
+    if (pattern.area() < 4 || square_size <= 0.0)
+        throw std::runtime_error("pattern_size must be the inner corner count (cols, rows) and square_size > 0");
+    if (robot_poses.ndim() != 2 || robot_poses.shape(1) != 6 || robot_poses.shape(0) != (py::ssize_t)corners.size())
+        throw std::runtime_error("robot_poses must be (N, 6) with one row per corners entry");
+    const int he_method = handEyeMethod(method);
+
+    // Collect the usable views
+    std::vector<int> view_index;
+    std::vector<std::vector<cv::Point2f>> view_corners;
+    std::vector<cv::Matx44d> base_T_flange;
+    auto poses = robot_poses.unchecked<2>();
+    for (size_t i = 0; i < corners.size(); ++i)
+    {
+        const py::object item = corners[i];
+        if (item.is_none())
+            continue;
+        auto pts = py::array_t<float, py::array::c_style | py::array::forcecast>::ensure(item);
+        if (!pts || pts.ndim() != 2 || pts.shape(1) != 2 || pts.shape(0) != pattern.area())
+            throw std::runtime_error("corners[" + std::to_string(i) + "] must be (" +
+                                     std::to_string(pattern.area()) + ", 2) or None");
+        std::vector<cv::Point2f> c((size_t)pattern.area());
+        std::memcpy(c.data(), pts.data(), c.size() * sizeof(cv::Point2f));
+        view_corners.push_back(std::move(c));
+        view_index.push_back((int)i);
+        base_T_flange.push_back(robotPoseToTransform(poses.data((py::ssize_t)i, 0), rotation_vector));
+    }
+    const int n = (int)view_index.size();
+    if (n < 3)
+        throw std::runtime_error("hand-eye calibration needs at least 3 views with the board found");
 
-            if (!(method == cv::TM_SQDIFF || method == cv::TM_SQDIFF_NORMED))
+    cv::Matx33d K;
+    cv::Vec<double, CALIB_DIST_COEFFS> dist(0, 0, 0, 0, 0);
+    bool have_intrinsics = !camera_matrix.is_none();
+    if (have_intrinsics)
+    {
+        auto k = py::array_t<double, py::array::c_style | py::array::forcecast>::ensure(camera_matrix);
+        if (!k || k.size() != 9)
+            throw std::runtime_error("camera_matrix must be 3x3");
+        std::memcpy(K.val, k.data(), 9 * sizeof(double));
+    }
+    if (!dist_coeffs.is_none())
+    {
+        auto d = py::array_t<double, py::array::c_style | py::array::forcecast>::ensure(dist_coeffs);
+        if (!d || d.size() > CALIB_DIST_COEFFS)
+            throw std::runtime_error("dist_coeffs must hold at most 5 values (k1, k2, p1, p2, k3)");
+        std::memcpy(dist.val, d.data(), d.size() * sizeof(double));
+    }
+    if (!refine_intrinsics && !have_intrinsics)
+        throw std::runtime_error("refine_intrinsics=False needs camera_matrix");
+    if (!have_intrinsics && (image_size.first <= 0 || image_size.second <= 0))
+        throw std::runtime_error("image_size (width, height) is needed to initialise the camera matrix");
+
+    const std::vector<cv::Point3d> board = chessboardPoints(pattern, square_size);
+    std::vector<cv::Point3f> board_f(board.begin(), board.end()); // initCameraMatrix2D takes float points
+    IntrinsicsProblem intrinsics;
+    HandEyeProblem hand_eye;
+    LmReport intrinsics_report, hand_eye_report;
+    double init_rms = 0.0;
+    std::vector<double> view_errors(corners.size(), -1.0);
+    {
+        py::gil_scoped_release release;
+        PERF_SCOPE("calib.hand_eye");
+
+        if (!have_intrinsics)
+        {
+            std::vector<std::vector<cv::Point3f>> object_points(n, board_f);
+            K = cv::Matx33d(cv::initCameraMatrix2D(object_points, view_corners,
+                                                   cv::Size(image_size.first, image_size.second), 0));
+        }
+
+        // Board pose per view, then intrinsics and distortion jointly with all board poses
+        intrinsics.board = &board;
+        intrinsics.corners = &view_corners;
+        intrinsics.K = K;
+        intrinsics.dist = dist;
+        intrinsics.poses.resize(n);
+        cv::parallel_for_(cv::Range(0, n), [&](const cv::Range &range)
+        {
+            for (int v = range.start; v < range.end; ++v)
             {
-                abs_x = max_loc.x + roi_x;
-                abs_y = max_loc.y + roi_y;
+                cv::Vec3d rvec, tvec;
+                cv::solvePnP(board_f, view_corners[v], K, dist, rvec, tvec);
+                intrinsics.poses[v] = cv::Vec6d(rvec[0], rvec[1], rvec[2], tvec[0], tvec[1], tvec[2]);
             }
-            matches.emplace_back(abs_x, abs_y, confidence);
+        });
+        if (refine_intrinsics)
+            intrinsics_report = levenbergMarquardt(intrinsics, max_iterations, 1e-10);
+
+        // AX=XB from the robot motions and the board motions seen by the camera
+        std::vector<cv::Mat> R_gripper2base, t_gripper2base, R_target2cam, t_target2cam;
+        for (int v = 0; v < n; ++v)
+        {
+            const cv::Vec6d &p = intrinsics.poses[v];
+            cv::Matx33d R;
+            cv::Rodrigues(cv::Vec3d(p[0], p[1], p[2]), R);
+            R_target2cam.push_back(cv::Mat(R, true));
+            t_target2cam.push_back(cv::Mat(cv::Vec3d(p[3], p[4], p[5]), true));
+            R_gripper2base.push_back(cv::Mat(rotationOf(base_T_flange[v]), true));
+            t_gripper2base.push_back(cv::Mat(translationOf(base_T_flange[v]), true));
+        }
+        cv::Mat R_cam2gripper, t_cam2gripper;
+        cv::calibrateHandEye(R_gripper2base, t_gripper2base, R_target2cam, t_target2cam,
+                             R_cam2gripper, t_cam2gripper, (cv::HandEyeCalibrationMethod)he_method);
+        const cv::Matx33d R_x = R_cam2gripper;
+        const cv::Vec3d t_x = t_cam2gripper;
+        const cv::Matx44d X = rigidTransform(R_x, t_x);
+
+        // The board pose in the base, averaged over the views
+        std::vector<cv::Matx33d> rotations(n);
+        cv::Vec3d t_sum(0, 0, 0);
+        for (int v = 0; v < n; ++v)
+        {
+            const cv::Vec6d &p = intrinsics.poses[v];
+            const cv::Matx44d W = base_T_flange[v] * X * rvecToTransform(cv::Vec3d(p[0], p[1], p[2]), cv::Vec3d(p[3], p[4], p[5]));
+            rotations[v] = rotationOf(W);
+            t_sum += translationOf(W);
         }
+
+        // Reprojection refinement of X and W through the robot poses
+        hand_eye.board = &board;
+        hand_eye.corners = &view_corners;
+        hand_eye.base_T_flange = &base_T_flange;
+        hand_eye.K = intrinsics.K;
+        hand_eye.dist = intrinsics.dist;
+        hand_eye.flange_T_cam = X;
+        hand_eye.base_T_board = rigidTransform(meanRotation(rotations), t_sum * (1.0 / n));
+        hand_eye_report = levenbergMarquardt(hand_eye, max_iterations, 1e-10);
+        if (!refine_intrinsics)
+            intrinsics_report.initial_rms = intrinsics_report.final_rms = -1.0;
+
+        cv::parallel_for_(cv::Range(0, n), [&](const cv::Range &range)
+        {
+            cv::Mat r;
+            for (int v = range.start; v < range.end; ++v)
+            {
+                hand_eye.evaluate(v, r, nullptr, nullptr);
+                view_errors[view_index[v]] = std::sqrt(r.dot(r) / board.size());
+            }
+        });
+        init_rms = hand_eye_report.initial_rms;
     }
 
-    return py::cast(matches);
+    py::dict out;
+    out["intrinsics"] = matrixToList(hand_eye.K.val, 3, 3);
+    py::list dist_row;
+    for (int k = 0; k < CALIB_DIST_COEFFS; ++k)
+        dist_row.append(hand_eye.dist[k]);
+    py::list dist_list;
+    dist_list.append(dist_row);
+    out["distCoeffs"] = dist_list;
+    out["T"] = matrixToList(hand_eye.flange_T_cam.val, 4, 4);
+    out["T_base_board"] = matrixToList(hand_eye.base_T_board.val, 4, 4);
+    out["rms"] = hand_eye_report.final_rms;
+    out["initial_rms"] = init_rms;
+    out["intrinsics_rms"] = intrinsics_report.final_rms;
+    out["intrinsics_iterations"] = intrinsics_report.iterations;
+    out["hand_eye_iterations"] = hand_eye_report.iterations;
+    out["converged"] = hand_eye_report.converged && (intrinsics_report.converged || !refine_intrinsics);
+    out["views_used"] = n;
+    out["view_errors"] = moveToArray(std::move(view_errors));
+    out["elapsed_ms"] = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    return out;
 }
 
+// vision_bench.cpp includes this file with VISION_CPP_EXT_NO_MODULE to call the kernels directly
+#ifndef VISION_CPP_EXT_NO_MODULE
 PYBIND11_MODULE(vision_cpp_ext, m)
 {
     m.doc() = "High Performance Vision Utils";
 
+    PERF_STATS::bindPerfStats(m);
+
+    m.def(
+        "get_cpu_dispatch", []()
+        { return std::string(CPU_DISPATCH::levelName(CPU_DISPATCH::level())); },
+        "SIMD level the edge kernels use: scalar, sse4.2, avx2, avx512 or neon");
+    m.def(
+        "set_cpu_dispatch", [](const std::string &name)
+        {
+            for (int l = CPU_DISPATCH::CPU_SCALAR; l <= CPU_DISPATCH::CPU_NEON; ++l)
+                if (name == CPU_DISPATCH::levelName(l))
+                    return std::string(CPU_DISPATCH::levelName(CPU_DISPATCH::setLevel(l)));
+            throw std::runtime_error("Unknown CPU dispatch level: " + name);
+        },
+        py::arg("level"),
+        "Cap the SIMD level (clamped to what the CPU supports, scalar for the other architecture) and return the level in use. For tests and A/B timing.");
+
+    PYBIND11_NUMPY_DTYPE(MatchResult, x, y, confidence);
+    PYBIND11_NUMPY_DTYPE(BatchMatchResult, job, x, y, confidence);
+    PYBIND11_NUMPY_DTYPE(EdgeResult, x, y, angle);
+    PYBIND11_NUMPY_DTYPE(EdgeLine, x, y, angle, residual, inliers, points);
+
     m.def("roi_edge_detection", &roi_edge_detection,
           "ROI Edge Detection",
           py::arg("image"), py::arg("roi_x"), py::arg("roi_y"),
           py::arg("roi_width"), py::arg("roi_height"),
-          py::arg("threshold"), py::arg("min_line_length"));
+          py::arg("threshold"), py::arg("min_line_length"),
+          py::arg("bayer_pattern") = -1, py::arg("legacy_output") = true);
+
+    m.def("roi_edge_line", &roi_edge_line,
+          "ROI edge line: sub-pixel caliper scan + RANSAC/least squares fit, returns (x, y, angle, residual, inliers) or None",
+          py::arg("image"), py::arg("roi_x"), py::arg("roi_y"),
+          py::arg("roi_width"), py::arg("roi_height"),
+          py::arg("direction") = (int)SCAN_DOWN, py::arg("num_calipers") = 16, py::arg("caliper_width") = 5,
+          py::arg("min_contrast") = 10.0f, py::arg("polarity") = 0, py::arg("ransac_threshold") = 1.5f,
+          py::arg("bayer_pattern") = -1, py::arg("legacy_output") = true);
+
+    py::class_<EdgeDetector>(m, "EdgeDetector")
+        .def(py::init<int, int, int>(), py::arg("blur_ksize") = 5, py::arg("morph_ksize") = 3,
+             py::arg("fused_max_area") = FUSED_EDGE_MAX_AREA)
+        .def("detect", &EdgeDetector::detect,
+             "ROI Edge Detection reusing this detector's scratch buffers",
+             py::arg("image"), py::arg("roi_x"), py::arg("roi_y"),
+             py::arg("roi_width"), py::arg("roi_height"),
+             py::arg("threshold"), py::arg("min_line_length"),
+             py::arg("bayer_pattern") = -1, py::arg("legacy_output") = true)
+        .def("reserve", &EdgeDetector::reserve,
+             "Pre-grow one scratch set of the detector's pool (shared by all threads, up to 8 idle sets kept) for ROIs up to max_width x max_height",
+             py::arg("max_width"), py::arg("max_height"), py::arg("channels") = 1)
+        .def_property_readonly("blur_ksize", &EdgeDetector::blurKsize)
+        .def_property_readonly("morph_ksize", &EdgeDetector::morphKsize)
+        .def_property_readonly("fused_max_area", &EdgeDetector::fusedMaxArea)
+        .def_property_readonly("scratch_bytes", &EdgeDetector::scratchBytes);
+
+    py::class_<TemplateHandle, std::shared_ptr<TemplateHandle>>(m, "TemplateHandle")
+        .def_property_readonly("width", &TemplateHandle::width)
+        .def_property_readonly("height", &TemplateHandle::height)
+        .def_property_readonly("mean", &TemplateHandle::mean)
+        .def_property_readonly("stddev", &TemplateHandle::stddev);
+
+    py::class_<TemplateTracker>(m, "TemplateTracker")
+        .def(py::init<std::shared_ptr<TemplateHandle>, int, int, int, int, int, float, float, float, int, int, bool>(),
+             py::arg("template_handle"),
+             py::arg("roi_x") = 0, py::arg("roi_y") = 0, py::arg("roi_width") = 0, py::arg("roi_height") = 0,
+             py::arg("method") = (int)cv::TM_CCOEFF_NORMED, py::arg("threshold") = 0.8f,
+             py::arg("min_margin") = 8.0f, py::arg("max_margin") = 64.0f, py::arg("pyramid_levels") = 0,
+             py::arg("bayer_pattern") = -1, py::arg("legacy_output") = true)
+        .def("track", &TemplateTracker::track,
+             "Best match in this frame, searching around the predicted position; same output as template_matching",
+             py::arg("image"))
+        .def("reset", &TemplateTracker::reset, "Forget the track; the next frame searches the full ROI")
+        .def_property_readonly("tracking", &TemplateTracker::tracking)
+        .def_property_readonly("next_window", &TemplateTracker::nextWindow, "(x, y, w, h) the next frame will search")
+        .def_property_readonly("stats", [](const TemplateTracker &t) { return trackStatsToDict(t.stats()); });
+
+    py::class_<EdgeTracker>(m, "EdgeTracker")
+        .def(py::init<int, int, int, int, int, int, int, float, float, int, bool>(),
+             py::arg("roi_x"), py::arg("roi_y"), py::arg("roi_width"), py::arg("roi_height"),
+             py::arg("threshold"), py::arg("min_line_length"), py::arg("min_edges") = 1,
+             py::arg("min_margin") = 8.0f, py::arg("max_margin") = 64.0f,
+             py::arg("bayer_pattern") = -1, py::arg("legacy_output") = true)
+        .def("track", &EdgeTracker::track,
+             "Edges in this frame, searching around the last edges' predicted box; same output as roi_edge_detection",
+             py::arg("image"))
+        .def("reset", &EdgeTracker::reset, "Forget the track; the next frame searches the full ROI")
+        .def_property_readonly("tracking", &EdgeTracker::tracking)
+        .def_property_readonly("next_window", &EdgeTracker::nextWindow, "(x, y, w, h) the next frame will search")
+        .def_property_readonly("stats", [](const EdgeTracker &t) { return trackStatsToDict(t.stats()); });
+
+    m.def("register_template", &register_template,
+          "Register a template once; the returned handle can replace template_img in the matching calls",
+          py::arg("template_img"), py::arg("bayer_pattern") = -1);
+
+    // Handle overloads are registered first so a TemplateHandle is never offered to the array conversion
+    m.def("template_matching", &template_matching_handle,
+          "Template Matching with a registered TemplateHandle",
+          py::arg("image"), py::arg("template_img"), py::arg("method"),
+          py::arg("threshold"), py::arg("multiple_matches"),
+          py::arg("roi_x"), py::arg("roi_y"), py::arg("roi_width"), py::arg("roi_height"),
+          py::arg("pyramid_levels") = 0, py::arg("bayer_pattern") = -1, py::arg("legacy_output") = true,
+          py::arg("nms_radius") = -1, py::arg("max_matches") = 0);
 
     m.def("template_matching", &template_matching,
           "Template Matching",
           py::arg("image"), py::arg("template_img"), py::arg("method"),
           py::arg("threshold"), py::arg("multiple_matches"),
-          py::arg("roi_x"), py::arg("roi_y"), py::arg("roi_width"), py::arg("roi_height"));
+          py::arg("roi_x"), py::arg("roi_y"), py::arg("roi_width"), py::arg("roi_height"),
+          py::arg("pyramid_levels") = 0, py::arg("template_id") = -1, py::arg("bayer_pattern") = -1,
+          py::arg("legacy_output") = true, py::arg("nms_radius") = -1, py::arg("max_matches") = 0);
+
+    m.def("clear_template_cache", &clear_template_cache,
+          "Drop all template pyramids cached by template_id");
+
+    m.def("template_matching_peaks", &template_matching_peaks_handle,
+          "Template Matching with a registered TemplateHandle returning NMS-filtered local maxima",
+          py::arg("image"), py::arg("template_img"), py::arg("method"), py::arg("threshold"),
+          py::arg("roi_x") = 0, py::arg("roi_y") = 0, py::arg("roi_width") = 0, py::arg("roi_height") = 0,
+          py::arg("nms_radius") = -1, py::arg("max_matches") = 0, py::arg("bayer_pattern") = -1);
+
+    m.def("template_matching_peaks", &template_matching_peaks,
+          "Template Matching returning NMS-filtered local maxima as a structured array",
+          py::arg("image"), py::arg("template_img"), py::arg("method"), py::arg("threshold"),
+          py::arg("roi_x") = 0, py::arg("roi_y") = 0, py::arg("roi_width") = 0, py::arg("roi_height") = 0,
+          py::arg("nms_radius") = -1, py::arg("max_matches") = 0, py::arg("bayer_pattern") = -1);
+
+    m.def("template_matching_batch", &template_matching_batch_handles,
+          "Batched template matching with registered TemplateHandles",
+          py::arg("image"), py::arg("templates"), py::arg("rois"),
+          py::arg("methods"), py::arg("thresholds"), py::arg("multiple_matches") = false,
+          py::arg("nms_radius") = -1, py::arg("max_matches") = 0, py::arg("bayer_pattern") = -1);
+
+    m.def("template_matching_batch", &template_matching_batch,
+          "Batched template matching: one frame, a list of (template, ROI, method, threshold) jobs",
+          py::arg("image"), py::arg("templates"), py::arg("rois"),
+          py::arg("methods"), py::arg("thresholds"), py::arg("multiple_matches") = false,
+          py::arg("nms_radius") = -1, py::arg("max_matches") = 0, py::arg("bayer_pattern") = -1);
+
+    py::class_<VisionPipeline>(m, "VisionPipeline")
+        .def(py::init<int, int, int, bool>(), py::arg("capacity") = 4, py::arg("result_capacity") = 16,
+             py::arg("bayer_pattern") = -1, py::arg("legacy_output") = true)
+        .def("add_edge_stage", &VisionPipeline::addEdgeStage,
+             "Add a roi_edge_detection stage; returns its index in the result's stages list",
+             py::arg("roi_x"), py::arg("roi_y"), py::arg("roi_width"), py::arg("roi_height"),
+             py::arg("threshold"), py::arg("min_line_length"))
+        .def("add_edge_line_stage", &VisionPipeline::addEdgeLineStage,
+             "Add a roi_edge_line stage; returns its index in the result's stages list",
+             py::arg("roi_x"), py::arg("roi_y"), py::arg("roi_width"), py::arg("roi_height"),
+             py::arg("direction") = (int)SCAN_DOWN, py::arg("num_calipers") = 16, py::arg("caliper_width") = 5,
+             py::arg("min_contrast") = 10.0f, py::arg("polarity") = 0, py::arg("ransac_threshold") = 1.5f)
+        .def("add_match_stage", &VisionPipeline::addMatchStage,
+             "Add a template matching stage for a registered TemplateHandle; returns its index",
+             py::arg("template_handle"),
+             py::arg("roi_x") = 0, py::arg("roi_y") = 0, py::arg("roi_width") = 0, py::arg("roi_height") = 0,
+             py::arg("method") = (int)cv::TM_CCOEFF_NORMED, py::arg("threshold") = 0.8f,
+             py::arg("multiple_matches") = false, py::arg("pyramid_levels") = 0,
+             py::arg("nms_radius") = -1, py::arg("max_matches") = 0)
+        .def("start", &VisionPipeline::start, "Start the worker thread")
+        .def("stop", &VisionPipeline::stop, "Stop the worker thread; queued frames are discarded")
+        .def("submit", &VisionPipeline::submit,
+             "Queue a frame (copied); returns False if the ring is full and the frame was dropped",
+             py::arg("image"), py::arg("frame_id") = -1, py::arg("timestamp") = -1.0)
+        .def("poll", &VisionPipeline::poll,
+             "Next result dict (frame_id, timestamp, latency_ms, stages) or None; timeout_ms < 0 waits until a result or stop()",
+             py::arg("timeout_ms") = 0)
+        .def("set_callback", &VisionPipeline::setCallback,
+             "Call callback(result) from the worker thread instead of queueing results (None restores polling)",
+             py::arg("callback"))
+        .def("set_servo_sink", &VisionPipeline::setServoSink,
+             "Feed stage's fitted line or best match to elite_ext VisualServo.native_sink() from the worker thread (None unlinks)",
+             py::arg("sink"), py::arg("stage") = 0, py::arg("camera") = 0)
+        .def_property_readonly("running", &VisionPipeline::running)
+        .def_property_readonly("pending", &VisionPipeline::pending)
+        .def_property_readonly("capacity", &VisionPipeline::capacity)
+        .def_property_readonly("stage_count", &VisionPipeline::stageCount)
+        .def_property_readonly("processed", &VisionPipeline::processed)
+        .def_property_readonly("dropped", &VisionPipeline::dropped)
+        .def_property_readonly("dropped_results", &VisionPipeline::droppedResults)
+        .def_property_readonly("core", &VisionPipeline::core)
+        .def_property_readonly("pinned", &VisionPipeline::pinned, "Whether the worker thread is pinned to core");
+
+    py::class_<MultiCameraExecutor>(m, "MultiCameraExecutor")
+        .def(py::init<double, double, int, bool>(), py::arg("sync_tolerance_ms") = 5.0, py::arg("max_wait_ms") = 100.0,
+             py::arg("result_capacity") = 16, py::arg("legacy_output") = true)
+        .def("add_camera", &MultiCameraExecutor::addCamera,
+             "Add a camera stream with its own worker (pinned to core if >= 0); returns its VisionPipeline for adding stages",
+             py::arg("capacity") = 4, py::arg("core") = -1, py::arg("bayer_pattern") = -1,
+             py::return_value_policy::reference_internal)
+        .def("camera", &MultiCameraExecutor::camera, "VisionPipeline of camera index", py::arg("index"),
+             py::return_value_policy::reference_internal)
+        .def("start", &MultiCameraExecutor::start, "Start all camera workers and the merge thread")
+        .def("stop", &MultiCameraExecutor::stop, "Stop all workers; queued frames are discarded, partially merged sets are delivered as incomplete")
+        .def("submit", &MultiCameraExecutor::submit,
+             "Queue a frame for a camera; timestamp (s) < 0 uses the submit time. Returns False if that camera's ring is full",
+             py::arg("camera"), py::arg("image"), py::arg("timestamp") = -1.0, py::arg("frame_id") = -1)
+        .def("poll", &MultiCameraExecutor::poll,
+             "Next frame set dict (timestamp, complete, cameras) or None; cameras[i] is a VisionPipeline result or None",
+             py::arg("timeout_ms") = 0)
+        .def("set_callback", &MultiCameraExecutor::setCallback,
+             "Call callback(frame_set) from the merge thread instead of queueing (None restores polling)",
+             py::arg("callback"))
+        .def_property_readonly("running", &MultiCameraExecutor::running)
+        .def_property_readonly("camera_count", &MultiCameraExecutor::cameraCount)
+        .def_property_readonly("merged", &MultiCameraExecutor::merged)
+        .def_property_readonly("incomplete", &MultiCameraExecutor::incomplete)
+        .def_property_readonly("dropped_results", &MultiCameraExecutor::droppedResults)
+        .def_property_readonly("late_results", &MultiCameraExecutor::lateResults);
+
+    m.def("find_chessboard_corners", &find_chessboard_corners,
+          "Detect chessboard inner corners in image files in parallel; returns ([(N, 2) float32 or None], (width, height))",
+          py::arg("image_paths"), py::arg("pattern_size"), py::arg("subpix") = true);
+    m.def("calibrate_hand_eye", &calibrate_hand_eye,
+          "Eye-in-hand calibration: intrinsics/distortion by LM, AX=XB, then reprojection refinement of the hand-eye "
+          "transform. robot_poses (N, 6) in m/rad, square_size in mm; returns a dict with intrinsics, distCoeffs and T (mm)",
+          py::arg("robot_poses"), py::arg("corners"), py::arg("pattern_size"), py::arg("square_size"),
+          py::arg("image_size") = std::make_pair(0, 0), py::arg("camera_matrix") = py::none(),
+          py::arg("dist_coeffs") = py::none(), py::arg("refine_intrinsics") = true,
+          py::arg("rotation_vector") = false, py::arg("method") = "park", py::arg("max_iterations") = 100);
 
     m.attr("TM_CCOEFF") = (int)cv::TM_CCOEFF;
     m.attr("TM_CCOEFF_NORMED") = (int)cv::TM_CCOEFF_NORMED;
@@ -196,4 +4388,20 @@ PYBIND11_MODULE(vision_cpp_ext, m)
     m.attr("TM_CCORR_NORMED") = (int)cv::TM_CCORR_NORMED;
     m.attr("TM_SQDIFF") = (int)cv::TM_SQDIFF;
     m.attr("TM_SQDIFF_NORMED") = (int)cv::TM_SQDIFF_NORMED;
+
+    m.attr("STAGE_EDGES") = (int)STAGE_EDGES;
+    m.attr("STAGE_EDGE_LINE") = (int)STAGE_EDGE_LINE;
+    m.attr("STAGE_MATCH") = (int)STAGE_MATCH;
+
+    m.attr("SCAN_DOWN") = (int)SCAN_DOWN;
+    m.attr("SCAN_UP") = (int)SCAN_UP;
+    m.attr("SCAN_RIGHT") = (int)SCAN_RIGHT;
+    m.attr("SCAN_LEFT") = (int)SCAN_LEFT;
+
+    // bayer_pattern values for raw sensor mosaics
+    m.attr("COLOR_BayerBG2GRAY") = (int)cv::COLOR_BayerBG2GRAY;
+    m.attr("COLOR_BayerGB2GRAY") = (int)cv::COLOR_BayerGB2GRAY;
+    m.attr("COLOR_BayerRG2GRAY") = (int)cv::COLOR_BayerRG2GRAY;
+    m.attr("COLOR_BayerGR2GRAY") = (int)cv::COLOR_BayerGR2GRAY;
 }
+#endif // VISION_CPP_EXT_NO_MODULE
@@ -0,0 +1,122 @@
+"""
+手眼标定求解工具
+
+读取标定数据日志 (calibration_log_tool) 中各点的机械臂位姿与图像，用 vision_cpp_ext 原生求解:
+并行检测棋盘格角点 -> LM 联合优化内参与畸变 -> AX=XB 手眼求解 -> 按重投影误差精修手眼矩阵。
+结果写成与现有文件相同格式的 intrinsics.json / distCoeffs.json / T_eye_in_hand_chessboard.json:
+
+    python hand_eye_calibration_tool.py workspace/calibration_3d_data.calib --pattern 9x6 --square 20
+    python hand_eye_calibration_tool.py LOG --pattern 9x6 --square 20 --intrinsics intrinsics.json --fix-intrinsics
+
+--square 为棋盘格方格边长 (mm)，--pattern 为内角点数 (列x行)。默认只显示结果，加 -o DIR 才写文件。
+"""
+import argparse
+import json
+import os
+import sys
+from pathlib import Path
+
+import numpy as np
+
+from calibration_log_tool import load_calibration_log
+
+CALIB_POINT_CAPTURED = 1
+
+try:
+    import vision_cpp_ext
+except ImportError:
+    # 开发环境: 从编译输出目录加载
+    ext_path = Path(__file__).resolve().parent / "cpp_extensions" / "extensions" / "Release"
+    sys.path.append(str(ext_path))
+    if hasattr(os, 'add_dll_directory') and ext_path.exists():
+        os.add_dll_directory(str(ext_path))
+    import vision_cpp_ext
+
+
+def calibrate_from_log(log_path, pattern, square_size, camera_matrix=None, dist_coeffs=None,
+                       refine_intrinsics=True, rotation_vector=False, method="park"):
+    """对一个标定日志求解，返回 vision_cpp_ext.calibrate_hand_eye 的结果字典 (附 point_ids)"""
+    _, records = load_calibration_log(log_path)
+    usable = [r for r in records if (r['flags'] & CALIB_POINT_CAPTURED) and r['image']]
+    if not usable:
+        raise ValueError("日志中没有带图像的有效点")
+
+    # 相对路径与采集时一样相对于项目根目录 (当前工作目录)
+    paths = [r['image'].decode('utf-8') for r in usable]
+    corners, image_size = vision_cpp_ext.find_chessboard_corners(paths, pattern)
+    poses = np.array([r['tcp_pose'] for r in usable])
+
+    result = vision_cpp_ext.calibrate_hand_eye(
+        poses, corners, pattern, square_size, image_size,
+        camera_matrix=camera_matrix, dist_coeffs=dist_coeffs,
+        refine_intrinsics=refine_intrinsics, rotation_vector=rotation_vector, method=method)
+    result['point_ids'] = [int(r['point_id']) for r in usable]
+    result['found'] = [c is not None for c in corners]
+    return result
+
+
+def _round(matrix):
+    return [[round(float(v), 6) for v in row] for row in matrix]
+
+
+def save_results(result, out_dir):
+    """按现有文件格式写出三个标定文件"""
+    files = {
+        "intrinsics.json": {"intrinsics": _round(result['intrinsics'])},
+        "distCoeffs.json": {"distCoeffs": _round(result['distCoeffs'])},
+        "T_eye_in_hand_chessboard.json": {"T": _round(result['T'])},
+    }
+    for name, content in files.items():
+        with open(os.path.join(out_dir, name), 'w', encoding='utf-8') as f:
+            json.dump(content, f, indent=4, separators=(',', ':'))
+    return list(files)
+
+
+def _load_json(path, key):
+    with open(path, encoding='utf-8') as f:
+        return np.array(json.load(f)[key], dtype=np.float64)
+
+
+def main():
+    parser = argparse.ArgumentParser(description="手眼标定求解工具")
+    parser.add_argument('log', help="标定数据日志 (.calib)")
+    parser.add_argument('--pattern', required=True, help="棋盘格内角点数，如 9x6")
+    parser.add_argument('--square', type=float, required=True, help="方格边长 (mm)")
+    parser.add_argument('--intrinsics', help="以已有 intrinsics.json 为初值")
+    parser.add_argument('--dist', help="以已有 distCoeffs.json 为初值")
+    parser.add_argument('--fix-intrinsics', action='store_true', help="不优化内参与畸变 (需 --intrinsics)")
+    parser.add_argument('--rotvec', action='store_true', help="位姿角度为旋转向量 (默认 RPY)")
+    parser.add_argument('--method', default="park", choices=["tsai", "park", "horaud", "andreff", "daniilidis"])
+    parser.add_argument('-o', '--output', help="写出标定文件的目录")
+    args = parser.parse_args()
+
+    try:
+        cols, rows = (int(v) for v in args.pattern.lower().split('x'))
+        result = calibrate_from_log(
+            args.log, (cols, rows), args.square,
+            camera_matrix=_load_json(args.intrinsics, "intrinsics") if args.intrinsics else None,
+            dist_coeffs=_load_json(args.dist, "distCoeffs") if args.dist else None,
+            refine_intrinsics=not args.fix_intrinsics, rotation_vector=args.rotvec, method=args.method)
+    except (OSError, ValueError, RuntimeError) as e:
+        print(f"错误: {e}")
+        return 1
+
+    print(f"有效视图: {result['views_used']}/{len(result['point_ids'])}  耗时: {result['elapsed_ms']:.0f}ms")
+    if result['intrinsics_rms'] >= 0:
+        print(f"内参重投影误差: {result['intrinsics_rms']:.3f}px ({result['intrinsics_iterations']} 次迭代)")
+    print(f"手眼重投影误差: {result['initial_rms']:.3f}px -> {result['rms']:.3f}px "
+          f"({result['hand_eye_iterations']} 次迭代{'' if result['converged'] else ', 未收敛'})")
+    for pid, found, err in zip(result['point_ids'], result['found'], result['view_errors']):
+        print(f"  点 {pid:4d}: " + (f"{err:.3f}px" if found else "未检测到棋盘格"))
+    print("T (mm):")
+    for row in result['T']:
+        print("  " + "  ".join(f"{v:10.6f}" for v in row))
+
+    if args.output:
+        names = save_results(result, args.output)
+        print(f"已写出 {', '.join(names)} 到 {args.output}")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
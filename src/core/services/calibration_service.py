@@ -49,6 +49,7 @@ class CalibrationService:
         """
         自动拍照回调
         此方法将被注入到机器人驱动中，由机器人线程在到达点位时调用
+        返回保存的图像路径，由驱动记录到标定日志；失败时返回 None，驱动把该点记为拍照失败
         """
         try:
             # 1. 检查相机连接
@@ -94,7 +95,7 @@ class CalibrationService:
             
             if success:
                 self._log("信息", f"✅ 自动拍照成功: {filename}")
-                # 可以在这里扩展：记录图片路径到标定数据文件等
+                return str(filepath)
             else:
                 self._log("错误", f"❌ 保存图像失败: {filename}")
 
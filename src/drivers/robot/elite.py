@@ -204,11 +204,16 @@ class EliteRobot(IRobot):
                 if os.path.exists(dll_path):
                     info(f"Initializing SDK wrapper: {dll_path}", "ROBOT_DRIVER")
                     self.sdk = EliteSDK(dll_path)
-                    self.driver_handle = self.sdk.create_driver(ip)
+                    # 与C++扩展使用同一个recipe目录（项目根目录）
+                    recipe_dir = os.path.abspath(os.path.join(current_dir, "../../../"))
+                    self.driver_handle = self.sdk.create_driver(ip, recipe_dir)
                     
                     if self.driver_handle:
                         is_connected = self.sdk.is_connected(self.driver_handle)
                         info(f"SDK initialized. Connected: {is_connected}", "ROBOT_DRIVER")
+                        health = self.sdk.get_health(self.driver_handle)
+                        if health is not None and not health.rtsi_configured:
+                            warning(f"RTSI recipe files not found in {recipe_dir}, pose reads unavailable", "ROBOT_DRIVER")
                     else:
                         warning("Failed to create SDK driver handle", "ROBOT_DRIVER")
             except Exception as e:
@@ -479,6 +484,30 @@ class EliteRobot(IRobot):
             error(f"Failed to start Elite robot calibration: {e}", "ROBOT_DRIVER")
             return {'success': False, 'error': str(e)}
 
+    def _attach_calibration_state_source(self):
+        """让C++标定直接读取控制器的RTSI状态缓存 (未连接时回退到get_pose回调)"""
+        if self.controller is None or not hasattr(self.calibration_controller, "set_state_source"):
+            return
+        try:
+            self.calibration_controller.set_state_source(self.controller)
+            # 到位稳定检测阈值 (mm/s, deg/s, mm, deg, 采样数), 固定延时作为上限
+            settle_cfg = self.config.get('calibration', {}).get('settle')
+            if settle_cfg:
+                self.calibration_controller.set_settle_detection(**settle_cfg)
+        except Exception as e:
+            warning(f"Failed to attach RTSI state source: {e}", "ROBOT_DRIVER")
+
+    def _record_capture_image(self, image_path):
+        """通过 set_capture_image 把拍照回调返回的图像路径交给C++, 随该点一起写入标定日志
+
+        拍照回调失败时返回 None 而不抛异常，这里把空路径转成异常，
+        C++侧才会把该点标记为 CALIB_POINT_CAPTURE_FAILED 而不是 CAPTURED
+        """
+        if not image_path:
+            raise RuntimeError("拍照回调未返回图像路径")
+        if hasattr(self.calibration_controller, "set_capture_image"):
+            self.calibration_controller.set_capture_image(str(image_path))
+
     def _run_cpp_3d_calibration(self, layers, base_width, top_width, height, tilt_angle, direction="Z+"):
         """Invoke C++ 3D Calibration Implementation"""
         info("[Calibration] Starting C++ 3D Calibration...", "ROBOT_DRIVER")
@@ -492,6 +521,8 @@ class EliteRobot(IRobot):
              self._broadcast_log("Error: C++标定控制器连接失败")
              return
 
+        self._attach_calibration_state_source()
+
         # 2. Define Callbacks
         def log_wrapper(msg: str):
             self._broadcast_log(f"[C++] {msg}")
@@ -501,9 +532,10 @@ class EliteRobot(IRobot):
             self._broadcast_log(f"[C++] 请求拍照: 点 {idx}")
             if self._capture_callback:
                 try:
-                    self._capture_callback(idx)
+                    self._record_capture_image(self._capture_callback(idx))
                 except Exception as e:
                     error(f"Python capture callback failed: {e}", "ROBOT_DRIVER")
+                    raise  # 交给C++侧把该点标记为 CALIB_POINT_CAPTURE_FAILED
 
         def get_pose_wrapper() -> List[float]:
             # Bypass to Python logic to get pose (though C++ controller can do it too)
@@ -515,9 +547,13 @@ class EliteRobot(IRobot):
 
         # 3. Run 3D Calibration
         try:
+            # 轨迹模式: 整条路径一次上传, 拍照点通过RTSI寄存器握手 (需要已连接的控制器)
+            calib_cfg = self.config.get('calibration', {})
             self.calibration_controller.run_3d_calibration(
                 layers, base_width, top_width, height, tilt_angle, direction,
-                log_wrapper, capture_wrapper, get_pose_wrapper
+                log_wrapper, capture_wrapper, get_pose_wrapper,
+                trajectory_mode=bool(calib_cfg.get('trajectory_mode', False)),
+                blend_radius=float(calib_cfg.get('blend_radius', 10.0))
             )
             self._broadcast_log("C++ 3D标定流程结束")
         except Exception as e:
@@ -539,6 +575,8 @@ class EliteRobot(IRobot):
              self._broadcast_log("Error: C++标定控制器连接失败")
              return
 
+        self._attach_calibration_state_source()
+
         # 2. Define Callbacks
         def log_wrapper(msg: str):
             self._broadcast_log(f"[Native] {msg}")
@@ -546,7 +584,7 @@ class EliteRobot(IRobot):
         def capture_wrapper(idx: int):
             if self._capture_callback:
                 self._broadcast_log(f"触发拍照 (点 {idx})...")
-                self._capture_callback(idx)
+                self._record_capture_image(self._capture_callback(idx))
 
         def get_pose_wrapper() -> List[float]:
             p = self.get_position()
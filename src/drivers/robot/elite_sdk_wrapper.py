@@ -1,11 +1,57 @@
 import ctypes
 import os
 import sys
-from typing import Optional
+from typing import Optional, Sequence
+
+class EliteState(ctypes.Structure):
+    """Mirror of EliteStateStruct in elite_wrapper.cpp (m, rad, m/s, rad/s)"""
+    _fields_ = [
+        ("tcp_pose", ctypes.c_double * 6),
+        ("tcp_speed", ctypes.c_double * 6),
+        ("joint_positions", ctypes.c_double * 6),
+        ("joint_speeds", ctypes.c_double * 6),
+        ("timestamp", ctypes.c_double),
+        ("age", ctypes.c_double),
+        ("robot_mode", ctypes.c_int32),
+        ("runtime_state", ctypes.c_int32),
+        ("sequence", ctypes.c_uint64),
+    ]
+
+    def to_dict(self) -> dict:
+        return {
+            "tcp_pose": list(self.tcp_pose),
+            "tcp_speed": list(self.tcp_speed),
+            "joint_positions": list(self.joint_positions),
+            "joint_speeds": list(self.joint_speeds),
+            "timestamp": self.timestamp,
+            "age": self.age,
+            "robot_mode": self.robot_mode,
+            "runtime_state": self.runtime_state,
+            "sequence": self.sequence,
+        }
+
+class EliteHealth(ctypes.Structure):
+    """Mirror of EliteHealthStruct in elite_wrapper.cpp (RTSI reconnect supervisor counters)"""
+    _fields_ = [
+        ("samples", ctypes.c_uint64),
+        ("disconnects", ctypes.c_uint64),
+        ("stale_resets", ctypes.c_uint64),
+        ("reconnect_attempts", ctypes.c_uint64),
+        ("reconnects", ctypes.c_uint64),
+        ("backoff", ctypes.c_double),
+        ("last_sample_age", ctypes.c_double),
+        ("rtsi_connected", ctypes.c_int32),
+        ("rtsi_configured", ctypes.c_int32),
+    ]
+
+    def to_dict(self) -> dict:
+        return {name: getattr(self, name) for name, _ in self._fields_}
 
 class EliteSDK:
     def __init__(self, dll_path: str):
         self.lib = None
+        self.has_bulk_api = False
+        self.has_health_api = False
         try:
             # Load the DLL
             # Note: On Windows, we might need to add the DLL directory to PATH or use os.add_dll_directory
@@ -36,14 +82,57 @@ class EliteSDK:
             # bool Elite_GetPose(EliteDriverHandle handle, double* pose)
             self.lib.Elite_GetPose.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_double)]
             self.lib.Elite_GetPose.restype = ctypes.c_bool
+
+            # Bulk state / batched motion, missing in older builds of the DLL
+            self.has_bulk_api = hasattr(self.lib, 'Elite_GetState')
+            if self.has_bulk_api:
+                # int Elite_GetStateSize()
+                self.lib.Elite_GetStateSize.argtypes = []
+                self.lib.Elite_GetStateSize.restype = ctypes.c_int
+                if self.lib.Elite_GetStateSize() != ctypes.sizeof(EliteState):
+                    print("Elite Wrapper DLL state layout mismatch, bulk API disabled")
+                    self.has_bulk_api = False
+
+            if self.has_bulk_api:
+                # bool Elite_GetState(EliteDriverHandle handle, EliteStateStruct* state)
+                self.lib.Elite_GetState.argtypes = [ctypes.c_void_p, ctypes.POINTER(EliteState)]
+                self.lib.Elite_GetState.restype = ctypes.c_bool
+
+                # bool Elite_MoveLinear(EliteDriverHandle handle, double x, y, z, rx, ry, rz, float speed)
+                self.lib.Elite_MoveLinear.argtypes = [ctypes.c_void_p] + [ctypes.c_double] * 6 + [ctypes.c_float]
+                self.lib.Elite_MoveLinear.restype = ctypes.c_bool
+
+                # bool Elite_SubmitPath(EliteDriverHandle handle, const double* poses, int n, double speed, double accel, double blend_radius)
+                self.lib.Elite_SubmitPath.argtypes = [ctypes.c_void_p, ctypes.POINTER(ctypes.c_double), ctypes.c_int,
+                                                      ctypes.c_double, ctypes.c_double, ctypes.c_double]
+                self.lib.Elite_SubmitPath.restype = ctypes.c_bool
+
+            # RTSI supervisor health, missing in older builds of the DLL
+            self.has_health_api = hasattr(self.lib, 'Elite_GetHealth')
+            if self.has_health_api:
+                self.lib.Elite_GetHealthSize.argtypes = []
+                self.lib.Elite_GetHealthSize.restype = ctypes.c_int
+                self.has_health_api = self.lib.Elite_GetHealthSize() == ctypes.sizeof(EliteHealth)
+
+            if self.has_health_api:
+                # EliteDriverHandle Elite_CreateEx(const char* robot_ip, const char* recipe_dir)
+                self.lib.Elite_CreateEx.argtypes = [ctypes.c_char_p, ctypes.c_char_p]
+                self.lib.Elite_CreateEx.restype = ctypes.c_void_p
+
+                # bool Elite_GetHealth(EliteDriverHandle handle, EliteHealthStruct* health)
+                self.lib.Elite_GetHealth.argtypes = [ctypes.c_void_p, ctypes.POINTER(EliteHealth)]
+                self.lib.Elite_GetHealth.restype = ctypes.c_bool
             
         except Exception as e:
             print(f"Failed to load Elite Wrapper DLL: {e}")
             self.lib = None
 
-    def create_driver(self, ip: str):
+    def create_driver(self, ip: str, recipe_dir: Optional[str] = None):
+        """recipe_dir holds the RTSI recipe files; None searches the working directory, then the DLL directory"""
         if not self.lib: return None
         ip_bytes = ip.encode('utf-8')
+        if self.has_health_api:
+            return self.lib.Elite_CreateEx(ip_bytes, recipe_dir.encode('utf-8') if recipe_dir else None)
         return self.lib.Elite_Create(ip_bytes)
 
     def destroy_driver(self, handle):
@@ -65,3 +154,34 @@ class EliteSDK:
         if self.lib.Elite_GetPose(handle, pose_array):
             return list(pose_array)
         return None
+
+    def get_state(self, handle) -> Optional[EliteState]:
+        """Cached RTSI state in one call, None before the first sample"""
+        if not self.lib or not handle or not self.has_bulk_api: return None
+        state = EliteState()
+        if self.lib.Elite_GetState(handle, ctypes.byref(state)):
+            return state
+        return None
+
+    def move_linear(self, handle, pose: Sequence[float], speed: float) -> bool:
+        """movel to pose [x, y, z, rx, ry, rz] (m, rad) at speed (m/s)"""
+        if not self.lib or not handle or not self.has_bulk_api: return False
+        return self.lib.Elite_MoveLinear(handle, *[float(v) for v in pose[:6]], float(speed))
+
+    def submit_path(self, handle, poses: Sequence[Sequence[float]], speed: float,
+                    accel: float = 0.0, blend_radius: float = 0.0) -> bool:
+        """Send poses (m, rad) as one blended movel program; blend_radius in m"""
+        if not self.lib or not handle or not self.has_bulk_api: return False
+        flat = [float(v) for pose in poses for v in pose[:6]]
+        n = len(flat) // 6
+        if n == 0 or len(flat) != 6 * len(poses): return False
+        buf = (ctypes.c_double * len(flat))(*flat)
+        return self.lib.Elite_SubmitPath(handle, buf, n, float(speed), float(accel), float(blend_radius))
+
+    def get_health(self, handle) -> Optional[EliteHealth]:
+        """RTSI reconnect supervisor counters (non-blocking)"""
+        if not self.lib or not handle or not self.has_health_api: return None
+        health = EliteHealth()
+        if self.lib.Elite_GetHealth(handle, ctypes.byref(health)):
+            return health
+        return None
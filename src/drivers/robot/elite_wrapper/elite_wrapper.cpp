@@ -1,11 +1,27 @@
 #define _CRT_SECURE_NO_WARNINGS
 #include <Elite/EliteDriver.hpp>
 #include <Elite/RtsiIOInterface.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <iomanip>
+#include <sstream>
+#include <thread>
 #include <vector>
 
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#endif
+
 // Define a macro for export
 #if defined(_WIN32)
 #define EXPORT __declspec(dllexport)
@@ -13,22 +29,297 @@
 #define EXPORT
 #endif
 
+// Bulk robot state returned by Elite_GetState. Plain C layout, mirrored by EliteState in
+// elite_sdk_wrapper.py; Elite_GetStateSize() lets the caller check the two agree.
+// Units are the SDK's (m, rad, m/s, rad/s).
+struct EliteStateStruct
+{
+    double tcp_pose[6];
+    double tcp_speed[6];
+    double joint_positions[6];
+    double joint_speeds[6];
+    double timestamp;  // Controller timestamp of the sample (s)
+    double age;        // Seconds since the sample was received, filled in by Elite_GetState
+    int32_t robot_mode;    // ELITE::RobotMode, -1 before the first sample
+    int32_t runtime_state; // ELITE::TaskStatus
+    uint64_t sequence;     // Samples received so far, 0 = no data yet
+};
+
+// RTSI supervisor counters returned by Elite_GetHealth, mirrored by EliteHealth in elite_sdk_wrapper.py
+struct EliteHealthStruct
+{
+    uint64_t samples;            // Samples received since Elite_Create
+    uint64_t disconnects;        // Unplanned link drops noticed by the supervisor
+    uint64_t stale_resets;       // Links reset because no sample arrived for RTSI_STALE_TIMEOUT
+    uint64_t reconnect_attempts;
+    uint64_t reconnects;         // Successful reconnects
+    double backoff;              // Current retry delay (s), 0 while connected
+    double last_sample_age;      // s, -1 before the first sample
+    int32_t rtsi_connected;
+    int32_t rtsi_configured;     // 0 if the recipe files were not found, RTSI is then unavailable
+};
+
+static const double RTSI_FREQUENCY = 250.0;
+// Reconnect supervision, same policy as EliteRobotController
+static const double RTSI_BACKOFF_INITIAL = 0.5; // s
+static const double RTSI_BACKOFF_MAX = 10.0;    // s
+static const double RTSI_STALE_TIMEOUT = 1.0;   // s without a new sample
+static const int RTSI_IDLE_POLL_MS = 50;
+static const double MOVE_ACCEL = 0.5;        // m/s^2, same as the script moves in elite.py
+static const double MIN_BLEND_RADIUS = 0.001; // m, smaller blends are sent as stops
+
 // Wrapper struct to hold both Driver and RTSI
 struct EliteContext
 {
     std::unique_ptr<ELITE::EliteDriver> driver;
     std::unique_ptr<ELITE::RtsiIOInterface> rtsi;
     std::string ip;
+
+    // Latest RTSI sample, written by rtsi_thread and copied out by Elite_GetState/Elite_GetPose
+    std::mutex state_mutex;
+    EliteStateStruct state{};
+    std::chrono::steady_clock::time_point state_received;
+    std::thread rtsi_thread;
+    std::atomic<bool> rtsi_running{false};
+
+    // Serializes connect/disconnect between the supervisor and Elite_ConnectRTSI/DisconnectRTSI
+    std::mutex rtsi_mutex;
+    // Cleared by Elite_DisconnectRTSI before it disconnects, so the supervisor leaves the link down
+    // and does not count the planned disconnect as a drop
+    std::atomic<bool> rtsi_enabled{true};
+    std::atomic<bool> rtsi_link_up{false};
+    std::atomic<uint64_t> disconnects{0};
+    std::atomic<uint64_t> stale_resets{0};
+    std::atomic<uint64_t> reconnect_attempts{0};
+    std::atomic<uint64_t> reconnects{0};
+    std::atomic<double> backoff{RTSI_BACKOFF_INITIAL};
 };
 
+static std::chrono::steady_clock::duration seconds(double s)
+{
+    return std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(s));
+}
+
+// Polls the RTSI interface at the recipe frequency and caches each new sample, so a ctypes
+// call never waits on the network. Also supervises the link: a drop, or a link that stays up
+// without new samples, is reconnected here with exponential backoff.
+static void rtsiLoop(EliteContext *ctx)
+{
+    using clock = std::chrono::steady_clock;
+    const auto period = seconds(1.0 / RTSI_FREQUENCY);
+    EliteStateStruct sample{};
+    sample.robot_mode = -1;
+    sample.runtime_state = -1;
+    double last_timestamp = -1.0;
+    auto next = clock::now();
+    bool link_up = false;
+    bool ever_up = false;
+    bool planned_down = false; // link taken down by Elite_DisconnectRTSI
+    double backoff = RTSI_BACKOFF_INITIAL;
+    auto retry_at = clock::now() + seconds(backoff);
+    auto last_sample_at = clock::now();
+
+    while (ctx->rtsi_running.load(std::memory_order_acquire))
+    {
+        next += period;
+        auto now = clock::now();
+        bool connected = false;
+        {
+            std::lock_guard<std::mutex> lock(ctx->rtsi_mutex);
+            try
+            {
+                connected = ctx->rtsi->isConnected();
+                if (connected && link_up && now - last_sample_at > seconds(RTSI_STALE_TIMEOUT))
+                {
+                    ctx->stale_resets.fetch_add(1, std::memory_order_relaxed);
+                    ctx->rtsi->disconnect();
+                    connected = false;
+                }
+            }
+            catch (...)
+            {
+                connected = false;
+            }
+        }
+
+        if (connected != link_up)
+        {
+            link_up = connected;
+            ctx->rtsi_link_up.store(connected, std::memory_order_release);
+            if (connected)
+            {
+                if (ever_up && !planned_down)
+                    ctx->reconnects.fetch_add(1, std::memory_order_relaxed);
+                ever_up = true;
+                planned_down = false;
+                backoff = RTSI_BACKOFF_INITIAL;
+                ctx->backoff.store(0.0, std::memory_order_relaxed);
+                last_sample_at = now;
+            }
+            else if (!ctx->rtsi_enabled.load(std::memory_order_acquire))
+            {
+                planned_down = true;
+            }
+            else
+            {
+                ctx->disconnects.fetch_add(1, std::memory_order_relaxed);
+                std::cerr << "[EliteWrapper] RTSI link lost, reconnecting." << std::endl;
+                retry_at = now + seconds(backoff);
+                ctx->backoff.store(backoff, std::memory_order_relaxed);
+            }
+        }
+
+        if (!connected)
+        {
+            if (ctx->rtsi_enabled.load(std::memory_order_acquire) && now >= retry_at)
+            {
+                ctx->reconnect_attempts.fetch_add(1, std::memory_order_relaxed);
+                bool ok = false;
+                {
+                    std::lock_guard<std::mutex> lock(ctx->rtsi_mutex);
+                    try
+                    {
+                        ok = ctx->rtsi->connect(ctx->ip);
+                    }
+                    catch (...)
+                    {
+                    }
+                }
+                if (!ok)
+                {
+                    backoff = std::min(backoff * 2.0, RTSI_BACKOFF_MAX);
+                    ctx->backoff.store(backoff, std::memory_order_relaxed);
+                    retry_at = clock::now() + seconds(backoff);
+                }
+            }
+            // Off the sample clock until the link is back; short ticks keep Elite_Destroy responsive
+            next = std::min(retry_at, clock::now() + std::chrono::milliseconds(RTSI_IDLE_POLL_MS));
+            std::this_thread::sleep_until(next);
+            continue;
+        }
+
+        try
+        {
+            std::lock_guard<std::mutex> lock(ctx->rtsi_mutex);
+            double ts = ctx->rtsi->getTimestamp();
+            if (ts != last_timestamp)
+            {
+                last_timestamp = ts;
+                last_sample_at = now;
+                auto pose = ctx->rtsi->getActualTCPPose();
+                auto speed = ctx->rtsi->getActualTCPVelocity();
+                auto joints = ctx->rtsi->getActualJointPositions();
+                auto joint_speeds = ctx->rtsi->getActualJointVelocity();
+                for (int i = 0; i < 6; ++i)
+                {
+                    sample.tcp_pose[i] = pose[i];
+                    sample.tcp_speed[i] = speed[i];
+                    sample.joint_positions[i] = joints[i];
+                    sample.joint_speeds[i] = joint_speeds[i];
+                }
+                sample.timestamp = ts;
+                sample.robot_mode = static_cast<int32_t>(ctx->rtsi->getRobotMode());
+                sample.runtime_state = static_cast<int32_t>(ctx->rtsi->getRuntimeState());
+                ++sample.sequence;
+
+                std::lock_guard<std::mutex> state_lock(ctx->state_mutex);
+                ctx->state = sample;
+                ctx->state_received = clock::now();
+            }
+        }
+        catch (...)
+        {
+            // Keep the last good sample, retry on the next tick
+        }
+
+        now = clock::now();
+        if (next < now)
+            next = now;
+        std::this_thread::sleep_until(next);
+    }
+}
+
+// Directory the recipe files are loaded from: recipe_dir if given, else the working directory,
+// else the directory of this DLL (bin/, next to external_control.script). Empty if none has both.
+static std::string findRecipeDir(const char *recipe_dir)
+{
+    auto has_recipes = [](const std::string &dir)
+    {
+        std::string prefix = dir.empty() ? "" : dir + "/";
+        FILE *f_out = fopen((prefix + "output_recipe.txt").c_str(), "r");
+        FILE *f_in = fopen((prefix + "input_recipe.txt").c_str(), "r");
+        bool ok = f_out && f_in;
+        if (f_out)
+            fclose(f_out);
+        if (f_in)
+            fclose(f_in);
+        return ok;
+    };
+
+    if (recipe_dir && *recipe_dir)
+        return has_recipes(recipe_dir) ? std::string(recipe_dir) : std::string();
+    if (has_recipes(""))
+        return ".";
+#if defined(_WIN32)
+    HMODULE module = nullptr;
+    char path[MAX_PATH];
+    if (GetModuleHandleExA(GET_MODULE_HANDLE_EX_FLAG_FROM_ADDRESS | GET_MODULE_HANDLE_EX_FLAG_UNCHANGED_REFCOUNT,
+                           reinterpret_cast<LPCSTR>(&findRecipeDir), &module) &&
+        GetModuleFileNameA(module, path, MAX_PATH) > 0)
+    {
+        std::string dir(path);
+        size_t slash = dir.find_last_of("\\/");
+        if (slash != std::string::npos)
+        {
+            dir.resize(slash);
+            if (has_recipes(dir))
+                return dir;
+        }
+    }
+#endif
+    return std::string();
+}
+
+static void startRtsiThread(EliteContext *ctx)
+{
+    if (ctx->rtsi_running.exchange(true))
+        return;
+    ctx->rtsi_thread = std::thread(rtsiLoop, ctx);
+}
+
+static void stopRtsiThread(EliteContext *ctx)
+{
+    ctx->rtsi_running.store(false, std::memory_order_release);
+    if (ctx->rtsi_thread.joinable())
+        ctx->rtsi_thread.join();
+}
+
+static std::string poseToString(const double *p)
+{
+    // Use list [...] instead of p[...] to avoid builtin_function subscript error
+    std::stringstream ss;
+    ss << std::setprecision(9) << "[" << p[0] << "," << p[1] << "," << p[2] << "," << p[3] << "," << p[4] << "," << p[5] << "]";
+    return ss.str();
+}
+
+static double segmentLength(const double *a, const double *b)
+{
+    double d = 0;
+    for (int k = 0; k < 3; ++k)
+        d += (a[k] - b[k]) * (a[k] - b[k]);
+    return std::sqrt(d);
+}
+
 extern "C"
 {
 
     // Opaque pointer to hold the EliteContext instance
     typedef void *EliteDriverHandle;
 
-    // Create the driver instance
-    EXPORT EliteDriverHandle Elite_Create(const char *robot_ip)
+    // Create the driver instance. recipe_dir holds output_recipe.txt/input_recipe.txt; nullptr or
+    // "" searches the working directory, then the DLL directory. Without recipes the handle still
+    // drives scripts but has no RTSI, see Elite_GetHealth()->rtsi_configured.
+    EXPORT EliteDriverHandle Elite_CreateEx(const char *robot_ip, const char *recipe_dir)
     {
         try
         {
@@ -61,45 +352,32 @@ extern "C"
                 return nullptr;
             }
 
-            // Initialize RTSI for data reading
-            try
+            // Initialize RTSI for data reading; the supervisor thread retries the connect
+            std::string dir = findRecipeDir(recipe_dir);
+            if (dir.empty())
             {
-                // Check if recipe files exist
-                FILE *f_out = fopen("output_recipe.txt", "r");
-                FILE *f_in = fopen("input_recipe.txt", "r");
-
-                if (f_out && f_in)
+                std::cerr << "[EliteWrapper] Recipe files not found (recipe_dir="
+                          << (recipe_dir && *recipe_dir ? recipe_dir : "<cwd, dll dir>")
+                          << "), RTSI disabled." << std::endl;
+            }
+            else
+            {
+                try
                 {
-                    fclose(f_out);
-                    fclose(f_in);
-                    ctx->rtsi = std::make_unique<ELITE::RtsiIOInterface>("output_recipe.txt", "input_recipe.txt", 250);
-                    if (ctx->rtsi)
-                    {
-                        bool connected = ctx->rtsi->connect(ctx->ip);
-                        if (!connected)
-                        {
-                            std::cerr << "[EliteWrapper] RTSI connect returned false." << std::endl;
-                        }
-                    }
+                    ctx->rtsi = std::make_unique<ELITE::RtsiIOInterface>(dir + "/output_recipe.txt", dir + "/input_recipe.txt", RTSI_FREQUENCY);
+                    if (!ctx->rtsi->connect(ctx->ip))
+                        std::cerr << "[EliteWrapper] RTSI connect returned false, retrying in background." << std::endl;
                 }
-                else
+                catch (const std::exception &e)
                 {
-                    std::cerr << "[EliteWrapper] Recipe files not found in current directory." << std::endl;
-                    if (f_out)
-                        fclose(f_out);
-                    if (f_in)
-                        fclose(f_in);
+                    std::cerr << "[EliteWrapper] RTSI initialization failed: " << e.what() << std::endl;
                 }
-            }
-            catch (const std::exception &e)
-            {
-                std::cerr << "[EliteWrapper] RTSI initialization failed: " << e.what() << std::endl;
-                // Continue without RTSI
-            }
-            catch (...)
-            {
-                std::cerr << "[EliteWrapper] RTSI initialization failed with unknown error." << std::endl;
-                // Continue without RTSI
+                catch (...)
+                {
+                    std::cerr << "[EliteWrapper] RTSI initialization failed with unknown error." << std::endl;
+                }
+                if (ctx->rtsi)
+                    startRtsiThread(ctx);
             }
 
             return ctx;
@@ -110,12 +388,18 @@ extern "C"
         }
     }
 
+    EXPORT EliteDriverHandle Elite_Create(const char *robot_ip)
+    {
+        return Elite_CreateEx(robot_ip, nullptr);
+    }
+
     // Destroy the driver instance
     EXPORT void Elite_Destroy(EliteDriverHandle handle)
     {
         if (handle)
         {
             auto ctx = static_cast<EliteContext *>(handle);
+            stopRtsiThread(ctx);
             if (ctx->rtsi)
                 ctx->rtsi->disconnect();
             if (ctx->driver)
@@ -130,10 +414,8 @@ extern "C"
         if (!handle)
             return false;
         auto ctx = static_cast<EliteContext *>(handle);
-        // Check both driver and RTSI? Or just driver?
-        bool driver_connected = ctx->driver && ctx->driver->isRobotConnected();
-        bool rtsi_connected = ctx->rtsi && ctx->rtsi->isConnected();
-        return driver_connected; // Return driver status primarily
+        // Driver status only; the RTSI link is reported by Elite_GetHealth
+        return ctx->driver && ctx->driver->isRobotConnected();
     }
 
     // Send script
@@ -147,6 +429,56 @@ extern "C"
         return ctx->driver->sendScript(std::string(script));
     }
 
+    // Size of EliteStateStruct, for checking the caller's mirror of the layout
+    EXPORT int Elite_GetStateSize()
+    {
+        return static_cast<int>(sizeof(EliteStateStruct));
+    }
+
+    // Fill *state from the cached RTSI sample in one call. Returns false if no sample has been
+    // received yet; state->age tells how stale the sample is.
+    EXPORT bool Elite_GetState(EliteDriverHandle handle, EliteStateStruct *state)
+    {
+        if (!handle || !state)
+            return false;
+        auto ctx = static_cast<EliteContext *>(handle);
+        std::chrono::steady_clock::time_point received;
+        {
+            std::lock_guard<std::mutex> lock(ctx->state_mutex);
+            *state = ctx->state;
+            received = ctx->state_received;
+        }
+        if (state->sequence == 0)
+            return false;
+        state->age = std::chrono::duration<double>(std::chrono::steady_clock::now() - received).count();
+        return true;
+    }
+
+    EXPORT int Elite_GetHealthSize()
+    {
+        return static_cast<int>(sizeof(EliteHealthStruct));
+    }
+
+    // RTSI supervisor counters, never blocks
+    EXPORT bool Elite_GetHealth(EliteDriverHandle handle, EliteHealthStruct *health)
+    {
+        if (!handle || !health)
+            return false;
+        auto ctx = static_cast<EliteContext *>(handle);
+        EliteStateStruct state;
+        bool have_sample = Elite_GetState(handle, &state);
+        health->samples = have_sample ? state.sequence : 0;
+        health->disconnects = ctx->disconnects.load(std::memory_order_relaxed);
+        health->stale_resets = ctx->stale_resets.load(std::memory_order_relaxed);
+        health->reconnect_attempts = ctx->reconnect_attempts.load(std::memory_order_relaxed);
+        health->reconnects = ctx->reconnects.load(std::memory_order_relaxed);
+        health->backoff = ctx->backoff.load(std::memory_order_relaxed);
+        health->last_sample_age = have_sample ? state.age : -1.0;
+        health->rtsi_connected = ctx->rtsi_link_up.load(std::memory_order_acquire) ? 1 : 0;
+        health->rtsi_configured = ctx->rtsi ? 1 : 0;
+        return true;
+    }
+
     // Get TCP Pose
     // Returns true if successful, false otherwise.
     // pose array must be at least size 6 [x, y, z, rx, ry, rz]
@@ -155,48 +487,77 @@ extern "C"
         if (!handle || !pose)
             return false;
 
+        auto ctx = static_cast<EliteContext *>(handle);
+        // Never blocks: a dropped link is reported as false until the supervisor brings it back
+        if (!ctx->rtsi_link_up.load(std::memory_order_acquire))
+            return false;
+        EliteStateStruct state;
+        if (!Elite_GetState(handle, &state))
+            return false;
+        std::memcpy(pose, state.tcp_pose, sizeof(state.tcp_pose));
+        return true;
+    }
+
+    // Linear move to [x, y, z, rx, ry, rz] (m, rad) at speed (m/s). Returns once the script is sent.
+    EXPORT bool Elite_MoveLinear(EliteDriverHandle handle, double x, double y, double z, double rx, double ry, double rz, float speed)
+    {
+        if (!handle)
+            return false;
+        auto ctx = static_cast<EliteContext *>(handle);
+        if (!ctx->driver)
+            return false;
+        const double pose[6] = {x, y, z, rx, ry, rz};
+        std::stringstream ss;
+        ss << "movel(" << poseToString(pose) << ", a=" << MOVE_ACCEL << ", v=" << speed << ")";
         try
         {
-            auto ctx = static_cast<EliteContext *>(handle);
-            if (!ctx || !ctx->rtsi)
-                return false;
-
-            // Ensure RTSI is connected
-            if (!ctx->rtsi->isConnected())
-            {
-                // Try to reconnect, but don't block or crash
-                // ctx->rtsi->connect(ctx->ip);
-                // if (!ctx->rtsi->isConnected())
-                //    return false;
-                return false;
-            }
-
-            auto vec = ctx->rtsi->getActualTCPPose();
-            if (vec.size() >= 6)
-            {
-                for (int i = 0; i < 6; ++i)
-                {
-                    pose[i] = vec[i];
-                }
-                return true;
-            }
+            return ctx->driver->sendScript(ss.str());
         }
         catch (...)
         {
             return false;
         }
-        return false;
     }
 
-    // Let's expose move functions
-    EXPORT bool Elite_MoveLinear(EliteDriverHandle handle, double x, double y, double z, double rx, double ry, double rz, float speed)
+    // Send n poses (n x 6 doubles, m/rad, row-major) as one blended movel program.
+    // Intermediate waypoints blend with up to blend_radius (m), clamped to 40% of the shorter
+    // adjacent segment; the last waypoint is a stop. accel <= 0 uses the default.
+    EXPORT bool Elite_SubmitPath(EliteDriverHandle handle, const double *poses, int n, double speed, double accel, double blend_radius)
     {
-        if (!handle)
+        if (!handle || !poses || n <= 0 || speed <= 0)
             return false;
-        return false;
+        auto ctx = static_cast<EliteContext *>(handle);
+        if (!ctx->driver)
+            return false;
+        if (accel <= 0)
+            accel = MOVE_ACCEL;
+
+        std::stringstream ss;
+        ss << "def submitted_path():\n";
+        for (int i = 0; i < n; ++i)
+        {
+            const double *p = poses + 6 * i;
+            double r = 0.0;
+            if (i > 0 && i + 1 < n && blend_radius > 0)
+            {
+                r = std::min(blend_radius, 0.4 * std::min(segmentLength(p - 6, p), segmentLength(p, p + 6)));
+                if (r < MIN_BLEND_RADIUS)
+                    r = 0.0;
+            }
+            ss << "  movel(" << poseToString(p) << ", a=" << accel << ", v=" << speed << ", r=" << r << ")\n";
+        }
+        ss << "end\n";
+        try
+        {
+            return ctx->driver->sendScript(ss.str());
+        }
+        catch (...)
+        {
+            return false;
+        }
     }
 
-    // Disconnect RTSI explicitly
+    // Disconnect RTSI explicitly; the supervisor leaves it down until Elite_ConnectRTSI
     EXPORT bool Elite_DisconnectRTSI(EliteDriverHandle handle)
     {
         if (!handle)
@@ -204,13 +565,15 @@ extern "C"
         auto ctx = static_cast<EliteContext *>(handle);
         if (ctx->rtsi)
         {
+            ctx->rtsi_enabled.store(false, std::memory_order_release);
+            std::lock_guard<std::mutex> lock(ctx->rtsi_mutex);
             ctx->rtsi->disconnect();
             return true;
         }
         return false;
     }
 
-    // Connect RTSI explicitly
+    // Connect RTSI explicitly and re-enable background reconnects
     EXPORT bool Elite_ConnectRTSI(EliteDriverHandle handle)
     {
         if (!handle)
@@ -218,7 +581,9 @@ extern "C"
         auto ctx = static_cast<EliteContext *>(handle);
         if (ctx->rtsi)
         {
-            return ctx->rtsi->connect(ctx->ip);
+            ctx->rtsi_enabled.store(true, std::memory_order_release);
+            std::lock_guard<std::mutex> lock(ctx->rtsi_mutex);
+            return ctx->rtsi->isConnected() || ctx->rtsi->connect(ctx->ip);
         }
         return false;
     }